@@ -0,0 +1,30 @@
+package com.breathinghand.audio
+
+import android.util.Log
+import androidx.test.ext.junit.runners.AndroidJUnit4
+
+import org.junit.Test
+import org.junit.runner.RunWith
+
+import org.junit.Assert.*
+
+/**
+ * Per-call JNI transition cost for the three binding kinds used by [OboeSynthesizer].
+ * Run on a device; results go to logcat under tag `JniCallCost`.
+ */
+@RunWith(AndroidJUnit4::class)
+class JniCallCostTest {
+    @Test
+    fun criticalIsNoSlowerThanRegular() {
+        val synth = OboeSynthesizer()
+        try {
+            val ns = synth.measureJniCallCost(2_000_000)
+            Log.i("JniCallCost", "regular %.1f ns, fast %.1f ns, critical %.1f ns".format(ns[0], ns[1], ns[2]))
+            assertTrue(ns.all { it > 0.0 })
+            // Generous margin: the point is to catch a binding that fell back to the slow path.
+            assertTrue(ns[2] <= ns[0] * 1.1)
+        } finally {
+            synth.close()
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include "AssetRegistry.h"
+
+AssetRegistry::~AssetRegistry() {
+    for (auto &s : wavetables_.slots) delete s.load(std::memory_order_relaxed);
+    for (auto &s : samples_.slots) delete s.load(std::memory_order_relaxed);
+}
+
+template <typename T, int N>
+int AssetRegistry::reserve(SlotTable<T, N> &table, int count, int *out) {
+    std::lock_guard<std::mutex> guard(writeMutex_);
+    int n = 0;
+    for (int i = 0; i < N && n < count; ++i) {
+        if (table.reserved[i] || table.slots[i].load(std::memory_order_relaxed) != nullptr) continue;
+        table.reserved[i] = true;
+        out[n++] = i;
+    }
+    return n;
+}
+
+template <typename T, int N>
+int AssetRegistry::publish(SlotTable<T, N> &table, std::unique_ptr<T> asset, int slot) {
+    if (!asset) return -1;
+    std::lock_guard<std::mutex> guard(writeMutex_);
+    if (slot < 0) {
+        for (int i = 0; i < N; ++i) {
+            if (!table.reserved[i] && table.slots[i].load(std::memory_order_relaxed) == nullptr) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) return -1;
+    }
+    if (slot >= N) return -1;
+
+    table.reserved[slot] = false;
+    T *previous = table.slots[slot].exchange(asset.release(), std::memory_order_acq_rel);
+    reclaimer_.retire(previous);
+    version_.fetch_add(1, std::memory_order_release);
+    return slot;
+}
+
+template <typename T, int N>
+bool AssetRegistry::unload(SlotTable<T, N> &table, int slot) {
+    if (slot < 0 || slot >= N) return false;
+    std::lock_guard<std::mutex> guard(writeMutex_);
+    T *previous = table.slots[slot].exchange(nullptr, std::memory_order_acq_rel);
+    if (!previous) return false;
+    reclaimer_.retire(previous);
+    version_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+int AssetRegistry::reserveWavetableSlots(int count, int *out) { return reserve(wavetables_, count, out); }
+int AssetRegistry::reserveSampleSlots(int count, int *out) { return reserve(samples_, count, out); }
+
+int AssetRegistry::publishWavetable(std::unique_ptr<Wavetable> table, int slot) {
+    return publish(wavetables_, std::move(table), slot);
+}
+
+int AssetRegistry::publishSample(std::unique_ptr<SampleAsset> sample, int slot) {
+    return publish(samples_, std::move(sample), slot);
+}
+
+void AssetRegistry::releaseWavetableSlot(int slot) {
+    if (slot < 0 || slot >= kMaxWavetables) return;
+    std::lock_guard<std::mutex> guard(writeMutex_);
+    wavetables_.reserved[slot] = false;
+}
+
+void AssetRegistry::releaseSampleSlot(int slot) {
+    if (slot < 0 || slot >= kMaxSamples) return;
+    std::lock_guard<std::mutex> guard(writeMutex_);
+    samples_.reserved[slot] = false;
+}
+
+bool AssetRegistry::unloadWavetable(int slot) { return unload(wavetables_, slot); }
+bool AssetRegistry::unloadSample(int slot) { return unload(samples_, slot); }
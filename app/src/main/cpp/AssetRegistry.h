@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Reclaimer.h"
+#include "Wavetable.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// A decoded, engine-ready sample: mono float PCM, peak-normalized. Imports own their frames
+// (resampled to the engine rate); registered PCM (OboeSynthesizer.registerPcm()) may instead
+// be adopted in place, in which case external points into the caller's buffer and
+// releaseExternal hands it back once the asset is destroyed.
+struct SampleAsset {
+    std::vector<float> frames;
+    double sampleRate = 48000.0;
+    const float *external = nullptr;
+    size_t externalFrames = 0;
+    std::function<void()> releaseExternal;
+
+    SampleAsset() = default;
+    SampleAsset(const SampleAsset &) = delete;
+    SampleAsset &operator=(const SampleAsset &) = delete;
+    ~SampleAsset() {
+        if (releaseExternal) releaseExternal();
+    }
+
+    const float *data() const { return external ? external : frames.data(); }
+    size_t size() const { return external ? externalFrames : frames.size(); }
+};
+
+// Slot tables of finished assets shared with the audio thread.
+//
+// Publishers (import workers, JNI threads) install a fully built asset with one atomic
+// pointer store; the audio thread reads slots with an acquire load and never blocks.
+// Replaced and unloaded assets are retired to the Reclaimer, which frees them on its
+// housekeeping thread once no callback (Reclaimer::Guard) can still be rendering from them.
+class AssetRegistry {
+public:
+    static constexpr int kMaxWavetables = 64;
+    static constexpr int kMaxSamples = 256;
+
+    explicit AssetRegistry(Reclaimer &reclaimer = Reclaimer::instance()) : reclaimer_(reclaimer) {}
+    ~AssetRegistry();
+
+    AssetRegistry(const AssetRegistry &) = delete;
+    AssetRegistry &operator=(const AssetRegistry &) = delete;
+
+    // --- Audio thread (lock-free, inside a Reclaimer::Guard) ---
+    const Wavetable *wavetable(int slot) const { return wavetables_.get(slot); }
+    const SampleAsset *sample(int slot) const { return samples_.get(slot); }
+    // Incremented after every publish/unload.
+    uint32_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // --- Non-audio threads ---
+    // Reserves count free slots (in ascending order) so results can be published later
+    // in any order. Returns the number reserved; out[i] receives the slot indices.
+    int reserveWavetableSlots(int count, int *out);
+    int reserveSampleSlots(int count, int *out);
+    // Publishes into a reserved or explicit slot (slot < 0 picks the first free one).
+    // Returns the slot, or -1 if the table is full or the index is invalid.
+    int publishWavetable(std::unique_ptr<Wavetable> table, int slot = -1);
+    int publishSample(std::unique_ptr<SampleAsset> sample, int slot = -1);
+    // Drops a reservation that will never be published (e.g. the import failed).
+    void releaseWavetableSlot(int slot);
+    void releaseSampleSlot(int slot);
+    bool unloadWavetable(int slot);
+    bool unloadSample(int slot);
+
+private:
+    template <typename T, int N>
+    struct SlotTable {
+        std::atomic<T *> slots[N] = {};
+        bool reserved[N] = {};
+
+        T *get(int slot) const {
+            if (slot < 0 || slot >= N) return nullptr;
+            return slots[slot].load(std::memory_order_acquire);
+        }
+    };
+
+    template <typename T, int N>
+    int reserve(SlotTable<T, N> &table, int count, int *out);
+    template <typename T, int N>
+    int publish(SlotTable<T, N> &table, std::unique_ptr<T> asset, int slot);
+    template <typename T, int N>
+    bool unload(SlotTable<T, N> &table, int slot);
+
+    Reclaimer &reclaimer_;
+    std::mutex writeMutex_; // serialises publishers; never taken by the audio thread
+    SlotTable<Wavetable, kMaxWavetables> wavetables_;
+    SlotTable<SampleAsset, kMaxSamples> samples_;
+    std::atomic<uint32_t> version_{0};
+};
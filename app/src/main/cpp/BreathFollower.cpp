@@ -0,0 +1,81 @@
+#include "BreathFollower.h"
+#include "DspKernels.h"
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    // One-pole coefficient reaching 1 - 1/e after timeMs, per kSubBlock-frame step.
+    float stepCoef(float timeMs, double sampleRate) {
+        const double steps = std::max(1e-3, static_cast<double>(timeMs) * 1e-3 * sampleRate / BreathFollower::kSubBlock);
+        return static_cast<float>(std::exp(-1.0 / steps));
+    }
+
+} // namespace
+
+BreathFollower::BreathFollower() {
+    configure(Params{}, 48000.0);
+}
+
+void BreathFollower::configure(const Params &params, double sampleRate) {
+    params_ = params;
+    attack_ = stepCoef(params.attackMs, sampleRate);
+    release_ = stepCoef(params.releaseMs, sampleRate);
+    baselineAttack_ = stepCoef(params.baselineAttackMs, sampleRate);
+    baselineRelease_ = stepCoef(params.baselineReleaseMs, sampleRate);
+    gate_ = fastmath::dbToGain(params.gateDb);
+    onsetRatio_ = fastmath::dbToGain(params.onsetRiseDb);
+    resetRatio_ = fastmath::dbToGain(params.onsetRiseDb * 0.5f);
+    refractorySteps_ = static_cast<int>(std::ceil(params.refractoryMs * 1e-3 * sampleRate / kSubBlock));
+}
+
+void BreathFollower::reset() {
+    pendingPeak_ = 0.0f;
+    pendingFrames_ = 0;
+    env_ = 0.0f;
+    baseline_ = 0.0f;
+    level_ = 0.0f;
+    ready_ = true;
+    cooldown_ = 0;
+    onsets_ = 0;
+    frames_ = 0;
+    lastOnsetFrame_ = -1;
+}
+
+int BreathFollower::process(const float *in, int frames) {
+    const dsp::Kernels &kernels = dsp::kernels();
+    const uint64_t before = onsets_;
+    int i = 0;
+    while (i < frames) {
+        const int n = std::min(kSubBlock - pendingFrames_, frames - i);
+        pendingPeak_ = std::max(pendingPeak_, kernels.peakAbs(in + i, n));
+        pendingFrames_ += n;
+        frames_ += n;
+        i += n;
+        if (pendingFrames_ == kSubBlock) {
+            step(pendingPeak_);
+            pendingPeak_ = 0.0f;
+            pendingFrames_ = 0;
+        }
+    }
+    return static_cast<int>(onsets_ - before);
+}
+
+void BreathFollower::step(float peak) {
+    env_ = peak + (env_ - peak) * (peak > env_ ? attack_ : release_);
+    baseline_ = env_ + (baseline_ - env_) * (env_ > baseline_ ? baselineAttack_ : baselineRelease_);
+
+    const float db = fastmath::gainToDb(std::max(env_, 1e-9f));
+    level_ = std::clamp((db - params_.floorDb) / (params_.ceilDb - params_.floorDb), 0.0f, 1.0f);
+
+    if (cooldown_ > 0) --cooldown_;
+    if (!ready_ && env_ < baseline_ * resetRatio_) ready_ = true;
+    if (ready_ && cooldown_ == 0 && env_ > gate_ && env_ > baseline_ * onsetRatio_) {
+        ++onsets_;
+        lastOnsetFrame_ = frames_;
+        ready_ = false;
+        cooldown_ = refractorySteps_;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+// Envelope follower with onset detection over a mono input (breath on the microphone).
+//
+// Input is measured in fixed kSubBlock-frame steps whatever the callback size: the peak of
+// each step comes from the dispatched peakAbs kernel (DspKernels.h) and drives a fast
+// attack/release envelope and a slow baseline. level() maps the envelope's dB onto 0..1
+// between Params::floorDb and ceilDb; an onset is the envelope jumping onsetRiseDb above the
+// baseline (above the gate), after which detection rests until the envelope settles back
+// towards the baseline and refractoryMs has passed. At 48 kHz a step is 0.33 ms, so a breath
+// attack shows up in level() and onsets() within a couple of milliseconds of reaching the
+// input.
+//
+// Audio thread only; no allocation.
+class BreathFollower {
+public:
+    static constexpr int kSubBlock = 16;
+
+    struct Params {
+        float attackMs = 1.0f;
+        float releaseMs = 40.0f;
+        float baselineAttackMs = 150.0f;
+        float baselineReleaseMs = 150.0f;
+        float floorDb = -60.0f;        // level() 0 at or below
+        float ceilDb = -12.0f;         // level() 1 at or above
+        float gateDb = -50.0f;         // no onset below this envelope
+        float onsetRiseDb = 6.0f;      // envelope over baseline that counts as an onset
+        float refractoryMs = 60.0f;
+    };
+
+    BreathFollower();
+
+    // Any time the audio thread is not inside process().
+    void configure(const Params &params, double sampleRate);
+    void reset();
+
+    // Consumes frames mono samples; returns the onsets detected in them.
+    int process(const float *in, int frames);
+
+    float envelope() const { return env_; }
+    float level() const { return level_; }
+    uint64_t onsets() const { return onsets_; }
+    // Input frame (counted from the last reset) at the end of the step that detected the
+    // latest onset, -1 if none.
+    int64_t lastOnsetFrame() const { return lastOnsetFrame_; }
+
+private:
+    void step(float peak);
+
+    Params params_;
+    float attack_ = 0.0f;          // per-step one-pole coefficients
+    float release_ = 0.0f;
+    float baselineAttack_ = 0.0f;
+    float baselineRelease_ = 0.0f;
+    float gate_ = 0.0f;            // linear
+    float onsetRatio_ = 1.0f;
+    float resetRatio_ = 1.0f;
+    int refractorySteps_ = 0;
+
+    float pendingPeak_ = 0.0f;     // partial step carried between calls
+    int pendingFrames_ = 0;
+    float env_ = 0.0f;
+    float baseline_ = 0.0f;
+    float level_ = 0.0f;
+    bool ready_ = true;            // detection re-enabled after the previous onset
+    int cooldown_ = 0;
+    uint64_t onsets_ = 0;
+    int64_t frames_ = 0;
+    int64_t lastOnsetFrame_ = -1;
+};
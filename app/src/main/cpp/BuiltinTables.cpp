@@ -0,0 +1,230 @@
+#include "BuiltinTables.h"
+#include "FastMath.h"
+
+#include <cstddef>
+
+// Everything below is evaluated by the compiler. The generators use plain loops over local
+// arrays (C++17 constexpr), double precision throughout, and are rounded to float once.
+namespace {
+
+    constexpr int kN = Wavetable::kWavetableSize;
+    constexpr int kLevels = Wavetable::kNumMipLevels;
+    constexpr double kPi = 3.14159265358979323846;
+
+    // ---------------------- constexpr math ----------------------
+
+    constexpr double cFloor(double x) {
+        const auto i = static_cast<long long>(x);
+        return static_cast<double>(x < static_cast<double>(i) ? i - 1 : i);
+    }
+
+    // Taylor series after reduction to [-pi, pi]; error < 1e-14.
+    constexpr double cSin(double x) {
+        x -= 2.0 * kPi * cFloor(x / (2.0 * kPi) + 0.5);
+        const double x2 = x * x;
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 14; ++n) {
+            term *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cCos(double x) { return cSin(x + 0.5 * kPi); }
+
+    constexpr double cExp2(double x) {
+        const double i = cFloor(x);
+        const double y = (x - i) * 0.69314718055994530942;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 22; ++n) {
+            term *= y / n;
+            sum += term;
+        }
+        for (long long k = 0; k < static_cast<long long>(i); ++k) sum *= 2.0;
+        for (long long k = 0; k > static_cast<long long>(i); --k) sum *= 0.5;
+        return sum;
+    }
+
+    constexpr double cAbs(double x) { return x < 0.0 ? -x : x; }
+
+    // ---------------------- waveforms ----------------------
+
+    // Fourier sine-series coefficient of harmonic k for each shape.
+    constexpr double sineCoefficient(builtin::Shape shape, int k) {
+        switch (shape) {
+            case builtin::Shape::kSine:
+                return k == 1 ? 1.0 : 0.0;
+            case builtin::Shape::kSaw:
+                return (k % 2 ? 2.0 : -2.0) / (kPi * k);
+            case builtin::Shape::kSquare:
+                return k % 2 ? 4.0 / (kPi * k) : 0.0;
+            case builtin::Shape::kTriangle:
+                return k % 2 ? ((k / 2) % 2 ? -8.0 : 8.0) / (kPi * kPi * k * k) : 0.0;
+            default:
+                return 0.0;
+        }
+    }
+
+    struct Stack {
+        float data[Wavetable::kStackFloats];
+    };
+
+    // Each level is Im(sum_k b_k e^{i 2 pi k n / N}) over its harmonic budget, evaluated with an
+    // iterative radix-2 inverse DFT: O(N log N) per level keeps the compile-time cost small.
+    constexpr Stack makeStack(builtin::Shape shape) {
+        double twCos[kN / 2] = {};
+        double twSin[kN / 2] = {};
+        for (int k = 0; k < kN / 2; ++k) {
+            twCos[k] = cCos(2.0 * kPi * k / kN);
+            twSin[k] = cSin(2.0 * kPi * k / kN);
+        }
+
+        Stack s{};
+        double levels[kLevels][kN] = {};
+        for (int level = 0; level < kLevels; ++level) {
+            const int maxHarmonic = (kN / 2) >> level;
+            double re[kN] = {};
+            double im[kN] = {};
+            for (int k = 1; k <= maxHarmonic && k < kN / 2; ++k) re[k] = sineCoefficient(shape, k);
+
+            for (int i = 1, j = 0; i < kN; ++i) {
+                int bit = kN >> 1;
+                for (; j & bit; bit >>= 1) j ^= bit;
+                j ^= bit;
+                if (i < j) {
+                    const double tr = re[i], ti = im[i];
+                    re[i] = re[j];
+                    im[i] = im[j];
+                    re[j] = tr;
+                    im[j] = ti;
+                }
+            }
+            for (int len = 2; len <= kN; len <<= 1) {
+                const int half = len / 2;
+                const int stride = kN / len;
+                for (int i = 0; i < kN; i += len) {
+                    for (int k = 0; k < half; ++k) {
+                        const double wr = twCos[k * stride];
+                        const double wi = twSin[k * stride];  // +sign: inverse transform
+                        const int a = i + k, b = a + half;
+                        const double vr = re[b] * wr - im[b] * wi;
+                        const double vi = re[b] * wi + im[b] * wr;
+                        re[b] = re[a] - vr;
+                        im[b] = im[a] - vi;
+                        re[a] += vr;
+                        im[a] += vi;
+                    }
+                }
+            }
+            for (int n = 0; n < kN; ++n) levels[level][n] = im[n];
+        }
+
+        // Same normalisation as imported tables: level 0 peaks at 1, other levels share its gain.
+        double peak = 0.0;
+        for (int n = 0; n < kN; ++n) peak = cAbs(levels[0][n]) > peak ? cAbs(levels[0][n]) : peak;
+        const double gain = peak > 0.0 ? 1.0 / peak : 1.0;
+        for (int level = 0; level < kLevels; ++level) {
+            for (int n = 0; n < kN; ++n) s.data[level * kN + n] = static_cast<float>(levels[level][n] * gain);
+        }
+        return s;
+    }
+
+    constexpr Stack kSineStack = makeStack(builtin::Shape::kSine);
+    constexpr Stack kSawStack = makeStack(builtin::Shape::kSaw);
+    constexpr Stack kSquareStack = makeStack(builtin::Shape::kSquare);
+    constexpr Stack kTriangleStack = makeStack(builtin::Shape::kTriangle);
+
+    static_assert(kSineStack.data[kN / 4] > 0.99999f && kSineStack.data[kN / 4] <= 1.0f, "sine peaks at N/4");
+    static_assert(cAbs(kSineStack.data[kN / 8] - 0.70710678) < 1e-6, "sine table accuracy");
+    static_assert(kSawStack.data[0] == 0.0f && kSquareStack.data[kN / 4] > 0.8f, "shape orientation");
+
+    // ---------------------- tuning ----------------------
+
+    struct NoteTable {
+        float inc[128];
+    };
+
+    constexpr NoteTable makeNoteTable(double sampleRate) {
+        NoteTable t{};
+        for (int n = 0; n < 128; ++n) t.inc[n] = static_cast<float>(440.0 * cExp2((n - 69) / 12.0) / sampleRate);
+        return t;
+    }
+
+    constexpr NoteTable kNoteTables[builtin::kNumTunedRates] = {
+            makeNoteTable(builtin::kTunedRates[0]),
+            makeNoteTable(builtin::kTunedRates[1]),
+            makeNoteTable(builtin::kTunedRates[2]),
+            makeNoteTable(builtin::kTunedRates[3]),
+    };
+
+    static_assert(kNoteTables[1].inc[69] == static_cast<float>(440.0 / 48000.0), "A4 at 48 kHz");
+    static_assert(cAbs(kNoteTables[0].inc[81] / kNoteTables[0].inc[69] - 2.0) < 1e-6, "octave doubles");
+
+    constexpr int kBendSteps = 16384;
+    constexpr int kBendAnchor = 128;
+
+    struct BendTable {
+        float ratio[kBendSteps];
+    };
+
+    // Exact exp2 every kBendAnchor steps, multiplied forward in between (drift < 1e-13).
+    constexpr BendTable makeBendTable(int rangeSemitones) {
+        BendTable t{};
+        const double semisPerStep = rangeSemitones / 8192.0;
+        const double step = cExp2(semisPerStep / 12.0);
+        for (int base = 0; base < kBendSteps; base += kBendAnchor) {
+            double r = cExp2((base - 8192) * semisPerStep / 12.0);
+            for (int i = 0; i < kBendAnchor; ++i) {
+                t.ratio[base + i] = static_cast<float>(r);
+                r *= step;
+            }
+        }
+        return t;
+    }
+
+    constexpr BendTable kBendTables[builtin::kNumBendRanges] = {
+            makeBendTable(builtin::kBendRanges[0]),
+            makeBendTable(builtin::kBendRanges[1]),
+    };
+
+    static_assert(kBendTables[0].ratio[8192] == 1.0f, "centre is unity");
+    static_assert(cAbs(kBendTables[1].ratio[0] - 0.0625) < 1e-7, "-48 semitones is four octaves down");
+
+} // namespace
+
+namespace builtin {
+
+    const float *waveStack(Shape shape) {
+        switch (shape) {
+            case Shape::kSaw: return kSawStack.data;
+            case Shape::kSquare: return kSquareStack.data;
+            case Shape::kTriangle: return kTriangleStack.data;
+            case Shape::kSine:
+            default: return kSineStack.data;
+        }
+    }
+
+    const float *noteIncrements(double sampleRate) {
+        for (int i = 0; i < kNumTunedRates; ++i) {
+            if (sampleRate == kTunedRates[i]) return kNoteTables[i].inc;
+        }
+        return nullptr;
+    }
+
+    float noteIncrement(int note, double sampleRate) {
+        note = note < 0 ? 0 : (note > 127 ? 127 : note);
+        if (const float *t = noteIncrements(sampleRate)) return t[note];
+        return static_cast<float>(fastmath::noteToHz(static_cast<float>(note)) / sampleRate);
+    }
+
+    float bendToRatio(int bend14, int rangeSemitones) {
+        bend14 = bend14 < 0 ? 0 : (bend14 > kBendSteps - 1 ? kBendSteps - 1 : bend14);
+        for (int i = 0; i < kNumBendRanges; ++i) {
+            if (rangeSemitones == kBendRanges[i]) return kBendTables[i].ratio[bend14];
+        }
+        return fastmath::semitonesToRatio(fastmath::bend14ToSemitones(bend14, static_cast<float>(rangeSemitones)));
+    }
+
+} // namespace builtin
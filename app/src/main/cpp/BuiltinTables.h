@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Wavetable.h"
+
+#include <cstdint>
+
+// Built-in waveforms and tuning tables, generated at compile time (BuiltinTables.cpp) and
+// linked as read-only data: no construction cost, no allocation, nothing to page in until used.
+namespace builtin {
+
+    enum class Shape : uint8_t {
+        kSine = 0,
+        kSaw,
+        kSquare,
+        kTriangle,
+        kCount
+    };
+
+    // Band-limited mip stack (Wavetable::kStackFloats, same layout as Wavetable::mipStack()),
+    // normalised so level 0 peaks at 1. Pass to Wavetable::wrap() for a renderable table.
+    const float *waveStack(Shape shape);
+
+    // Sample rates with a precomputed note table.
+    constexpr int kNumTunedRates = 4;
+    constexpr double kTunedRates[kNumTunedRates] = {44100.0, 48000.0, 88200.0, 96000.0};
+
+    // Phase increments (cycles per sample, A4 = 440 Hz, equal temperament) for MIDI notes
+    // 0..127 at sampleRate, or nullptr when the rate has no table.
+    const float *noteIncrements(double sampleRate);
+
+    // Single lookup; falls back to fastmath for untabulated rates.
+    float noteIncrement(int note, double sampleRate);
+
+    // Bend ranges (semitones) with a 14-bit bend -> frequency ratio table: the MIDI default
+    // and the MPE member-channel default.
+    constexpr int kNumBendRanges = 2;
+    constexpr int kBendRanges[kNumBendRanges] = {2, 48};
+
+    // Frequency ratio for a 14-bit bend (0..16383, centre 8192) at rangeSemitones.
+    // Tabulated ranges are a single load; others fall back to fastmath.
+    float bendToRatio(int bend14, int rangeSemitones);
+
+} // namespace builtin
@@ -0,0 +1,188 @@
+#include "CallCapture.h"
+
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+    constexpr char kMagic[8] = {'B', 'H', 'C', 'A', 'L', 'L', 'S', '1'};
+    constexpr int kWriterPeriodMs = 5;
+    constexpr size_t kChunkBytes = sizeof(int32_t) * 4;
+
+    int64_t steadyNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+} // namespace
+
+CallCapture::~CallCapture() {
+    stop();
+}
+
+int32_t CallCapture::floatBits(float f) {
+    int32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+float CallCapture::bitsFloat(int32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+int64_t CallCapture::sinceStart() const {
+    return steadyNanos() - startNanos_;
+}
+
+bool CallCapture::start(const std::string &path) {
+    std::lock_guard<std::mutex> guard(controlMutex_);
+    if (file_) return false;
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.recordSize = sizeof(Record);
+    header.startEpochMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+
+    // Late pushes from a previous session (racing its stop()) are not part of this one.
+    Record stale;
+    while (queue_.pop(stale)) {}
+    dropped_.store(0, std::memory_order_relaxed);
+    written_.store(0, std::memory_order_relaxed);
+    startNanos_ = steadyNanos();
+
+    writerRun_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { writerLoop(); });
+    active_.store(true, std::memory_order_release);
+    return true;
+}
+
+void CallCapture::stop() {
+    std::lock_guard<std::mutex> guard(controlMutex_);
+    if (!file_) return;
+    active_.store(false, std::memory_order_release);
+    writerRun_.store(false, std::memory_order_release);
+    if (writer_.joinable()) writer_.join();
+    drainToFile();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void CallCapture::push(Op op, const void *payload, size_t bytes, int32_t a0, int32_t a1, int32_t a2, int32_t a3) {
+    if (bytes > kMaxPayloadBytes) bytes = kMaxPayloadBytes;
+    const uint32_t seq = nextSeq_.fetch_add(1, std::memory_order_relaxed);
+    const int64_t t = sinceStart();
+
+    const auto *src = static_cast<const uint8_t *>(payload);
+    for (size_t offset = 0; offset < bytes; offset += kChunkBytes) {
+        Record chunk{};
+        chunk.tNanos = t;
+        chunk.op = kOpPayloadChunk;
+        chunk.seq = seq;
+        const size_t n = bytes - offset < kChunkBytes ? bytes - offset : kChunkBytes;
+        chunk.payloadBytes = static_cast<uint16_t>(n);
+        std::memcpy(chunk.args, src + offset, n);
+        if (!queue_.push(chunk)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Record r{};
+    r.tNanos = t;
+    r.op = op;
+    r.payloadBytes = static_cast<uint16_t>(bytes);
+    r.seq = seq;
+    r.args[0] = a0;
+    r.args[1] = a1;
+    r.args[2] = a2;
+    r.args[3] = a3;
+    if (!queue_.push(r)) dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CallCapture::writerLoop() {
+    while (writerRun_.load(std::memory_order_acquire)) {
+        drainToFile();
+        std::this_thread::sleep_for(std::chrono::milliseconds(kWriterPeriodMs));
+    }
+}
+
+void CallCapture::drainToFile() {
+    Record batch[256];
+    size_t n = 0;
+    uint64_t total = 0;
+    Record r;
+    while (queue_.pop(r)) {
+        batch[n++] = r;
+        if (n == sizeof(batch) / sizeof(batch[0])) {
+            total += std::fwrite(batch, sizeof(Record), n, file_);
+            n = 0;
+        }
+    }
+    if (n) total += std::fwrite(batch, sizeof(Record), n, file_);
+    if (total) {
+        std::fflush(file_);
+        written_.fetch_add(total, std::memory_order_relaxed);
+    }
+}
+
+bool CallCapture::read(const std::string &path, std::vector<Call> &out, FileHeader *headerOut) {
+    std::FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    FileHeader header{};
+    const bool valid = std::fread(&header, sizeof(header), 1, f) == 1
+            && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+            && header.version == kFormatVersion && header.recordSize == sizeof(Record);
+    if (!valid) {
+        std::fclose(f);
+        return false;
+    }
+    if (headerOut) *headerOut = header;
+
+    std::unordered_map<uint32_t, std::vector<uint8_t>> pending;
+    Record r;
+    while (std::fread(&r, sizeof(r), 1, f) == 1) {
+        if (r.op == kOpPayloadChunk) {
+            const size_t n = r.payloadBytes < kChunkBytes ? r.payloadBytes : kChunkBytes;
+            auto &bytes = pending[r.seq];
+            const auto *src = reinterpret_cast<const uint8_t *>(r.args);
+            bytes.insert(bytes.end(), src, src + n);
+            continue;
+        }
+        if (r.op >= kOpCount) continue;
+        Call call;
+        call.tNanos = r.tNanos;
+        call.op = static_cast<Op>(r.op);
+        std::memcpy(call.args, r.args, sizeof(call.args));
+        if (r.payloadBytes) {
+            auto it = pending.find(r.seq);
+            // A dropped chunk leaves the payload short; keep what arrived.
+            if (it != pending.end()) {
+                call.payload = std::move(it->second);
+                pending.erase(it);
+            }
+        }
+        out.push_back(std::move(call));
+    }
+    std::fclose(f);
+    return true;
+}
+
+const char *CallCapture::opName(Op op) {
+    static const char *const kNames[kOpCount] = {
+            "payload", "start", "stop", "noteOn", "noteOff", "pitchBend", "channelPressure",
+            "controlChange", "ump", "setConductor", "setModRoutes", "setLfoRate", "setLowPowerRender",
+            "loadSoundFont", "initFluidSynth", "shutdownFluidSynth", "importFiles",
+            "openWavetableCache", "flushWavetableCache", "setWavetableVoice",
+            "setGranularSource", "registerPcm", "setBreathInput",
+    };
+    return op < kOpCount ? kNames[op] : "unknown";
+}
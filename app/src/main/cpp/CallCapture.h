@@ -0,0 +1,130 @@
+#pragma once
+
+#include "EventQueue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Opt-in recording of every state-changing JNI entry into the engine, for replaying field
+// sessions offline (host tool: app/src/test/cpp/CaptureReplay.cpp).
+//
+// record() copies the call into a fixed 32-byte Record and pushes it into a lock-free MPSC
+// queue; a writer thread drains the queue to disk every few milliseconds. When capture is
+// off record() is a single atomic load. Calls with variable-size arguments (paths, route arrays,
+// UMP words) are followed by payload chunks carrying the same sequence number; a producer
+// pushes its chunks before the call record, so a reader always sees them first.
+//
+// File: FileHeader, then Records in queue order (native endianness).
+class CallCapture {
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+    static constexpr size_t kQueueCapacity = 8192;
+    static constexpr size_t kMaxPayloadBytes = 65535;
+
+    // Appended only: op values are stored in capture files.
+    enum Op : uint16_t {
+        kOpPayloadChunk = 0,     // 16 payload bytes in args
+        kOpStart,
+        kOpStop,
+        kOpNoteOn,               // channel, note, velocity
+        kOpNoteOff,              // channel, note
+        kOpPitchBend,            // channel, bend14
+        kOpChannelPressure,      // channel, pressure
+        kOpControlChange,        // channel, cc, value
+        kOpUmp,                  // payload: 32-bit words
+        kOpSetConductor,         // flow, height, grip (float bits)
+        kOpSetModRoutes,         // payload: float quadruples
+        kOpSetLfoRate,           // lfo, hz (float bits)
+        kOpSetLowPowerRender,    // enabled
+        kOpLoadSoundFont,        // payload: path
+        kOpInitFluidSynth,
+        kOpShutdownFluidSynth,
+        kOpImportFiles,          // kind; payload: '\n'-separated paths
+        kOpOpenWavetableCache,   // payload: path
+        kOpFlushWavetableCache,
+        kOpSetWavetableVoice,    // slot, copies, detuneCents, spread (float bits)
+        kOpSetGranularSource,    // kind, slot
+        kOpRegisterPcm,          // kind, format, channels, frames (the PCM itself is not captured)
+        kOpSetBreathInput,       // enabled
+        kOpCount
+    };
+
+    struct Record {
+        int64_t tNanos;          // since capture start
+        uint16_t op;
+        uint16_t payloadBytes;   // call: total payload; chunk: bytes used in this chunk
+        uint32_t seq;            // call sequence number (shared by its chunks)
+        int32_t args[4];
+    };
+    static_assert(sizeof(Record) == 32, "Record must stay 32 bytes");
+
+    struct FileHeader {
+        char magic[8];           // "BHCALLS1"
+        uint32_t version;
+        uint32_t recordSize;
+        int64_t startEpochMs;    // wall clock at start, for matching with user reports
+        uint8_t reserved[8];
+    };
+    static_assert(sizeof(FileHeader) == 32, "FileHeader must stay 32 bytes");
+
+    CallCapture() = default;
+    ~CallCapture();
+
+    CallCapture(const CallCapture &) = delete;
+    CallCapture &operator=(const CallCapture &) = delete;
+
+    // Opens path (truncating) and starts recording. False if already running or on I/O error.
+    bool start(const std::string &path);
+    // Stops recording, writes everything still queued and closes the file.
+    void stop();
+    bool active() const { return active_.load(std::memory_order_acquire); }
+
+    // Any thread; lock-free. No-ops while inactive.
+    void record(Op op, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0, int32_t a3 = 0) {
+        if (active()) push(op, nullptr, 0, a0, a1, a2, a3);
+    }
+    void recordWithPayload(Op op, const void *payload, size_t bytes, int32_t a0 = 0) {
+        if (active()) push(op, payload, bytes, a0, 0, 0, 0);
+    }
+    static int32_t floatBits(float f);
+    static float bitsFloat(int32_t bits);
+
+    // Records lost because the queue was full (writer behind) since start().
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t writtenCount() const { return written_.load(std::memory_order_relaxed); }
+
+    // ---- Reading (host tools, tests) ----
+    struct Call {
+        int64_t tNanos = 0;
+        Op op = kOpPayloadChunk;
+        int32_t args[4] = {};
+        std::vector<uint8_t> payload;
+    };
+    // Reassembles calls with their payloads, in recorded order.
+    static bool read(const std::string &path, std::vector<Call> &out, FileHeader *header = nullptr);
+    static const char *opName(Op op);
+
+private:
+    void push(Op op, const void *payload, size_t bytes, int32_t a0, int32_t a1, int32_t a2, int32_t a3);
+    void writerLoop();
+    void drainToFile();
+    int64_t sinceStart() const;
+
+    MpscQueue<Record, kQueueCapacity> queue_;
+    std::atomic<bool> active_{false};
+    std::atomic<uint32_t> nextSeq_{1};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    int64_t startNanos_ = 0;
+
+    std::mutex controlMutex_;    // start/stop
+    std::atomic<bool> writerRun_{false};
+    std::thread writer_;
+    std::FILE *file_ = nullptr;
+};
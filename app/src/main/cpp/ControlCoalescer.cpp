@@ -0,0 +1,86 @@
+#include "ControlCoalescer.h"
+#include "FastMath.h"
+
+#include <cmath>
+
+bool ControlCoalescer::absorb(const EngineEvent &e) {
+    int slot;
+    switch (e.type) {
+        case EngineEvent::kPitchBend:
+            slot = kSlotBend;
+            break;
+        case EngineEvent::kChannelPressure:
+            slot = kSlotPressure;
+            break;
+        case EngineEvent::kControlChange:
+            if (!isContinuousCc(e.data1)) return false;
+            slot = kSlotCcBase + (e.data1 & 0x7F);
+            break;
+        default:
+            return false;
+    }
+
+    const int index = (e.channel & 0x0F) * kSlotsPerChannel + slot;
+    ++absorbed_;
+    if (isDirty_[index]) {
+        ++merged_;
+    } else {
+        isDirty_[index] = 1;
+        dirty_[dirtyCount_++] = static_cast<uint16_t>(index);
+    }
+    value_[index] = e.value;
+    flags_[index] = e.flags;
+    return true;
+}
+
+void ParamSmoother::configure(Ramp ramp, float timeMs, float initial) {
+    ramp_ = ramp;
+    timeMs_ = timeMs;
+    reset(initial);
+}
+
+void ParamSmoother::reset(float value) {
+    current_ = target_ = value;
+    step_ = 0.0f;
+    remaining_ = 0;
+    moving_ = false;
+}
+
+void ParamSmoother::setTarget(float target, int rampFrames, double sampleRate) {
+    target_ = target;
+    if (target_ == current_) {
+        moving_ = false;
+        return;
+    }
+    moving_ = true;
+    if (ramp_ == kLinear) {
+        remaining_ = rampFrames > 0 ? rampFrames : 1;
+        step_ = (target_ - current_) / static_cast<float>(remaining_);
+    } else {
+        const double tauFrames = static_cast<double>(timeMs_) * 0.001 * sampleRate;
+        invTauFrames_ = tauFrames > 1.0 ? static_cast<float>(1.0 / tauFrames) : 1.0f;
+    }
+}
+
+float ParamSmoother::advance(int frames) {
+    if (!moving_) return current_;
+    if (ramp_ == kLinear) {
+        if (frames >= remaining_) {
+            current_ = target_;
+            remaining_ = 0;
+            moving_ = false;
+        } else {
+            current_ += step_ * static_cast<float>(frames);
+            remaining_ -= frames;
+        }
+        return current_;
+    }
+
+    const float decay = fastmath::exp(-static_cast<float>(frames) * invTauFrames_);
+    current_ = target_ + (current_ - target_) * decay;
+    if (std::fabs(current_ - target_) < 0.01f) {
+        current_ = target_;
+        moving_ = false;
+    }
+    return current_;
+}
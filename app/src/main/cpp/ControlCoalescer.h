@@ -0,0 +1,104 @@
+#pragma once
+
+#include "EventQueue.h"
+
+#include <cstdint>
+
+// Per-block coalescing of continuous controller events.
+//
+// Within one audio block only the last pitch bend, channel pressure or continuous CC per
+// channel matters, so absorb() keeps the latest value in a per-(channel, parameter) slot
+// and reports everything else (notes and order-sensitive CCs) as "apply in order".
+// flush() then hands each dirty slot to the caller exactly once.
+class ControlCoalescer {
+public:
+    static constexpr int kChannels = 16;
+    static constexpr int kSlotBend = 0;
+    static constexpr int kSlotPressure = 1;
+    static constexpr int kSlotCcBase = 2;                 // slot = kSlotCcBase + cc number
+    static constexpr int kSlotsPerChannel = kSlotCcBase + 128;
+
+    // True for controllers whose meaning does not depend on ordering with other events:
+    // data entry / RPN / NRPN, switches (64-69) and channel mode messages must stay in order.
+    static constexpr bool isContinuousCc(int cc) {
+        return cc != 6 && cc != 38 && !(cc >= 64 && cc <= 69) && !(cc >= 96 && cc <= 101) && cc < 120;
+    }
+
+    // Returns true if the event was taken (its value will come out of flush()).
+    bool absorb(const EngineEvent &e);
+
+    // Calls fn(channel, slot, value, flags) for each slot touched since the last flush; flags
+    // are the EngineEvent flags of the value (kFlagHighRes: MIDI 2.0 scale).
+    template <typename Fn>
+    void flush(Fn &&fn) {
+        for (int i = 0; i < dirtyCount_; ++i) {
+            const int index = dirty_[i];
+            isDirty_[index] = 0;
+            fn(index / kSlotsPerChannel, index % kSlotsPerChannel, value_[index], flags_[index]);
+        }
+        dirtyCount_ = 0;
+    }
+
+    // Like flush(), for one channel's slots only; the others stay pending. Used before an
+    // in-order event so it sees the controls that were sent ahead of it on its channel.
+    template <typename Fn>
+    void flushChannel(int channel, Fn &&fn) {
+        int kept = 0;
+        for (int i = 0; i < dirtyCount_; ++i) {
+            const int index = dirty_[i];
+            if (index / kSlotsPerChannel != (channel & 0x0F)) {
+                dirty_[kept++] = static_cast<uint16_t>(index);
+                continue;
+            }
+            isDirty_[index] = 0;
+            fn(index / kSlotsPerChannel, index % kSlotsPerChannel, value_[index], flags_[index]);
+        }
+        dirtyCount_ = kept;
+    }
+
+    // Events absorbed, and how many of those were overwritten before being applied.
+    uint64_t absorbedCount() const { return absorbed_; }
+    uint64_t mergedCount() const { return merged_; }
+
+private:
+    static constexpr int kTotalSlots = kChannels * kSlotsPerChannel;
+
+    uint32_t value_[kTotalSlots] = {};
+    uint8_t flags_[kTotalSlots] = {};
+    uint8_t isDirty_[kTotalSlots] = {};
+    uint16_t dirty_[kTotalSlots] = {};
+    int dirtyCount_ = 0;
+    uint64_t absorbed_ = 0;
+    uint64_t merged_ = 0;
+};
+
+// Block-rate smoothing of one control value toward its latest (coalesced) target, in the
+// value's own units (e.g. 14-bit bend steps). Linear ramps arrive exactly at the target after
+// the ramp length; exponential ramps are a one-pole glide with a fixed time constant.
+class ParamSmoother {
+public:
+    enum Ramp : uint8_t { kLinear = 0, kExponential };
+
+    void configure(Ramp ramp, float timeMs, float initial);
+    void reset(float value);
+
+    // Start moving toward target; linear ramps take rampFrames frames.
+    void setTarget(float target, int rampFrames, double sampleRate);
+
+    // Advances by frames and returns the value at the end of that span.
+    float advance(int frames);
+
+    bool moving() const { return moving_; }
+    float current() const { return current_; }
+    float target() const { return target_; }
+
+private:
+    Ramp ramp_ = kLinear;
+    float timeMs_ = 5.0f;
+    float current_ = 0.0f;
+    float target_ = 0.0f;
+    float step_ = 0.0f;          // linear: per frame
+    float invTauFrames_ = 0.0f;  // exponential: 1 / (time constant in frames)
+    int remaining_ = 0;
+    bool moving_ = false;
+};
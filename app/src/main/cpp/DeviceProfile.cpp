@@ -0,0 +1,181 @@
+#include "DeviceProfile.h"
+#include "BuiltinTables.h"
+#include "DspKernels.h"
+#include "UnisonVoice.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+    // Tier thresholds in voiceCapacity(): the high tier keeps 4th-order interpolation and
+    // 128 voices inside half a callback with room to spare.
+    constexpr double kHighCapacity = 192.0;
+    constexpr double kMidCapacity = 64.0;
+    // Deeper than this, scheduling jitter is already costing latency: one tier down.
+    constexpr int kJitteryBursts = 2;
+
+    constexpr int kBenchBlock = 192;
+    constexpr int kBenchBlocks = 32;
+    constexpr int kBenchTrials = 3;
+
+    // Best-of-trials ns per frame of render(frames) (after one warm-up call).
+    template <typename Fn>
+    double bestNsPerFrame(Fn render) {
+        using clock = std::chrono::steady_clock;
+        render();
+        double best = 1e30;
+        for (int t = 0; t < kBenchTrials; ++t) {
+            const auto t0 = clock::now();
+            for (int b = 0; b < kBenchBlocks; ++b) render();
+            const double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+            best = std::min(best, ns / (kBenchBlocks * kBenchBlock));
+        }
+        return best;
+    }
+
+    bool parseInt(const char *text, int lo, int hi, int &out) {
+        char *end = nullptr;
+        const long v = std::strtol(text, &end, 10);
+        if (end == text || v < lo || v > hi) return false;
+        out = static_cast<int>(v);
+        return true;
+    }
+
+    bool parseDouble(const char *text, double lo, double hi, double &out) {
+        char *end = nullptr;
+        const double v = std::strtod(text, &end);
+        if (end == text || !std::isfinite(v) || v < lo || v > hi) return false;
+        out = v;
+        return true;
+    }
+
+} // namespace
+
+double DeviceProfile::voiceCapacity(const Measurements &m) {
+    if (m.voiceNsPerFrame <= 0.0 || m.sampleRate <= 0.0) return 0.0;
+    return 0.5 * (1e9 / m.sampleRate) / m.voiceNsPerFrame;
+}
+
+DeviceProfile DeviceProfile::choose(const Measurements &m) {
+    DeviceProfile p;
+    p.measured = m;
+    const double capacity = voiceCapacity(m);
+    int tier = capacity >= kHighCapacity ? kTierHigh : capacity >= kMidCapacity ? kTierMid : kTierLow;
+    if (m.bufferBursts > kJitteryBursts && tier > kTierLow) --tier;
+    p.tier = static_cast<Tier>(tier);
+    p.bufferBursts = std::clamp(m.bufferBursts, 1, 16);
+
+    switch (p.tier) {
+        case kTierHigh:
+            p.polyphony = 128;
+            p.interpolation = 4;
+            p.effects = true;
+            p.lowPowerRender = false;
+            p.unisonCopies = 7;
+            break;
+        case kTierMid:
+            p.polyphony = 64;
+            p.interpolation = 1;
+            p.effects = true;
+            p.lowPowerRender = false;
+            p.unisonCopies = 5;
+            break;
+        case kTierLow:
+            p.polyphony = 32;
+            p.interpolation = 1;
+            p.effects = false;
+            p.lowPowerRender = true;
+            p.unisonCopies = 3;
+            break;
+    }
+    return p;
+}
+
+void DeviceProfile::measureKernels(Measurements &m) {
+    static const auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+    const double rate = m.sampleRate > 0.0 ? m.sampleRate : 48000.0;
+    const float inc = builtin::noteIncrement(57, rate);
+    float out[2 * kBenchBlock];
+
+    UnisonVoice::Params params;
+    params.sustain = 1.0f;
+    UnisonVoice voice;
+    params.copies = 1;
+    voice.noteOn(params, 57, 1.0f, 1);
+    m.voiceNsPerFrame = bestNsPerFrame([&] {
+        voice.render(*saw, inc, 8000.0f, 1.0f, rate, out, kBenchBlock);
+    });
+
+    UnisonVoice stack;
+    params.copies = 7;
+    stack.noteOn(params, 57, 1.0f, 1);
+    m.unisonNsPerFrame = bestNsPerFrame([&] {
+        stack.render(*saw, inc, 8000.0f, 1.0f, rate, out, kBenchBlock);
+    });
+    m.isa = static_cast<int>(dsp::kernels().isa);
+}
+
+bool DeviceProfile::save(const std::string &path) const {
+    std::FILE *f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "version=%d\n", kVersion);
+    std::fprintf(f, "sampleRate=%.1f\nframesPerBurst=%d\nmeasuredBufferBursts=%d\n", measured.sampleRate,
+                 measured.framesPerBurst, measured.bufferBursts);
+    std::fprintf(f, "voiceNsPerFrame=%.3f\nunisonNsPerFrame=%.3f\nisa=%d\n", measured.voiceNsPerFrame,
+                 measured.unisonNsPerFrame, measured.isa);
+    std::fprintf(f, "tier=%d\npolyphony=%d\ninterpolation=%d\neffects=%d\nlowPowerRender=%d\nunisonCopies=%d\nbufferBursts=%d\n",
+                 static_cast<int>(tier), polyphony, interpolation, effects ? 1 : 0, lowPowerRender ? 1 : 0,
+                 unisonCopies, bufferBursts);
+    return std::fclose(f) == 0;
+}
+
+bool DeviceProfile::load(const std::string &path, DeviceProfile &out) {
+    std::FILE *f = std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    DeviceProfile p;
+    int version = -1, tierValue = -1, effectsValue = -1, lowPowerValue = -1;
+    bool ok = true;
+    char line[128];
+    while (ok && std::fgets(line, sizeof(line), f)) {
+        char *eq = std::strchr(line, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        const char *key = line;
+        const char *value = eq + 1;
+        if (!std::strcmp(key, "version")) ok = parseInt(value, 0, 1 << 30, version);
+        else if (!std::strcmp(key, "sampleRate")) ok = parseDouble(value, 8000.0, 384000.0, p.measured.sampleRate);
+        else if (!std::strcmp(key, "framesPerBurst")) ok = parseInt(value, 1, 1 << 16, p.measured.framesPerBurst);
+        else if (!std::strcmp(key, "measuredBufferBursts")) ok = parseInt(value, 1, 64, p.measured.bufferBursts);
+        else if (!std::strcmp(key, "voiceNsPerFrame")) ok = parseDouble(value, 0.0, 1e9, p.measured.voiceNsPerFrame);
+        else if (!std::strcmp(key, "unisonNsPerFrame")) ok = parseDouble(value, 0.0, 1e9, p.measured.unisonNsPerFrame);
+        else if (!std::strcmp(key, "isa")) ok = parseInt(value, 0, 31, p.measured.isa);
+        else if (!std::strcmp(key, "tier")) ok = parseInt(value, kTierLow, kTierHigh, tierValue);
+        else if (!std::strcmp(key, "polyphony")) ok = parseInt(value, 1, 1024, p.polyphony);
+        else if (!std::strcmp(key, "interpolation")) ok = parseInt(value, 0, 7, p.interpolation);
+        else if (!std::strcmp(key, "effects")) ok = parseInt(value, 0, 1, effectsValue);
+        else if (!std::strcmp(key, "lowPowerRender")) ok = parseInt(value, 0, 1, lowPowerValue);
+        else if (!std::strcmp(key, "unisonCopies")) ok = parseInt(value, 1, UnisonVoice::kMaxCopies, p.unisonCopies);
+        else if (!std::strcmp(key, "bufferBursts")) ok = parseInt(value, 0, 16, p.bufferBursts);
+    }
+    std::fclose(f);
+    if (!ok || version != kVersion || tierValue < 0 || effectsValue < 0 || lowPowerValue < 0) return false;
+    p.tier = static_cast<Tier>(tierValue);
+    p.effects = effectsValue != 0;
+    p.lowPowerRender = lowPowerValue != 0;
+    out = p;
+    return true;
+}
+
+const char *DeviceProfile::tierName(Tier tier) {
+    switch (tier) {
+        case kTierLow: return "low";
+        case kTierMid: return "mid";
+        case kTierHigh: return "high";
+    }
+    return "unknown";
+}
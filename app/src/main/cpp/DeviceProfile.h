@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Per-device engine settings chosen from a one-off self-benchmark instead of hand-tuned
+// guesses per device family.
+//
+// OboeSynthesizer.probeDevice() runs once (first launch, background thread): it times the
+// render kernels on this CPU, opens a probe stream for the native rate and burst size, finds
+// the shallowest buffer (in bursts) that runs without underruns, then choose()s a tier and
+// saves the profile. Later launches only load() it; a profile written by a different
+// kVersion is rejected so the probe runs again.
+struct DeviceProfile {
+    static constexpr int kVersion = 1;
+
+    enum Tier : int {
+        kTierLow = 0,
+        kTierMid,
+        kTierHigh,
+    };
+
+    struct Measurements {
+        double sampleRate = 48000.0;
+        int framesPerBurst = 192;
+        int bufferBursts = 2;            // shallowest depth that ran without underruns
+        double voiceNsPerFrame = 0.0;    // one enveloped, filtered wavetable voice
+        double unisonNsPerFrame = 0.0;   // one 7-copy unison stack
+        int isa = 0;                     // dsp::Isa the kernels ran with
+    };
+
+    Measurements measured;
+
+    // Chosen from measured. The defaults are the hand-tuned mid tier used without a profile.
+    Tier tier = kTierMid;
+    int polyphony = 64;                  // FluidSynth synth.polyphony
+    int interpolation = 1;               // FluidSynth synth.interpolation: 1 linear, 4 4th order
+    bool effects = true;                 // FluidSynth reverb and chorus
+    bool lowPowerRender = false;         // OboeSynthesizer.setLowPowerRender
+    int unisonCopies = 7;                // default wavetable unison
+    int bufferBursts = 0;                // stream buffer depth, 0 = leave Oboe's default
+
+    // Synth voices that fit in half of each callback at the measured cost.
+    static double voiceCapacity(const Measurements &m);
+    static DeviceProfile choose(const Measurements &m);
+
+    // Times one wavetable voice and one 7-copy unison stack with the bound DSP kernels
+    // (best of a few short runs, ~20 ms in total) and fills those fields of m.
+    static void measureKernels(Measurements &m);
+
+    // key=value text. load() fails on a missing file, another kVersion or bad values.
+    bool save(const std::string &path) const;
+    static bool load(const std::string &path, DeviceProfile &out);
+
+    static const char *tierName(Tier tier);
+};
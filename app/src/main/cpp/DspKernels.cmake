@@ -0,0 +1,28 @@
+# Runtime-dispatched DSP kernels (DspKernels.h): one translation unit per ISA variant, each
+# with its own flags. Included by the app build and by the host test build; sets
+# DSP_KERNEL_SOURCES for the including directory.
+set(DSP_KERNEL_SOURCES
+    "${CMAKE_CURRENT_LIST_DIR}/DspKernels.cpp"
+    "${CMAKE_CURRENT_LIST_DIR}/DspKernelsBaseline.cpp"
+)
+
+if (CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|i[3-6]86|x86")
+    list(APPEND DSP_KERNEL_SOURCES
+        "${CMAKE_CURRENT_LIST_DIR}/DspKernelsSse41.cpp"
+        "${CMAKE_CURRENT_LIST_DIR}/DspKernelsAvx2.cpp"
+        "${CMAKE_CURRENT_LIST_DIR}/DspKernelsAvx512.cpp"
+    )
+    set_source_files_properties("${CMAKE_CURRENT_LIST_DIR}/DspKernelsSse41.cpp"
+        PROPERTIES COMPILE_OPTIONS "-msse4.1")
+    set_source_files_properties("${CMAKE_CURRENT_LIST_DIR}/DspKernelsAvx2.cpp"
+        PROPERTIES COMPILE_OPTIONS "-mavx2;-mfma")
+    set_source_files_properties("${CMAKE_CURRENT_LIST_DIR}/DspKernelsAvx512.cpp"
+        PROPERTIES COMPILE_OPTIONS "-mavx512f;-mavx2;-mfma")
+    # GCC's AVX-512 intrinsics start from _mm512_undefined_*(), which its own
+    # -Wmaybe-uninitialized then flags at every inlined call.
+    if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        set(DSP_AVX512_WARNING_FLAGS "-Wno-maybe-uninitialized")
+        set_property(SOURCE "${CMAKE_CURRENT_LIST_DIR}/DspKernelsAvx512.cpp" APPEND PROPERTY
+            COMPILE_OPTIONS ${DSP_AVX512_WARNING_FLAGS})
+    endif()
+endif()
@@ -0,0 +1,95 @@
+#include "DspKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define DSP_KERNELS_X86 1
+#endif
+
+namespace dsp {
+    namespace detail {
+
+        extern const Kernels kBaselineKernels;
+#if defined(DSP_KERNELS_X86)
+        extern const Kernels kSse41Kernels;
+        extern const Kernels kAvx2Kernels;
+        extern const Kernels kAvx512Kernels;
+#endif
+
+        std::atomic<const Kernels *> active{&kBaselineKernels};
+
+    } // namespace detail
+
+    namespace {
+
+        constexpr uint32_t bit(Isa isa) { return 1u << static_cast<unsigned>(isa); }
+
+        const Kernels *const kVariants[] = {
+                &detail::kBaselineKernels,
+#if defined(DSP_KERNELS_X86)
+                &detail::kSse41Kernels,
+                &detail::kAvx2Kernels,
+                &detail::kAvx512Kernels,
+#endif
+        };
+
+        // What the CPU (and OS, for the AVX register state) supports; probed once.
+        uint32_t cpuIsas() {
+            static const uint32_t mask = [] {
+                uint32_t m = bit(detail::kBaselineKernels.isa);
+#if defined(DSP_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+                __builtin_cpu_init();
+                const bool fma = __builtin_cpu_supports("fma");
+                if (__builtin_cpu_supports("sse4.1")) m |= bit(Isa::kSse41);
+                if (__builtin_cpu_supports("avx2") && fma) m |= bit(Isa::kAvx2);
+                if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && fma) m |= bit(Isa::kAvx512);
+#endif
+                return m;
+            }();
+            return mask;
+        }
+
+    } // namespace
+
+    const char *isaName(Isa isa) {
+        switch (isa) {
+            case Isa::kScalar: return "scalar";
+            case Isa::kNeon: return "neon";
+            case Isa::kSse2: return "sse2";
+            case Isa::kSse41: return "sse4.1";
+            case Isa::kAvx2: return "avx2";
+            case Isa::kAvx512: return "avx512";
+            case Isa::kCount: break;
+        }
+        return "?";
+    }
+
+    uint32_t availableIsas() {
+        uint32_t m = 0;
+        for (const Kernels *k : kVariants) m |= bit(k->isa);
+        return m & cpuIsas();
+    }
+
+    const Kernels *variant(Isa isa) {
+        if ((availableIsas() & bit(isa)) == 0) return nullptr;
+        for (const Kernels *k : kVariants) {
+            if (k->isa == isa) return k;
+        }
+        return nullptr;
+    }
+
+    bool bind(Isa isa) {
+        const Kernels *k = variant(isa);
+        if (!k) return false;
+        detail::active.store(k, std::memory_order_relaxed);
+        return true;
+    }
+
+    Isa bindBest() {
+        const Kernels *best = &detail::kBaselineKernels;
+        for (const Kernels *k : kVariants) {
+            if ((availableIsas() & bit(k->isa)) && k->isa > best->isa) best = k;
+        }
+        detail::active.store(best, std::memory_order_relaxed);
+        return best->isa;
+    }
+
+} // namespace dsp
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Runtime-dispatched DSP inner loops.
+//
+// The hot kernels (wavetable unison oscillators, granular grains, the half-band FIR, bus
+// mixing, PCM conversion and input peak detection) are written once in DspKernelsImpl.h and compiled once per
+// instruction set: the baseline the library is built for (NEON on ARM, SSE2 on x86), plus
+// SSE4.1, AVX2+FMA and AVX-512F variants on x86 (DspKernels.cmake sets the flags). bindBest()
+// probes the CPU once, at engine creation, and points kernels() at the widest variant the
+// CPU supports; until then the baseline variant is active. Callers always go through
+// kernels(), one relaxed pointer load, so they never need ISA #ifs of their own.
+namespace dsp {
+
+    enum class Isa : uint8_t {
+        kScalar = 0,
+        kNeon,
+        kSse2,
+        kSse41,
+        kAvx2,
+        kAvx512,
+        kCount
+    };
+
+    // Widest lane count of any variant; per-copy arrays handed to unisonOsc must be at
+    // least this long (zero-filled past the used copies).
+    constexpr int kMaxLaneWidth = 16;
+
+    struct UnisonArgs {
+        const float *table;     // one mip level, tableMask + 1 entries
+        int tableMask;
+        float *phase;           // per copy, cycles in [0, 1); advanced in place
+        const float *inc;       // per copy, cycles per sample
+        const float *gainL;
+        const float *gainR;
+        int copies;
+        float *outL;            // frames sums of all copies (overwritten)
+        float *outR;
+        int frames;
+    };
+
+    struct GrainArgs {
+        const float *source;
+        int32_t mask;           // source length - 1 for loops, all ones otherwise
+        int32_t base;           // source frame of the grain's first sample
+        float inc;              // source frames per output frame
+        const float *window;
+        float winInc;           // window entries per output frame
+        float gainL;
+        float gainR;
+        int age;                // output frames already rendered
+        float *left;            // added to
+        float *right;
+        int frames;
+    };
+
+    struct Kernels {
+        Isa isa;
+        int laneWidth;
+
+        void (*unisonOsc)(const UnisonArgs &args);
+        void (*grain)(const GrainArgs &args);
+        // out[j] = sum_i taps[i] * x[j + i], j < frames.
+        void (*fir)(const float *taps, int numTaps, const float *x, float *out, int frames);
+        // out[i] = in[i] * gain / out[i] += in[i] * gain, i < count.
+        void (*mixScale)(float *out, const float *in, float gain, int count);
+        void (*mixAdd)(float *out, const float *in, float gain, int count);
+        // out[2i] += left[i], out[2i + 1] += right[i].
+        void (*interleaveAdd)(float *out, const float *left, const float *right, int frames);
+        // Little-endian int16 (any alignment) to float times scale.
+        void (*int16ToFloat)(const void *src, float *out, size_t count, float scale);
+        // max |in[i]|, i < count (0 for count 0).
+        float (*peakAbs)(const float *in, int count);
+    };
+
+    const char *isaName(Isa isa);
+
+    // Bit (1 << Isa) for every variant that is compiled in and runs on this CPU.
+    uint32_t availableIsas();
+    // The variant for isa, or nullptr if it is not available.
+    const Kernels *variant(Isa isa);
+
+    // Binds kernels() to isa; false (nothing changes) if it is not available.
+    bool bind(Isa isa);
+    // Binds the widest available variant and returns it.
+    Isa bindBest();
+
+    namespace detail {
+        extern std::atomic<const Kernels *> active;
+    }
+
+    inline const Kernels &kernels() { return *detail::active.load(std::memory_order_relaxed); }
+
+} // namespace dsp
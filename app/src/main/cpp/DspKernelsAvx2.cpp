@@ -0,0 +1,8 @@
+// AVX2 + FMA DSP kernels (x86 only, compiled with -mavx2 -mfma; see DspKernels.cmake).
+#if !defined(__AVX2__) || !defined(__FMA__)
+#error "DspKernelsAvx2.cpp must be compiled with -mavx2 -mfma"
+#endif
+#define DSP_VARIANT_NAMESPACE dsp_avx2
+#define DSP_VARIANT_TABLE kAvx2Kernels
+#define DSP_VARIANT_ISA dsp::Isa::kAvx2
+#include "DspKernelsImpl.h"
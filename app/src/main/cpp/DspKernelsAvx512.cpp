@@ -0,0 +1,8 @@
+// AVX-512F DSP kernels (x86 only, compiled with -mavx512f -mavx2 -mfma; see DspKernels.cmake).
+#if !defined(__AVX512F__) || !defined(__AVX2__) || !defined(__FMA__)
+#error "DspKernelsAvx512.cpp must be compiled with -mavx512f -mavx2 -mfma"
+#endif
+#define DSP_VARIANT_NAMESPACE dsp_avx512
+#define DSP_VARIANT_TABLE kAvx512Kernels
+#define DSP_VARIANT_ISA dsp::Isa::kAvx512
+#include "DspKernelsImpl.h"
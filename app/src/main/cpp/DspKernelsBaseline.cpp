@@ -0,0 +1,11 @@
+// DSP kernels for the ISA the whole library is built for: NEON on ARM, SSE2 on x86.
+#define DSP_VARIANT_NAMESPACE dsp_baseline
+#define DSP_VARIANT_TABLE kBaselineKernels
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DSP_VARIANT_ISA dsp::Isa::kNeon
+#elif defined(__SSE2__) || defined(_M_X64)
+#define DSP_VARIANT_ISA dsp::Isa::kSse2
+#else
+#define DSP_VARIANT_ISA dsp::Isa::kScalar
+#endif
+#include "DspKernelsImpl.h"
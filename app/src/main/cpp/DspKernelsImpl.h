@@ -0,0 +1,242 @@
+// Body of one DSP kernel variant (see DspKernels.h). Not an ordinary header: each
+// DspKernels<Isa>.cpp defines DSP_VARIANT_NAMESPACE, DSP_VARIANT_TABLE and DSP_VARIANT_ISA,
+// includes this once and is compiled with that ISA's flags.
+//
+// Everything here must stay private to the variant. An inline function shared with other
+// translation units (FastMath, but also std::min and friends) would be emitted with this
+// variant's instructions and the linker may keep that copy for the baseline callers too,
+// so FastMath is wrapped in the variant's namespace and the kernels use plain loops.
+
+#include "DspKernels.h"
+
+#include <cstring>
+
+#define FASTMATH_OUTER_NAMESPACE DSP_VARIANT_NAMESPACE
+#include "FastMath.h"
+
+namespace DSP_VARIANT_NAMESPACE {
+    namespace {
+
+        using namespace fastmath;
+        using namespace fastmath::lane;
+
+#if defined(FASTMATH_HAS_F32X16)
+        using Wide = F32x16;
+#elif defined(FASTMATH_HAS_F32X8)
+        using Wide = F32x8;
+#elif defined(FASTMATH_HAS_F32X4)
+        using Wide = F32x4;
+#else
+        using Wide = float;
+#endif
+
+        alignas(64) constexpr float kIota[16] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                                 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f};
+
+        // ---- render: unison oscillators -------------------------------------------------
+        // Copies run W at a time; only the two table reads per copy are scalar.
+        template <typename V>
+        void unisonLanes(const dsp::UnisonArgs &a) {
+            constexpr int W = width<V>();
+            const int padded = (a.copies + W - 1) / W * W;
+            const V tableSize(static_cast<float>(a.tableMask + 1));
+            alignas(64) float index[W];
+            alignas(64) float lo[W];
+            alignas(64) float hi[W];
+
+            for (int f = 0; f < a.frames; ++f) {
+                V accL(0.0f), accR(0.0f);
+                for (int c = 0; c < padded; c += W) {
+                    V ph = load<V>(a.phase + c) + load<V>(a.inc + c);
+                    ph = ph - floorv(ph);
+                    store(ph, a.phase + c);
+                    const V x = ph * tableSize;
+                    const V xi = floorv(x);
+                    const V frac = x - xi;
+                    store(xi, index);
+                    for (int l = 0; l < W; ++l) {
+                        const int i = static_cast<int>(index[l]);
+                        lo[l] = a.table[i & a.tableMask];
+                        hi[l] = a.table[(i + 1) & a.tableMask];
+                    }
+                    const V s0 = load<V>(lo);
+                    const V s = fmadd(load<V>(hi) - s0, frac, s0);
+                    accL = fmadd(s, load<V>(a.gainL + c), accL);
+                    accR = fmadd(s, load<V>(a.gainR + c), accR);
+                }
+                a.outL[f] = hsum(accL);
+                a.outR[f] = hsum(accR);
+            }
+        }
+
+        // The narrowest lanes that cover the copies: wider ones would only add padding
+        // copies, each costing two scalar table reads.
+        void unisonOsc(const dsp::UnisonArgs &a) {
+#if defined(FASTMATH_HAS_F32X16)
+            if (a.copies > 8) return unisonLanes<F32x16>(a);
+#endif
+#if defined(FASTMATH_HAS_F32X8)
+            if (a.copies > 4) return unisonLanes<F32x8>(a);
+#endif
+#if defined(FASTMATH_HAS_F32X4)
+            unisonLanes<F32x4>(a);
+#else
+            unisonLanes<float>(a);
+#endif
+        }
+
+        // ---- render: granular grain ------------------------------------------------------
+        // Frames [first, first + count) of one grain, W at a time; count is a multiple of W.
+        template <typename V>
+        void grainLanes(const dsp::GrainArgs &g, int first, int count) {
+            constexpr int W = width<V>();
+            const V inc(g.inc);
+            const V winInc(g.winInc);
+            const V gl(g.gainL);
+            const V gr(g.gainR);
+            float *left = g.left + first;
+            float *right = g.right + first;
+            alignas(64) float index[W];
+            alignas(64) float winPos[W];
+            alignas(64) float lo[W];
+            alignas(64) float hi[W];
+            alignas(64) float w[W];
+
+            V t = V(static_cast<float>(g.age + first)) + load<V>(kIota);
+            for (int f = 0; f < count; f += W) {
+                const V x = t * inc;
+                const V xi = floorv(x);
+                const V frac = x - xi;
+                store(xi, index);
+                store(t * winInc, winPos);
+                for (int l = 0; l < W; ++l) {
+                    const int32_t i = g.base + static_cast<int32_t>(index[l]);
+                    lo[l] = g.source[i & g.mask];
+                    hi[l] = g.source[(i + 1) & g.mask];
+                    w[l] = g.window[static_cast<int>(winPos[l])];
+                }
+                const V a = load<V>(lo);
+                const V s = fmadd(load<V>(hi) - a, frac, a) * load<V>(w);
+                store(fmadd(s, gl, load<V>(left + f)), left + f);
+                store(fmadd(s, gr, load<V>(right + f)), right + f);
+                t = t + V(static_cast<float>(W));
+            }
+        }
+
+        void grain(const dsp::GrainArgs &g) {
+            const int vec = g.frames - g.frames % width<Wide>();
+            grainLanes<Wide>(g, 0, vec);
+            grainLanes<float>(g, vec, g.frames - vec);
+        }
+
+        // ---- filter: FIR over consecutive outputs ----------------------------------------
+        template <typename V>
+        int firLanes(const float *taps, int numTaps, const float *x, float *out, int j, int frames) {
+            constexpr int W = width<V>();
+            for (; j + W <= frames; j += W) {
+                V acc(0.0f);
+                for (int i = 0; i < numTaps; ++i) acc = fmadd(V(taps[i]), load<V>(x + j + i), acc);
+                store(acc, out + j);
+            }
+            return j;
+        }
+
+        void fir(const float *taps, int numTaps, const float *x, float *out, int frames) {
+            int j = 0;
+#if defined(FASTMATH_HAS_F32X16)
+            j = firLanes<F32x16>(taps, numTaps, x, out, j, frames);
+#endif
+#if defined(FASTMATH_HAS_F32X8)
+            j = firLanes<F32x8>(taps, numTaps, x, out, j, frames);
+#endif
+#if defined(FASTMATH_HAS_F32X4)
+            j = firLanes<F32x4>(taps, numTaps, x, out, j, frames);
+#endif
+            firLanes<float>(taps, numTaps, x, out, j, frames);
+        }
+
+        // ---- mix ------------------------------------------------------------------------
+        template <bool Accumulate, typename V>
+        int mixLanes(float *out, const float *in, float gain, int i, int count) {
+            constexpr int W = width<V>();
+            const V g(gain);
+            for (; i + W <= count; i += W) {
+                const V v = load<V>(in + i) * g;
+                store(Accumulate ? v + load<V>(out + i) : v, out + i);
+            }
+            return i;
+        }
+
+        template <bool Accumulate>
+        void mix(float *out, const float *in, float gain, int count) {
+            int i = mixLanes<Accumulate, Wide>(out, in, gain, 0, count);
+#if defined(FASTMATH_HAS_F32X4)
+            i = mixLanes<Accumulate, F32x4>(out, in, gain, i, count);
+#endif
+            mixLanes<Accumulate, float>(out, in, gain, i, count);
+        }
+
+        void mixScale(float *out, const float *in, float gain, int count) { mix<false>(out, in, gain, count); }
+        void mixAdd(float *out, const float *in, float gain, int count) { mix<true>(out, in, gain, count); }
+
+        // ---- convert --------------------------------------------------------------------
+        // Plain loops: the compiler vectorises them for the variant's ISA.
+        void interleaveAdd(float *out, const float *left, const float *right, int frames) {
+            for (int i = 0; i < frames; ++i) {
+                out[2 * i] += left[i];
+                out[2 * i + 1] += right[i];
+            }
+        }
+
+        void int16ToFloat(const void *src, float *out, size_t count, float scale) {
+            const auto *s = static_cast<const unsigned char *>(src);
+            for (size_t i = 0; i < count; ++i) {
+                int16_t v;
+                std::memcpy(&v, s + 2 * i, sizeof(v));
+                out[i] = static_cast<float>(v) * scale;
+            }
+        }
+
+        // ---- measure --------------------------------------------------------------------
+        template <typename V>
+        int peakLanes(const float *in, int i, int count, float &peak) {
+            constexpr int W = width<V>();
+            if (i + W > count) return i;
+            V acc(0.0f);
+            for (; i + W <= count; i += W) acc = maxv(acc, absv(load<V>(in + i)));
+            alignas(64) float lanes[W];
+            store(acc, lanes);
+            for (int l = 0; l < W; ++l) peak = lanes[l] > peak ? lanes[l] : peak;
+            return i;
+        }
+
+        float peakAbs(const float *in, int count) {
+            float peak = 0.0f;
+            int i = peakLanes<Wide>(in, 0, count, peak);
+#if defined(FASTMATH_HAS_F32X4)
+            i = peakLanes<F32x4>(in, i, count, peak);
+#endif
+            peakLanes<float>(in, i, count, peak);
+            return peak;
+        }
+
+    } // namespace
+} // namespace DSP_VARIANT_NAMESPACE
+
+namespace dsp {
+    namespace detail {
+        extern const Kernels DSP_VARIANT_TABLE;
+        const Kernels DSP_VARIANT_TABLE = {
+                DSP_VARIANT_ISA,
+                DSP_VARIANT_NAMESPACE::fastmath::lane::width<DSP_VARIANT_NAMESPACE::Wide>(),
+                &DSP_VARIANT_NAMESPACE::unisonOsc,
+                &DSP_VARIANT_NAMESPACE::grain,
+                &DSP_VARIANT_NAMESPACE::fir,
+                &DSP_VARIANT_NAMESPACE::mixScale,
+                &DSP_VARIANT_NAMESPACE::mixAdd,
+                &DSP_VARIANT_NAMESPACE::interleaveAdd,
+                &DSP_VARIANT_NAMESPACE::int16ToFloat,
+                &DSP_VARIANT_NAMESPACE::peakAbs,
+        };
+    } // namespace detail
+} // namespace dsp
@@ -0,0 +1,8 @@
+// SSE4.1 DSP kernels (x86 only, compiled with -msse4.1; see DspKernels.cmake).
+#if !defined(__SSE4_1__)
+#error "DspKernelsSse41.cpp must be compiled with -msse4.1"
+#endif
+#define DSP_VARIANT_NAMESPACE dsp_sse41
+#define DSP_VARIANT_TABLE kSse41Kernels
+#define DSP_VARIANT_ISA dsp::Isa::kSse41
+#include "DspKernelsImpl.h"
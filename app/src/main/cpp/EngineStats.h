@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Engine counters, readable from Kotlin via OboeSynthesizer.getStats().
+// Index values are part of the JNI contract: append new entries, never reorder.
+enum EngineStat : int {
+    kStatEventsReceived = 0,     // events accepted into the event queue
+    kStatEventsDropped,          // events rejected because the queue was full
+    kStatNoteEvents,             // note on/off applied in order
+    kStatControlEvents,          // continuous control events absorbed by the coalescer
+    kStatControlEventsMerged,    // ... of which overwritten within the same block
+    kStatStarts,                 // start() calls (cold start and warm resume)
+    kStatStreamOpens,            // ... of which had to (re)open the Oboe stream
+    kStatStartLatencyUs,         // last start() -> first unmuted callback, microseconds
+    kStatStreamDisconnects,      // onErrorAfterClose (route change, unplug, device loss)
+    kStatStreamReopenAttempts,   // reopen attempts made by the recovery thread
+    kStatStreamRecoveries,       // disconnects recovered without a user action
+    kStatLastRecoveryUs,         // last disconnect -> stream restarted, microseconds
+    kStatUmpPackets,             // Universal MIDI Packets received
+    kStatUmpIgnored,             // ... of which had no engine event (utility, system, ...)
+    kStatLowPowerRender,         // 1 while the callback renders at half rate + upsampling
+    kStatWavetableVoices,        // sounding wavetable (unison) voices, last block
+    kStatGraphNodesRun,          // render-graph node runs in the last block (all sub-blocks)
+    kStatGraphNodesSkipped,      // ... node runs skipped because the node was silent
+    kStatGranularGrains,         // sounding granular grains, last block
+    kStatGranularDropped,        // grain onsets dropped because the grain budget was full
+    kStatDspIsa,                 // dsp::Isa of the DSP kernels bound at creation
+    kStatDspIsasAvailable,       // bit (1 << dsp::Isa) per kernel variant this CPU can run
+    kStatBreathInputFrames,      // microphone frames consumed by the breath follower
+    kStatBreathOnsets,           // breath onsets detected
+    kStatBreathInputErrors,      // failed input reads (the input is dropped until re-enabled)
+    kStatDeviceTier,             // DeviceProfile::Tier in use, -1 without a profile
+    kStatCount
+};
+
+class EngineStats {
+public:
+    EngineStats() {
+        for (auto &v : values_) v.store(0, std::memory_order_relaxed);
+    }
+
+    void add(EngineStat id, int64_t n = 1) { values_[id].fetch_add(n, std::memory_order_relaxed); }
+    void set(EngineStat id, int64_t v) { values_[id].store(v, std::memory_order_relaxed); }
+    int64_t get(EngineStat id) const { return values_[id].load(std::memory_order_relaxed); }
+
+    // Copies up to count values into out; returns how many were written.
+    int snapshot(int64_t *out, int count) const {
+        const int n = count < kStatCount ? count : kStatCount;
+        for (int i = 0; i < n; ++i) out[i] = values_[i].load(std::memory_order_relaxed);
+        return n;
+    }
+
+private:
+    std::atomic<int64_t> values_[kStatCount];
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size event passed from the JNI threads to the audio callback.
+struct EngineEvent {
+    enum Type : uint8_t {
+        kNoteOn = 0,
+        kNoteOff,
+        kPitchBend,        // value: 0..16383, centre 8192
+        kChannelPressure,  // value: 0..127
+        kControlChange,    // data1: CC number, value: 0..127
+    };
+
+    // value is MIDI 2.0 resolution: 16-bit velocity, 32-bit bend (centre 0x80000000),
+    // pressure and CC value. Set by the UMP input path (Ump.h).
+    static constexpr uint8_t kFlagHighRes = 0x01;
+
+    uint8_t type = kNoteOn;
+    uint8_t channel = 0;
+    uint8_t data1 = 0;     // note or CC number
+    uint8_t flags = 0;
+    uint32_t value = 0;    // velocity, bend, pressure or CC value
+
+    // Range-clamped MIDI 1.0 events, as built by the JNI entry points (and the host replay).
+    static EngineEvent make(uint8_t type, int channel, int data1, int value, int maxValue) {
+        EngineEvent e;
+        e.type = type;
+        e.channel = static_cast<uint8_t>(clampTo(channel, 15));
+        e.data1 = static_cast<uint8_t>(clampTo(data1, 127));
+        e.value = static_cast<uint32_t>(clampTo(value, maxValue));
+        return e;
+    }
+    static EngineEvent noteOn(int ch, int note, int velocity) { return make(kNoteOn, ch, note, velocity, 127); }
+    static EngineEvent noteOff(int ch, int note) { return make(kNoteOff, ch, note, 0, 0); }
+    static EngineEvent pitchBend(int ch, int bend14) { return make(kPitchBend, ch, 0, bend14, 16383); }
+    static EngineEvent channelPressure(int ch, int pressure) { return make(kChannelPressure, ch, 0, pressure, 127); }
+    static EngineEvent controlChange(int ch, int cc, int value) { return make(kControlChange, ch, cc, value, 127); }
+
+private:
+    static int clampTo(int v, int hi) { return v < 0 ? 0 : (v > hi ? hi : v); }
+};
+static_assert(sizeof(EngineEvent) == 8, "EngineEvent must stay a single 8-byte packet");
+
+// Bounded lock-free multi-producer / single-consumer queue (Vyukov's sequence-per-cell
+// design). push() never blocks and fails when full; pop() is for the one consumer
+// (the audio callback). Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MpscQueue() {
+        for (size_t i = 0; i < Capacity; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(const T &item) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[pos & (Capacity - 1)];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T &out) {
+        Cell &cell = cells_[head_ & (Capacity - 1)];
+        const size_t seq = cell.seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(head_ + 1) < 0) return false; // empty
+        out = cell.item;
+        cell.seq.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T item;
+    };
+
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;
+    alignas(64) Cell cells_[Capacity];
+};
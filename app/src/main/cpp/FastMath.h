@@ -0,0 +1,515 @@
+#pragma once
+
+// Bounded-error polynomial approximations for block-rate DSP parameter math.
+//
+// Every function is written once as a template over a "lane" type and instantiated for
+// plain float (scalar) and, when the target supports it, a 4-wide vector (NEON or SSE2,
+// with SSE4.1 rounding/blends when available), an 8-wide vector (AVX2) and a 16-wide
+// vector (AVX-512F). The *Block() helpers run the widest compiled variant over an array
+// and finish the tail with the scalar path.
+//
+// Per-ISA builds (DspKernelsImpl.h) define FASTMATH_OUTER_NAMESPACE before including this
+// header, so inline functions compiled with e.g. -mavx2 get their own mangled names and
+// can never be merged by the linker into callers built for the baseline ISA.
+//
+// Error bounds (float32 inputs, verified by app/src/test/cpp/FastMathTest.cpp):
+//   exp2, exp, dbToGain      relative error < 1e-6   (x clamped to [-126, 128))
+//   log2, gainToDb           absolute error < 1e-6 / 1e-5 dB (x <= 0 clamps to FLT_MIN)
+//   tanh                     absolute error < 1e-6
+//   sin, cos                 absolute error < 2e-6   for |x| <= 64*pi
+//
+// Header-only and allocation-free: safe to call from the audio callback.
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FASTMATH_HAS_F32X4 1
+#define FASTMATH_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define FASTMATH_HAS_F32X4 1
+#define FASTMATH_SSE2 1
+#endif
+
+#if defined(__AVX2__)
+#define FASTMATH_HAS_F32X8 1
+#endif
+
+#if defined(__AVX512F__)
+#define FASTMATH_HAS_F32X16 1
+#endif
+
+#if defined(FASTMATH_OUTER_NAMESPACE)
+namespace FASTMATH_OUTER_NAMESPACE {
+#endif
+
+namespace fastmath {
+
+    static constexpr float kPi       = 3.14159265358979f;
+    static constexpr float kHalfPi   = 1.57079632679490f;
+    static constexpr float kTwoPi    = 6.28318530717959f;
+    static constexpr float kInvTwoPi = 0.159154943091895f;
+    static constexpr float kLog2E    = 1.44269504088896f;
+    // 2*pi split so x - k*hi - k*lo stays accurate for moderately large k (Cody-Waite).
+    static constexpr float kTwoPiHi  = 6.28125f;
+    static constexpr float kTwoPiLo  = 1.93530717958647692e-3f;
+    // 20*log10(x) == kDbPerLog2 * log2(x)
+    static constexpr float kDbPerLog2 = 6.02059991327962f;
+    static constexpr float kLog2PerDb = 0.166096404744368f;
+
+    // ------------------------------------------------------------------
+    // Lane primitives: scalar
+    // ------------------------------------------------------------------
+    namespace lane {
+
+        inline float fmadd(float a, float b, float c) { return a * b + c; }
+        inline float div(float a, float b) { return a / b; }
+        inline float minv(float a, float b) { return a < b ? a : b; }
+        inline float maxv(float a, float b) { return a > b ? a : b; }
+        inline float absv(float a) { return a < 0.0f ? -a : a; }
+        inline float selectGt(float a, float b, float x, float y) { return a > b ? x : y; }
+        // Sum of all lanes.
+        inline float hsum(float a) { return a; }
+
+        // Floats of magnitude >= 2^23 (and NaN) are returned as is: they are already integral
+        // and may not fit an int32.
+        inline float floorv(float x) {
+            if (!(absv(x) < 8388608.0f)) return x;
+            const float t = static_cast<float>(static_cast<int32_t>(x));
+            return t > x ? t - 1.0f : t;
+        }
+
+        // 2^n for integral-valued n in [-126, 127].
+        inline float pow2i(float n) {
+            const int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+            float r;
+            std::memcpy(&r, &bits, sizeof(r));
+            return r;
+        }
+
+        // x = m * 2^e with m in [1, 2), for positive normal x.
+        inline void frexpv(float x, float &e, float &m) {
+            uint32_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+            bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+            std::memcpy(&m, &bits, sizeof(m));
+        }
+
+    } // namespace lane
+
+    // ------------------------------------------------------------------
+    // Lane primitives: 4-wide (NEON or SSE2)
+    // ------------------------------------------------------------------
+#if defined(FASTMATH_NEON)
+    struct F32x4 {
+        static constexpr int kWidth = 4;
+        float32x4_t v;
+        F32x4() = default;
+        F32x4(float32x4_t x) : v(x) {}
+        F32x4(float s) : v(vdupq_n_f32(s)) {}
+        static F32x4 load(const float *p) { return vld1q_f32(p); }
+        void store(float *p) const { vst1q_f32(p, v); }
+    };
+
+    inline F32x4 operator+(F32x4 a, F32x4 b) { return vaddq_f32(a.v, b.v); }
+    inline F32x4 operator-(F32x4 a, F32x4 b) { return vsubq_f32(a.v, b.v); }
+    inline F32x4 operator*(F32x4 a, F32x4 b) { return vmulq_f32(a.v, b.v); }
+    inline F32x4 operator-(F32x4 a) { return vnegq_f32(a.v); }
+
+    namespace lane {
+        inline F32x4 fmadd(F32x4 a, F32x4 b, F32x4 c) {
+#if defined(__aarch64__)
+            return vfmaq_f32(c.v, a.v, b.v);
+#else
+            return vmlaq_f32(c.v, a.v, b.v);
+#endif
+        }
+        inline F32x4 div(F32x4 a, F32x4 b) {
+#if defined(__aarch64__)
+            return vdivq_f32(a.v, b.v);
+#else
+            float32x4_t r = vrecpeq_f32(b.v);
+            r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+            r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+            return vmulq_f32(a.v, r);
+#endif
+        }
+        inline F32x4 minv(F32x4 a, F32x4 b) { return vminq_f32(a.v, b.v); }
+        inline F32x4 maxv(F32x4 a, F32x4 b) { return vmaxq_f32(a.v, b.v); }
+        inline F32x4 absv(F32x4 a) { return vabsq_f32(a.v); }
+        inline float hsum(F32x4 a) {
+#if defined(__aarch64__)
+            return vaddvq_f32(a.v);
+#else
+            const float32x2_t p = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+            return vget_lane_f32(vpadd_f32(p, p), 0);
+#endif
+        }
+        inline F32x4 selectGt(F32x4 a, F32x4 b, F32x4 x, F32x4 y) {
+            return vbslq_f32(vcgtq_f32(a.v, b.v), x.v, y.v);
+        }
+        inline F32x4 floorv(F32x4 x) {
+            const float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(x.v));
+            const uint32x4_t gt = vcgtq_f32(t, x.v);
+            const uint32x4_t one = vandq_u32(gt, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)));
+            const uint32x4_t small = vcltq_f32(vabsq_f32(x.v), vdupq_n_f32(8388608.0f));
+            return vbslq_f32(small, vsubq_f32(t, vreinterpretq_f32_u32(one)), x.v);
+        }
+        inline F32x4 pow2i(F32x4 n) {
+            int32x4_t i = vcvtq_s32_f32(n.v);
+            i = vshlq_n_s32(vaddq_s32(i, vdupq_n_s32(127)), 23);
+            return vreinterpretq_f32_s32(i);
+        }
+        inline void frexpv(F32x4 x, F32x4 &e, F32x4 &m) {
+            const uint32x4_t bits = vreinterpretq_u32_f32(x.v);
+            const int32x4_t ei = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127));
+            e = vcvtq_f32_s32(ei);
+            m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFFu)), vdupq_n_u32(0x3F800000u)));
+        }
+    } // namespace lane
+
+#elif defined(FASTMATH_SSE2)
+    struct F32x4 {
+        static constexpr int kWidth = 4;
+        __m128 v;
+        F32x4() = default;
+        F32x4(__m128 x) : v(x) {}
+        F32x4(float s) : v(_mm_set1_ps(s)) {}
+        static F32x4 load(const float *p) { return _mm_loadu_ps(p); }
+        void store(float *p) const { _mm_storeu_ps(p, v); }
+    };
+
+    inline F32x4 operator+(F32x4 a, F32x4 b) { return _mm_add_ps(a.v, b.v); }
+    inline F32x4 operator-(F32x4 a, F32x4 b) { return _mm_sub_ps(a.v, b.v); }
+    inline F32x4 operator*(F32x4 a, F32x4 b) { return _mm_mul_ps(a.v, b.v); }
+    inline F32x4 operator-(F32x4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+    namespace lane {
+        inline F32x4 fmadd(F32x4 a, F32x4 b, F32x4 c) {
+#if defined(__FMA__)
+            return _mm_fmadd_ps(a.v, b.v, c.v);
+#else
+            return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v);
+#endif
+        }
+        inline F32x4 div(F32x4 a, F32x4 b) { return _mm_div_ps(a.v, b.v); }
+        inline F32x4 minv(F32x4 a, F32x4 b) { return _mm_min_ps(a.v, b.v); }
+        inline F32x4 maxv(F32x4 a, F32x4 b) { return _mm_max_ps(a.v, b.v); }
+        inline F32x4 absv(F32x4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+        inline float hsum(F32x4 a) {
+            const __m128 p = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+            return _mm_cvtss_f32(_mm_add_ss(p, _mm_shuffle_ps(p, p, 0x55)));
+        }
+        inline F32x4 selectGt(F32x4 a, F32x4 b, F32x4 x, F32x4 y) {
+            const __m128 m = _mm_cmpgt_ps(a.v, b.v);
+#if defined(__SSE4_1__)
+            return _mm_blendv_ps(y.v, x.v, m);
+#else
+            return _mm_or_ps(_mm_and_ps(m, x.v), _mm_andnot_ps(m, y.v));
+#endif
+        }
+        inline F32x4 floorv(F32x4 x) {
+#if defined(__SSE4_1__)
+            return _mm_floor_ps(x.v);
+#else
+            const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x.v));
+            const __m128 f = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x.v), _mm_set1_ps(1.0f)));
+            const __m128 small = _mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x.v), _mm_set1_ps(8388608.0f));
+            return _mm_or_ps(_mm_and_ps(small, f), _mm_andnot_ps(small, x.v));
+#endif
+        }
+        inline F32x4 pow2i(F32x4 n) {
+            __m128i i = _mm_cvttps_epi32(n.v);
+            i = _mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23);
+            return _mm_castsi128_ps(i);
+        }
+        inline void frexpv(F32x4 x, F32x4 &e, F32x4 &m) {
+            const __m128i bits = _mm_castps_si128(x.v);
+            const __m128i ei = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+            e = _mm_cvtepi32_ps(ei);
+            m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                                              _mm_set1_epi32(0x3F800000)));
+        }
+    } // namespace lane
+#endif
+
+    // ------------------------------------------------------------------
+    // Lane primitives: 8-wide (AVX2)
+    // ------------------------------------------------------------------
+#if defined(FASTMATH_HAS_F32X8)
+    struct F32x8 {
+        static constexpr int kWidth = 8;
+        __m256 v;
+        F32x8() = default;
+        F32x8(__m256 x) : v(x) {}
+        F32x8(float s) : v(_mm256_set1_ps(s)) {}
+        static F32x8 load(const float *p) { return _mm256_loadu_ps(p); }
+        void store(float *p) const { _mm256_storeu_ps(p, v); }
+    };
+
+    inline F32x8 operator+(F32x8 a, F32x8 b) { return _mm256_add_ps(a.v, b.v); }
+    inline F32x8 operator-(F32x8 a, F32x8 b) { return _mm256_sub_ps(a.v, b.v); }
+    inline F32x8 operator*(F32x8 a, F32x8 b) { return _mm256_mul_ps(a.v, b.v); }
+    inline F32x8 operator-(F32x8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+    namespace lane {
+        inline F32x8 fmadd(F32x8 a, F32x8 b, F32x8 c) {
+#if defined(__FMA__)
+            return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+            return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+        }
+        inline F32x8 div(F32x8 a, F32x8 b) { return _mm256_div_ps(a.v, b.v); }
+        inline F32x8 minv(F32x8 a, F32x8 b) { return _mm256_min_ps(a.v, b.v); }
+        inline F32x8 maxv(F32x8 a, F32x8 b) { return _mm256_max_ps(a.v, b.v); }
+        inline F32x8 absv(F32x8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+        inline float hsum(F32x8 a) {
+            const __m128 q = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+            const __m128 p = _mm_add_ps(q, _mm_movehl_ps(q, q));
+            return _mm_cvtss_f32(_mm_add_ss(p, _mm_shuffle_ps(p, p, 0x55)));
+        }
+        inline F32x8 selectGt(F32x8 a, F32x8 b, F32x8 x, F32x8 y) {
+            return _mm256_blendv_ps(y.v, x.v, _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ));
+        }
+        inline F32x8 floorv(F32x8 x) { return _mm256_floor_ps(x.v); }
+        inline F32x8 pow2i(F32x8 n) {
+            __m256i i = _mm256_cvttps_epi32(n.v);
+            i = _mm256_slli_epi32(_mm256_add_epi32(i, _mm256_set1_epi32(127)), 23);
+            return _mm256_castsi256_ps(i);
+        }
+        inline void frexpv(F32x8 x, F32x8 &e, F32x8 &m) {
+            const __m256i bits = _mm256_castps_si256(x.v);
+            const __m256i ei = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+            e = _mm256_cvtepi32_ps(ei);
+            m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                    _mm256_set1_epi32(0x3F800000)));
+        }
+    } // namespace lane
+#endif
+
+    // ------------------------------------------------------------------
+    // Lane primitives: 16-wide (AVX-512F)
+    // ------------------------------------------------------------------
+#if defined(FASTMATH_HAS_F32X16)
+    struct F32x16 {
+        static constexpr int kWidth = 16;
+        __m512 v;
+        F32x16() = default;
+        F32x16(__m512 x) : v(x) {}
+        F32x16(float s) : v(_mm512_set1_ps(s)) {}
+        static F32x16 load(const float *p) { return _mm512_loadu_ps(p); }
+        void store(float *p) const { _mm512_storeu_ps(p, v); }
+    };
+
+    inline F32x16 operator+(F32x16 a, F32x16 b) { return _mm512_add_ps(a.v, b.v); }
+    inline F32x16 operator-(F32x16 a, F32x16 b) { return _mm512_sub_ps(a.v, b.v); }
+    inline F32x16 operator*(F32x16 a, F32x16 b) { return _mm512_mul_ps(a.v, b.v); }
+    inline F32x16 operator-(F32x16 a) {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MIN)));
+    }
+
+    namespace lane {
+        inline F32x16 fmadd(F32x16 a, F32x16 b, F32x16 c) { return _mm512_fmadd_ps(a.v, b.v, c.v); }
+        inline F32x16 div(F32x16 a, F32x16 b) { return _mm512_div_ps(a.v, b.v); }
+        inline F32x16 minv(F32x16 a, F32x16 b) { return _mm512_min_ps(a.v, b.v); }
+        inline F32x16 maxv(F32x16 a, F32x16 b) { return _mm512_max_ps(a.v, b.v); }
+        inline F32x16 absv(F32x16 a) {
+            return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MAX)));
+        }
+        inline float hsum(F32x16 a) { return _mm512_reduce_add_ps(a.v); }
+        inline F32x16 selectGt(F32x16 a, F32x16 b, F32x16 x, F32x16 y) {
+            return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ), y.v, x.v);
+        }
+        inline F32x16 floorv(F32x16 x) {
+            return _mm512_roundscale_ps(x.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        }
+        inline F32x16 pow2i(F32x16 n) {
+            __m512i i = _mm512_cvttps_epi32(n.v);
+            i = _mm512_slli_epi32(_mm512_add_epi32(i, _mm512_set1_epi32(127)), 23);
+            return _mm512_castsi512_ps(i);
+        }
+        inline void frexpv(F32x16 x, F32x16 &e, F32x16 &m) {
+            const __m512i bits = _mm512_castps_si512(x.v);
+            const __m512i ei = _mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(127));
+            e = _mm512_cvtepi32_ps(ei);
+            m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)),
+                                                    _mm512_set1_epi32(0x3F800000)));
+        }
+    } // namespace lane
+#endif
+
+    // ------------------------------------------------------------------
+    // Uniform load/store/width over float and the vector lane types
+    // ------------------------------------------------------------------
+    namespace lane {
+        template <typename V> inline V load(const float *p) { return V::load(p); }
+        template <> inline float load<float>(const float *p) { return *p; }
+        template <typename V> inline void store(V v, float *p) { v.store(p); }
+        inline void store(float v, float *p) { *p = v; }
+        template <typename V> constexpr int width() { return V::kWidth; }
+        template <> constexpr int width<float>() { return 1; }
+    } // namespace lane
+
+    // ------------------------------------------------------------------
+    // Kernels (written once, instantiated per lane type)
+    // ------------------------------------------------------------------
+    namespace kernel {
+        using namespace lane;
+
+        template <typename V>
+        inline V exp2(V x) {
+            x = minv(maxv(x, V(-126.0f)), V(127.99999f));
+            const V n = floorv(x);
+            const V f = x - n;
+            // Weighted least-squares fit of 2^f on [0, 1), relative error 7.7e-8.
+            V p = V(1.876233619e-03f);
+            p = fmadd(p, f, V(8.992589181e-03f));
+            p = fmadd(p, f, V(5.582359290e-02f));
+            p = fmadd(p, f, V(2.401545374e-01f));
+            p = fmadd(p, f, V(6.931529665e-01f));
+            p = fmadd(p, f, V(9.999999270e-01f));
+            return p * pow2i(n);
+        }
+
+        template <typename V>
+        inline V log2(V x) {
+            x = maxv(x, V(1.17549435e-38f));
+            V e, m;
+            frexpv(x, e, m);
+            const V t = m - V(1.0f);
+            // Least-squares fit of log2(1 + t) / t on [0, 1), absolute error 3.7e-7.
+            V p = V(1.512742681e-02f);
+            p = fmadd(p, t, V(-7.815663573e-02f));
+            p = fmadd(p, t, V(1.923830892e-01f));
+            p = fmadd(p, t, V(-3.246151824e-01f));
+            p = fmadd(p, t, V(4.731129765e-01f));
+            p = fmadd(p, t, V(-7.205154625e-01f));
+            p = fmadd(p, t, V(1.442664044e+00f));
+            return fmadd(p, t, e);
+        }
+
+        template <typename V>
+        inline V tanh(V x) {
+            x = minv(maxv(x, V(-9.0f)), V(9.0f));
+            // Large |x|: (e^2x - 1) / (e^2x + 1). Small |x| uses the series to avoid cancellation.
+            const V e = exp2(x * V(2.0f * kLog2E));
+            const V big = div(e - V(1.0f), e + V(1.0f));
+            const V x2 = x * x;
+            V s = fmadd(x2, V(2.0f / 15.0f), V(-1.0f / 3.0f));
+            s = fmadd(s * x2, x, x);
+            return selectGt(absv(x), V(0.0625f), big, s);
+        }
+
+        // x - 2*pi*round(x / 2*pi), in [-pi, pi].
+        template <typename V>
+        inline V reduceTwoPi(V x) {
+            const V k = floorv(fmadd(x, V(kInvTwoPi), V(0.5f)));
+            x = x - k * V(kTwoPiHi);
+            return x - k * V(kTwoPiLo);
+        }
+
+        template <typename V>
+        inline V sin(V x) {
+            // Reduce to [-pi, pi], then fold into [-pi/2, pi/2].
+            x = reduceTwoPi(x);
+            x = selectGt(x, V(kHalfPi), V(kPi) - x, x);
+            x = selectGt(V(-kHalfPi), x, V(-kPi) - x, x);
+            // Odd Taylor polynomial to x^11, truncation error < 6e-8 on [-pi/2, pi/2].
+            const V x2 = x * x;
+            V p = V(-2.50521083854e-08f);
+            p = fmadd(p, x2, V(2.75573192240e-06f));
+            p = fmadd(p, x2, V(-1.98412698413e-04f));
+            p = fmadd(p, x2, V(8.33333333333e-03f));
+            p = fmadd(p, x2, V(-1.66666666667e-01f));
+            p = p * x2;
+            return fmadd(p, x, x);
+        }
+
+        template <typename V>
+        inline V cos(V x) { return sin(reduceTwoPi(x) + V(kHalfPi)); }
+
+    } // namespace kernel
+
+    // ------------------------------------------------------------------
+    // Scalar API
+    // ------------------------------------------------------------------
+    inline float exp2(float x) { return kernel::exp2(x); }
+    inline float log2(float x) { return kernel::log2(x); }
+    inline float exp(float x) { return kernel::exp2(x * kLog2E); }
+    inline float tanh(float x) { return kernel::tanh(x); }
+    inline float sin(float x) { return kernel::sin(x); }
+    inline float cos(float x) { return kernel::cos(x); }
+    inline float dbToGain(float db) { return kernel::exp2(db * kLog2PerDb); }
+    inline float gainToDb(float gain) { return kernel::log2(gain) * kDbPerLog2; }
+
+    // MIDI -> DSP conversions used by the engine.
+    inline float semitonesToRatio(float semitones) { return kernel::exp2(semitones * (1.0f / 12.0f)); }
+    inline float noteToHz(float note) { return 440.0f * kernel::exp2((note - 69.0f) * (1.0f / 12.0f)); }
+    // 14-bit bend (0..16383, centre 8192) -> semitones for a +/- rangeSemitones wheel.
+    inline float bend14ToSemitones(int bend14, float rangeSemitones) {
+        return static_cast<float>(bend14 - 8192) * (rangeSemitones / 8192.0f);
+    }
+    // 7-bit velocity -> linear gain on a dB curve (127 -> 0 dB, 1 -> floorDb).
+    inline float velocityToGain(int velocity, float floorDb = -40.0f) {
+        if (velocity <= 0) return 0.0f;
+        const float t = static_cast<float>(velocity - 1) * (1.0f / 126.0f);
+        return dbToGain(floorDb * (1.0f - t));
+    }
+
+    // ------------------------------------------------------------------
+    // Block API: out[i] = f(in[i]); in and out may alias.
+    // ------------------------------------------------------------------
+    namespace detail {
+        template <typename Fn>
+        inline void forEach(const float *in, float *out, int n, Fn fn) {
+            int i = 0;
+#if defined(FASTMATH_HAS_F32X16)
+            for (; i + 16 <= n; i += 16) fn(F32x16::load(in + i)).store(out + i);
+#endif
+#if defined(FASTMATH_HAS_F32X8)
+            for (; i + 8 <= n; i += 8) fn(F32x8::load(in + i)).store(out + i);
+#endif
+#if defined(FASTMATH_HAS_F32X4)
+            for (; i + 4 <= n; i += 4) fn(F32x4::load(in + i)).store(out + i);
+#endif
+            for (; i < n; ++i) out[i] = fn(in[i]);
+        }
+    } // namespace detail
+
+    inline void exp2Block(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::exp2(v); });
+    }
+    inline void log2Block(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::log2(v); });
+    }
+    inline void expBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::exp2(v * decltype(v)(kLog2E)); });
+    }
+    inline void tanhBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::tanh(v); });
+    }
+    inline void sinBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::sin(v); });
+    }
+    inline void cosBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::cos(v); });
+    }
+    inline void dbToGainBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::exp2(v * decltype(v)(kLog2PerDb)); });
+    }
+    inline void gainToDbBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::log2(v) * decltype(v)(kDbPerLog2); });
+    }
+    inline void semitonesToRatioBlock(const float *in, float *out, int n) {
+        detail::forEach(in, out, n, [](auto v) { return kernel::exp2(v * decltype(v)(1.0f / 12.0f)); });
+    }
+
+} // namespace fastmath
+
+#if defined(FASTMATH_OUTER_NAMESPACE)
+} // namespace FASTMATH_OUTER_NAMESPACE
+#endif
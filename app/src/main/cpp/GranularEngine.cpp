@@ -0,0 +1,169 @@
+#include "GranularEngine.h"
+#include "DspKernels.h"
+#include "FastMath.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+GranularEngine::GranularEngine() {
+    window();   // build the shared table here rather than on the first audio block
+}
+
+const float *GranularEngine::window() {
+    static const auto table = [] {
+        std::array<float, kWindowSize + 1> w{};
+        for (int i = 0; i <= kWindowSize; ++i) {
+            w[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * 3.14159265358979323846 * i / kWindowSize));
+        }
+        return w;
+    }();
+    return table.data();
+}
+
+void GranularEngine::setSource(const float *data, int frames, double sourceRate, bool loop) {
+    if (!data || frames < 4 || (loop && (frames & (frames - 1)) != 0)) {
+        clearSource();
+        return;
+    }
+    if (frames != sourceFrames_ || loop != loop_ || (!loop && data != source_)) reset();
+    source_ = data;
+    sourceFrames_ = frames;
+    sourceMask_ = loop ? frames - 1 : -1;
+    loop_ = loop;
+    sourceRate_ = sourceRate;
+}
+
+void GranularEngine::clearSource() {
+    source_ = nullptr;
+    sourceFrames_ = 0;
+    reset();
+}
+
+void GranularEngine::reset() {
+    count_ = 0;
+    untilNext_ = 0.0f;
+}
+
+float GranularEngine::nextUnit() {
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return static_cast<float>(rng_ >> 8) * (1.0f / 16777216.0f);
+}
+
+void GranularEngine::spawn(const Params &params, double sampleRate, int delay) {
+    const int budget = std::clamp(params.maxGrains, 1, kMaxGrains);
+    if (count_ >= budget) {
+        ++dropped_;
+        return;
+    }
+
+    const float cents = params.pitchSpreadCents * (2.0f * nextUnit() - 1.0f);
+    const float inc = std::max(1.0e-3f, params.pitch * static_cast<float>(sourceRate_ / sampleRate)
+            * fastmath::exp2(cents * (1.0f / 1200.0f)));
+    int length = std::max(2, static_cast<int>(params.grainMs * 0.001f * static_cast<float>(sampleRate)));
+    const float centre = std::clamp(params.position + params.positionJitter * (2.0f * nextUnit() - 1.0f), 0.0f, 1.0f);
+
+    int32_t base;
+    if (loop_) {
+        base = static_cast<int32_t>(centre * static_cast<float>(sourceFrames_)) & sourceMask_;
+    } else {
+        // The whole read span (plus the interpolation guard) must lie inside the buffer,
+        // so the render loop needs no bounds checks; long grains on short sources shrink.
+        const int usable = sourceFrames_ - 3;
+        if (static_cast<float>(length) * inc > static_cast<float>(usable)) {
+            length = static_cast<int>(static_cast<float>(usable) / inc);
+            if (length < 2) return;
+        }
+        const int span = static_cast<int>(static_cast<float>(length) * inc) + 1;
+        const int maxStart = std::max(0, usable - span);
+        base = std::clamp(static_cast<int32_t>(centre * static_cast<float>(sourceFrames_)) - span / 2, 0, maxStart);
+    }
+
+    // Equal-power pan; overlapping grains are incoherent, so scale by 1/sqrt(overlap).
+    const float overlap = params.density * params.grainMs * 0.001f;
+    const float gain = params.gain / std::sqrt(std::max(1.0f, overlap));
+    const float pan = std::clamp(params.stereoSpread, 0.0f, 1.0f) * (2.0f * nextUnit() - 1.0f);
+    const float angle = (pan + 1.0f) * (fastmath::kPi * 0.25f);
+
+    const int g = count_++;
+    base_[g] = base;
+    inc_[g] = inc;
+    winInc_[g] = static_cast<float>(kWindowSize) / static_cast<float>(length);
+    gainL_[g] = fastmath::cos(angle) * gain;
+    gainR_[g] = fastmath::sin(angle) * gain;
+    age_[g] = 0;
+    length_[g] = length;
+    delay_[g] = delay;
+}
+
+void GranularEngine::schedule(const Params &params, double sampleRate, int frames) {
+    if (params.density <= 0.0f) {
+        untilNext_ = 0.0f;
+        return;
+    }
+    // Onset intervals uniform in [0.5, 1.5) of the mean; at most one onset per frame.
+    const float mean = std::max(1.0f, static_cast<float>(sampleRate) / params.density);
+    while (untilNext_ < static_cast<float>(frames)) {
+        spawn(params, sampleRate, static_cast<int>(untilNext_));
+        untilNext_ += mean * (0.5f + nextUnit());
+    }
+    untilNext_ -= static_cast<float>(frames);
+}
+
+void GranularEngine::render(const Params &params, double sampleRate, float *out, int frames) {
+    if (!source_) return;
+    if (count_ == 0 && params.density <= 0.0f) {
+        untilNext_ = 0.0f;
+        return;
+    }
+
+    const dsp::Kernels &kernels = dsp::kernels();
+    dsp::GrainArgs args{};
+    args.source = source_;
+    args.mask = sourceMask_;
+    args.window = window();
+    while (frames > 0) {
+        const int n = std::min(frames, kBlock);
+        std::memset(left_, 0, sizeof(float) * static_cast<size_t>(n));
+        std::memset(right_, 0, sizeof(float) * static_cast<size_t>(n));
+        schedule(params, sampleRate, n);
+
+        for (int g = 0; g < count_;) {
+            const int d = delay_[g];
+            const int m = std::min(n - d, length_[g] - age_[g]);
+            args.base = base_[g];
+            args.inc = inc_[g];
+            args.winInc = winInc_[g];
+            args.gainL = gainL_[g];
+            args.gainR = gainR_[g];
+            args.age = age_[g];
+            args.left = left_ + d;
+            args.right = right_ + d;
+            args.frames = m;
+            kernels.grain(args);
+            age_[g] += m;
+            delay_[g] = 0;
+            if (age_[g] < length_[g]) {
+                ++g;
+                continue;
+            }
+            // Finished: move the last grain into this slot (and render it next).
+            const int last = --count_;
+            base_[g] = base_[last];
+            inc_[g] = inc_[last];
+            winInc_[g] = winInc_[last];
+            gainL_[g] = gainL_[last];
+            gainR_[g] = gainR_[last];
+            age_[g] = age_[last];
+            length_[g] = length_[last];
+            delay_[g] = delay_[last];
+        }
+
+        kernels.interleaveAdd(out, left_, right_, n);
+        out += 2 * n;
+        frames -= n;
+    }
+}
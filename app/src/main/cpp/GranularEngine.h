@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+// Asynchronous granular source over a mono float buffer: an imported sample, or one mip
+// level of a wavetable read as a loop.
+//
+// Grains live in a fixed pool of kMaxGrains struct-of-arrays slots kept compact (a finished
+// grain is swapped with the last one), so rendering walks [0, activeGrains()). Each grain is
+// rendered by the dispatched grain kernel (DspKernels.h), 4/8/16 frames at a time: read
+// position, interpolation, window and the pan-weighted stereo mix are vector ops, only the
+// source and window table reads are scalar (NEON has no gather). The Hann window is a
+// precomputed table.
+//
+// Cost is bounded: at most Params::maxGrains grains sound at once and onsets beyond that are
+// dropped (droppedGrains()), so a block never renders more than maxGrains * frames
+// grain-frames however high the density is driven.
+//
+// Audio thread only; no allocation.
+class GranularEngine {
+public:
+    static constexpr int kMaxGrains = 512;
+    static constexpr int kWindowSize = 4096;
+
+    struct Params {
+        float density = 20.0f;          // grain onsets per second (mean; onsets are jittered)
+        float position = 0.5f;          // centre of the read region, 0..1 of the source
+        float positionJitter = 0.05f;   // onsets land within +/- this of position
+        float grainMs = 100.0f;
+        float pitch = 1.0f;             // playback ratio at the source's own rate
+        float pitchSpreadCents = 0.0f;  // each grain detuned by up to +/- this
+        float stereoSpread = 0.8f;      // 0..1
+        float gain = 1.0f;
+        int maxGrains = 256;            // concurrent grain budget, <= kMaxGrains
+    };
+
+    GranularEngine();
+
+    // Reads from data (frames samples at sourceRate) until the next call. loop: data is one
+    // period of power-of-two length, read with wrap-around (wavetables). Grains restart when
+    // a non-looping buffer or the length changes; a looping source of the same length may
+    // be switched per block (mip level changes).
+    void setSource(const float *data, int frames, double sourceRate, bool loop);
+    void clearSource();
+    // Drops all grains.
+    void reset();
+    void seed(uint32_t seed) { rng_ = seed ? seed : 0x9E3779B9u; }
+
+    bool hasSource() const { return source_ != nullptr; }
+    int activeGrains() const { return count_; }
+    int64_t droppedGrains() const { return dropped_; }
+
+    // Adds frames of interleaved stereo to out. Params are read once per call.
+    void render(const Params &params, double sampleRate, float *out, int frames);
+
+    // The shared window, kWindowSize + 1 entries.
+    static const float *window();
+
+private:
+    static constexpr int kBlock = 256;   // frames per internal pass
+
+    void schedule(const Params &params, double sampleRate, int frames);
+    void spawn(const Params &params, double sampleRate, int delay);
+    float nextUnit();
+
+    const float *source_ = nullptr;
+    int sourceFrames_ = 0;
+    int32_t sourceMask_ = -1;   // frames - 1 for loops, all ones (no-op) otherwise
+    bool loop_ = false;
+    double sourceRate_ = 48000.0;
+
+    // Grain pool, struct of arrays.
+    int32_t base_[kMaxGrains] = {};     // source frame of the grain's first sample
+    float inc_[kMaxGrains] = {};        // source frames per output frame
+    float winInc_[kMaxGrains] = {};     // window entries per output frame
+    float gainL_[kMaxGrains] = {};
+    float gainR_[kMaxGrains] = {};
+    int32_t age_[kMaxGrains] = {};      // frames rendered so far
+    int32_t length_[kMaxGrains] = {};   // frames in total
+    int32_t delay_[kMaxGrains] = {};    // frames before the onset, inside the current pass
+    int count_ = 0;
+
+    float untilNext_ = 0.0f;   // frames to the next onset
+    uint32_t rng_ = 0x9E3779B9u;
+    int64_t dropped_ = 0;
+
+    alignas(32) float left_[kBlock] = {};
+    alignas(32) float right_[kBlock] = {};
+};
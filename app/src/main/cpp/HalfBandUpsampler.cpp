@@ -0,0 +1,81 @@
+#include "HalfBandUpsampler.h"
+#include "DspKernels.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kKaiserBeta = 8.0;
+
+    // Zeroth-order modified Bessel function (series), for the Kaiser window.
+    double besselI0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+} // namespace
+
+HalfBandUpsampler::HalfBandUpsampler() {
+    // Interpolator g[j] = sinc(j / 2) * kaiser(j), j = -(2K - 1) .. 2K - 1. Even j other than
+    // 0 are zero; odd j form the odd phase: c_k = g[2k + 1], applied to x[p - k] and x[p + 1 + k].
+    const int halfLength = 2 * kHalfTaps - 1;
+    const double norm = besselI0(kKaiserBeta);
+    double c[kHalfTaps];
+    double sum = 0.0;
+    for (int k = 0; k < kHalfTaps; ++k) {
+        const double j = 2.0 * k + 1.0;
+        const double r = j / (halfLength + 1.0);
+        const double window = besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / norm;
+        c[k] = std::sin(kPi * j / 2.0) / (kPi * j / 2.0) * window;
+        sum += 2.0 * c[k];
+    }
+    // Unity DC gain on the odd phase, like the even phase.
+    for (int k = 0; k < kHalfTaps; ++k) {
+        const float v = static_cast<float>(c[k] / sum);
+        taps_[kHalfTaps - 1 - k] = v;
+        taps_[kHalfTaps + k] = v;
+    }
+    reset();
+}
+
+void HalfBandUpsampler::reset() {
+    std::memset(history_, 0, sizeof(history_));
+}
+
+void HalfBandUpsampler::process(const float *in, int frames, float *out) {
+    while (frames > 0) {
+        const int n = frames < kMaxChunk ? frames : kMaxChunk;
+        processChunk(in, n, out);
+        in += n * kChannels;
+        out += 2 * n * kChannels;
+        frames -= n;
+    }
+}
+
+void HalfBandUpsampler::processChunk(const float *in, int frames, float *out) {
+    constexpr int kHistory = kTaps - 1;
+    const dsp::Kernels &kernels = dsp::kernels();
+
+    for (int ch = 0; ch < kChannels; ++ch) {
+        float *x = history_[ch];
+        for (int i = 0; i < frames; ++i) x[kHistory + i] = in[i * kChannels + ch];
+
+        // odd_[j] = sum_i taps_[i] * x[j + i]: vectorised across consecutive outputs.
+        kernels.fir(taps_, kTaps, x, odd_, frames);
+
+        // Even phase: the input delayed to the filter centre.
+        for (int i = 0; i < frames; ++i) {
+            out[(2 * i) * kChannels + ch] = x[i + kHalfTaps - 1];
+            out[(2 * i + 1) * kChannels + ch] = odd_[i];
+        }
+
+        std::memmove(x, x + frames, sizeof(float) * kHistory);
+    }
+}
@@ -0,0 +1,208 @@
+#include "ImportPipeline.h"
+#include "PcmConvert.h"
+#include "StreamDecoder.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+    bool readFile(const std::string &path, std::vector<uint8_t> &out) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        in.seekg(0, std::ios::end);
+        const std::streamoff size = in.tellg();
+        if (size <= 0) return false;
+        in.seekg(0, std::ios::beg);
+        out.resize(static_cast<size_t>(size));
+        in.read(reinterpret_cast<char *>(out.data()), size);
+        return static_cast<bool>(in);
+    }
+
+    // Streams the file through one decoder chunk into the resampler: besides the finished
+    // asset, memory is a chunk of decoded and resampled frames whatever the file length.
+    std::unique_ptr<SampleAsset> buildSample(const std::string &path, double targetRate) {
+        auto decoder = pcm::StreamDecoder::open(path);
+        if (!decoder) return nullptr;
+
+        auto asset = std::make_unique<SampleAsset>();
+        asset->sampleRate = targetRate;
+
+        constexpr size_t kChunk = pcm::StreamDecoder::kChunkFrames;
+        pcm::LinearResampler resampler(static_cast<double>(decoder->sampleRate()), targetRate);
+        std::vector<float> mono(kChunk);
+        std::vector<float> resampled(resampler.maxOutput(kChunk));
+        if (decoder->frameCountHint() > 0) {
+            asset->frames.reserve(static_cast<size_t>(static_cast<double>(decoder->frameCountHint()) * targetRate
+                                                      / decoder->sampleRate()) + 2);
+        }
+
+        while (const size_t n = decoder->read(mono.data(), kChunk)) {
+            const size_t produced = resampler.process(mono.data(), n, resampled.data(), resampled.size());
+            asset->frames.insert(asset->frames.end(), resampled.begin(), resampled.begin() + static_cast<std::ptrdiff_t>(produced));
+        }
+        if (decoder->failed() || asset->frames.empty()) return nullptr;
+
+        pcm::normalizePeak(asset->frames.data(), asset->frames.size());
+        return asset;
+    }
+
+    std::unique_ptr<Wavetable> buildWavetable(const std::vector<uint8_t> &bytes) {
+        auto table = std::make_unique<Wavetable>(bytes.data(), bytes.size());
+        // Only real tables are published; the constructor's sine fallback means "unreadable".
+        return table->parsedOk() ? std::move(table) : nullptr;
+    }
+
+} // namespace
+
+ImportPipeline::ImportPipeline(AssetRegistry &registry, double targetSampleRate, int workerCount)
+        : registry_(registry), targetSampleRate_(targetSampleRate), jobs_(new Job[kMaxJobs]) {
+    if (workerCount <= 0) workerCount = static_cast<int>(std::thread::hardware_concurrency());
+    workerCount = std::clamp(workerCount, 1, 16);
+    workers_.reserve(static_cast<size_t>(workerCount));
+    for (int i = 0; i < workerCount; ++i) workers_.emplace_back([this] { workerLoop(); });
+}
+
+ImportPipeline::~ImportPipeline() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+        // Queued tasks that never started release their reservations.
+        for (const Task &t : tasks_) {
+            Job &job = jobs_[t.job];
+            const int slot = job.reserved[t.index];
+            if (job.requests[t.index].kind == Kind::kWavetable) registry_.releaseWavetableSlot(slot);
+            else registry_.releaseSampleSlot(slot);
+        }
+        tasks_.clear();
+    }
+    workAvailable_.notify_all();
+    for (auto &w : workers_) w.join();
+}
+
+int ImportPipeline::submit(const std::vector<Request> &requests) {
+    if (requests.empty() || requests.size() > static_cast<size_t>(kMaxRequestsPerJob)) return -1;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    int index = -1;
+    for (int i = 0; i < kMaxJobs; ++i) {
+        if (!jobs_[i].active.load(std::memory_order_acquire)) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) return -1;
+
+    Job &job = jobs_[index];
+    // New generation first, so ids of the previous job using this slot stop resolving.
+    const uint32_t generation = job.generation.load(std::memory_order_relaxed) + 1;
+    job.generation.store(generation, std::memory_order_release);
+    const int count = static_cast<int>(requests.size());
+    job.requests = requests;
+    job.total.store(count, std::memory_order_relaxed);
+    job.completed.store(0, std::memory_order_relaxed);
+    job.failed.store(0, std::memory_order_relaxed);
+    job.cacheHits.store(0, std::memory_order_relaxed);
+
+    // Reserve registry slots in request order so results land predictably whatever the
+    // completion order.
+    for (int i = 0; i < count; ++i) {
+        int slot = -1;
+        if (requests[i].kind == Kind::kWavetable) registry_.reserveWavetableSlots(1, &slot);
+        else registry_.reserveSampleSlots(1, &slot);
+        job.reserved[i] = slot;
+        job.results[i].store(-1, std::memory_order_relaxed);
+    }
+
+    job.active.store(true, std::memory_order_release);
+    for (int i = 0; i < count; ++i) tasks_.push_back(Task{index, i});
+    workAvailable_.notify_all();
+    return static_cast<int>(generation) * kMaxJobs + index;
+}
+
+ImportPipeline::Job *ImportPipeline::jobFor(int jobId) const {
+    if (jobId < 0) return nullptr;
+    Job &job = jobs_[jobId % kMaxJobs];
+    if (job.generation.load(std::memory_order_acquire) != static_cast<uint32_t>(jobId / kMaxJobs)) return nullptr;
+    return &job;
+}
+
+bool ImportPipeline::progress(int jobId, Progress &out) const {
+    const Job *job = jobFor(jobId);
+    if (!job) return false;
+    out.total = job->total.load(std::memory_order_relaxed);
+    out.failed = job->failed.load(std::memory_order_relaxed);
+    out.cacheHits = job->cacheHits.load(std::memory_order_relaxed);
+    out.completed = job->completed.load(std::memory_order_acquire);
+    out.done = out.completed >= out.total;
+    return true;
+}
+
+int ImportPipeline::resultSlot(int jobId, int index) const {
+    const Job *job = jobFor(jobId);
+    if (!job || index < 0 || index >= job->total.load(std::memory_order_relaxed)) return -1;
+    return job->results[index].load(std::memory_order_acquire);
+}
+
+void ImportPipeline::waitIdle() {
+    std::unique_lock<std::mutex> guard(mutex_);
+    idle_.wait(guard, [this] { return tasks_.empty() && running_ == 0; });
+}
+
+void ImportPipeline::workerLoop() {
+    for (;;) {
+        Task task{};
+        {
+            std::unique_lock<std::mutex> guard(mutex_);
+            workAvailable_.wait(guard, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_) return;
+            task = tasks_.front();
+            tasks_.pop_front();
+            ++running_;
+        }
+
+        Job &job = jobs_[task.job];
+        if (!runTask(job, task.index)) job.failed.fetch_add(1, std::memory_order_relaxed);
+        const int done = job.completed.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (done >= job.total.load(std::memory_order_relaxed)) job.active.store(false, std::memory_order_release);
+            --running_;
+            if (tasks_.empty() && running_ == 0) idle_.notify_all();
+        }
+    }
+}
+
+bool ImportPipeline::runTask(Job &job, int index) {
+    const Request &req = job.requests[index];
+    const int slot = job.reserved[index];
+    const bool isWavetable = req.kind == Kind::kWavetable;
+
+    std::vector<uint8_t> bytes;
+    int published = -1;
+    if (isWavetable && slot >= 0 && readFile(req.path, bytes)) {
+        const uint64_t hash = cache_ ? WavetableCache::contentHash(bytes.data(), bytes.size()) : 0;
+        std::unique_ptr<Wavetable> table = cache_ ? cache_->load(hash) : nullptr;
+        if (table) {
+            job.cacheHits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            table = buildWavetable(bytes);
+            if (table && cache_) cache_->store(hash, *table);
+        }
+        if (table) published = registry_.publishWavetable(std::move(table), slot);
+    } else if (!isWavetable && slot >= 0) {
+        // Samples are never read whole: the decoder streams them from the file.
+        auto sample = buildSample(req.path, targetSampleRate_.load(std::memory_order_relaxed));
+        if (sample) published = registry_.publishSample(std::move(sample), slot);
+    }
+
+    if (published < 0) {
+        if (isWavetable) registry_.releaseWavetableSlot(slot);
+        else registry_.releaseSampleSlot(slot);
+        return false;
+    }
+    job.results[index].store(published, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "AssetRegistry.h"
+#include "WavetableCache.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Parallel batch import of wavetables and samples.
+//
+// submit() queues one task per file; a fixed worker pool reads, parses, downmixes,
+// resamples, normalizes and (for wavetables) builds mipmaps, then publishes each finished
+// asset into the AssetRegistry slot reserved for it at submit time. Files must be WAV
+// (compressed formats are decoded by the app first); samples are
+// streamed from the file a decoder chunk at a time (StreamDecoder.h). Progress is a set of
+// atomic counters per job, so the UI can poll without taking a lock.
+//
+// Never call from the audio thread.
+class ImportPipeline {
+public:
+    enum class Kind : uint8_t {
+        kWavetable = 0,  // one cycle -> Wavetable (kWavetableSize + mipmaps)
+        kSample,         // full-length mono sample resampled to the engine rate
+    };
+
+    struct Request {
+        std::string path;
+        Kind kind = Kind::kWavetable;
+    };
+
+    struct Progress {
+        int total = 0;
+        int completed = 0;   // finished, successfully or not
+        int failed = 0;
+        int cacheHits = 0;   // wavetables served from the WavetableCache
+        bool done = false;
+    };
+
+    static constexpr int kMaxJobs = 8;
+    static constexpr int kMaxRequestsPerJob = 1024;
+
+    // workerCount <= 0 uses std::thread::hardware_concurrency().
+    ImportPipeline(AssetRegistry &registry, double targetSampleRate, int workerCount = 0);
+    ~ImportPipeline();
+
+    ImportPipeline(const ImportPipeline &) = delete;
+    ImportPipeline &operator=(const ImportPipeline &) = delete;
+
+    // Returns a job id, or -1 if every job slot is still busy or the batch is larger than
+    // kMaxRequestsPerJob (split it).
+    int submit(const std::vector<Request> &requests);
+
+    // Lock-free snapshot of a job's counters; false for an unknown/expired id.
+    bool progress(int jobId, Progress &out) const;
+
+    // Registry slot of request index once it has been published, else -1.
+    int resultSlot(int jobId, int index) const;
+
+    // Wavetables are looked up by content hash before building and stored after. Set before
+    // the first submit(); the cache must outlive the pipeline and the registry's tables.
+    void setWavetableCache(WavetableCache *cache) { cache_ = cache; }
+
+    void setTargetSampleRate(double sampleRate) { targetSampleRate_.store(sampleRate, std::memory_order_relaxed); }
+    int workerCount() const { return static_cast<int>(workers_.size()); }
+
+    // Blocks until every queued task has finished (tests and shutdown paths).
+    void waitIdle();
+
+private:
+    struct Job {
+        std::atomic<uint32_t> generation{0};
+        std::atomic<bool> active{false};
+        std::atomic<int> total{0};
+        std::atomic<int> completed{0};
+        std::atomic<int> failed{0};
+        std::atomic<int> cacheHits{0};
+        std::vector<Request> requests;
+        int reserved[kMaxRequestsPerJob];                // registry slot per request (-1 = none)
+        std::atomic<int> results[kMaxRequestsPerJob];    // published slot per request
+    };
+
+    struct Task {
+        int job;
+        int index;
+    };
+
+    void workerLoop();
+    bool runTask(Job &job, int index);
+    Job *jobFor(int jobId) const;
+
+    AssetRegistry &registry_;
+    WavetableCache *cache_ = nullptr;
+    std::atomic<double> targetSampleRate_;
+
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable idle_;
+    std::deque<Task> tasks_;
+    int running_ = 0;
+    bool stopping_ = false;
+
+    std::unique_ptr<Job[]> jobs_;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,198 @@
+#include "ModMatrix.h"
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+#if defined(FASTMATH_HAS_F32X8)
+    using Lane = fastmath::F32x8;
+#elif defined(FASTMATH_HAS_F32X4)
+    using Lane = fastmath::F32x4;
+#endif
+
+#if defined(FASTMATH_HAS_F32X8) || defined(FASTMATH_HAS_F32X4)
+    constexpr int kLaneWidth = Lane::kWidth;
+    inline Lane loadLane(const float *p) { return Lane::load(p); }
+    inline void storeLane(const Lane &v, float *p) { v.store(p); }
+#else
+    using Lane = float;
+    constexpr int kLaneWidth = 1;
+    inline Lane loadLane(const float *p) { return *p; }
+    inline void storeLane(Lane v, float *p) { *p = v; }
+#endif
+
+    static_assert(ModMatrix::kMaxVoices % kLaneWidth == 0, "voice lanes must fill whole vectors");
+
+    template <typename V>
+    inline V applyCurve(V x, ModMatrix::Curve curve) {
+        using namespace fastmath::lane;
+        switch (curve) {
+            case ModMatrix::kCurveExp:
+                return x * absv(x);
+            case ModMatrix::kCurveLog: {
+                const V a = minv(absv(x), V(1.0f));
+                const V m = V(1.0f) - a;
+                const V y = V(1.0f) - m * m;
+                return selectGt(V(0.0f), x, -y, y);
+            }
+            case ModMatrix::kCurveSCurve: {
+                const V c = minv(maxv(x, V(-1.0f)), V(1.0f));
+                return c * (V(1.5f) - V(0.5f) * c * c);
+            }
+            case ModMatrix::kCurveBipolar:
+                return fmadd(x, V(2.0f), V(-1.0f));
+            case ModMatrix::kCurveLinear:
+            default:
+                return x;
+        }
+    }
+
+    // dst[0..n) += amount * curve(src[0..n)), n a multiple of the lane width.
+    template <ModMatrix::Curve C>
+    inline void accumulate(const float *src, float *dst, float amount, int n) {
+        const Lane amt(amount);
+        for (int i = 0; i < n; i += kLaneWidth) {
+            const Lane x = applyCurve(loadLane(src + i), C);
+            storeLane(fastmath::lane::fmadd(x, amt, loadLane(dst + i)), dst + i);
+        }
+    }
+
+    using AccumulateFn = void (*)(const float *, float *, float, int);
+    constexpr AccumulateFn kAccumulate[ModMatrix::kNumCurves] = {
+            accumulate<ModMatrix::kCurveLinear>,
+            accumulate<ModMatrix::kCurveExp>,
+            accumulate<ModMatrix::kCurveLog>,
+            accumulate<ModMatrix::kCurveSCurve>,
+            accumulate<ModMatrix::kCurveBipolar>,
+    };
+
+    inline uint64_t packRoute(const ModMatrix::Route &r) {
+        uint32_t amountBits;
+        std::memcpy(&amountBits, &r.amount, sizeof(amountBits));
+        return static_cast<uint64_t>(r.source)
+               | (static_cast<uint64_t>(r.dest) << 8)
+               | (static_cast<uint64_t>(r.curve) << 16)
+               | (static_cast<uint64_t>(amountBits) << 32);
+    }
+
+    inline ModMatrix::Route unpackRoute(uint64_t w) {
+        ModMatrix::Route r;
+        r.source = static_cast<ModMatrix::Source>(w & 0xFF);
+        r.dest = static_cast<ModMatrix::Dest>((w >> 8) & 0xFF);
+        r.curve = static_cast<ModMatrix::Curve>((w >> 16) & 0xFF);
+        const auto amountBits = static_cast<uint32_t>(w >> 32);
+        std::memcpy(&r.amount, &amountBits, sizeof(r.amount));
+        return r;
+    }
+
+} // namespace
+
+ModMatrix::ModMatrix() {
+    for (auto &w : pendingRoutes_) w.store(0, std::memory_order_relaxed);
+    lfoRateHz_[0].store(5.0f, std::memory_order_relaxed);
+    lfoRateHz_[1].store(0.25f, std::memory_order_relaxed);
+
+    Route defaults[kMaxRoutes];
+    setRoutes(defaults, defaultRoutes(defaults, kMaxRoutes));
+}
+
+int ModMatrix::defaultRoutes(Route *out, int capacity) {
+    // Timbre and conductor height open the filter. Gain-neutral: pressure already reaches
+    // FluidSynth as channel pressure, and a louder default would change every soundfont.
+    const Route defaults[] = {
+            {kSrcTimbre, kDestCutoff, kCurveBipolar, 2.0f},
+            {kSrcHeight, kDestCutoff, kCurveBipolar, 1.0f},
+    };
+    const int n = std::min(capacity, static_cast<int>(sizeof(defaults) / sizeof(defaults[0])));
+    for (int i = 0; i < n; ++i) out[i] = defaults[i];
+    return n;
+}
+
+void ModMatrix::setRoutes(const Route *routes, int count) {
+    count = std::clamp(count, 0, kMaxRoutes);
+    std::lock_guard<std::mutex> guard(writerMutex_);
+    const uint32_t seq = routeSeq_.load(std::memory_order_relaxed);
+    routeSeq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < count; ++i) {
+        pendingRoutes_[i].store(packRoute(routes[i]), std::memory_order_relaxed);
+    }
+    pendingCount_.store(count, std::memory_order_relaxed);
+    routeSeq_.store(seq + 2, std::memory_order_release);
+}
+
+void ModMatrix::setLfoRate(int lfo, float hz) {
+    if (lfo < 0 || lfo >= kNumLfos) return;
+    lfoRateHz_[lfo].store(std::max(0.0f, hz), std::memory_order_relaxed);
+}
+
+void ModMatrix::setVoiceActive(int voice, bool active) {
+    if (voice < 0 || voice >= kMaxVoices) return;
+    if (active) activeMask_ |= (1u << voice);
+    else activeMask_ &= ~(1u << voice);
+}
+
+void ModMatrix::pullRoutes() {
+    const uint32_t s1 = routeSeq_.load(std::memory_order_acquire);
+    if ((s1 & 1u) != 0 || s1 == appliedSeq_) return;
+
+    Route next[kMaxRoutes];
+    const int count = pendingCount_.load(std::memory_order_relaxed);
+    int valid = 0;
+    for (int i = 0; i < count; ++i) {
+        const Route r = unpackRoute(pendingRoutes_[i].load(std::memory_order_relaxed));
+        if (r.source >= kNumSources || r.dest >= kNumDests || r.curve >= kNumCurves) continue;
+        next[valid++] = r;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (routeSeq_.load(std::memory_order_relaxed) != s1) return; // writer raced us; retry next block
+
+    std::copy(next, next + valid, routes_);
+    routeCount_ = valid;
+    appliedSeq_ = s1;
+}
+
+void ModMatrix::process(int numFrames, double sampleRate) {
+    pullRoutes();
+
+    // LFOs advance by one block; the value is held for the block.
+    for (int l = 0; l < kNumLfos; ++l) {
+        const double inc = static_cast<double>(lfoRateHz_[l].load(std::memory_order_relaxed))
+                           * static_cast<double>(numFrames) / sampleRate;
+        lfoPhase_[l] += inc;
+        lfoPhase_[l] -= static_cast<double>(static_cast<int64_t>(lfoPhase_[l]));
+        global_[kSrcLfo1 + l] = fastmath::sin(fastmath::kTwoPi * static_cast<float>(lfoPhase_[l]));
+    }
+
+    // Only lanes up to the highest active voice are evaluated (rounded up to the lane width).
+    int highest = 0;
+    for (uint32_t m = activeMask_; m != 0; m >>= 1) ++highest;
+    laneCount_ = (highest + kLaneWidth - 1) / kLaneWidth * kLaneWidth;
+
+    for (int d = 0; d < kNumDests; ++d) std::fill(dst_[d], dst_[d] + kMaxVoices, 0.0f);
+
+    if (laneCount_ > 0) {
+        // Broadcast global sources across the voice lanes so every route runs the same kernel.
+        for (int s = kSrcFlow; s < kNumSources; ++s) {
+            std::fill(src_[s], src_[s] + laneCount_, global_[s]);
+        }
+        for (int r = 0; r < routeCount_; ++r) {
+            const Route &route = routes_[r];
+            kAccumulate[route.curve](src_[route.source], dst_[route.dest], route.amount, laneCount_);
+        }
+    }
+
+    // Active lanes remember this block; inactive ones (releasing or idle) repeat their last.
+    for (int d = 0; d < kNumDests; ++d) {
+        for (int v = 0; v < kMaxVoices; ++v) {
+            if ((activeMask_ & (1u << v)) != 0) held_[d][v] = dst_[d][v];
+            else dst_[d][v] = held_[d][v];
+        }
+    }
+
+    fastmath::semitonesToRatioBlock(dst_[kDestPitch], pitchRatio_, kMaxVoices);
+    fastmath::exp2Block(dst_[kDestCutoff], cutoffScale_, kMaxVoices);
+    fastmath::dbToGainBlock(dst_[kDestGain], gain_, kMaxVoices);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Block-rate modulation matrix for MPE expression.
+//
+// Sources (per-voice MPE dimensions, velocity/key, conductor parameters, LFOs) are stored
+// as struct-of-arrays rows of kMaxVoices lanes; each route adds amount * curve(source) into
+// a destination row. process() runs once per audio block over every active voice lane in
+// SIMD, so cost grows with routes x (active voices / lane width), not with event count.
+//
+// Threading: routes and LFO rates are written from any non-audio thread via setRoutes() /
+// setLfoRate(); concurrent setRoutes() callers serialise on a writer mutex the audio thread
+// never takes. Everything else (setVoiceSource, setGlobalSource, process, outputs) belongs
+// to the audio thread, which sees no allocation and no locks.
+class ModMatrix {
+public:
+    static constexpr int kMaxVoices = 16;   // one lane per MPE member channel
+    static constexpr int kMaxRoutes = 32;
+    static constexpr int kNumLfos = 2;
+
+    enum Source : uint8_t {
+        kSrcPitchBend = 0,  // per voice, bipolar -1..1
+        kSrcPressure,       // per voice, 0..1
+        kSrcTimbre,         // per voice (CC74), 0..1
+        kSrcVelocity,       // per voice, 0..1 (latched at note on)
+        kSrcKey,            // per voice, (note - 60) / 60
+        kSrcFlow,           // conductor flowEnergy, 0..1
+        kSrcHeight,         // conductor verticalBias, 0..1
+        kSrcGrip,           // conductor pinch, 0..1
+        kSrcLfo1,           // bipolar -1..1
+        kSrcLfo2,
+        kSrcBreath,         // microphone breath envelope, 0..1 (OboeSynthesizer.setBreathInput)
+        kNumSources
+    };
+
+    // Destination units: pitch in semitones, cutoff in octaves, gain in dB, pan in -1..1.
+    // FluidSynth takes gain boosts up to the engine's kFluidModGainHeadroomDb (+6 dB); the
+    // default routes leave gain alone, so a boost needs an explicit kDestGain route.
+    enum Dest : uint8_t {
+        kDestPitch = 0,
+        kDestCutoff,
+        kDestGain,
+        kDestPan,
+        kNumDests
+    };
+
+    enum Curve : uint8_t {
+        kCurveLinear = 0,   // x
+        kCurveExp,          // x * |x|          (slow start)
+        kCurveLog,          // sign(x) * (1 - (1 - |x|)^2)  (fast start)
+        kCurveSCurve,       // 1.5x - 0.5x^3    (soft saturation on -1..1)
+        kCurveBipolar,      // 2x - 1           (unipolar source centred at 0.5)
+        kNumCurves
+    };
+
+    struct Route {
+        Source source = kSrcPressure;
+        Dest dest = kDestGain;
+        Curve curve = kCurveLinear;
+        float amount = 0.0f;
+    };
+
+    ModMatrix();
+
+    // --- Configuration (any non-audio thread) ---
+    // Replaces the whole route table. Picked up by the audio thread at the next block.
+    void setRoutes(const Route *routes, int count);
+    void setLfoRate(int lfo, float hz);
+    // Route set used when nothing else has been configured.
+    static int defaultRoutes(Route *out, int capacity);
+
+    // --- Audio thread ---
+    void setVoiceSource(int voice, Source source, float value) { src_[source][voice] = value; }
+    void setGlobalSource(Source source, float value) { global_[source] = value; }
+    // An inactive lane holds the outputs of its last active block, so a voice in its release
+    // tail keeps its pitch, cutoff, gain and pan until a new note makes the lane active again.
+    void setVoiceActive(int voice, bool active);
+
+    // Evaluates all routes for one block of numFrames at sampleRate (advances the LFOs).
+    void process(int numFrames, double sampleRate);
+
+    // Raw destination rows (kMaxVoices lanes, destination units; 0 for lanes never active).
+    const float *dest(Dest d) const { return dst_[d]; }
+    // Converted rows, valid after process(): pitch as a frequency ratio, cutoff as a frequency
+    // factor, gain as linear amplitude.
+    const float *pitchRatio() const { return pitchRatio_; }
+    const float *cutoffScale() const { return cutoffScale_; }
+    const float *gain() const { return gain_; }
+
+    int activeLaneCount() const { return laneCount_; }
+    int routeCount() const { return routeCount_; }
+
+private:
+    void pullRoutes();
+
+    // Route table shared with the configuring thread: a seqlock over packed 64-bit words,
+    // so the audio thread never waits (a torn read keeps the previous table for one block).
+    std::mutex writerMutex_;            // setRoutes() callers only; the seqlock has one writer
+    std::atomic<uint32_t> routeSeq_{0};
+    std::atomic<int> pendingCount_{0};
+    std::atomic<uint64_t> pendingRoutes_[kMaxRoutes];
+    std::atomic<float> lfoRateHz_[kNumLfos];
+    uint32_t appliedSeq_ = ~0u;
+
+    Route routes_[kMaxRoutes];
+    int routeCount_ = 0;
+
+    double lfoPhase_[kNumLfos] = {0.0, 0.0};
+    float global_[kNumSources] = {};
+    uint32_t activeMask_ = 0;
+    int laneCount_ = 0;
+
+    alignas(32) float src_[kNumSources][kMaxVoices] = {};
+    alignas(32) float dst_[kNumDests][kMaxVoices] = {};
+    alignas(32) float held_[kNumDests][kMaxVoices] = {};   // last active block, per lane
+    alignas(32) float pitchRatio_[kMaxVoices] = {};
+    alignas(32) float cutoffScale_[kMaxVoices] = {};
+    alignas(32) float gain_[kMaxVoices] = {};
+};
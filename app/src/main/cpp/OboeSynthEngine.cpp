@@ -1,12 +1,44 @@
+#include <android/api-level.h>
 #include <jni.h>
 #include <oboe/Oboe.h>
 
+#include "AssetRegistry.h"
+#include "BreathFollower.h"
+#include "BuiltinTables.h"
+#include "CallCapture.h"
+#include "ControlCoalescer.h"
+#include "DeviceProfile.h"
+#include "DspKernels.h"
+#include "EngineStats.h"
+#include "EventQueue.h"
+#include "FastMath.h"
+#include "GranularEngine.h"
+#include "HalfBandUpsampler.h"
+#include "ImportPipeline.h"
+#include "WavetableCache.h"
+#include "ModMatrix.h"
+#include "PcmConvert.h"
+#include "Reclaimer.h"
+#include "RenderGraph.h"
+#include "SmfRecorder.h"
+#include "Ump.h"
+#include "UnisonVoice.h"
+#include "Visualization.h"
+#include "VoiceLeading.h"
+
 #include <atomic>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #ifdef HAVE_FLUIDSYNTH
 #include <fluidsynth.h>
@@ -14,41 +46,71 @@
 
 namespace {
 
+    // Callback of the probeDevice() stream: spins for part of each block, standing in for the
+    // synth's render so underruns show up at realistic callback durations, then writes silence.
+    class ProbeCallback final : public oboe::AudioStreamCallback {
+    public:
+        static constexpr double kLoadFraction = 0.5;
+
+        oboe::DataCallbackResult onAudioReady(oboe::AudioStream* stream, void* audioData, int32_t numFrames) override {
+            const auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(
+                    static_cast<int64_t>(kLoadFraction * 1e9 * numFrames / stream->getSampleRate()));
+            while (std::chrono::steady_clock::now() < until) {}
+            std::memset(audioData, 0, sizeof(float) * static_cast<size_t>(numFrames) * 2);
+            return oboe::DataCallbackResult::Continue;
+        }
+    };
+
     class OboeSynthEngine final : public oboe::AudioStreamCallback {
     public:
-        OboeSynthEngine() = default;
+        OboeSynthEngine() {
+            // Probes the CPU once and binds the widest DSP kernel variant it supports.
+            stats_.set(kStatDspIsa, static_cast<int64_t>(dsp::bindBest()));
+            stats_.set(kStatDspIsasAvailable, dsp::availableIsas());
+            stats_.set(kStatDeviceTier, -1);
+            initChannels();
+            buildRenderGraph();
+        }
 
         ~OboeSynthEngine() override {
+            stopRecoveryThread();
             close();
             shutdownFluidSynth();
         }
 
+        // Warm restart: stop() leaves FluidSynth, loaded banks, the asset registry and channel
+        // state resident, so start() after stop() only restarts the stream (reopening it only if
+        // it was closed or disconnected meanwhile). The first callbacks render muted to prime
+        // caches and flush events queued while stopped; start-to-first-unmuted-callback time
+        // is reported as kStatStartLatencyUs.
         bool start() {
-            if (!stream_) {
-                if (!openStream()) return false;
-            }
-            isPlaying_.store(true, std::memory_order_release);
-            return stream_->requestStart() == oboe::Result::OK;
+            std::lock_guard<std::mutex> guard(streamMutex_);
+            stats_.add(kStatStarts);
+            return startLocked(nowNanos());
         }
 
         void stop() {
+            std::lock_guard<std::mutex> guard(streamMutex_);
             isPlaying_.store(false, std::memory_order_release);
             if (stream_) stream_->requestStop();
+            if (inputStream_) inputStream_->requestStop();
         }
 
         void close() {
-            stop();
-            if (stream_) {
-                stream_->close();
-                stream_.reset();
-            }
+            std::lock_guard<std::mutex> guard(streamMutex_);
+            isPlaying_.store(false, std::memory_order_release);
+            closeInputLocked();
+            closeStreamLocked();
         }
 
 #ifdef HAVE_FLUIDSYNTH
         // Keep these defaults close to what your current file used (but without any logcat).
         static constexpr double kFluidSynthMasterGain = 0.7;
-        static constexpr int    kFluidSynthPolyphony  = 64;
-        static constexpr int    kFluidSynthInterpolation = 1; // 1=linear
+        // FluidSynth can only attenuate a channel (GEN_ATTENUATION offsets below 0 are clamped),
+        // so the synth runs this much hotter and every channel rests this far down: the
+        // ModMatrix gain destination can then raise FluidSynth by up to this much, like the
+        // wavetable voices. Covers the default pressure route (+6 dB); more saturates.
+        static constexpr float kFluidModGainHeadroomDb = 6.0f;
 
         static constexpr bool   kFluidSynthReverbActive = true;
         static constexpr double kFluidSynthReverbRoomSize = 0.45;
@@ -72,41 +134,50 @@ namespace {
             return false;
 #else
             if (fs_initialized_) return true;
+            // Polyphony, interpolation and effects come from the device profile (DeviceProfile.h).
+            const DeviceProfile profile = deviceProfile();
 
             if (!fs_settings_) {
                 fs_settings_ = new_fluid_settings();
                 if (!fs_settings_) return false;
             }
 
-            // Match output sample rate.
-            const double sr = sampleRate_.load(std::memory_order_relaxed);
-            fluid_settings_setnum(fs_settings_, "synth.sample-rate", sr);
+            // Match output sample rate (half of it in low-power render).
+            fluid_settings_setnum(fs_settings_, "synth.sample-rate", synthRate());
 
             // Core tuning.
-            fluid_settings_setnum(fs_settings_, "synth.gain", kFluidSynthMasterGain);
-            fluid_settings_setint(fs_settings_, "synth.polyphony", kFluidSynthPolyphony);
-            fluid_settings_setint(fs_settings_, "synth.interpolation", kFluidSynthInterpolation);
+            fluid_settings_setnum(fs_settings_, "synth.gain",
+                                  kFluidSynthMasterGain * fastmath::dbToGain(kFluidModGainHeadroomDb));
+            fluid_settings_setint(fs_settings_, "synth.polyphony", profile.polyphony);
+            fluid_settings_setint(fs_settings_, "synth.interpolation", profile.interpolation);
 
             // Reverb.
-            fluid_settings_setint(fs_settings_, "synth.reverb.active", kFluidSynthReverbActive ? 1 : 0);
+            fluid_settings_setint(fs_settings_, "synth.reverb.active", kFluidSynthReverbActive && profile.effects ? 1 : 0);
             fluid_settings_setnum(fs_settings_, "synth.reverb.room-size", kFluidSynthReverbRoomSize);
             fluid_settings_setnum(fs_settings_, "synth.reverb.damp", kFluidSynthReverbDamp);
             fluid_settings_setnum(fs_settings_, "synth.reverb.level", kFluidSynthReverbLevel);
             fluid_settings_setnum(fs_settings_, "synth.reverb.width", kFluidSynthReverbWidth);
 
             // Chorus.
-            fluid_settings_setint(fs_settings_, "synth.chorus.active", kFluidSynthChorusActive ? 1 : 0);
+            fluid_settings_setint(fs_settings_, "synth.chorus.active", kFluidSynthChorusActive && profile.effects ? 1 : 0);
             fluid_settings_setint(fs_settings_, "synth.chorus.nr", kFluidSynthChorusNr);
             fluid_settings_setnum(fs_settings_, "synth.chorus.level", kFluidSynthChorusLevel);
             fluid_settings_setnum(fs_settings_, "synth.chorus.depth", kFluidSynthChorusDepth);
             fluid_settings_setnum(fs_settings_, "synth.chorus.speed", kFluidSynthChorusSpeed);
 
-            fs_synth_ = new_fluid_synth(fs_settings_);
-            if (!fs_synth_) {
+            fluid_synth_t* synth = new_fluid_synth(fs_settings_);
+            if (!synth) {
                 delete_fluid_settings(fs_settings_);
                 fs_settings_ = nullptr;
                 return false;
             }
+            // Channels start at rest (no modulation), i.e. kFluidModGainHeadroomDb down.
+            for (int ch = 0; ch < kNumChannels; ++ch) {
+                std::fill(std::begin(appliedGen_[ch]), std::end(appliedGen_[ch]), 0.0f);
+                appliedGen_[ch][2] = fluidAttenuation(0.0f);
+                fluid_synth_set_gen(synth, ch, GEN_ATTENUATION, appliedGen_[ch][2]);
+            }
+            fs_synth_ = synth;
 
             fs_initialized_ = true;
             loaded_soundfont_id_ = -1;
@@ -155,12 +226,282 @@ namespace {
 #endif
         }
 
+        // ---------------------- Event input (any thread) ----------------------
+        // JNI entry points post fixed-size events; the callback drains them at the start of
+        // each block, applying notes in order and coalescing continuous controls.
+        static constexpr int kNumChannels = ModMatrix::kMaxVoices;
+        static constexpr size_t kEventQueueCapacity = 1024;
+        // Frames between smoothed control updates inside one callback.
+        static constexpr int32_t kControlSubBlock = 64;
+        static_assert(kControlSubBlock <= RenderGraph::kMaxFrames, "sub-blocks must fit the graph buffers");
+
+        bool postEvent(const EngineEvent& e) {
+            if (!events_.push(e)) {
+                stats_.add(kStatEventsDropped);
+                return false;
+            }
+            stats_.add(kStatEventsReceived);
+            performance_.record(e);
+            return true;
+        }
+
+        // Posts each packet of a UMP word stream as one event; returns the number of words
+        // consumed (a truncated trailing packet is left for the caller).
+        int postUmp(const uint32_t* words, int numWords) {
+            int offset = 0;
+            int64_t ignored = 0;
+            while (offset < numWords) {
+                const int size = ump::packetWords(words[offset]);
+                if (offset + size > numWords) break;
+                EngineEvent e;
+                if (ump::toEvent(words + offset, size, e)) {
+                    postEvent(e);
+                } else {
+                    ++ignored;
+                }
+                stats_.add(kStatUmpPackets);
+                offset += size;
+            }
+            if (ignored) stats_.add(kStatUmpIgnored, ignored);
+            return offset;
+        }
+
+        void setConductor(float flow, float height, float grip) {
+            conductorFlow_.store(std::clamp(flow, 0.0f, 1.0f), std::memory_order_relaxed);
+            conductorHeight_.store(std::clamp(height, 0.0f, 1.0f), std::memory_order_relaxed);
+            conductorGrip_.store(std::clamp(grip, 0.0f, 1.0f), std::memory_order_relaxed);
+        }
+
+        // ---------------------- Low-power render (control thread) ----------------------
+        // FluidSynth renders at half the stream rate and upsampler_ restores the stream rate,
+        // roughly halving synth CPU. Switching fades the output out over one sub-block, changes
+        // the synth rate while the callback is not rendering, then fades back in; held voices
+        // keep playing. Without FluidSynth only the flag is stored.
+        bool setLowPowerRender(bool enabled) {
+            std::lock_guard<std::mutex> guard(streamMutex_);
+            if (halfRateRequested_.load(std::memory_order_relaxed) == enabled) return true;
+
+            const bool running = isPlaying_.load(std::memory_order_acquire) && stream_
+                    && stream_->getState() == oboe::StreamState::Started;
+            bool muted = !running;
+            if (running) {
+                renderSwitch_.store(kSwitchFadeOut, std::memory_order_release);
+                for (int i = 0; i < kSwitchTimeoutMs && !muted; ++i) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    muted = renderSwitch_.load(std::memory_order_acquire) == kSwitchMuted;
+                }
+            }
+
+            halfRateRequested_.store(enabled, std::memory_order_release);
+#ifdef HAVE_FLUIDSYNTH
+            if (fs_synth_) setFluidSampleRate(synthRate());
+#endif
+            renderSwitch_.store(running ? kSwitchFadeIn : kSwitchIdle, std::memory_order_release);
+            return muted;
+        }
+
+        // ---------------------- Breath input (control thread) ----------------------
+        // Full duplex: a low-latency mono input stream without a callback, drained
+        // non-blocking from the output callback and fed to breath_, so the breath envelope
+        // (ModMatrix::kSrcBreath, CC2 to FluidSynth) and its onsets follow the microphone
+        // within one output block. Needs RECORD_AUDIO. Returns false if the input cannot be
+        // opened; enabling again after an input error reopens it.
+        bool setBreathInput(bool enabled) {
+            std::lock_guard<std::mutex> guard(streamMutex_);
+            if (enabled && inputStream_ && input_.load(std::memory_order_acquire)) return true;
+            closeInputLocked();
+            if (!enabled) return true;
+
+            oboe::AudioStreamBuilder builder;
+            builder.setDirection(oboe::Direction::Input);
+            builder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
+            builder.setSharingMode(oboe::SharingMode::Exclusive);
+            builder.setFormat(oboe::AudioFormat::Float);
+            builder.setChannelCount(1);
+            builder.setInputPreset(oboe::InputPreset::VoicePerformance);
+            builder.setSampleRate(static_cast<int32_t>(sampleRate_.load(std::memory_order_relaxed)));
+            if (builder.openStream(inputStream_) != oboe::Result::OK) {
+                inputStream_.reset();
+                return false;
+            }
+            // Not published yet, so the callback is not inside breath_.
+            breath_.configure(BreathFollower::Params{}, inputStream_->getSampleRate());
+            breath_.reset();
+            if (isPlaying_.load(std::memory_order_acquire) && inputStream_->requestStart() != oboe::Result::OK) {
+                closeInputLocked();
+                return false;
+            }
+            input_.store(inputStream_.get(), std::memory_order_seq_cst);
+            return true;
+        }
+
+        // ---------------------- Device profile (control threads) ----------------------
+        // Applies a DeviceProfile: the stream's buffer depth, low-power render and the default
+        // unison copies at once; FluidSynth polyphony, interpolation and effects at
+        // initFluidSynth(), so load or probe before that.
+        void applyDeviceProfile(const DeviceProfile& profile) {
+            {
+                std::lock_guard<std::mutex> guard(streamMutex_);
+                profile_ = profile;
+                if (stream_) applyBufferDepthLocked();
+            }
+            unisonCopies_.store(profile.unisonCopies, std::memory_order_relaxed);
+            stats_.set(kStatDeviceTier, profile.tier);
+            setLowPowerRender(profile.lowPowerRender);
+        }
+
+        DeviceProfile deviceProfile() {
+            std::lock_guard<std::mutex> guard(streamMutex_);
+            return profile_;
+        }
+
+        // Applies the profile saved at path; returns its tier, -1 if there is none (or it is
+        // from another DeviceProfile::kVersion).
+        int loadDeviceProfile(const char* path) {
+            DeviceProfile profile;
+            if (!DeviceProfile::load(path, profile)) return -1;
+            applyDeviceProfile(profile);
+            return profile.tier;
+        }
+
+        // First-launch self-benchmark, ~2 s on the calling (background) thread: probes a stream,
+        // times the kernels, then chooses, saves (to path) and applies a profile. Returns its
+        // tier; -1 if it could not be saved, in which case it is still applied for this run.
+        // The engine's own stream is closed while the probe stream runs (an Exclusive stream
+        // of ours would otherwise be what it measures); a start() meanwhile takes effect after.
+        int probeDevice(const char* path) {
+            DeviceProfile::Measurements m;
+            {
+                std::lock_guard<std::mutex> guard(streamMutex_);
+                probing_ = true;
+                if (inputStream_) inputStream_->requestStop();
+                closeStreamLocked();
+            }
+            probeStream(m);
+            {
+                std::lock_guard<std::mutex> guard(streamMutex_);
+                probing_ = false;
+                if (isPlaying_.load(std::memory_order_acquire)) startLocked(nowNanos());
+            }
+            DeviceProfile::measureKernels(m);
+            const DeviceProfile profile = DeviceProfile::choose(m);
+            const bool saved = profile.save(path);
+            applyDeviceProfile(profile);
+            return saved ? profile.tier : -1;
+        }
+
+        // ---------------------- Asset import (non-audio threads) ----------------------
+        AssetRegistry& assets() { return assets_; }
+
+        // Worker pool is started on first use.
+        ImportPipeline& importer() {
+            std::lock_guard<std::mutex> guard(importerMutex_);
+            if (!importer_) {
+                importer_ = std::make_unique<ImportPipeline>(assets_, sampleRate_.load(std::memory_order_relaxed));
+                importer_->setWavetableCache(&wavetableCache_);
+            }
+            return *importer_;
+        }
+
+        // The pipeline if an import was ever submitted, else nullptr; never starts the pool.
+        // Once created it lives as long as the engine.
+        ImportPipeline* importerIfStarted() {
+            std::lock_guard<std::mutex> guard(importerMutex_);
+            return importer_.get();
+        }
+
+        // Maps the wavetable cache. Only before the first import, so no worker is reading it.
+        bool openWavetableCache(const char* path) {
+            std::lock_guard<std::mutex> guard(importerMutex_);
+            if (importer_) return false;
+            return wavetableCache_.open(path);
+        }
+
+        bool flushWavetableCache() { return wavetableCache_.flush(); }
+
+        // Registers caller PCM (interleaved int16 or float, native byte order) as a wavetable
+        // (kind 0) or sample (kind 1) without a WAV round trip. The buffer is converted to
+        // mono float in place; a sample then references it directly (adopted) and release
+        // runs when the asset is destroyed. Otherwise the engine keeps nothing of the buffer
+        // and release runs before returning. Returns the slot or -1. Non-audio threads.
+        int registerPcm(int kind, void* buffer, size_t capacityBytes, pcm::SampleFormat format, int channels,
+                        size_t frames, double sampleRate, int slot, std::function<void()> release, bool& adopted) {
+            adopted = false;
+            const bool ok = buffer && frames > 0 && channels >= 1 && channels <= kMaxPcmChannels
+                    && capacityBytes / (pcm::bytesPerSample(format) * static_cast<size_t>(channels)) >= frames
+                    && (kind == kGranularWavetable || sampleRate > 0.0);
+            float* mono = ok ? pcm::toMonoInPlace(buffer, capacityBytes, format, channels, frames) : nullptr;
+            int result = -1;
+            if (ok && kind == kGranularWavetable) {
+                if (mono) {
+                    result = assets_.publishWavetable(std::make_unique<Wavetable>(mono, frames), slot);
+                } else {
+                    // Misaligned, or mono int16 without room for floats: convert into scratch.
+                    std::unique_ptr<float[]> scratch(new float[frames]);
+                    pcm::downmixToMono(buffer, format, channels, frames, scratch.get());
+                    result = assets_.publishWavetable(std::make_unique<Wavetable>(scratch.get(), frames), slot);
+                }
+            } else if (ok && kind == kGranularSample) {
+                auto asset = std::make_unique<SampleAsset>();
+                asset->sampleRate = sampleRate;
+                if (mono) {
+                    pcm::normalizePeak(mono, frames);
+                    asset->external = mono;
+                    asset->externalFrames = frames;
+                    asset->releaseExternal = std::move(release);
+                    release = nullptr;
+                    adopted = true;
+                } else {
+                    asset->frames.resize(frames);
+                    pcm::downmixToMono(buffer, format, channels, frames, asset->frames.data());
+                    pcm::normalizePeak(asset->frames.data(), frames);
+                }
+                // A failed publish destroys the asset, which releases an adopted buffer.
+                result = assets_.publishSample(std::move(asset), slot);
+                if (result < 0) adopted = false;
+            }
+            if (release) release();
+            return result;
+        }
+
+        // Plays notes on a registered wavetable as well (slot < 0 turns the layer off). Each
+        // channel's note is one UnisonVoice of `copies` detuned copies; applies from the next
+        // note on. Any thread.
+        bool setWavetableVoice(int slot, int copies, float detuneCents, float spread) {
+            if (slot >= AssetRegistry::kMaxWavetables || copies < 1 || copies > UnisonVoice::kMaxCopies) return false;
+            unisonCopies_.store(copies, std::memory_order_relaxed);
+            unisonDetune_.store(std::max(0.0f, detuneCents), std::memory_order_relaxed);
+            unisonSpread_.store(std::clamp(spread, 0.0f, 1.0f), std::memory_order_relaxed);
+            wavetableSlot_.store(slot < 0 ? -1 : slot, std::memory_order_release);
+            return true;
+        }
+
+        // Granular texture over a registered sample (kind 1) or wavetable (kind 0, looped at
+        // kGranularWavetableNote); slot < 0 turns it off. The conductor plays it: flow sets
+        // the grain density, height the read position, grip the pitch spread. Any thread.
+        bool setGranularSource(int kind, int slot) {
+            if (kind != kGranularWavetable && kind != kGranularSample) return false;
+            const int slots = kind == kGranularSample ? AssetRegistry::kMaxSamples : AssetRegistry::kMaxWavetables;
+            if (slot >= slots) return false;
+            granularSource_.store(slot < 0 ? -1 : (kind << 16) | slot, std::memory_order_release);
+            return true;
+        }
+
+        ModMatrix& modMatrix() { return modMatrix_; }
+        const EngineStats& stats() const { return stats_; }
+        const RenderGraph& renderGraph() const { return graph_; }
+        CallCapture& capture() { return capture_; }
+        SmfRecorder& performance() { return performance_; }
+
         // ---------------------- Audio callback ----------------------
         oboe::DataCallbackResult onAudioReady(
                 oboe::AudioStream* audioStream,
                 void* audioData,
                 int32_t numFrames
         ) override {
+            // Tables, samples and graph plans loaded in this block (and the engine itself) stay
+            // alive until the guard is released; see Reclaimer.
+            Reclaimer::Guard epoch(Reclaimer::instance());
             float* out = static_cast<float*>(audioData);
             const int channels = audioStream->getChannelCount();
 
@@ -169,23 +510,752 @@ namespace {
                 return oboe::DataCallbackResult::Continue;
             }
 
-#ifdef HAVE_FLUIDSYNTH
-            if (fs_synth_) {
-                // Always render stereo float (LR interleaved)
-                fluid_synth_write_float(fs_synth_, numFrames, out, 0, 2, out, 1, 2);
-                return oboe::DataCallbackResult::Continue;
-            }
-#endif
+            render(out, numFrames, channels);
 
-            std::memset(out, 0, sizeof(float) * static_cast<size_t>(numFrames) * static_cast<size_t>(channels));
+            // Priming after start(): the full path runs (warming caches, applying queued events)
+            // but the output is muted.
+            const int prime = primeCallbacks_.load(std::memory_order_relaxed);
+            if (prime > 0) {
+                std::memset(out, 0, sizeof(float) * static_cast<size_t>(numFrames) * static_cast<size_t>(channels));
+                primeCallbacks_.store(prime - 1, std::memory_order_relaxed);
+            } else {
+                const int64_t t0 = startNanos_.load(std::memory_order_relaxed);
+                if (t0 != 0) {
+                    stats_.set(kStatStartLatencyUs, (nowNanos() - t0) / 1000);
+                    startNanos_.store(0, std::memory_order_relaxed);
+                }
+            }
+            publishVisualization(out, numFrames);
             return oboe::DataCallbackResult::Continue;
         }
 
+        // Meters of the block just rendered for readVisualization(). A channel's level is its
+        // wavetable voice envelope, or for a held FluidSynth note its velocity (or pressure, if
+        // higher), so the meters move whichever layer is sounding.
+        void publishVisualization(const float* out, int32_t numFrames) {
+            float levels[vis::kChannels];
+            for (int ch = 0; ch < vis::kChannels; ++ch) {
+                const ChannelState& c = channelState_[ch];
+                const float held = c.held > 0 ? std::max(c.velocity, c.pressure.current() * (1.0f / 127.0f)) : 0.0f;
+                levels[ch] = std::max(unisonVoices_[ch].level(), held);
+            }
+            visualization_.publish(out, numFrames, levels, activeWavetableVoices_ + fluidVoices_);
+        }
+
+        // UI thread (one reader): newest published meters.
+        uint32_t readVisualization(void* dst) { return visualization_.read(dst); }
+
+        // Route change, headphone unplug, device loss: Oboe has already closed the stream.
+        // Reopening must not happen on this (Oboe-owned) thread, so hand it to the helper.
         void onErrorAfterClose(oboe::AudioStream*, oboe::Result) override {
-            stream_.reset();
+            Reclaimer::Guard epoch(Reclaimer::instance());   // nativeDelete may retire the engine meanwhile
+            stats_.add(kStatStreamDisconnects);
+            {
+                std::lock_guard<std::mutex> guard(recoveryMutex_);
+                if (recoveryExit_) return;
+                recoveryNanos_ = nowNanos();
+                recoveryRequested_ = true;
+                if (!recoveryThread_.joinable()) recoveryThread_ = std::thread([this] { recoveryLoop(); });
+            }
+            recoveryWake_.notify_one();
         }
 
     private:
+        static int64_t nowNanos() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // ---------------------- Stream lifecycle (streamMutex_ held) ----------------------
+        bool startLocked(int64_t t0) {
+            if (probing_) {
+                isPlaying_.store(true, std::memory_order_release);   // probeDevice() starts it
+                return true;
+            }
+            if (!streamUsable()) {
+                closeStreamLocked();
+                if (!openStream()) return false;
+                stats_.add(kStatStreamOpens);
+            }
+            startNanos_.store(t0, std::memory_order_relaxed);
+            primeCallbacks_.store(kPrimeCallbacks, std::memory_order_relaxed);
+            isPlaying_.store(true, std::memory_order_release);
+            if (inputStream_) inputStream_->requestStart();
+            return stream_->requestStart() == oboe::Result::OK;
+        }
+
+        void closeStreamLocked() {
+            if (stream_) {
+                stream_->close();
+                stream_.reset();
+            }
+        }
+
+        // Profile buffer depth in bursts; 0 leaves Oboe's default.
+        void applyBufferDepthLocked() {
+            if (profile_.bufferBursts > 0) {
+                stream_->setBufferSizeInFrames(profile_.bufferBursts * stream_->getFramesPerBurst());
+            }
+        }
+
+        // Native rate, burst size and the shallowest buffer (in bursts) that runs ProbeCallback
+        // without underruns, on a stream of its own. Leaves the defaults in m where the device
+        // does not report them.
+        static void probeStream(DeviceProfile::Measurements& m) {
+            ProbeCallback callback;
+            oboe::AudioStreamBuilder builder;
+            builder.setDirection(oboe::Direction::Output);
+            builder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
+            builder.setSharingMode(oboe::SharingMode::Exclusive);
+            builder.setFormat(oboe::AudioFormat::Float);
+            builder.setChannelCount(2);
+            builder.setCallback(&callback);
+            std::shared_ptr<oboe::AudioStream> stream;
+            if (builder.openStream(stream) != oboe::Result::OK) return;
+
+            m.sampleRate = stream->getSampleRate();
+            m.framesPerBurst = stream->getFramesPerBurst();
+            if (stream->requestStart() == oboe::Result::OK) {
+                stream->setBufferSizeInFrames(kProbeMaxBursts * m.framesPerBurst);
+                std::this_thread::sleep_for(std::chrono::milliseconds(kProbeSettleMs));
+                for (int bursts = 1; bursts <= kProbeMaxBursts; ++bursts) {
+                    if (!stream->setBufferSizeInFrames(bursts * m.framesPerBurst)) break;
+                    const oboe::ResultWithValue<int32_t> before = stream->getXRunCount();
+                    if (!before) break;   // not reported: keep the default depth
+                    std::this_thread::sleep_for(std::chrono::milliseconds(kProbeListenMs));
+                    const oboe::ResultWithValue<int32_t> after = stream->getXRunCount();
+                    if (after && after.value() == before.value()) {
+                        m.bufferBursts = bursts;
+                        break;
+                    }
+                    m.bufferBursts = std::min(bursts + 1, kProbeMaxBursts);
+                }
+                stream->stop();
+            }
+            stream->close();
+        }
+
+        // Unpublishes the input and waits out a read in flight before closing it.
+        void closeInputLocked() {
+            input_.store(nullptr, std::memory_order_seq_cst);
+            while (inputInUse_.load(std::memory_order_seq_cst)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            if (inputStream_) {
+                inputStream_->stop();
+                inputStream_->close();
+                inputStream_.reset();
+            }
+        }
+
+        // Reopens with the same parameters after a disconnect, retrying with backoff. Held
+        // notes and controller state live in FluidSynth and channelState_, which are untouched,
+        // so playing resumes where it stopped. A stopped engine is left closed for start().
+        void recoveryLoop() {
+            std::unique_lock<std::mutex> lock(recoveryMutex_);
+            for (;;) {
+                recoveryWake_.wait(lock, [this] { return recoveryExit_ || recoveryRequested_; });
+                if (recoveryExit_) return;
+                recoveryRequested_ = false;
+                const int64_t t0 = recoveryNanos_;
+                lock.unlock();
+
+                int backoffMs = kRecoveryBackoffMs;
+                for (int attempt = 0; attempt < kRecoveryMaxAttempts; ++attempt) {
+                    const ReopenResult r = tryReopen(t0);
+                    if (r == ReopenResult::kRecovered) {
+                        stats_.add(kStatStreamRecoveries);
+                        stats_.set(kStatLastRecoveryUs, (nowNanos() - t0) / 1000);
+                    }
+                    if (r != ReopenResult::kRetry) break;
+                    // The new route may still be coming up; back off without holding the stream lock.
+                    lock.lock();
+                    const bool exiting = recoveryWake_.wait_for(lock, std::chrono::milliseconds(backoffMs),
+                                                                [this] { return recoveryExit_; });
+                    lock.unlock();
+                    if (exiting) return;
+                    backoffMs *= 2;
+                }
+                lock.lock();
+            }
+        }
+
+        enum class ReopenResult { kRecovered, kRetry, kIdle };
+
+        ReopenResult tryReopen(int64_t t0) {
+            std::lock_guard<std::mutex> guard(streamMutex_);
+            if (!isPlaying_.load(std::memory_order_acquire)) {
+                // Stopped before or during recovery: drop the dead stream, start() reopens it.
+                closeStreamLocked();
+                return ReopenResult::kIdle;
+            }
+            if (streamUsable() && stream_->getState() == oboe::StreamState::Started) {
+                return ReopenResult::kIdle;  // start() already reopened it
+            }
+            stats_.add(kStatStreamReopenAttempts);
+            return startLocked(t0) ? ReopenResult::kRecovered : ReopenResult::kRetry;
+        }
+
+        void stopRecoveryThread() {
+            {
+                std::lock_guard<std::mutex> guard(recoveryMutex_);
+                recoveryExit_ = true;
+            }
+            recoveryWake_.notify_one();
+            if (recoveryThread_.joinable()) recoveryThread_.join();
+        }
+
+        bool streamUsable() const {
+            if (!stream_) return false;
+            const oboe::StreamState st = stream_->getState();
+            return st != oboe::StreamState::Closed && st != oboe::StreamState::Closing
+                    && st != oboe::StreamState::Disconnected;
+        }
+
+        void render(float* out, int32_t numFrames, int channels) {
+            // While the control thread changes the synth rate nothing touches FluidSynth;
+            // queued events wait for the next block.
+            const int renderSwitch = renderSwitch_.load(std::memory_order_acquire);
+            if (renderSwitch == kSwitchMuted) {
+                std::memset(out, 0, sizeof(float) * static_cast<size_t>(numFrames) * static_cast<size_t>(channels));
+                return;
+            }
+            if (renderSwitch != kSwitchFadeOut) adoptRenderRate();
+
+            drainEvents(numFrames);
+            pollBreathInput();
+            updateModulation(numFrames);
+#ifdef HAVE_FLUIDSYNTH
+            if (fs_synth_) applyModulationToFluidSynth();
+#endif
+
+            // Render in sub-blocks so smoothed controls move inside the callback. The graph
+            // always renders stereo float (LR interleaved).
+            int64_t nodesRun = 0, nodesSkipped = 0;
+            activeWavetableVoices_ = 0;
+            fluidVoices_ = 0;
+            for (int32_t offset = 0; offset < numFrames; offset += kControlSubBlock) {
+                const int32_t n = std::min(kControlSubBlock, numFrames - offset);
+                advanceSmoothers(n);
+                graph_.render(out + static_cast<size_t>(offset) * 2, n);
+                nodesRun += graph_.lastRun();
+                nodesSkipped += graph_.lastSkipped();
+            }
+            stats_.set(kStatWavetableVoices, activeWavetableVoices_);
+            stats_.set(kStatGraphNodesRun, nodesRun);
+            stats_.set(kStatGraphNodesSkipped, nodesSkipped);
+            stats_.set(kStatGranularGrains, granular_.activeGrains());
+            stats_.set(kStatGranularDropped, granular_.droppedGrains());
+
+            if (renderSwitch == kSwitchFadeOut) {
+                applyRamp(out, numFrames, 1.0f, 0.0f);
+                renderSwitch_.store(kSwitchMuted, std::memory_order_release);
+            } else if (renderSwitch == kSwitchFadeIn) {
+                applyRamp(out, numFrames, 0.0f, 1.0f);
+                int expected = kSwitchFadeIn;
+                renderSwitch_.compare_exchange_strong(expected, kSwitchIdle, std::memory_order_acq_rel);
+            }
+        }
+
+        // Render-rate handshake between setLowPowerRender() and the callback.
+        enum RenderSwitch : int {
+            kSwitchIdle = 0,
+            kSwitchFadeOut,   // control -> audio: ramp this block down, then report muted
+            kSwitchMuted,     // audio -> control: not rendering, safe to change the synth rate
+            kSwitchFadeIn,    // control -> audio: ramp this block up
+        };
+        static constexpr int kSwitchTimeoutMs = 100;
+
+        // Audio thread: picks up a changed render rate (also when switched while stopped).
+        void adoptRenderRate() {
+            const bool half = halfRateRequested_.load(std::memory_order_acquire);
+            if (half == halfRate_) return;
+            halfRate_ = half;
+            hasCarry_ = false;
+            upsampler_.reset();
+            stats_.set(kStatLowPowerRender, half ? 1 : 0);
+        }
+
+        static void applyRamp(float* out, int32_t numFrames, float from, float to) {
+            const float step = (to - from) / static_cast<float>(numFrames > 0 ? numFrames : 1);
+            float g = from;
+            for (int32_t i = 0; i < numFrames; ++i, g += step) {
+                out[2 * i] *= g;
+                out[2 * i + 1] *= g;
+            }
+        }
+
+        // Adds the wavetable layer for n frames at the stream rate (also in low-power mode: the
+        // voices are cheap, only FluidSynth is slowed down). Pitch follows the channel's bend and
+        // the pitch route; cutoff and gain come from the mod matrix.
+        void renderWavetableVoices(float* dst, int32_t n) {
+            const int slot = wavetableSlot_.load(std::memory_order_acquire);
+            const Wavetable* table = slot >= 0 ? assets_.wavetable(slot) : nullptr;
+            const double sr = sampleRate_.load(std::memory_order_relaxed);
+            const float* pitchRatio = modMatrix_.pitchRatio();
+            const float* cutoffScale = modMatrix_.cutoffScale();
+            const float* gain = modMatrix_.gain();
+            int active = 0;
+            for (int ch = 0; ch < kNumChannels; ++ch) {
+                UnisonVoice& v = unisonVoices_[ch];
+                if (!v.active()) continue;
+                if (!table) {
+                    v.reset();
+                    continue;
+                }
+                const int bend = static_cast<int>(std::lround(channelState_[ch].bend.current()));
+                const float inc = builtin::noteIncrement(v.note(), sr) * builtin::bendToRatio(bend, kWavetableBendRange)
+                        * pitchRatio[ch];
+                v.render(*table, inc, kWavetableCutoffHz * cutoffScale[ch], gain[ch] * kWavetableHeadroom, sr, dst, n);
+                ++active;
+            }
+            activeWavetableVoices_ = active;
+        }
+
+        void startWavetableVoice(int ch, int note, float velocity) {
+            if (wavetableSlot_.load(std::memory_order_acquire) < 0) return;
+            UnisonVoice::Params p;
+            p.copies = unisonCopies_.load(std::memory_order_relaxed);
+            p.detuneCents = unisonDetune_.load(std::memory_order_relaxed);
+            p.spread = unisonSpread_.load(std::memory_order_relaxed);
+            voiceSeed_ = voiceSeed_ * 1664525u + 1013904223u;
+            unisonVoices_[ch].noteOn(p, note, velocity, voiceSeed_);
+        }
+
+        void stopWavetableVoice(int ch, int note) {
+            UnisonVoice& v = unisonVoices_[ch];
+            if (v.held() && v.note() == note) v.noteOff();
+        }
+
+        // ---------------------- Render graph ----------------------
+        // Sources feed the master mix; graph_ skips a source while it is silent. New stages
+        // (buses, effects) are nodes connected here, not edits to render().
+        class FluidSynthNode final : public RenderNode {
+        public:
+            explicit FluidSynthNode(OboeSynthEngine& engine) : RenderNode("fluidsynth"), engine_(engine) {}
+            bool active() const override { return engine_.fluidSounding(); }
+            bool process(const float* const*, int, float* out, int frames) override {
+                return engine_.renderFluidSynth(out, frames);
+            }
+        private:
+            OboeSynthEngine& engine_;
+        };
+
+        class WavetableNode final : public RenderNode {
+        public:
+            explicit WavetableNode(OboeSynthEngine& engine) : RenderNode("wavetable"), engine_(engine) {}
+            bool active() const override {
+                for (const UnisonVoice& v : engine_.unisonVoices_) {
+                    if (v.active()) return true;
+                }
+                return false;
+            }
+            bool process(const float* const*, int, float* out, int frames) override {
+                std::memset(out, 0, sizeof(float) * 2 * static_cast<size_t>(frames));
+                engine_.renderWavetableVoices(out, frames);
+                return engine_.activeWavetableVoices_ > 0;
+            }
+        private:
+            OboeSynthEngine& engine_;
+        };
+
+        class GranularNode final : public RenderNode {
+        public:
+            explicit GranularNode(OboeSynthEngine& engine) : RenderNode("granular"), engine_(engine) {}
+            bool active() const override { return engine_.granularSounding(); }
+            bool process(const float* const*, int, float* out, int frames) override {
+                std::memset(out, 0, sizeof(float) * 2 * static_cast<size_t>(frames));
+                engine_.renderGranular(out, frames);
+                return true;
+            }
+        private:
+            OboeSynthEngine& engine_;
+        };
+
+        void buildRenderGraph() {
+            const int master = graph_.addNode(&masterNode_);
+            graph_.connect(graph_.addNode(&fluidNode_), master);
+            graph_.connect(graph_.addNode(&wavetableNode_), master);
+            graph_.connect(graph_.addNode(&granularNode_), master);
+            graph_.setOutput(master);
+            graph_.compile();
+        }
+
+        // Keeps FluidSynth running while it has voices and for kFluidTailSeconds after the
+        // last one, so reverb and chorus tails ring out before the node is skipped.
+        bool fluidSounding() const {
+#ifdef HAVE_FLUIDSYNTH
+            return fs_synth_ && (fluid_synth_get_active_voice_count(fs_synth_) > 0 || fluidTailFrames_ > 0);
+#else
+            return false;
+#endif
+        }
+
+        bool renderFluidSynth(float* dst, int32_t n) {
+#ifdef HAVE_FLUIDSYNTH
+            if (!fs_synth_) return false;
+            if (halfRate_) {
+                renderHalfRate(dst, n);
+            } else {
+                fluid_synth_write_float(fs_synth_, n, dst, 0, 2, dst, 1, 2);
+            }
+            fluidVoices_ = fluid_synth_get_active_voice_count(fs_synth_);
+            if (fluidVoices_ > 0) {
+                fluidTailFrames_ = static_cast<int32_t>(kFluidTailSeconds * sampleRate_.load(std::memory_order_relaxed));
+            } else {
+                fluidTailFrames_ = std::max<int32_t>(0, fluidTailFrames_ - n);
+            }
+            return true;
+#else
+            (void)dst; (void)n;
+            return false;
+#endif
+        }
+
+        bool granularSounding() const {
+            return granularSource_.load(std::memory_order_relaxed) >= 0
+                    && (granular_.activeGrains() > 0 || conductorFlow_.load(std::memory_order_relaxed) > kGranularMinFlow);
+        }
+
+        // Adds n frames of the granular texture. The source is re-resolved every sub-block, so
+        // an unloaded asset or a changed slot simply ends the grains.
+        void renderGranular(float* dst, int32_t n) {
+            const int source = granularSource_.load(std::memory_order_acquire);
+            if (source != granularBound_) {
+                granular_.clearSource();
+                granularBound_ = source;
+            }
+            if (source < 0) return;
+
+            const double sr = sampleRate_.load(std::memory_order_relaxed);
+            const float flow = conductorFlow_.load(std::memory_order_relaxed);
+            GranularEngine::Params p;
+            p.density = flow > kGranularMinFlow ? kGranularMaxDensity * flow * flow : 0.0f;
+            p.position = conductorHeight_.load(std::memory_order_relaxed);
+            p.pitchSpreadCents = kGranularMaxSpreadCents * conductorGrip_.load(std::memory_order_relaxed);
+            p.grainMs = kGranularGrainMs;
+            p.gain = kGranularHeadroom;
+            p.maxGrains = kGranularBudget;
+
+            const int slot = source & 0xFFFF;
+            if ((source >> 16) == kGranularSample) {
+                const SampleAsset* a = assets_.sample(slot);
+                if (!a) {
+                    granular_.clearSource();
+                    return;
+                }
+                granular_.setSource(a->data(), static_cast<int>(a->size()), a->sampleRate, false);
+            } else {
+                const Wavetable* t = assets_.wavetable(slot);
+                if (!t) {
+                    granular_.clearSource();
+                    return;
+                }
+                // One table cycle per kGranularWavetableNote period; the mip level leaves room
+                // for the widest detune.
+                const float inc = builtin::noteIncrement(kGranularWavetableNote, sr);
+                p.pitch = inc * static_cast<float>(Wavetable::kWavetableSize);
+                const float widest = inc * fastmath::exp2(p.pitchSpreadCents * (1.0f / 1200.0f));
+                granular_.setSource(t->mipLevel(Wavetable::levelForIncrement(widest)), Wavetable::kWavetableSize, sr, true);
+            }
+            granular_.render(p, sr, dst, n);
+        }
+
+#ifdef HAVE_FLUIDSYNTH
+        // n stream frames (n <= kControlSubBlock) from FluidSynth running at half rate. The
+        // upsampler emits frame pairs; an odd leftover frame is carried into the next call.
+        void renderHalfRate(float* dst, int32_t n) {
+            int32_t written = 0;
+            if (hasCarry_) {
+                dst[0] = carry_[0];
+                dst[1] = carry_[1];
+                hasCarry_ = false;
+                written = 1;
+            }
+            const int32_t remaining = n - written;
+            const int32_t low = (remaining + 1) / 2;
+            if (low == 0) return;
+            fluid_synth_write_float(fs_synth_, low, halfIn_, 0, 2, halfIn_, 1, 2);
+            upsampler_.process(halfIn_, low, halfOut_);
+            std::memcpy(dst + written * 2, halfOut_, sizeof(float) * static_cast<size_t>(remaining) * 2);
+            if (2 * low > remaining) {
+                carry_[0] = halfOut_[remaining * 2];
+                carry_[1] = halfOut_[remaining * 2 + 1];
+                hasCarry_ = true;
+            }
+        }
+
+        // Caller holds streamMutex_ (or the stream is not running).
+        void setFluidSampleRate(double rate) {
+            fluid_synth_set_sample_rate(fs_synth_, static_cast<float>(rate));
+            if (fs_settings_) fluid_settings_setnum(fs_settings_, "synth.sample-rate", rate);
+        }
+#endif
+
+        double synthRate() const {
+            const double rate = sampleRate_.load(std::memory_order_relaxed);
+            return halfRateRequested_.load(std::memory_order_relaxed) ? rate * 0.5 : rate;
+        }
+
+        // Audio-thread view of one MIDI channel.
+        struct ChannelState {
+            ParamSmoother bend;      // 14-bit units, linear ramp (pitch must land exactly)
+            ParamSmoother pressure;  // 7-bit units, exponential glide
+            ParamSmoother timbre;    // CC74, 7-bit units, exponential glide
+            int sentBend = 8192;
+            int sentPressure = 0;
+            int sentTimbre = 64;
+            float velocity = 0.0f;
+            float key = 0.0f;
+            int held = 0;
+        };
+
+        void initChannels() {
+            for (ChannelState& c : channelState_) {
+                c.bend.configure(ParamSmoother::kLinear, 0.0f, 8192.0f);
+                c.pressure.configure(ParamSmoother::kExponential, 8.0f, 0.0f);
+                c.timbre.configure(ParamSmoother::kExponential, 8.0f, 64.0f);
+            }
+        }
+
+        void drainEvents(int32_t numFrames) {
+            EngineEvent e;
+            int64_t notes = 0;
+            const double sr = sampleRate_.load(std::memory_order_relaxed);
+            while (events_.pop(e)) {
+                if (coalescer_.absorb(e)) continue;
+                if (e.type == EngineEvent::kNoteOn || e.type == EngineEvent::kNoteOff) ++notes;
+                // Controls sent ahead of this event on its channel apply first. A note starting
+                // on a silent channel (MPE: its own channel) jumps to its initial bend, pressure
+                // and timbre instead of gliding there from the previous note's.
+                coalescer_.flushChannel(e.channel, [&](int ch, int slot, uint32_t value, uint8_t flags) {
+                    applyControl(ch, slot, value, flags, numFrames, sr);
+                });
+                if (startsNote(e) && channelState_[e.channel].held == 0) snapControls(e.channel);
+                applyOrdered(e);
+            }
+
+            coalescer_.flush([&](int ch, int slot, uint32_t value, uint8_t flags) {
+                applyControl(ch, slot, value, flags, numFrames, sr);
+            });
+
+            if (notes) stats_.add(kStatNoteEvents, notes);
+            stats_.set(kStatControlEvents, static_cast<int64_t>(coalescer_.absorbedCount()));
+            stats_.set(kStatControlEventsMerged, static_cast<int64_t>(coalescer_.mergedCount()));
+        }
+
+        static bool startsNote(const EngineEvent& e) {
+            if (e.type != EngineEvent::kNoteOn) return false;
+            return (e.flags & EngineEvent::kFlagHighRes) ? ump::velocity16To7Bit(e.value) > 0 : e.value > 0;
+        }
+
+        // A coalesced control value: bend, pressure and CC74 glide over rampFrames, other
+        // continuous CCs go straight to FluidSynth.
+        void applyControl(int ch, int slot, uint32_t value, uint8_t flags, int32_t rampFrames, double sr) {
+            ChannelState& c = channelState_[ch];
+            // MIDI 2.0 values keep their fraction in the smoothers' 14/7-bit units.
+            const bool highRes = flags & EngineEvent::kFlagHighRes;
+            const float v = static_cast<float>(value);
+            if (slot == ControlCoalescer::kSlotBend) {
+                c.bend.setTarget(highRes ? v * ump::kToBend14 : v, rampFrames, sr);
+            } else if (slot == ControlCoalescer::kSlotPressure) {
+                c.pressure.setTarget(highRes ? v * ump::kTo7Bit : v, rampFrames, sr);
+            } else if (slot == ControlCoalescer::kSlotCcBase + 74) {
+                c.timbre.setTarget(highRes ? v * ump::kTo7Bit : v, rampFrames, sr);
+            } else {
+                sendControlChange(ch, slot - ControlCoalescer::kSlotCcBase,
+                                  highRes ? ump::to7Bit(value) : static_cast<int>(value));
+            }
+        }
+
+        // Ends the channel's glides at their targets and forwards the values before a note starts.
+        void snapControls(int ch) {
+            ChannelState& c = channelState_[ch];
+            if (snap(c.bend, c.sentBend)) sendPitchBend(ch, c.sentBend);
+            if (snap(c.pressure, c.sentPressure)) sendChannelPressure(ch, c.sentPressure);
+            if (snap(c.timbre, c.sentTimbre)) sendControlChange(ch, 74, c.sentTimbre);
+        }
+
+        // True when the integer value to send changed.
+        static bool snap(ParamSmoother& s, int& sent) {
+            s.reset(s.target());
+            const int v = static_cast<int>(std::lround(s.target()));
+            if (v == sent) return false;
+            sent = v;
+            return true;
+        }
+
+        void applyOrdered(const EngineEvent& e) {
+            ChannelState& c = channelState_[e.channel];
+            switch (e.type) {
+                case EngineEvent::kNoteOn: {
+                    const bool highRes = e.flags & EngineEvent::kFlagHighRes;
+                    const int velocity = highRes ? ump::velocity16To7Bit(e.value) : static_cast<int>(e.value);
+                    if (velocity > 0) {
+                        c.velocity = highRes ? static_cast<float>(e.value) * ump::kVelocity16ToUnit
+                                             : static_cast<float>(e.value) * (1.0f / 127.0f);
+                        c.key = static_cast<float>(static_cast<int>(e.data1) - 60) * (1.0f / 60.0f);
+                        ++c.held;
+                        startWavetableVoice(e.channel, e.data1, c.velocity);
+                    } else {
+                        if (c.held > 0) --c.held;
+                        stopWavetableVoice(e.channel, e.data1);
+                    }
+#ifdef HAVE_FLUIDSYNTH
+                    if (fs_synth_) fluid_synth_noteon(fs_synth_, e.channel, e.data1, velocity);
+#endif
+                    break;
+                }
+                case EngineEvent::kNoteOff:
+                    if (c.held > 0) --c.held;
+                    stopWavetableVoice(e.channel, e.data1);
+#ifdef HAVE_FLUIDSYNTH
+                    if (fs_synth_) fluid_synth_noteoff(fs_synth_, e.channel, e.data1);
+#endif
+                    break;
+                case EngineEvent::kControlChange:
+                    sendControlChange(e.channel, e.data1, e.flags & EngineEvent::kFlagHighRes
+                                                          ? ump::to7Bit(e.value) : static_cast<int>(e.value));
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Moves every gliding control by frames and forwards changed integer values.
+        void advanceSmoothers(int32_t frames) {
+            for (int ch = 0; ch < kNumChannels; ++ch) {
+                ChannelState& c = channelState_[ch];
+                if (c.bend.moving()) {
+                    const int v = static_cast<int>(std::lround(c.bend.advance(frames)));
+                    if (v != c.sentBend) { c.sentBend = v; sendPitchBend(ch, v); }
+                }
+                if (c.pressure.moving()) {
+                    const int v = static_cast<int>(std::lround(c.pressure.advance(frames)));
+                    if (v != c.sentPressure) { c.sentPressure = v; sendChannelPressure(ch, v); }
+                }
+                if (c.timbre.moving()) {
+                    const int v = static_cast<int>(std::lround(c.timbre.advance(frames)));
+                    if (v != c.sentTimbre) { c.sentTimbre = v; sendControlChange(ch, 74, v); }
+                }
+            }
+        }
+
+        void sendPitchBend(int ch, int bend14) {
+#ifdef HAVE_FLUIDSYNTH
+            if (!fs_synth_) return;
+            // Preserve your current behavior: convert 0..16383 to -8192..8191
+            int pb = bend14 - 8192;
+            if (pb < -8192) pb = -8192;
+            if (pb > 8191) pb = 8191;
+            fluid_synth_pitch_bend(fs_synth_, ch, pb);
+#else
+            (void)ch; (void)bend14;
+#endif
+        }
+
+        void sendChannelPressure(int ch, int pressure) {
+#ifdef HAVE_FLUIDSYNTH
+            if (fs_synth_) fluid_synth_channel_pressure(fs_synth_, ch, pressure);
+#else
+            (void)ch; (void)pressure;
+#endif
+        }
+
+        void sendControlChange(int ch, int cc, int value) {
+#ifdef HAVE_FLUIDSYNTH
+            if (fs_synth_) fluid_synth_cc(fs_synth_, ch, cc, value);
+#else
+            (void)ch; (void)cc; (void)value;
+#endif
+        }
+
+        // Drains whatever the input has captured since the last block (never waits) through
+        // the breath follower. An input error drops the input until setBreathInput() again.
+        void pollBreathInput() {
+            inputInUse_.store(true, std::memory_order_seq_cst);
+            oboe::AudioStream* in = input_.load(std::memory_order_seq_cst);
+            float level = 0.0f;
+            if (in) {
+                int64_t frames = 0;
+                int onsets = 0;
+                for (;;) {
+                    const oboe::ResultWithValue<int32_t> r = in->read(inputBuffer_, kInputChunk, 0);
+                    if (!r) {
+                        stats_.add(kStatBreathInputErrors);
+                        input_.store(nullptr, std::memory_order_relaxed);
+                        break;
+                    }
+                    if (r.value() <= 0) break;
+                    onsets += breath_.process(inputBuffer_, r.value());
+                    frames += r.value();
+                    if (r.value() < kInputChunk) break;
+                }
+                if (frames) stats_.add(kStatBreathInputFrames, frames);
+                if (onsets) stats_.add(kStatBreathOnsets, onsets);
+                level = breath_.level();
+            }
+            inputInUse_.store(false, std::memory_order_release);
+
+            modMatrix_.setGlobalSource(ModMatrix::kSrcBreath, level);
+#ifdef HAVE_FLUIDSYNTH
+            // Breath controller for SoundFonts that use it; released to 0 once when the input goes.
+            const int cc = static_cast<int>(std::lround(level * 127.0f));
+            if (fs_synth_ && cc != lastBreathCc_ && (in || lastBreathCc_ > 0)) {
+                for (int ch = 0; ch < kNumChannels; ++ch) fluid_synth_cc(fs_synth_, ch, 2, cc);
+                lastBreathCc_ = cc;
+            }
+#endif
+        }
+
+        void updateModulation(int32_t numFrames) {
+            for (int ch = 0; ch < kNumChannels; ++ch) {
+                const ChannelState& c = channelState_[ch];
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcPitchBend, (c.bend.current() - 8192.0f) * (1.0f / 8192.0f));
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcPressure, c.pressure.current() * (1.0f / 127.0f));
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcTimbre, c.timbre.current() * (1.0f / 127.0f));
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcVelocity, c.velocity);
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcKey, c.key);
+                modMatrix_.setVoiceActive(ch, c.held > 0);
+            }
+            modMatrix_.setGlobalSource(ModMatrix::kSrcFlow, conductorFlow_.load(std::memory_order_relaxed));
+            modMatrix_.setGlobalSource(ModMatrix::kSrcHeight, conductorHeight_.load(std::memory_order_relaxed));
+            modMatrix_.setGlobalSource(ModMatrix::kSrcGrip, conductorGrip_.load(std::memory_order_relaxed));
+            modMatrix_.process(numFrames, sampleRate_.load(std::memory_order_relaxed));
+        }
+
+#ifdef HAVE_FLUIDSYNTH
+        // Channel attenuation offset (centibels) for a gain destination value; see
+        // kFluidModGainHeadroomDb.
+        static float fluidAttenuation(float gainDb) {
+            return std::max(0.0f, (kFluidModGainHeadroomDb - gainDb) * 10.0f);
+        }
+
+        // The destinations map onto per-channel generator offsets. Only changed values are
+        // pushed (set_gen touches every voice).
+        void applyModulationToFluidSynth() {
+            const float* pitch = modMatrix_.dest(ModMatrix::kDestPitch);
+            const float* cutoff = modMatrix_.dest(ModMatrix::kDestCutoff);
+            const float* gainDb = modMatrix_.dest(ModMatrix::kDestGain);
+            const float* pan = modMatrix_.dest(ModMatrix::kDestPan);
+            for (int ch = 0; ch < kNumChannels; ++ch) {
+                pushGen(ch, 0, GEN_FINETUNE, pitch[ch] * 100.0f, 1.0f);       // cents
+                pushGen(ch, 1, GEN_FILTERFC, cutoff[ch] * 1200.0f, 5.0f);     // cents
+                pushGen(ch, 2, GEN_ATTENUATION, fluidAttenuation(gainDb[ch]), 0.5f);   // centibels
+                pushGen(ch, 3, GEN_PAN, pan[ch] * 500.0f, 2.0f);              // 0.1 %
+            }
+        }
+
+        void pushGen(int ch, int slot, int gen, float value, float epsilon) {
+            float& last = appliedGen_[ch][slot];
+            if (std::fabs(value - last) < epsilon) return;
+            last = value;
+            fluid_synth_set_gen(fs_synth_, ch, gen, value);
+        }
+
+        float appliedGen_[kNumChannels][4] = {};
+#endif
+
         bool openStream() {
             oboe::AudioStreamBuilder builder;
             builder.setDirection(oboe::Direction::Output);
@@ -201,14 +1271,124 @@ namespace {
                 return false;
             }
 
-            sampleRate_.store(stream_->getSampleRate(), std::memory_order_relaxed);
+            applyBufferDepthLocked();
+
+            const double previousRate = sampleRate_.exchange(stream_->getSampleRate(), std::memory_order_relaxed);
+#ifdef HAVE_FLUIDSYNTH
+            // A reopen can land on a device with a different native rate (e.g. BT vs speaker).
+            // The stream is not started yet, so the synth is not rendering concurrently.
+            if (fs_synth_ && previousRate != stream_->getSampleRate()) setFluidSampleRate(synthRate());
+#else
+            (void) previousRate;
+#endif
+            {
+                std::lock_guard<std::mutex> guard(importerMutex_);
+                if (importer_) importer_->setTargetSampleRate(stream_->getSampleRate());
+            }
             return true;
         }
 
+        std::mutex streamMutex_;  // serialises JNI start/stop/close with the recovery thread
         std::shared_ptr<oboe::AudioStream> stream_;
         std::atomic<bool> isPlaying_{false};
+        static constexpr int kPrimeCallbacks = 2;   // muted callbacks after each start()
+        static constexpr int kRecoveryMaxAttempts = 6;
+        static constexpr int kRecoveryBackoffMs = 50; // doubles per attempt (~3 s total)
+        std::atomic<int> primeCallbacks_{0};
+        std::atomic<int64_t> startNanos_{0};
+        DeviceProfile profile_;   // streamMutex_
+        bool probing_ = false;    // streamMutex_; the probe stream has the device
+        static constexpr int kProbeMaxBursts = 4;
+        static constexpr int kProbeSettleMs = 200;
+        static constexpr int kProbeListenMs = 300;
+
+        // Breath input. input_ is what the callback reads; inputInUse_ brackets the callback's
+        // use of it so closeInputLocked() can wait for a read in flight.
+        static constexpr int kInputChunk = 512;
+        std::shared_ptr<oboe::AudioStream> inputStream_;   // streamMutex_
+        std::atomic<oboe::AudioStream*> input_{nullptr};
+        std::atomic<bool> inputInUse_{false};
+        BreathFollower breath_;
+        float inputBuffer_[kInputChunk] = {};
+        int lastBreathCc_ = 0;
+
+        std::mutex recoveryMutex_;
+        std::condition_variable recoveryWake_;
+        std::thread recoveryThread_;
+        bool recoveryRequested_ = false;
+        bool recoveryExit_ = false;
+        int64_t recoveryNanos_ = 0;  // when the disconnect was reported
         std::atomic<double> sampleRate_{48000.0};
 
+        MpscQueue<EngineEvent, kEventQueueCapacity> events_;
+        ControlCoalescer coalescer_;
+        ChannelState channelState_[kNumChannels];
+        EngineStats stats_;
+        CallCapture capture_;
+        SmfRecorder performance_;
+
+        std::atomic<float> conductorFlow_{0.5f};
+        std::atomic<float> conductorHeight_{0.5f};
+        std::atomic<float> conductorGrip_{0.0f};
+        ModMatrix modMatrix_;
+
+        std::atomic<bool> halfRateRequested_{false};
+        std::atomic<int> renderSwitch_{kSwitchIdle};
+        bool halfRate_ = false;   // audio thread's view of halfRateRequested_
+        HalfBandUpsampler upsampler_;
+        float halfIn_[kControlSubBlock] = {};            // kControlSubBlock / 2 stereo frames
+        float halfOut_[2 * kControlSubBlock] = {};
+        float carry_[2] = {};
+        bool hasCarry_ = false;
+
+        // Declared before the importer so workers are joined before the assets go away, and
+        // the cache before the assets because wrapped tables point into its mapping.
+        WavetableCache wavetableCache_;
+        AssetRegistry assets_;
+
+        // Wavetable layer. FluidSynth's default wheel range, so both layers bend together.
+        static constexpr int kWavetableBendRange = 2;
+        static constexpr float kWavetableCutoffHz = 2000.0f;   // at 0 octaves of cutoff modulation
+        static constexpr float kWavetableHeadroom = 0.25f;
+        std::atomic<int> wavetableSlot_{-1};
+        std::atomic<int> unisonCopies_{7};
+        std::atomic<float> unisonDetune_{20.0f};
+        std::atomic<float> unisonSpread_{0.7f};
+        UnisonVoice unisonVoices_[kNumChannels];
+        uint32_t voiceSeed_ = 1;
+        int activeWavetableVoices_ = 0;
+        int fluidVoices_ = 0;
+
+        static constexpr int kMaxPcmChannels = 16;   // registerPcm()
+
+        static_assert(kNumChannels == vis::kChannels, "one meter per channel");
+        vis::Tap visualization_;
+
+        // Granular texture. 2000 onsets/s of 120 ms grains is ~240 overlapping at full flow.
+        static constexpr int kGranularWavetable = 0;   // kinds match OboeSynthesizer.IMPORT_*
+        static constexpr int kGranularSample = 1;
+        static constexpr float kGranularMinFlow = 0.02f;
+        static constexpr float kGranularMaxDensity = 2000.0f;
+        static constexpr float kGranularGrainMs = 120.0f;
+        static constexpr float kGranularMaxSpreadCents = 1200.0f;
+        static constexpr float kGranularHeadroom = 0.5f;
+        static constexpr int kGranularBudget = 256;
+        static constexpr int kGranularWavetableNote = 57;
+        std::atomic<int> granularSource_{-1};   // (kind << 16) | slot, -1 off
+        int granularBound_ = -1;                // audio thread's view of granularSource_
+        GranularEngine granular_;
+
+        // Nodes before the graph: they must outlive it.
+        static constexpr float kFluidTailSeconds = 3.0f;
+        int32_t fluidTailFrames_ = 0;
+        FluidSynthNode fluidNode_{*this};
+        WavetableNode wavetableNode_{*this};
+        GranularNode granularNode_{*this};
+        MixNode masterNode_{"master"};
+        RenderGraph graph_;
+        std::mutex importerMutex_;
+        std::unique_ptr<ImportPipeline> importer_;
+
 #ifdef HAVE_FLUIDSYNTH
         bool fs_initialized_ = false;
         int loaded_soundfont_id_ = -1;
@@ -222,10 +1402,33 @@ namespace {
         return reinterpret_cast<OboeSynthEngine*>(handle);
     }
 
+    // Set in JNI_OnLoad; assets holding Java objects release them from whichever thread
+    // destroys them.
+    JavaVM* gJavaVm = nullptr;
+
+    // Result bit of nativeRegisterPcm when the engine adopted the buffer (OboeSynthesizer.PCM_ADOPTED).
+    constexpr jint kPcmAdopted = 1 << 16;
+
+    void deleteGlobalRef(jobject ref) {
+        JNIEnv* env = nullptr;
+        bool attached = false;
+        if (gJavaVm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+            if (gJavaVm->AttachCurrentThread(&env, nullptr) != JNI_OK) return;
+            attached = true;
+        }
+        env->DeleteGlobalRef(ref);
+        if (attached) gJavaVm->DetachCurrentThread();
+    }
+
 } // namespace
 
 // ============================================================================
-// JNI exports (MUST match Kotlin calls)
+// JNI entry points (MUST match Kotlin calls). All of them are bound explicitly in
+// JNI_OnLoad at the end of this file; a new native needs a row in kNatives there.
+//
+// The per-touch-frame calls (note, bend, pressure, CC, UMP, conductor) take only
+// primitives and are @CriticalNative statics on the Kotlin side: no JNIEnv, no jclass,
+// no thread-state transition. They must not call back into the VM.
 // ============================================================================
 
 extern "C" JNIEXPORT jlong JNICALL
@@ -239,13 +1442,16 @@ Java_com_breathinghand_audio_OboeSynthesizer_nativeDelete(JNIEnv*, jobject, jlon
     auto* engine = fromHandle(handle);
     if (!engine) return;
     engine->close();
-    delete engine;
+    // An Oboe thread may still be inside a callback on this engine; the reclaimer destroys it
+    // once none can be.
+    Reclaimer::instance().retire(engine);
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_breathinghand_audio_OboeSynthesizer_nativeStart(JNIEnv*, jobject, jlong handle) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
+    engine->capture().record(CallCapture::kOpStart);
     engine->start();
 }
 
@@ -253,88 +1459,345 @@ extern "C" JNIEXPORT void JNICALL
 Java_com_breathinghand_audio_OboeSynthesizer_nativeStop(JNIEnv*, jobject, jlong handle) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
+    engine->capture().record(CallCapture::kOpStop);
     engine->stop();
 }
 
-extern "C" JNIEXPORT void JNICALL
-Java_com_breathinghand_audio_OboeSynthesizer_nativeNoteOn(JNIEnv*, jobject, jlong handle, jint channel, jint note, jint velocity) {
+static void criticalNoteOn(jlong handle, jint channel, jint note, jint velocity) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
-#ifdef HAVE_FLUIDSYNTH
-    fluid_synth_t* s = engine->getFluidSynth();
-    if (!s) return;
-    const int chan = std::clamp(static_cast<int>(channel), 0, 15);
-    const int key  = static_cast<int>(note);
-    const int vel  = std::clamp(static_cast<int>(velocity), 0, 127);
-    fluid_synth_noteon(s, chan, key, vel);
-#else
-    (void)channel; (void)note; (void)velocity;
-#endif
+    engine->capture().record(CallCapture::kOpNoteOn, channel, note, velocity);
+    engine->postEvent(EngineEvent::noteOn(channel, note, velocity));
 }
 
-extern "C" JNIEXPORT void JNICALL
-Java_com_breathinghand_audio_OboeSynthesizer_nativeNoteOff(JNIEnv*, jobject, jlong handle, jint channel, jint note) {
+static void criticalNoteOff(jlong handle, jint channel, jint note) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
-#ifdef HAVE_FLUIDSYNTH
-    fluid_synth_t* s = engine->getFluidSynth();
-    if (!s) return;
-    const int chan = std::clamp(static_cast<int>(channel), 0, 15);
-    const int key  = static_cast<int>(note);
-    fluid_synth_noteoff(s, chan, key);
-#else
-    (void)channel; (void)note;
-#endif
+    engine->capture().record(CallCapture::kOpNoteOff, channel, note);
+    engine->postEvent(EngineEvent::noteOff(channel, note));
 }
 
-extern "C" JNIEXPORT void JNICALL
-Java_com_breathinghand_audio_OboeSynthesizer_nativePitchBend(JNIEnv*, jobject, jlong handle, jint channel, jint bend14) {
+static void criticalPitchBend(jlong handle, jint channel, jint bend14) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
-#ifdef HAVE_FLUIDSYNTH
-    fluid_synth_t* s = engine->getFluidSynth();
-    if (!s) return;
-    const int chan = std::clamp(static_cast<int>(channel), 0, 15);
-    // Preserve your current behavior: convert 0..16383 to -8192..8191
-    int b = std::clamp(static_cast<int>(bend14), 0, 16383);
-    int pb = b - 8192;
-    if (pb < -8192) pb = -8192;
-    if (pb > 8191) pb = 8191;
-    fluid_synth_pitch_bend(s, chan, pb);
-#else
-    (void)channel; (void)bend14;
-#endif
+    engine->capture().record(CallCapture::kOpPitchBend, channel, bend14);
+    engine->postEvent(EngineEvent::pitchBend(channel, bend14));
 }
 
-extern "C" JNIEXPORT void JNICALL
-Java_com_breathinghand_audio_OboeSynthesizer_nativeChannelPressure(JNIEnv*, jobject, jlong handle, jint channel, jint pressure) {
+static void criticalChannelPressure(jlong handle, jint channel, jint pressure) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
-#ifdef HAVE_FLUIDSYNTH
-    fluid_synth_t* s = engine->getFluidSynth();
-    if (!s) return;
-    const int chan = std::clamp(static_cast<int>(channel), 0, 15);
-    const int p    = std::clamp(static_cast<int>(pressure), 0, 127);
-    fluid_synth_channel_pressure(s, chan, p);
-#else
-    (void)channel; (void)pressure;
-#endif
+    engine->capture().record(CallCapture::kOpChannelPressure, channel, pressure);
+    engine->postEvent(EngineEvent::channelPressure(channel, pressure));
+}
+
+static void criticalControlChange(jlong handle, jint channel, jint cc, jint value) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return;
+    engine->capture().record(CallCapture::kOpControlChange, channel, cc, value);
+    engine->postEvent(EngineEvent::controlChange(channel, cc, value));
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSendUmp(JNIEnv* env, jobject, jlong handle, jintArray words, jint count) {
+    auto* engine = fromHandle(handle);
+    if (!engine || words == nullptr) return 0;
+    const int total = std::min<int>(count, env->GetArrayLength(words));
+    // Copied in fixed chunks: no allocation and no pinning on the caller's hot path.
+    constexpr int kChunkWords = 64;
+    jint chunk[kChunkWords];
+    int consumed = 0;
+    while (consumed < total) {
+        const int n = std::min(kChunkWords, total - consumed);
+        env->GetIntArrayRegion(words, consumed, n, chunk);
+        engine->capture().recordWithPayload(CallCapture::kOpUmp, chunk, sizeof(jint) * static_cast<size_t>(n));
+        const int used = engine->postUmp(reinterpret_cast<const uint32_t*>(chunk), n);
+        if (used == 0) break;  // truncated packet at the end
+        consumed += used;
+    }
+    return consumed;
+}
+
+static void criticalSendUmp64(jlong handle, jint word0, jint word1) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return;
+    const uint32_t packet[2] = {static_cast<uint32_t>(word0), static_cast<uint32_t>(word1)};
+    const int size = ump::packetWords(packet[0]);
+    if (size > 2) return;
+    engine->capture().recordWithPayload(CallCapture::kOpUmp, packet, sizeof(uint32_t) * static_cast<size_t>(size));
+    engine->postUmp(packet, size);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSetLowPowerRender(JNIEnv*, jobject, jlong handle, jboolean enabled) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpSetLowPowerRender, enabled == JNI_TRUE ? 1 : 0);
+    return engine->setLowPowerRender(enabled == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSetBreathInput(JNIEnv*, jobject, jlong handle, jboolean enabled) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpSetBreathInput, enabled == JNI_TRUE ? 1 : 0);
+    return engine->setBreathInput(enabled == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+static void criticalSetConductor(jlong handle, jfloat flow, jfloat height, jfloat grip) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return;
+    engine->capture().record(CallCapture::kOpSetConductor, CallCapture::floatBits(flow),
+                             CallCapture::floatBits(height), CallCapture::floatBits(grip));
+    engine->setConductor(flow, height, grip);
 }
 
 extern "C" JNIEXPORT void JNICALL
-Java_com_breathinghand_audio_OboeSynthesizer_nativeControlChange(JNIEnv*, jobject, jlong handle, jint channel, jint cc, jint value) {
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSetModRoutes(JNIEnv* env, jobject, jlong handle, jfloatArray routes) {
+    auto* engine = fromHandle(handle);
+    if (!engine || routes == nullptr) return;
+    // Flat [source, dest, curve, amount] quadruples.
+    jfloat buf[ModMatrix::kMaxRoutes * 4];
+    const jsize len = std::min<jsize>(env->GetArrayLength(routes), ModMatrix::kMaxRoutes * 4);
+    env->GetFloatArrayRegion(routes, 0, len, buf);
+    engine->capture().recordWithPayload(CallCapture::kOpSetModRoutes, buf, sizeof(jfloat) * static_cast<size_t>(len));
+    ModMatrix::Route parsed[ModMatrix::kMaxRoutes];
+    const int count = len / 4;
+    for (int i = 0; i < count; ++i) {
+        parsed[i].source = static_cast<ModMatrix::Source>(static_cast<int>(buf[i * 4 + 0]));
+        parsed[i].dest   = static_cast<ModMatrix::Dest>(static_cast<int>(buf[i * 4 + 1]));
+        parsed[i].curve  = static_cast<ModMatrix::Curve>(static_cast<int>(buf[i * 4 + 2]));
+        parsed[i].amount = buf[i * 4 + 3];
+    }
+    engine->modMatrix().setRoutes(parsed, count);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSetLfoRate(JNIEnv*, jobject, jlong handle, jint lfo, jfloat hz) {
     auto* engine = fromHandle(handle);
     if (!engine) return;
-#ifdef HAVE_FLUIDSYNTH
-    fluid_synth_t* s = engine->getFluidSynth();
-    if (!s) return;
-    const int chan = std::clamp(static_cast<int>(channel), 0, 15);
-    const int c    = std::clamp(static_cast<int>(cc), 0, 127);
-    const int v    = std::clamp(static_cast<int>(value), 0, 127);
-    fluid_synth_cc(s, chan, c, v);
-#else
-    (void)channel; (void)cc; (void)value;
-#endif
+    engine->capture().record(CallCapture::kOpSetLfoRate, lfo, CallCapture::floatBits(hz));
+    engine->modMatrix().setLfoRate(lfo, hz);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeStartCallCapture(JNIEnv* env, jobject, jlong handle, jstring path) {
+    auto* engine = fromHandle(handle);
+    if (!engine || path == nullptr) return JNI_FALSE;
+    const char* pathC = env->GetStringUTFChars(path, nullptr);
+    if (!pathC) return JNI_FALSE;
+    const bool ok = engine->capture().start(pathC);
+    env->ReleaseStringUTFChars(path, pathC);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeStopCallCapture(JNIEnv*, jobject, jlong handle) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return 0;
+    engine->capture().stop();
+    return static_cast<jlong>(engine->capture().writtenCount());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeLoadDeviceProfile(JNIEnv* env, jobject, jlong handle, jstring path) {
+    auto* engine = fromHandle(handle);
+    if (!engine || path == nullptr) return -1;
+    const char* pathC = env->GetStringUTFChars(path, nullptr);
+    if (!pathC) return -1;
+    const int tier = engine->loadDeviceProfile(pathC);
+    env->ReleaseStringUTFChars(path, pathC);
+    return tier;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeProbeDevice(JNIEnv* env, jobject, jlong handle, jstring path) {
+    auto* engine = fromHandle(handle);
+    if (!engine || path == nullptr) return -1;
+    const char* pathC = env->GetStringUTFChars(path, nullptr);
+    if (!pathC) return -1;
+    const int tier = engine->probeDevice(pathC);
+    env->ReleaseStringUTFChars(path, pathC);
+    return tier;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeStartPerformanceExport(JNIEnv* env, jobject, jlong handle, jstring path) {
+    auto* engine = fromHandle(handle);
+    if (!engine || path == nullptr) return JNI_FALSE;
+    const char* pathC = env->GetStringUTFChars(path, nullptr);
+    if (!pathC) return JNI_FALSE;
+    const bool ok = engine->performance().start(pathC);
+    env->ReleaseStringUTFChars(path, pathC);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeStopPerformanceExport(JNIEnv*, jobject, jlong handle) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return -1;
+    if (!engine->performance().stop()) return -1;
+    return static_cast<jlong>(engine->performance().writtenCount());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeGetStats(JNIEnv* env, jobject, jlong handle, jlongArray out) {
+    auto* engine = fromHandle(handle);
+    if (!engine || out == nullptr) return 0;
+    jlong values[kStatCount];
+    const int n = engine->stats().snapshot(values, std::min<int>(env->GetArrayLength(out), kStatCount));
+    env->SetLongArrayRegion(out, 0, n, values);
+    return n;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeReadVisualization(JNIEnv* env, jobject, jlong handle, jobject out) {
+    auto* engine = fromHandle(handle);
+    if (!engine || out == nullptr || env->GetDirectBufferCapacity(out) < static_cast<jlong>(sizeof(vis::Frame))) return 0;
+    void* dst = env->GetDirectBufferAddress(out);
+    return dst ? static_cast<jint>(engine->readVisualization(dst)) : 0;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeGetRenderNodeStats(JNIEnv* env, jobject, jlong handle, jlongArray out) {
+    auto* engine = fromHandle(handle);
+    if (!engine || out == nullptr) return 0;
+    const RenderGraph& graph = engine->renderGraph();
+    const int n = std::min(graph.nodeCount(), static_cast<int>(env->GetArrayLength(out)) / 3);
+    jlong values[3 * RenderGraph::kMaxNodes];
+    for (int i = 0; i < n; ++i) {
+        const RenderNode::Stats st = graph.node(i)->stats();
+        values[3 * i] = st.nanos;
+        values[3 * i + 1] = st.runs;
+        values[3 * i + 2] = st.skips;
+    }
+    env->SetLongArrayRegion(out, 0, 3 * n, values);
+    return n;
+}
+
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeGetRenderNodeNames(JNIEnv* env, jobject, jlong handle) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return nullptr;
+    const RenderGraph& graph = engine->renderGraph();
+    const int n = graph.nodeCount();
+    jobjectArray names = env->NewObjectArray(n, env->FindClass("java/lang/String"), nullptr);
+    if (names == nullptr) return nullptr;
+    for (int i = 0; i < n; ++i) {
+        jstring name = env->NewStringUTF(graph.node(i)->name());
+        env->SetObjectArrayElement(names, i, name);
+        env->DeleteLocalRef(name);
+    }
+    return names;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeImportFiles(JNIEnv* env, jobject, jlong handle, jobjectArray paths, jint kind) {
+    auto* engine = fromHandle(handle);
+    if (!engine || paths == nullptr) return -1;
+
+    std::vector<ImportPipeline::Request> requests;
+    const jsize count = env->GetArrayLength(paths);
+    requests.reserve(static_cast<size_t>(count));
+    for (jsize i = 0; i < count; ++i) {
+        auto path = static_cast<jstring>(env->GetObjectArrayElement(paths, i));
+        if (!path) continue;
+        const char* pathC = env->GetStringUTFChars(path, nullptr);
+        if (pathC) {
+            ImportPipeline::Request r;
+            r.path = pathC;
+            r.kind = kind == 1 ? ImportPipeline::Kind::kSample : ImportPipeline::Kind::kWavetable;
+            requests.push_back(std::move(r));
+            env->ReleaseStringUTFChars(path, pathC);
+        }
+        env->DeleteLocalRef(path);
+    }
+    if (engine->capture().active()) {
+        std::string joined;
+        for (const auto& r : requests) joined.append(r.path).push_back('\n');
+        engine->capture().recordWithPayload(CallCapture::kOpImportFiles, joined.data(), joined.size(), kind);
+    }
+    return engine->importer().submit(requests);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeImportProgress(JNIEnv* env, jobject, jlong handle, jint jobId, jintArray out) {
+    auto* engine = fromHandle(handle);
+    const jsize n = out ? env->GetArrayLength(out) : 0;
+    if (!engine || n < 3) return JNI_FALSE;
+    ImportPipeline* importer = engine->importerIfStarted();
+    ImportPipeline::Progress p;
+    if (!importer || !importer->progress(jobId, p)) return JNI_FALSE;
+    const jint values[4] = {p.total, p.completed, p.failed, p.cacheHits};
+    env->SetIntArrayRegion(out, 0, n < 4 ? n : 4, values);
+    return JNI_TRUE;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeImportResultSlot(JNIEnv*, jobject, jlong handle, jint jobId, jint index) {
+    auto* engine = fromHandle(handle);
+    ImportPipeline* importer = engine ? engine->importerIfStarted() : nullptr;
+    if (!importer) return -1;
+    return importer->resultSlot(jobId, index);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeRegisterPcm(JNIEnv* env, jobject, jlong handle, jobject buffer, jint format,
+                                                               jint channels, jint frames, jint sampleRate, jint kind, jint slot) {
+    auto* engine = fromHandle(handle);
+    if (!engine || !buffer || frames <= 0 || format < 0 || format > static_cast<jint>(pcm::SampleFormat::kFloat32)) return -1;
+    void* data = env->GetDirectBufferAddress(buffer);
+    const jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!data || capacity <= 0) return -1;
+    engine->capture().record(CallCapture::kOpRegisterPcm, kind, format, channels, frames);
+
+    // Held while a sample references the buffer, so Kotlin may drop its own reference.
+    jobject ref = env->NewGlobalRef(buffer);
+    if (!ref) return -1;
+    bool adopted = false;
+    const int result = engine->registerPcm(kind, data, static_cast<size_t>(capacity), static_cast<pcm::SampleFormat>(format),
+                                           channels, static_cast<size_t>(frames), sampleRate, slot,
+                                           [ref] { deleteGlobalRef(ref); }, adopted);
+    if (result < 0) return -1;
+    return adopted ? result | kPcmAdopted : result;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeOpenWavetableCache(JNIEnv* env, jobject, jlong handle, jstring path) {
+    auto* engine = fromHandle(handle);
+    if (!engine || path == nullptr) return JNI_FALSE;
+    const char* pathC = env->GetStringUTFChars(path, nullptr);
+    if (!pathC) return JNI_FALSE;
+    engine->capture().recordWithPayload(CallCapture::kOpOpenWavetableCache, pathC, std::strlen(pathC));
+    const bool ok = engine->openWavetableCache(pathC);
+    env->ReleaseStringUTFChars(path, pathC);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeFlushWavetableCache(JNIEnv*, jobject, jlong handle) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpFlushWavetableCache);
+    return engine->flushWavetableCache() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSetWavetableVoice(JNIEnv*, jobject, jlong handle, jint slot, jint copies,
+                                                                     jfloat detuneCents, jfloat spread) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpSetWavetableVoice, slot, copies, CallCapture::floatBits(detuneCents),
+                             CallCapture::floatBits(spread));
+    return engine->setWavetableVoice(slot, copies, detuneCents, spread) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeSetGranularSource(JNIEnv*, jobject, jlong handle, jint kind, jint slot) {
+    auto* engine = fromHandle(handle);
+    if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpSetGranularSource, kind, slot);
+    return engine->setGranularSource(kind, slot) ? JNI_TRUE : JNI_FALSE;
 }
 
 extern "C" JNIEXPORT jboolean JNICALL
@@ -346,6 +1809,7 @@ Java_com_breathinghand_audio_OboeSynthesizer_nativeLoadSoundFont(JNIEnv* env, jo
     const char* pathC = env->GetStringUTFChars(path, nullptr);
     if (!pathC) return JNI_FALSE;
 
+    engine->capture().recordWithPayload(CallCapture::kOpLoadSoundFont, pathC, std::strlen(pathC));
     const bool ok = engine->loadSoundFontFromPath(std::string(pathC));
     env->ReleaseStringUTFChars(path, pathC);
     return ok ? JNI_TRUE : JNI_FALSE;
@@ -355,6 +1819,7 @@ extern "C" JNIEXPORT jboolean JNICALL
 Java_com_breathinghand_audio_OboeSynthesizer_nativeInitFluidSynth(JNIEnv*, jobject, jlong handle) {
     auto* engine = fromHandle(handle);
     if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpInitFluidSynth);
     return engine->initFluidSynth() ? JNI_TRUE : JNI_FALSE;
 }
 
@@ -362,10 +1827,43 @@ extern "C" JNIEXPORT jboolean JNICALL
 Java_com_breathinghand_audio_OboeSynthesizer_nativeShutdownFluidSynth(JNIEnv*, jobject, jlong handle) {
     auto* engine = fromHandle(handle);
     if (!engine) return JNI_FALSE;
+    engine->capture().record(CallCapture::kOpShutdownFluidSynth);
     engine->shutdownFluidSynth();
     return JNI_TRUE;
 }
 
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeGetDspKernels(JNIEnv* env, jobject) {
+    // "avx2 (sse2 sse4.1 avx2 avx512)": the bound variant, then every one this CPU runs.
+    std::string text = dsp::isaName(dsp::kernels().isa);
+    text += " (";
+    bool first = true;
+    for (int i = 0; i < static_cast<int>(dsp::Isa::kCount); ++i) {
+        if ((dsp::availableIsas() & (1u << i)) == 0) continue;
+        if (!first) text += ' ';
+        text += dsp::isaName(static_cast<dsp::Isa>(i));
+        first = false;
+    }
+    text += ')';
+    return env->NewStringUTF(text.c_str());
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_breathinghand_audio_OboeSynthesizer_nativeGetVoiceLeadingTable(JNIEnv* env, jobject,
+                                                                        jbyteArray voicings,
+                                                                        jbyteArray transitions) {
+    // Copies of the compile-time tables (VoiceLeading.h); read once at startup.
+    constexpr jsize kVoicingBytes = voicing::kStates * voicing::kLayers;
+    constexpr jsize kTransitionBytes = voicing::kStates * voicing::kStates * voicing::kUpperMasks;
+    if (!voicings || !transitions || env->GetArrayLength(voicings) != kVoicingBytes
+            || env->GetArrayLength(transitions) != kTransitionBytes) {
+        return JNI_FALSE;
+    }
+    env->SetByteArrayRegion(voicings, 0, kVoicingBytes, reinterpret_cast<const jbyte*>(voicing::voicings()));
+    env->SetByteArrayRegion(transitions, 0, kTransitionBytes, reinterpret_cast<const jbyte*>(voicing::transitions()));
+    return JNI_TRUE;
+}
+
 extern "C" JNIEXPORT jboolean JNICALL
 Java_com_breathinghand_audio_OboeSynthesizer_nativeIsFluidSynthCompiled(JNIEnv*, jobject) {
 #ifdef HAVE_FLUIDSYNTH
@@ -375,3 +1873,102 @@ Java_com_breathinghand_audio_OboeSynthesizer_nativeIsFluidSynthCompiled(JNIEnv*,
 #endif
 }
 
+// Same trivial body bound three ways, for OboeSynthesizer.measureJniCallCost().
+static jint callCost(JNIEnv*, jobject, jlong handle, jint value) {
+    return fromHandle(handle) ? value + 1 : 0;
+}
+
+static jint criticalCallCost(jlong handle, jint value) {
+    return fromHandle(handle) ? value + 1 : 0;
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+namespace {
+
+    // Before API 26 the runtime ignores @CriticalNative and calls the method as a plain
+    // static native, so the critical entry points are registered behind this adapter.
+    template <auto Fn>
+    struct WithEnv;
+
+    template <typename R, typename... A, R (*Fn)(A...)>
+    struct WithEnv<Fn> {
+        static R call(JNIEnv*, jclass, A... args) { return Fn(args...); }
+    };
+
+    template <auto Fn>
+    void* critical(bool supported) {
+        return supported ? reinterpret_cast<void*>(Fn) : reinterpret_cast<void*>(&WithEnv<Fn>::call);
+    }
+
+#define BH_NATIVE(name, sig) \
+    {#name, sig, reinterpret_cast<void*>(&Java_com_breathinghand_audio_OboeSynthesizer_##name)}
+
+    jint registerNatives(JNIEnv* env) {
+        jclass cls = env->FindClass("com/breathinghand/audio/OboeSynthesizer");
+        if (cls == nullptr) return JNI_ERR;
+        const bool criticalSupported = android_get_device_api_level() >= 26;
+
+        const JNINativeMethod kNatives[] = {
+                BH_NATIVE(nativeCreate, "()J"),
+                BH_NATIVE(nativeDelete, "(J)V"),
+                BH_NATIVE(nativeStart, "(J)V"),
+                BH_NATIVE(nativeStop, "(J)V"),
+                {"nativeNoteOn", "(JIII)V", critical<criticalNoteOn>(criticalSupported)},
+                {"nativeNoteOff", "(JII)V", critical<criticalNoteOff>(criticalSupported)},
+                {"nativePitchBend", "(JII)V", critical<criticalPitchBend>(criticalSupported)},
+                {"nativeChannelPressure", "(JII)V", critical<criticalChannelPressure>(criticalSupported)},
+                {"nativeControlChange", "(JIII)V", critical<criticalControlChange>(criticalSupported)},
+                BH_NATIVE(nativeSendUmp, "(J[II)I"),
+                {"nativeSendUmp64", "(JII)V", critical<criticalSendUmp64>(criticalSupported)},
+                BH_NATIVE(nativeSetLowPowerRender, "(JZ)Z"),
+                BH_NATIVE(nativeSetBreathInput, "(JZ)Z"),
+                {"nativeSetConductor", "(JFFF)V", critical<criticalSetConductor>(criticalSupported)},
+                BH_NATIVE(nativeSetModRoutes, "(J[F)V"),
+                BH_NATIVE(nativeSetLfoRate, "(JIF)V"),
+                BH_NATIVE(nativeStartCallCapture, "(JLjava/lang/String;)Z"),
+                BH_NATIVE(nativeStopCallCapture, "(J)J"),
+                BH_NATIVE(nativeStartPerformanceExport, "(JLjava/lang/String;)Z"),
+                BH_NATIVE(nativeLoadDeviceProfile, "(JLjava/lang/String;)I"),
+                BH_NATIVE(nativeProbeDevice, "(JLjava/lang/String;)I"),
+                BH_NATIVE(nativeStopPerformanceExport, "(J)J"),
+                BH_NATIVE(nativeGetStats, "(J[J)I"),
+                BH_NATIVE(nativeReadVisualization, "(JLjava/nio/ByteBuffer;)I"),
+                BH_NATIVE(nativeGetRenderNodeStats, "(J[J)I"),
+                BH_NATIVE(nativeGetRenderNodeNames, "(J)[Ljava/lang/String;"),
+                BH_NATIVE(nativeImportFiles, "(J[Ljava/lang/String;I)I"),
+                BH_NATIVE(nativeImportProgress, "(JI[I)Z"),
+                BH_NATIVE(nativeImportResultSlot, "(JII)I"),
+                BH_NATIVE(nativeRegisterPcm, "(JLjava/nio/ByteBuffer;IIIIII)I"),
+                BH_NATIVE(nativeOpenWavetableCache, "(JLjava/lang/String;)Z"),
+                BH_NATIVE(nativeFlushWavetableCache, "(J)Z"),
+                BH_NATIVE(nativeSetWavetableVoice, "(JIIFF)Z"),
+                BH_NATIVE(nativeSetGranularSource, "(JII)Z"),
+                BH_NATIVE(nativeLoadSoundFont, "(JLjava/lang/String;)Z"),
+                BH_NATIVE(nativeInitFluidSynth, "(J)Z"),
+                BH_NATIVE(nativeShutdownFluidSynth, "(J)Z"),
+                BH_NATIVE(nativeIsFluidSynthCompiled, "()Z"),
+                BH_NATIVE(nativeGetDspKernels, "()Ljava/lang/String;"),
+                BH_NATIVE(nativeGetVoiceLeadingTable, "([B[B)Z"),
+                {"nativeCallCostRegular", "(JI)I", reinterpret_cast<void*>(&callCost)},
+                {"nativeCallCostFast", "(JI)I", reinterpret_cast<void*>(&callCost)},
+                {"nativeCallCostCritical", "(JI)I", critical<criticalCallCost>(criticalSupported)},
+        };
+        const jint result = env->RegisterNatives(cls, kNatives, sizeof(kNatives) / sizeof(kNatives[0]));
+        env->DeleteLocalRef(cls);
+        return result == JNI_OK ? JNI_OK : JNI_ERR;
+    }
+
+#undef BH_NATIVE
+
+} // namespace
+
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) return JNI_ERR;
+    gJavaVm = vm;
+    if (registerNatives(env) != JNI_OK) return JNI_ERR;
+    return JNI_VERSION_1_6;
+}
@@ -0,0 +1,177 @@
+#include "PcmConvert.h"
+#include "DspKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pcm {
+
+    // Little-endian helpers
+    static uint16_t read_u16_le(const uint8_t *p) {
+        return static_cast<uint16_t>(p[0]) | (static_cast<uint16_t>(p[1]) << 8);
+    }
+    static uint32_t read_u32_le(const uint8_t *p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    bool parseWav(const uint8_t *data, size_t size, WavInfo &info) {
+        if (!data || size < 12) return false;
+        if (std::memcmp(data, "RIFF", 4) != 0) return false;
+        if (std::memcmp(data + 8, "WAVE", 4) != 0) return false;
+
+        size_t pos = 12;
+        uint16_t audioFormat = 0;
+        uint16_t numChannels = 1;
+        uint32_t sampleRate = 44100;
+        uint16_t bitsPerSample = 16;
+        const uint8_t *dataStart = nullptr;
+        size_t dataBytes = 0;
+
+        while (pos + 8 <= size) {
+            const uint8_t *hdr = data + pos;
+            uint32_t chunkSize = read_u32_le(hdr + 4);
+            pos += 8;
+
+            if (pos + chunkSize > size) return false; // malformed
+
+            if (std::memcmp(hdr, "fmt ", 4) == 0) {
+                if (chunkSize < 16) return false;
+                audioFormat = read_u16_le(data + pos);
+                numChannels = read_u16_le(data + pos + 2);
+                sampleRate = read_u32_le(data + pos + 4);
+                bitsPerSample = read_u16_le(data + pos + 14);
+                // ignore any extra fmt bytes
+            } else if (std::memcmp(hdr, "data", 4) == 0) {
+                dataStart = data + pos;
+                dataBytes = chunkSize;
+                break; // done
+            }
+
+            pos += chunkSize;
+        }
+
+        if (!dataStart || dataBytes == 0 || numChannels == 0) return false;
+
+        if (audioFormat == 1 && bitsPerSample == 16) {
+            info.format = SampleFormat::kInt16;
+        } else if (audioFormat == 3 && bitsPerSample == 32) {
+            info.format = SampleFormat::kFloat32;
+        } else {
+            return false; // Unsupported format
+        }
+
+        info.channels = numChannels;
+        info.sampleRate = sampleRate;
+        info.data = dataStart;
+        info.frames = dataBytes / (bytesPerSample(info.format) * numChannels);
+        return info.frames > 0;
+    }
+
+    void downmixToMono(const void *src, SampleFormat format, int channels, size_t frames, float *out) {
+        const float scale = 1.0f / static_cast<float>(channels);
+        // int16 is converted in scratch-sized chunks by the dispatched kernel, then summed.
+        constexpr size_t kScratch = 1024;
+        if (format == SampleFormat::kInt16 && static_cast<size_t>(channels) <= kScratch) {
+            const auto *s = static_cast<const uint8_t *>(src);
+            const size_t ch = static_cast<size_t>(channels);
+            const size_t perChunk = kScratch / ch;
+            float scratch[kScratch];
+            const dsp::Kernels &kernels = dsp::kernels();
+            for (size_t i = 0; i < frames; i += perChunk) {
+                const size_t n = std::min(perChunk, frames - i);
+                if (ch == 1) {
+                    kernels.int16ToFloat(s + 2 * i, out + i, n, 1.0f / 32768.0f);
+                    continue;
+                }
+                kernels.int16ToFloat(s + 2 * i * ch, scratch, n * ch, 1.0f / 32768.0f);
+                for (size_t f = 0; f < n; ++f) {
+                    float acc = 0.0f;
+                    for (size_t c = 0; c < ch; ++c) acc += scratch[f * ch + c];
+                    out[i + f] = acc * scale;
+                }
+            }
+        } else if (format == SampleFormat::kInt16) {
+            const auto *s = static_cast<const uint8_t *>(src);
+            for (size_t i = 0; i < frames; ++i) {
+                float acc = 0.0f;
+                for (int c = 0; c < channels; ++c) {
+                    // memcpy: WAV data chunks are not guaranteed to be 2-byte aligned.
+                    int16_t v;
+                    std::memcpy(&v, s + (i * channels + c) * 2, sizeof(v));
+                    acc += static_cast<float>(v) / 32768.0f;
+                }
+                out[i] = acc * scale;
+            }
+        } else {
+            const auto *s = static_cast<const uint8_t *>(src);
+            for (size_t i = 0; i < frames; ++i) {
+                float acc = 0.0f;
+                for (int c = 0; c < channels; ++c) {
+                    float v;
+                    std::memcpy(&v, s + (i * channels + c) * 4, sizeof(v));
+                    acc += v;
+                }
+                out[i] = acc * scale;
+            }
+        }
+    }
+
+    float *toMonoInPlace(void *buffer, size_t capacityBytes, SampleFormat format, int channels, size_t frames) {
+        if (!buffer || channels <= 0 || reinterpret_cast<uintptr_t>(buffer) % alignof(float) != 0) return nullptr;
+        const size_t ch = static_cast<size_t>(channels);
+        if (capacityBytes / (bytesPerSample(format) * ch) < frames || capacityBytes / sizeof(float) < frames) return nullptr;
+        auto *out = static_cast<float *>(buffer);
+        if (format == SampleFormat::kFloat32 && ch == 1) return out;
+        if (format == SampleFormat::kInt16 && ch == 1) {
+            // Each float is wider than its source sample, so convert from the end backwards:
+            // frame i's output only overwrites samples at or past i, all consumed already.
+            const auto *s = static_cast<const uint8_t *>(buffer);
+            for (size_t i = frames; i-- > 0;) {
+                int16_t v;
+                std::memcpy(&v, s + 2 * i, sizeof(v));
+                out[i] = static_cast<float>(v) / 32768.0f;
+            }
+            return out;
+        }
+        // Otherwise the output stride (4 bytes) never exceeds the input frame stride, and
+        // downmixToMono reads each frame (or int16 chunk) before writing its result.
+        downmixToMono(buffer, format, channels, frames, out);
+        return out;
+    }
+
+    void normalizePeak(float *data, size_t count) {
+        float maxv = 0.0f;
+        for (size_t i = 0; i < count; ++i) maxv = std::max(maxv, std::fabs(data[i]));
+        if (maxv < 1e-6f) return;
+        const float g = 1.0f / maxv;
+        for (size_t i = 0; i < count; ++i) data[i] *= g;
+    }
+
+    LinearResampler::LinearResampler(double inRate, double outRate)
+            : step_(outRate > 0.0 ? inRate / outRate : 1.0) {}
+
+    size_t LinearResampler::maxOutput(size_t inFrames) const {
+        return static_cast<size_t>(std::ceil(static_cast<double>(inFrames + 1) / step_)) + 1;
+    }
+
+    size_t LinearResampler::process(const float *in, size_t inFrames, float *out, size_t outCapacity) {
+        if (inFrames == 0) return 0;
+        size_t produced = 0;
+        const auto n = static_cast<int64_t>(inFrames);
+        while (produced < outCapacity) {
+            const double base = std::floor(pos_);
+            const auto i0 = static_cast<int64_t>(base);
+            if (i0 + 1 >= n) break;
+            const float a = i0 < 0 ? prev_ : in[i0];
+            const float b = in[i0 + 1];
+            const auto frac = static_cast<float>(pos_ - base);
+            out[produced++] = a + (b - a) * frac;
+            pos_ += step_;
+        }
+        prev_ = in[inFrames - 1];
+        pos_ -= static_cast<double>(inFrames);
+        return produced;
+    }
+
+} // namespace pcm
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// PCM parsing and conversion kernels shared by Wavetable and the import pipeline.
+// All functions work on caller-provided buffers so they can run chunk by chunk.
+namespace pcm {
+
+    enum class SampleFormat : uint8_t {
+        kInt16 = 0,
+        kFloat32,
+    };
+
+    inline size_t bytesPerSample(SampleFormat f) { return f == SampleFormat::kInt16 ? 2 : 4; }
+
+    // Location and format of the sample data inside a RIFF/WAVE byte buffer.
+    struct WavInfo {
+        SampleFormat format = SampleFormat::kInt16;
+        int channels = 1;
+        uint32_t sampleRate = 44100;
+        const uint8_t *data = nullptr;   // first sample frame (points into the input buffer)
+        size_t frames = 0;
+    };
+
+    // Minimal RIFF/WAVE parser. Accepts PCM 16-bit or IEEE float 32.
+    bool parseWav(const uint8_t *data, size_t size, WavInfo &info);
+
+    // Converts interleaved frames to mono float in [-1, 1] by averaging channels.
+    void downmixToMono(const void *src, SampleFormat format, int channels, size_t frames, float *out);
+
+    // Converts interleaved frames to mono float inside their own buffer (capacityBytes long,
+    // 4-byte aligned) and returns it, or nullptr when the result does not fit (mono int16 needs
+    // 4 bytes per frame) or the buffer is misaligned. Mono float is returned as is.
+    float *toMonoInPlace(void *buffer, size_t capacityBytes, SampleFormat format, int channels, size_t frames);
+
+    // Scales data so its peak magnitude is 1 (silence is left untouched).
+    void normalizePeak(float *data, size_t count);
+
+    // Streaming linear-interpolation resampler; feed any chunk size, state carries over.
+    class LinearResampler {
+    public:
+        LinearResampler(double inRate, double outRate);
+
+        // Worst-case output frames for an input chunk of inFrames.
+        size_t maxOutput(size_t inFrames) const;
+
+        // Consumes all of in[0..inFrames) and writes up to outCapacity frames; returns frames written.
+        size_t process(const float *in, size_t inFrames, float *out, size_t outCapacity);
+
+    private:
+        double step_;      // input frames per output frame
+        double pos_ = 0.0; // next read position relative to the current chunk (-1 = previous sample)
+        float prev_ = 0.0f;
+    };
+
+} // namespace pcm
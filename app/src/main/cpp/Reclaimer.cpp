@@ -0,0 +1,114 @@
+#include "Reclaimer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+Reclaimer &Reclaimer::instance() {
+    // Never destroyed: an engine retired just before exit would otherwise be freed during static
+    // destruction, after the things it uses.
+    static Reclaimer *reclaimer = new Reclaimer();
+    return *reclaimer;
+}
+
+Reclaimer::Reclaimer(bool housekeeping) {
+    if (housekeeping) housekeeper_ = std::thread([this] { housekeepingLoop(); });
+}
+
+Reclaimer::~Reclaimer() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        exit_ = true;
+    }
+    wake_.notify_one();
+    if (housekeeper_.joinable()) housekeeper_.join();
+
+    // No guards are left, so the epochs no longer matter. A deleter may retire more.
+    for (;;) {
+        std::vector<Retired> rest;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            rest.swap(retired_);
+        }
+        if (rest.empty()) break;
+        for (const Retired &r : rest) r.deleter(r.p);
+        freed_.fetch_add(rest.size(), std::memory_order_relaxed);
+        pending_.fetch_sub(rest.size(), std::memory_order_release);
+    }
+}
+
+// Announces the epoch this guard started in. The CAS claims a free slot and the fence orders
+// the announcement before every load the guarded block makes; collect() fences between
+// bumping the epoch and scanning, so it either sees this slot or this block sees the unlink.
+int Reclaimer::enter() {
+    const uint64_t e = epoch_.load(std::memory_order_acquire);
+    for (;;) {
+        for (int i = 0; i < kMaxReaders; ++i) {
+            std::atomic<uint64_t> &slot = readers_[i].epoch;
+            uint64_t free = 0;
+            if (slot.load(std::memory_order_relaxed) == 0
+                && slot.compare_exchange_strong(free, e, std::memory_order_seq_cst)) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return i;
+            }
+        }
+    }
+}
+
+void Reclaimer::exit(int slot) {
+    readers_[slot].epoch.store(0, std::memory_order_release);
+}
+
+void Reclaimer::retire(void *p, void (*deleter)(void *)) {
+    if (!p) return;
+    // A release RMW: a guard that later reads a newer epoch (every write to epoch_ is an RMW,
+    // so it continues this release sequence) also sees the unlink that preceded this.
+    const uint64_t e = epoch_.fetch_add(0, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        pending_.fetch_add(1, std::memory_order_relaxed);   // before any pass can free it
+        retired_.push_back(Retired{p, deleter, e});
+    }
+    wake_.notify_one();
+}
+
+int Reclaimer::collect() {
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (retired_.empty()) return 0;
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // An object stamped e is safe once no guard announced an epoch <= e: guards entered
+        // since then read an epoch written after its retire().
+        uint64_t oldest = std::numeric_limits<uint64_t>::max();
+        for (const Slot &s : readers_) {
+            const uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+            if (e != 0) oldest = std::min(oldest, e);
+        }
+        const auto firstReady = std::partition(retired_.begin(), retired_.end(),
+                                               [oldest](const Retired &r) { return r.epoch >= oldest; });
+        ready.assign(firstReady, retired_.end());
+        retired_.erase(firstReady, retired_.end());
+    }
+    for (const Retired &r : ready) r.deleter(r.p);
+    freed_.fetch_add(ready.size(), std::memory_order_relaxed);
+    pending_.fetch_sub(ready.size(), std::memory_order_release);
+    return static_cast<int>(ready.size());
+}
+
+// Collects as soon as something is retired (callbacks spend most of their period outside a
+// guard, so that usually frees it), then every kPeriodMs until nothing is pending.
+void Reclaimer::housekeepingLoop() {
+    std::unique_lock<std::mutex> guard(mutex_);
+    while (!exit_) {
+        wake_.wait(guard, [this] { return exit_ || !retired_.empty(); });
+        if (exit_) break;
+        guard.unlock();
+        collect();
+        guard.lock();
+        if (!retired_.empty()) {
+            wake_.wait_for(guard, std::chrono::milliseconds(kPeriodMs), [this] { return exit_; });
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Epoch-based reclamation for everything the audio thread reads through a pointer that other
+// threads replace: wavetables and samples (AssetRegistry), render plans (RenderGraph) and the
+// engine itself (nativeDelete).
+//
+// A reader (the audio callback) wraps each block in a Guard, which announces the global epoch
+// it started in and withdraws it on exit; both are single atomic operations on a
+// preallocated slot. Writers unlink an object first and then retire() it, stamping it with the
+// current epoch. The housekeeping thread advances the epoch and frees an object once every
+// announced epoch is newer than its stamp, i.e. once each block that could have loaded the old
+// pointer has finished. The audio thread never frees memory, takes a lock or waits on a
+// writer, and dropping a table is no longer tied to the lifetime of whoever published it.
+class Reclaimer {
+public:
+    static constexpr int kMaxReaders = 16;   // concurrent guards (callbacks), not engines
+    static constexpr int kPeriodMs = 10;     // housekeeping pass while objects are pending
+
+    // The process-wide instance used by the engine; started on first use.
+    static Reclaimer &instance();
+
+    // housekeeping = false leaves collection to explicit collect() calls (tests).
+    explicit Reclaimer(bool housekeeping = true);
+    // Stops the housekeeping thread and frees everything still retired; no guard may be held.
+    ~Reclaimer();
+
+    Reclaimer(const Reclaimer &) = delete;
+    Reclaimer &operator=(const Reclaimer &) = delete;
+
+    // --- Audio thread (wait-free while fewer than kMaxReaders guards are held) ---
+    class Guard {
+    public:
+        explicit Guard(Reclaimer &r) : reclaimer_(r), slot_(r.enter()) {}
+        ~Guard() { reclaimer_.exit(slot_); }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        Reclaimer &reclaimer_;
+        const int slot_;
+    };
+
+    // --- Non-audio threads ---
+    // Frees p with deleter after every guard that might still see it has been released. p
+    // must already be unreachable for guards entered from now on.
+    void retire(void *p, void (*deleter)(void *));
+    template <typename T>
+    void retire(T *p) {
+        if (p) retire(p, [](void *q) { delete static_cast<T *>(q); });
+    }
+
+    // One housekeeping pass: advances the epoch and frees what no guard can see any more.
+    // Returns the number of objects freed. Deleters run outside the internal mutex, so a
+    // destructor may retire() further objects.
+    int collect();
+
+    // Retired and not yet freed (including objects whose deleter is running).
+    size_t pending() const { return pending_.load(std::memory_order_acquire); }
+    uint64_t freedCount() const { return freed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Retired {
+        void *p;
+        void (*deleter)(void *);
+        uint64_t epoch;
+    };
+
+    int enter();
+    void exit(int slot);
+    void housekeepingLoop();
+
+    std::atomic<uint64_t> epoch_{1};                   // 0 marks a free reader slot
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};
+    };
+    Slot readers_[kMaxReaders];
+
+    mutable std::mutex mutex_;   // never taken by the audio thread
+    std::condition_variable wake_;
+    std::vector<Retired> retired_;
+    bool exit_ = false;
+    std::atomic<size_t> pending_{0};
+    std::atomic<uint64_t> freed_{0};
+    std::thread housekeeper_;
+};
@@ -0,0 +1,216 @@
+#include "RenderGraph.h"
+#include "DspKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+    inline int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+} // namespace
+
+RenderNode::Stats RenderNode::stats() const {
+    Stats s;
+    s.nanos = nanos_.load(std::memory_order_relaxed);
+    s.runs = runs_.load(std::memory_order_relaxed);
+    s.skips = skips_.load(std::memory_order_relaxed);
+    return s;
+}
+
+bool MixNode::process(const float *const *inputs, int numInputs, float *out, int frames) {
+    if (numInputs == 0) return false;
+    const float g = gain_.load(std::memory_order_relaxed);
+    const dsp::Kernels &kernels = dsp::kernels();
+    kernels.mixScale(out, inputs[0], g, 2 * frames);
+    for (int k = 1; k < numInputs; ++k) kernels.mixAdd(out, inputs[k], g, 2 * frames);
+    return true;
+}
+
+RenderGraph::~RenderGraph() {
+    delete published_.load(std::memory_order_relaxed);
+}
+
+int RenderGraph::addNode(RenderNode *node) {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    if (!node || static_cast<int>(nodes_.size()) >= kMaxNodes) return -1;
+    nodes_.push_back(node);
+    inputs_.emplace_back();
+    return static_cast<int>(nodes_.size()) - 1;
+}
+
+bool RenderGraph::connect(int from, int to) {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    const int n = static_cast<int>(nodes_.size());
+    if (from < 0 || from >= n || to < 0 || to >= n || from == to) return false;
+    std::vector<int> &in = inputs_[to];
+    if (std::find(in.begin(), in.end(), from) != in.end()) return true;
+    if (static_cast<int>(in.size()) >= kMaxInputs) return false;
+    in.push_back(from);
+    return true;
+}
+
+bool RenderGraph::disconnect(int from, int to) {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    if (to < 0 || to >= static_cast<int>(nodes_.size())) return false;
+    std::vector<int> &in = inputs_[to];
+    const auto it = std::find(in.begin(), in.end(), from);
+    if (it == in.end()) return false;
+    in.erase(it);
+    return true;
+}
+
+bool RenderGraph::setOutput(int node) {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    if (node < 0 || node >= static_cast<int>(nodes_.size())) return false;
+    output_ = node;
+    return true;
+}
+
+bool RenderGraph::compile() {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    const int n = static_cast<int>(nodes_.size());
+    if (output_ < 0) return false;
+
+    // Only what feeds the output is scheduled.
+    std::vector<bool> reached(n, false);
+    std::vector<int> stack{output_};
+    reached[output_] = true;
+    while (!stack.empty()) {
+        const int v = stack.back();
+        stack.pop_back();
+        for (int u : inputs_[v]) {
+            if (!reached[u]) {
+                reached[u] = true;
+                stack.push_back(u);
+            }
+        }
+    }
+
+    // Kahn's algorithm, lowest id first so equal topologies compile to equal plans.
+    std::vector<int> pending(n, 0);
+    std::vector<std::vector<int>> consumers(n);
+    for (int v = 0; v < n; ++v) {
+        if (!reached[v]) continue;
+        for (int u : inputs_[v]) {
+            ++pending[v];
+            consumers[u].push_back(v);
+        }
+    }
+    std::vector<int> order;
+    std::vector<bool> ready(n, false);
+    for (int v = 0; v < n; ++v) ready[v] = reached[v] && pending[v] == 0;
+    for (;;) {
+        int next = -1;
+        for (int v = 0; v < n && next < 0; ++v) {
+            if (ready[v]) next = v;
+        }
+        if (next < 0) break;
+        ready[next] = false;
+        order.push_back(next);
+        for (int c : consumers[next]) {
+            if (--pending[c] == 0) ready[c] = true;
+        }
+    }
+    const int scheduled = static_cast<int>(std::count(reached.begin(), reached.end(), true));
+    if (static_cast<int>(order.size()) != scheduled) return false;   // cycle
+
+    // Liveness: a node's buffer is free again after its last consumer has run. The output
+    // is allocated before the inputs are released so a node never reads what it writes.
+    std::vector<int> position(n, -1), lastUse(n, -1), buffer(n, -1);
+    for (int i = 0; i < scheduled; ++i) position[order[i]] = i;
+    for (int v : order) {
+        for (int u : inputs_[v]) lastUse[u] = std::max(lastUse[u], position[v]);
+    }
+    bool busy[kMaxNodes] = {};
+    auto plan = std::make_unique<Plan>();
+    for (int i = 0; i < scheduled; ++i) {
+        const int v = order[i];
+        int b = 0;
+        while (busy[b]) ++b;
+        busy[b] = true;
+        buffer[v] = b;
+        plan->numBuffers = std::max(plan->numBuffers, b + 1);
+
+        Step &step = plan->steps[i];
+        step.node = nodes_[v];
+        step.output = b;
+        step.numInputs = static_cast<int>(inputs_[v].size());
+        for (int k = 0; k < step.numInputs; ++k) {
+            const int u = inputs_[v][k];
+            step.inputs[k] = buffer[u];
+            if (lastUse[u] == i && u != output_) busy[buffer[u]] = false;
+        }
+    }
+    plan->numSteps = scheduled;
+    plan->outputBuffer = buffer[output_];
+
+    plannedNodes_ = plan->numSteps;
+    plannedBuffers_ = plan->numBuffers;
+    // The previous plan may still be running in a callback; the reclaimer frees it later.
+    reclaimer_.retire(published_.exchange(plan.release(), std::memory_order_acq_rel));
+    return true;
+}
+
+int RenderGraph::nodeCount() const {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    return static_cast<int>(nodes_.size());
+}
+
+RenderNode *RenderGraph::node(int id) const {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    return id >= 0 && id < static_cast<int>(nodes_.size()) ? nodes_[id] : nullptr;
+}
+
+int RenderGraph::plannedNodes() const {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    return plannedNodes_;
+}
+
+int RenderGraph::plannedBuffers() const {
+    std::lock_guard<std::mutex> guard(editMutex_);
+    return plannedBuffers_;
+}
+
+bool RenderGraph::render(float *out, int frames) {
+    lastRun_ = 0;
+    lastSkipped_ = 0;
+    frames = std::min(frames, kMaxFrames);
+    const Plan *plan = published_.load(std::memory_order_acquire);
+    if (!plan || frames <= 0) {
+        if (frames > 0) std::memset(out, 0, sizeof(float) * 2 * static_cast<size_t>(frames));
+        return false;
+    }
+
+    for (int i = 0; i < plan->numSteps; ++i) {
+        const Step &step = plan->steps[i];
+        const float *in[kMaxInputs];
+        int live = 0;
+        for (int k = 0; k < step.numInputs; ++k) {
+            if (live_[step.inputs[k]]) in[live++] = buffers_[step.inputs[k]];
+        }
+        RenderNode &node = *step.node;
+        if (live == 0 && !node.active()) {
+            live_[step.output] = false;
+            node.skips_.fetch_add(1, std::memory_order_relaxed);
+            ++lastSkipped_;
+            continue;
+        }
+        const int64_t t0 = nowNanos();
+        live_[step.output] = node.process(in, live, buffers_[step.output], frames);
+        node.nanos_.fetch_add(nowNanos() - t0, std::memory_order_relaxed);
+        node.runs_.fetch_add(1, std::memory_order_relaxed);
+        ++lastRun_;
+    }
+
+    if (!live_[plan->outputBuffer]) {
+        std::memset(out, 0, sizeof(float) * 2 * static_cast<size_t>(frames));
+        return false;
+    }
+    std::memcpy(out, buffers_[plan->outputBuffer], sizeof(float) * 2 * static_cast<size_t>(frames));
+    return true;
+}
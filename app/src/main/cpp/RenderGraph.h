@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Reclaimer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// One processing stage of the RenderGraph (a source, bus, effect or mixer).
+//
+// Nodes are owned by the caller and must outlive the graph. process() and active() run on
+// the audio thread only; the telemetry counters may be read from any thread.
+class RenderNode {
+public:
+    struct Stats {
+        int64_t nanos = 0;   // total time spent in process()
+        int64_t runs = 0;    // process() calls
+        int64_t skips = 0;   // calls skipped because the node and all its inputs were silent
+    };
+
+    explicit RenderNode(const char *name) : name_(name) {}
+    virtual ~RenderNode() = default;
+
+    RenderNode(const RenderNode &) = delete;
+    RenderNode &operator=(const RenderNode &) = delete;
+
+    const char *name() const { return name_; }
+
+    // Writes frames interleaved stereo frames into out (not cleared beforehand). inputs holds
+    // only the inputs that carry signal this pass. Returns false if out was left silent, in
+    // which case downstream nodes never read it.
+    virtual bool process(const float *const *inputs, int numInputs, float *out, int frames) = 0;
+
+    // True while the node makes sound without input (a source with voices, an effect tail).
+    // A node that is not active and has no live input is skipped.
+    virtual bool active() const { return false; }
+
+    Stats stats() const;
+
+private:
+    friend class RenderGraph;
+
+    const char *name_;
+    std::atomic<int64_t> nanos_{0};
+    std::atomic<int64_t> runs_{0};
+    std::atomic<int64_t> skips_{0};
+};
+
+// Sums its live inputs, scaled by gain. Silent when every input is.
+class MixNode final : public RenderNode {
+public:
+    explicit MixNode(const char *name, float gain = 1.0f) : RenderNode(name), gain_(gain) {}
+
+    void setGain(float gain) { gain_.store(gain, std::memory_order_relaxed); }
+    bool process(const float *const *inputs, int numInputs, float *out, int frames) override;
+
+private:
+    std::atomic<float> gain_;
+};
+
+// Preallocated render graph: sources -> buses -> effects -> mixer -> master.
+//
+// Non-audio threads edit the topology (addNode, connect, setOutput) and compile() it into a
+// plan: nodes that do not reach the output are dropped, the rest are ordered topologically
+// and every node output is given one of kMaxNodes scratch buffers by liveness (a buffer is
+// reused once its last reader has run), so a chain of any length works in two buffers and
+// a fan-in of k sources in k + 1. The plan is published with one atomic store and picked
+// up by the next render(); the replaced plan is retired to the Reclaimer, so render() must
+// run inside a Reclaimer::Guard whenever compile() can run concurrently.
+//
+// render() runs the plan in order, skipping nodes that are silent (see RenderNode::active)
+// along with everything downstream of them that has no other live input, and times every
+// node that runs. It never allocates or blocks.
+class RenderGraph {
+public:
+    static constexpr int kMaxNodes = 32;
+    static constexpr int kMaxInputs = 8;     // per node
+    static constexpr int kMaxFrames = 64;    // per render() call
+
+    explicit RenderGraph(Reclaimer &reclaimer = Reclaimer::instance()) : reclaimer_(reclaimer) {}
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph &) = delete;
+    RenderGraph &operator=(const RenderGraph &) = delete;
+
+    // --- Non-audio threads ---
+    // Returns the node id (ids count up from 0), or -1 when full.
+    int addNode(RenderNode *node);
+    // Feeds from's output into to. False for unknown ids, self loops or a full input list.
+    bool connect(int from, int to);
+    bool disconnect(int from, int to);
+    // The node whose output render() returns (normally the master).
+    bool setOutput(int node);
+    // Builds and publishes a plan for the current topology. False (and nothing published)
+    // when there is no output or the graph has a cycle.
+    bool compile();
+
+    int nodeCount() const;
+    RenderNode *node(int id) const;
+    // Shape of the last compiled plan.
+    int plannedNodes() const;
+    int plannedBuffers() const;
+
+    // --- Audio thread ---
+    // Renders frames (<= kMaxFrames) interleaved stereo frames into out. Returns false when
+    // the output was silent (out is zeroed). Without a plan renders silence.
+    bool render(float *out, int frames);
+    // Nodes run / skipped by the last render().
+    int lastRun() const { return lastRun_; }
+    int lastSkipped() const { return lastSkipped_; }
+
+private:
+    struct Step {
+        RenderNode *node = nullptr;
+        int output = 0;                 // buffer index
+        int numInputs = 0;
+        int inputs[kMaxInputs] = {};    // buffer indices
+    };
+
+    struct Plan {
+        int numSteps = 0;
+        int numBuffers = 0;
+        int outputBuffer = -1;
+        Step steps[kMaxNodes];
+    };
+
+    // Topology; guarded by editMutex_, never read by the audio thread.
+    mutable std::mutex editMutex_;
+    std::vector<RenderNode *> nodes_;
+    std::vector<std::vector<int>> inputs_;   // per node, source node ids
+    int output_ = -1;
+    int plannedNodes_ = 0;
+    int plannedBuffers_ = 0;
+
+    Reclaimer &reclaimer_;
+    std::atomic<Plan *> published_{nullptr};
+
+    // Audio thread.
+    int lastRun_ = 0;
+    int lastSkipped_ = 0;
+    bool live_[kMaxNodes] = {};
+    alignas(64) float buffers_[kMaxNodes][2 * kMaxFrames] = {};
+};
@@ -0,0 +1,252 @@
+#include "SmfRecorder.h"
+#include "Ump.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    constexpr int kWriterPeriodMs = 5;
+
+    int64_t steadyNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Variable-length quantity: 7 bits per byte, most significant first.
+    void putVarLen(std::vector<uint8_t> &out, uint32_t v) {
+        uint8_t bytes[5];
+        int n = 0;
+        do {
+            bytes[n++] = static_cast<uint8_t>(v & 0x7F);
+            v >>= 7;
+        } while (v);
+        while (n > 1) out.push_back(static_cast<uint8_t>(bytes[--n] | 0x80));
+        out.push_back(bytes[0]);
+    }
+
+    void putBigEndian(std::vector<uint8_t> &out, uint32_t v, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    void putMetaText(std::vector<uint8_t> &out, uint8_t type, const std::string &text) {
+        out.push_back(0x00);
+        out.push_back(0xFF);
+        out.push_back(type);
+        putVarLen(out, static_cast<uint32_t>(text.size()));
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    void putEndOfTrack(std::vector<uint8_t> &out, uint32_t delta) {
+        putVarLen(out, delta);
+        out.push_back(0xFF);
+        out.push_back(0x2F);
+        out.push_back(0x00);
+    }
+
+    // "MTrk", the length of head + bodyBytes + tail, then head (body and tail follow).
+    bool writeTrackHeader(std::FILE *f, const std::vector<uint8_t> &head, size_t bodyBytes,
+                          const std::vector<uint8_t> &tail) {
+        std::vector<uint8_t> chunk = {'M', 'T', 'r', 'k'};
+        putBigEndian(chunk, static_cast<uint32_t>(head.size() + bodyBytes + tail.size()), 4);
+        chunk.insert(chunk.end(), head.begin(), head.end());
+        return std::fwrite(chunk.data(), 1, chunk.size(), f) == chunk.size();
+    }
+
+    bool copyFile(std::FILE *from, std::FILE *to) {
+        char buf[16384];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), from)) > 0) {
+            if (std::fwrite(buf, 1, n, to) != n) return false;
+        }
+        return !std::ferror(from);
+    }
+
+} // namespace
+
+SmfRecorder::~SmfRecorder() {
+    stop();
+}
+
+int64_t SmfRecorder::sinceStart() const {
+    return steadyNanos() - startNanos_;
+}
+
+uint32_t SmfRecorder::toTicks(int64_t tNanos) {
+    if (tNanos <= 0) return 0;
+    constexpr int64_t kNanosPerQuarter = static_cast<int64_t>(kMicrosPerQuarter) * 1000;
+    const int64_t ticks = (tNanos * kTicksPerQuarter + kNanosPerQuarter / 2) / kNanosPerQuarter;
+    return static_cast<uint32_t>(std::min<int64_t>(ticks, 0x0FFFFFFF));   // largest delta an SMF can hold
+}
+
+int SmfRecorder::toMidi1(const EngineEvent &e, uint8_t out[3]) {
+    const bool highRes = e.flags & EngineEvent::kFlagHighRes;
+    const uint8_t ch = e.channel & 0x0F;
+    switch (e.type) {
+        case EngineEvent::kNoteOn:
+            out[0] = static_cast<uint8_t>(0x90 | ch);
+            out[1] = e.data1 & 0x7F;
+            out[2] = static_cast<uint8_t>(highRes ? ump::velocity16To7Bit(e.value) : e.value & 0x7F);
+            return 3;
+        case EngineEvent::kNoteOff:
+            out[0] = static_cast<uint8_t>(0x80 | ch);
+            out[1] = e.data1 & 0x7F;
+            out[2] = static_cast<uint8_t>(highRes ? (e.value >> 9) & 0x7F : e.value & 0x7F);
+            return 3;
+        case EngineEvent::kPitchBend: {
+            const uint32_t v = highRes ? static_cast<uint32_t>(ump::to14Bit(e.value)) : e.value & 0x3FFF;
+            out[0] = static_cast<uint8_t>(0xE0 | ch);
+            out[1] = static_cast<uint8_t>(v & 0x7F);
+            out[2] = static_cast<uint8_t>(v >> 7);
+            return 3;
+        }
+        case EngineEvent::kChannelPressure:
+            out[0] = static_cast<uint8_t>(0xD0 | ch);
+            out[1] = static_cast<uint8_t>(highRes ? ump::to7Bit(e.value) : e.value & 0x7F);
+            return 2;
+        case EngineEvent::kControlChange:
+        default:
+            out[0] = static_cast<uint8_t>(0xB0 | ch);
+            out[1] = e.data1 & 0x7F;
+            out[2] = static_cast<uint8_t>(highRes ? ump::to7Bit(e.value) : e.value & 0x7F);
+            return 3;
+    }
+}
+
+bool SmfRecorder::start(const std::string &path) {
+    std::lock_guard<std::mutex> guard(controlMutex_);
+    if (file_) return false;
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+    path_ = path;
+
+    // Late pushes from a previous export (racing its stop()) are not part of this one.
+    Timed stale;
+    while (queue_.pop(stale)) {}
+    std::fill(std::begin(lastTick_), std::end(lastTick_), 0u);
+    spoolError_ = false;
+    dropped_.store(0, std::memory_order_relaxed);
+    written_.store(0, std::memory_order_relaxed);
+    startNanos_ = steadyNanos();
+
+    writerRun_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { writerLoop(); });
+    active_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool SmfRecorder::stop() {
+    std::lock_guard<std::mutex> guard(controlMutex_);
+    if (!file_) return false;
+    active_.store(false, std::memory_order_release);
+    writerRun_.store(false, std::memory_order_release);
+    if (writer_.joinable()) writer_.join();
+    drainToSpools();
+    const bool ok = assemble() && !spoolError_;
+    closeSpools();
+    const bool closed = std::fclose(file_) == 0;
+    file_ = nullptr;
+    return ok && closed;
+}
+
+void SmfRecorder::push(const EngineEvent &e, int64_t tNanos) {
+    if (!queue_.push(Timed{tNanos, e})) dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SmfRecorder::writerLoop() {
+    while (writerRun_.load(std::memory_order_acquire)) {
+        drainToSpools();
+        std::this_thread::sleep_for(std::chrono::milliseconds(kWriterPeriodMs));
+    }
+}
+
+std::string SmfRecorder::spoolPath(int channel) const {
+    return path_ + ".ch" + std::to_string(channel + 1);
+}
+
+void SmfRecorder::drainToSpools() {
+    std::vector<uint8_t> bytes;
+    uint64_t total = 0;
+    Timed t;
+    while (queue_.pop(t)) {
+        const int ch = t.event.channel & 0x0F;
+        std::FILE *&spool = spools_[ch];
+        if (!spool) {
+            spool = std::fopen(spoolPath(ch).c_str(), "w+b");
+            if (!spool) {
+                spoolError_ = true;
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+        }
+        // Producers stamp before pushing, so two threads can land slightly out of order.
+        const uint32_t tick = std::max(toTicks(t.tNanos), lastTick_[ch]);
+        uint8_t msg[3];
+        const int n = toMidi1(t.event, msg);
+        bytes.clear();
+        putVarLen(bytes, tick - lastTick_[ch]);
+        bytes.insert(bytes.end(), msg, msg + n);
+        lastTick_[ch] = tick;
+        if (std::fwrite(bytes.data(), 1, bytes.size(), spool) != bytes.size()) {
+            spoolError_ = true;
+            continue;
+        }
+        ++total;
+    }
+    if (total) written_.fetch_add(total, std::memory_order_relaxed);
+}
+
+bool SmfRecorder::assemble() {
+    uint32_t endTick = toTicks(sinceStart());
+    int tracks = 1;
+    for (int ch = 0; ch < kChannels; ++ch) {
+        if (!spools_[ch]) continue;
+        endTick = std::max(endTick, lastTick_[ch]);
+        ++tracks;
+    }
+
+    std::vector<uint8_t> header = {'M', 'T', 'h', 'd'};
+    putBigEndian(header, 6, 4);
+    putBigEndian(header, 1, 2);                   // format 1: simultaneous tracks
+    putBigEndian(header, static_cast<uint32_t>(tracks), 2);
+    putBigEndian(header, kTicksPerQuarter, 2);
+    if (std::fwrite(header.data(), 1, header.size(), file_) != header.size()) return false;
+
+    std::vector<uint8_t> head, tail;
+    putMetaText(head, 0x03, "Performance");
+    head.insert(head.end(), {0x00, 0xFF, 0x51, 0x03});
+    putBigEndian(head, kMicrosPerQuarter, 3);
+    head.insert(head.end(), {0x00, 0xFF, 0x58, 0x04, 0x04, 0x02, 0x18, 0x08});   // 4/4
+    putEndOfTrack(tail, endTick);
+    if (!writeTrackHeader(file_, head, 0, tail) || std::fwrite(tail.data(), 1, tail.size(), file_) != tail.size()) {
+        return false;
+    }
+
+    for (int ch = 0; ch < kChannels; ++ch) {
+        std::FILE *spool = spools_[ch];
+        if (!spool) continue;
+        std::fflush(spool);
+        const long bodyBytes = std::ftell(spool);
+        if (bodyBytes < 0 || std::fseek(spool, 0, SEEK_SET) != 0) return false;
+        head.clear();
+        tail.clear();
+        putMetaText(head, 0x03, "Channel " + std::to_string(ch + 1));
+        putEndOfTrack(tail, endTick - lastTick_[ch]);
+        if (!writeTrackHeader(file_, head, static_cast<size_t>(bodyBytes), tail) || !copyFile(spool, file_)
+            || std::fwrite(tail.data(), 1, tail.size(), file_) != tail.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SmfRecorder::closeSpools() {
+    for (int ch = 0; ch < kChannels; ++ch) {
+        if (!spools_[ch]) continue;
+        std::fclose(spools_[ch]);
+        spools_[ch] = nullptr;
+        std::remove(spoolPath(ch).c_str());
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "EventQueue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Performance export: every event the engine accepts (as posted to the audio queue) is
+// written to a Standard MIDI File (OboeSynthesizer.startPerformanceExport).
+//
+// record() stamps the event and pushes it into a lock-free MPSC queue; when no export is
+// running it is a single atomic load. A writer thread drains the queue every few
+// milliseconds, encodes each event as MIDI 1.0 with its delta time and appends it to a spool
+// file for its channel (path + ".chN"), so a long take is never held in memory. stop()
+// assembles the SMF: format 1, a tempo track, then one track per channel that carried events
+// (one per MPE member channel). MIDI 2.0 events (EngineEvent::kFlagHighRes) are reduced to
+// MIDI 1.0 resolution.
+class SmfRecorder {
+public:
+    static constexpr size_t kQueueCapacity = 8192;
+    static constexpr int kChannels = 16;
+    static constexpr int kTicksPerQuarter = 960;
+    static constexpr int kMicrosPerQuarter = 500000;   // 120 bpm: a tick is ~0.52 ms
+
+    SmfRecorder() = default;
+    ~SmfRecorder();
+
+    SmfRecorder(const SmfRecorder &) = delete;
+    SmfRecorder &operator=(const SmfRecorder &) = delete;
+
+    // Opens path (truncating) and starts an export; the file is written by stop(). False if
+    // one is already running or path cannot be created.
+    bool start(const std::string &path);
+    // Writes everything still queued, assembles the file and removes the spools. False if
+    // nothing was running or on I/O error.
+    bool stop();
+    bool active() const { return active_.load(std::memory_order_acquire); }
+
+    // Any thread; lock-free. No-ops while inactive.
+    void record(const EngineEvent &e) {
+        if (active()) push(e, sinceStart());
+    }
+    // With an explicit time since start() (host replay of a captured session).
+    void recordAt(const EngineEvent &e, int64_t tNanos) {
+        if (active()) push(e, tNanos);
+    }
+
+    // Events lost because the queue was full (writer behind) since start().
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t writtenCount() const { return written_.load(std::memory_order_relaxed); }
+
+    // MIDI 1.0 bytes of e, status first; returns the length (2 or 3).
+    static int toMidi1(const EngineEvent &e, uint8_t out[3]);
+    static uint32_t toTicks(int64_t tNanos);
+
+private:
+    struct Timed {
+        int64_t tNanos;
+        EngineEvent event;
+    };
+
+    void push(const EngineEvent &e, int64_t tNanos);
+    void writerLoop();
+    void drainToSpools();
+    bool assemble();
+    void closeSpools();
+    std::string spoolPath(int channel) const;
+    int64_t sinceStart() const;
+
+    MpscQueue<Timed, kQueueCapacity> queue_;
+    std::atomic<bool> active_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    int64_t startNanos_ = 0;
+
+    std::mutex controlMutex_;    // start/stop
+    std::atomic<bool> writerRun_{false};
+    std::thread writer_;
+    std::FILE *file_ = nullptr;
+    std::string path_;
+
+    // Writer thread (stop() after joining it).
+    std::FILE *spools_[kChannels] = {};
+    uint32_t lastTick_[kChannels] = {};
+    bool spoolError_ = false;
+};
@@ -0,0 +1,105 @@
+#include "StreamDecoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace pcm {
+
+    namespace {
+
+        struct FileCloser {
+            void operator()(std::FILE *f) const { std::fclose(f); }
+        };
+        using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+        uint16_t readU16(const uint8_t *p) {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        uint32_t readU32(const uint8_t *p) {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+                    | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        // RIFF/WAVE, PCM 16-bit or IEEE float 32 (the formats parseWav accepts). The header is
+        // walked chunk by chunk; sample data is then read a chunk of frames at a time.
+        class WavStream final : public StreamDecoder {
+        public:
+            static std::unique_ptr<StreamDecoder> open(FilePtr file) {
+                if (std::fseek(file.get(), 12, SEEK_SET) != 0) return nullptr;
+
+                bool haveFmt = false;
+                uint16_t audioFormat = 0;
+                uint16_t channels = 0;
+                uint32_t sampleRate = 0;
+                uint16_t bits = 0;
+                uint8_t hdr[8];
+                while (std::fread(hdr, 1, sizeof(hdr), file.get()) == sizeof(hdr)) {
+                    const uint32_t size = readU32(hdr + 4);
+                    if (std::memcmp(hdr, "fmt ", 4) == 0) {
+                        uint8_t fmt[16];
+                        if (size < sizeof(fmt) || std::fread(fmt, 1, sizeof(fmt), file.get()) != sizeof(fmt)) return nullptr;
+                        audioFormat = readU16(fmt);
+                        channels = readU16(fmt + 2);
+                        sampleRate = readU32(fmt + 4);
+                        bits = readU16(fmt + 14);
+                        haveFmt = true;
+                        if (std::fseek(file.get(), static_cast<long>(size - sizeof(fmt) + (size & 1)), SEEK_CUR) != 0) return nullptr;
+                    } else if (std::memcmp(hdr, "data", 4) == 0) {
+                        if (!haveFmt || channels == 0 || channels > kMaxChannels || sampleRate == 0) return nullptr;
+                        SampleFormat format;
+                        if (audioFormat == 1 && bits == 16) format = SampleFormat::kInt16;
+                        else if (audioFormat == 3 && bits == 32) format = SampleFormat::kFloat32;
+                        else return nullptr;
+                        const size_t frames = size / (bytesPerSample(format) * channels);
+                        if (frames == 0) return nullptr;
+                        return std::unique_ptr<StreamDecoder>(
+                                new WavStream(std::move(file), format, channels, sampleRate, frames));
+                    } else if (std::fseek(file.get(), static_cast<long>(size + (size & 1)), SEEK_CUR) != 0) {
+                        return nullptr;
+                    }
+                }
+                return nullptr;
+            }
+
+            size_t read(float *out, size_t maxFrames) override {
+                const size_t n = std::min({maxFrames, kChunkFrames, remaining_});
+                if (n == 0) return 0;
+                const size_t got = std::fread(bytes_.get(), frameBytes_, n, file_.get());
+                if (got < n) {
+                    failed_ = true;     // shorter than the data chunk says
+                    remaining_ = 0;
+                } else {
+                    remaining_ -= got;
+                }
+                downmixToMono(bytes_.get(), format_, channels(), got, out);
+                return got;
+            }
+
+        private:
+            WavStream(FilePtr file, SampleFormat format, int channels, uint32_t sampleRate, size_t frames)
+                    : StreamDecoder(channels, sampleRate, frames),
+                      file_(std::move(file)), format_(format),
+                      frameBytes_(bytesPerSample(format) * static_cast<size_t>(channels)),
+                      remaining_(frames), bytes_(new uint8_t[kChunkFrames * frameBytes_]) {}
+
+            FilePtr file_;
+            SampleFormat format_;
+            size_t frameBytes_;
+            size_t remaining_;
+            std::unique_ptr<uint8_t[]> bytes_;
+        };
+
+    } // namespace
+
+    std::unique_ptr<StreamDecoder> StreamDecoder::open(const std::string &path) {
+        FilePtr file(std::fopen(path.c_str(), "rb"));
+        if (!file) return nullptr;
+        uint8_t head[12];
+        if (std::fread(head, 1, sizeof(head), file.get()) != sizeof(head)) return nullptr;
+        if (std::memcmp(head, "RIFF", 4) != 0 || std::memcmp(head + 8, "WAVE", 4) != 0) return nullptr;
+        return WavStream::open(std::move(file));
+    }
+
+} // namespace pcm
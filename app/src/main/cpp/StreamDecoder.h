@@ -0,0 +1,55 @@
+#pragma once
+
+#include "PcmConvert.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Streaming WAV file decoder for the import pipeline.
+//
+// open() checks the RIFF/WAVE header and returns a decoder that pulls the file through one
+// fixed-size buffer: each read() delivers at most kChunkFrames mono float frames (channels
+// averaged by the downmixToMono kernels), so decoding memory is bounded by a chunk whatever
+// the file length, and the decoded PCM goes straight to the caller's resampler without
+// reading the file whole. Formats are those parseWav accepts (int16, float32); compressed
+// audio is decoded on the Kotlin side (AudioDecoder.kt). Not for the audio thread.
+namespace pcm {
+
+    class StreamDecoder {
+    public:
+        static constexpr size_t kChunkFrames = 4096;
+        static constexpr int kMaxChannels = 16;
+
+        // nullptr if the file is missing or unreadable, or not a supported WAV file.
+        static std::unique_ptr<StreamDecoder> open(const std::string &path);
+
+        virtual ~StreamDecoder() = default;
+        StreamDecoder(const StreamDecoder &) = delete;
+        StreamDecoder &operator=(const StreamDecoder &) = delete;
+
+        int channels() const { return channels_; }
+        uint32_t sampleRate() const { return sampleRate_; }
+        // Total frames if the header says so, else 0 (a hint for reserving output).
+        size_t frameCountHint() const { return frameCountHint_; }
+
+        // Decodes up to min(maxFrames, kChunkFrames) mono frames into out; 0 at the end of
+        // the stream. failed() tells a truncated or corrupt stream from a clean end.
+        virtual size_t read(float *out, size_t maxFrames) = 0;
+        bool failed() const { return failed_; }
+
+    protected:
+        StreamDecoder(int channels, uint32_t sampleRate, size_t frameCountHint)
+                : channels_(channels), sampleRate_(sampleRate),
+                  frameCountHint_(frameCountHint) {}
+
+        bool failed_ = false;
+
+    private:
+        int channels_;
+        uint32_t sampleRate_;
+        size_t frameCountHint_;
+    };
+
+} // namespace pcm
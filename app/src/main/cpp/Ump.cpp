@@ -0,0 +1,118 @@
+#include "Ump.h"
+
+namespace {
+
+    // MIDI 2.0 channel voice opcodes (upper nibble of the status byte).
+    constexpr uint8_t kRegisteredPerNoteController = 0x0;
+    constexpr uint8_t kAssignablePerNoteController = 0x1;
+    constexpr uint8_t kPerNotePitchBend = 0x6;
+    constexpr uint8_t kNoteOff = 0x8;
+    constexpr uint8_t kNoteOn = 0x9;
+    constexpr uint8_t kPolyPressure = 0xA;
+    constexpr uint8_t kControlChange = 0xB;
+    constexpr uint8_t kChannelPressure = 0xD;
+    constexpr uint8_t kPitchBend = 0xE;
+
+    bool midi1ToEvent(uint32_t w, EngineEvent &out) {
+        const uint8_t opcode = (w >> 20) & 0x0F;
+        const uint8_t d1 = (w >> 8) & 0x7F;
+        const uint8_t d2 = w & 0x7F;
+        out.channel = (w >> 16) & 0x0F;
+        out.flags = 0;
+        switch (opcode) {
+            case kNoteOn:
+                out.type = EngineEvent::kNoteOn;
+                out.data1 = d1;
+                out.value = d2;
+                return true;
+            case kNoteOff:
+                out.type = EngineEvent::kNoteOff;
+                out.data1 = d1;
+                out.value = 0;
+                return true;
+            case kControlChange:
+                out.type = EngineEvent::kControlChange;
+                out.data1 = d1;
+                out.value = d2;
+                return true;
+            case kChannelPressure:
+                out.type = EngineEvent::kChannelPressure;
+                out.data1 = 0;
+                out.value = d1;
+                return true;
+            case kPitchBend:
+                out.type = EngineEvent::kPitchBend;
+                out.data1 = 0;
+                out.value = static_cast<uint32_t>(d1) | (static_cast<uint32_t>(d2) << 7);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool midi2ToEvent(uint32_t w0, uint32_t w1, EngineEvent &out) {
+        const uint8_t opcode = (w0 >> 20) & 0x0F;
+        const uint8_t index = (w0 >> 8) & 0x7F;   // note or controller number
+        const uint8_t index2 = w0 & 0xFF;         // per-note controller number / attribute type
+        out.channel = (w0 >> 16) & 0x0F;
+        out.flags = EngineEvent::kFlagHighRes;
+        switch (opcode) {
+            case kNoteOn:
+                out.type = EngineEvent::kNoteOn;
+                out.data1 = index;
+                out.value = w1 >> 16;
+                return true;
+            case kNoteOff:
+                out.type = EngineEvent::kNoteOff;
+                out.data1 = index;
+                out.value = w1 >> 16;
+                return true;
+            case kControlChange:
+                out.type = EngineEvent::kControlChange;
+                out.data1 = index;
+                out.value = w1;
+                return true;
+            case kChannelPressure:
+            case kPolyPressure:
+                out.type = EngineEvent::kChannelPressure;
+                out.data1 = 0;
+                out.value = w1;
+                return true;
+            case kPitchBend:
+            case kPerNotePitchBend:
+                out.type = EngineEvent::kPitchBend;
+                out.data1 = 0;
+                out.value = w1;
+                return true;
+            case kAssignablePerNoteController:
+                // Assignable controllers follow CC numbering (74 = brightness).
+                if (index2 > 127) return false;
+                out.type = EngineEvent::kControlChange;
+                out.data1 = index2;
+                out.value = w1;
+                return true;
+            case kRegisteredPerNoteController:
+            default:
+                return false;
+        }
+    }
+
+} // namespace
+
+namespace ump {
+
+    int packetWords(uint32_t word0) {
+        static constexpr int8_t kWords[16] = {1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4};
+        return kWords[word0 >> 28];
+    }
+
+    bool toEvent(const uint32_t *packet, int numWords, EngineEvent &out) {
+        if (numWords < 1) return false;
+        const uint32_t messageType = packet[0] >> 28;
+        if (numWords < packetWords(packet[0])) return false;
+        if (messageType == 0x2) return midi1ToEvent(packet[0], out);
+        if (messageType == 0x4) return midi2ToEvent(packet[0], packet[1], out);
+        return false;
+    }
+
+} // namespace ump
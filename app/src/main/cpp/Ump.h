@@ -0,0 +1,40 @@
+#pragma once
+
+#include "EventQueue.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Universal MIDI Packet (MIDI 2.0) input.
+//
+// MIDI 2.0 channel voice packets (message type 4, two words) carry 16-bit velocity and 32-bit
+// bend, pressure and controller values. Each one becomes a single EngineEvent with
+// EngineEvent::kFlagHighRes set, so the full resolution reaches the smoothers and the mod
+// matrix instead of being split into MIDI 1.0 bytes. MIDI 1.0 channel voice packets (type 2)
+// map onto the ordinary 7/14-bit events.
+//
+// Per-note messages (per-note pitch bend, poly pressure, assignable per-note controllers) are
+// applied to their note's channel: the engine plays one note per channel (MPE layout).
+namespace ump {
+
+    // Packet size in 32-bit words, from the message type in the top nibble of the first word.
+    int packetWords(uint32_t word0);
+
+    // Translates one packet into an engine event. Returns false for packets the engine does
+    // not handle (utility, system, data, program change, RPN/NRPN, per-note management).
+    bool toEvent(const uint32_t *packet, int numWords, EngineEvent &out);
+
+    // 32-bit bend centre, and conversions from the high-resolution scales to the 14-bit and
+    // 7-bit units the smoothers run in (fractions are kept).
+    constexpr uint32_t kBendCentre = 0x80000000u;
+    constexpr float kToBend14 = 1.0f / 262144.0f;       // 2^-18
+    constexpr float kTo7Bit = 1.0f / 33554432.0f;       // 2^-25
+    constexpr float kVelocity16ToUnit = 1.0f / 65535.0f;
+
+    // MIDI 2.0 -> MIDI 1.0 down-conversion (for FluidSynth).
+    constexpr int to7Bit(uint32_t v32) { return static_cast<int>(v32 >> 25); }
+    constexpr int to14Bit(uint32_t v32) { return static_cast<int>(v32 >> 18); }
+    // A MIDI 2.0 note on with velocity 0 still sounds; MIDI 1.0 would read it as note off.
+    constexpr int velocity16To7Bit(uint32_t v16) { return v16 >> 9 ? static_cast<int>(v16 >> 9) : 1; }
+
+} // namespace ump
@@ -0,0 +1,147 @@
+#include "UnisonVoice.h"
+#include "DspKernels.h"
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr int kTableMask = Wavetable::kWavetableSize - 1;
+    static_assert(UnisonVoice::kMaxCopies >= dsp::kMaxLaneWidth, "the kernel reads whole lanes of copies");
+    constexpr float kSilentLevel = 1.0e-4f;   // release ends below -80 dB
+
+    // Cheap deterministic phases: xorshift32 mapped to [0, 1).
+    inline float nextUnit(uint32_t &state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // One-pole coefficient reaching 1/e of the distance in ms.
+    inline float timeCoef(float ms, double sampleRate) {
+        const float samples = std::max(1.0f, ms * 0.001f * static_cast<float>(sampleRate));
+        return 1.0f - fastmath::exp(-1.0f / samples);
+    }
+
+} // namespace
+
+void UnisonVoice::noteOn(const Params &params, int note, float velocity, uint32_t seed) {
+    params_ = params;
+    note_ = note;
+    velocity_ = velocity;
+    copies_ = std::clamp(params.copies, 1, kMaxCopies);
+
+    // Copies spread evenly over +/- detune; adjacent detunes go to opposite sides so the
+    // stereo image stays balanced for any count. Equal-power pan, summed power normalised.
+    uint32_t rng = seed ? seed : 0x9E3779B9u;
+    const float norm = 1.0f / std::sqrt(static_cast<float>(copies_));
+    const float spread = std::clamp(params.spread, 0.0f, 1.0f);
+    maxRatio_ = 1.0f;
+    for (int i = 0; i < kMaxCopies; ++i) {
+        if (i >= copies_) {
+            phase_[i] = ratio_[i] = inc_[i] = gainL_[i] = gainR_[i] = 0.0f;
+            continue;
+        }
+        const float offset = copies_ > 1 ? 2.0f * static_cast<float>(i) / static_cast<float>(copies_ - 1) - 1.0f : 0.0f;
+        ratio_[i] = fastmath::exp2(offset * params.detuneCents * (1.0f / 1200.0f));
+        maxRatio_ = std::max(maxRatio_, ratio_[i]);
+        const float pan = spread * ((i & 1) ? -std::fabs(offset) : std::fabs(offset));
+        const float angle = (pan + 1.0f) * (fastmath::kPi * 0.25f);
+        gainL_[i] = fastmath::cos(angle) * norm;
+        gainR_[i] = fastmath::sin(angle) * norm;
+        // A single copy starts at 0 so plain voices attack consistently.
+        phase_[i] = copies_ > 1 ? nextUnit(rng) : 0.0f;
+    }
+
+    if (stage_ == kIdle) {
+        level_ = 0.0f;
+        ic1_[0] = ic1_[1] = ic2_[0] = ic2_[1] = 0.0f;
+    }
+    stage_ = kAttack;
+    k_ = 1.0f / std::max(0.5f, params.resonance);
+}
+
+void UnisonVoice::noteOff() {
+    if (stage_ != kIdle) stage_ = kRelease;
+}
+
+void UnisonVoice::reset() {
+    stage_ = kIdle;
+    level_ = 0.0f;
+    note_ = -1;
+}
+
+float UnisonVoice::nextEnvelope() {
+    switch (stage_) {
+        case kAttack:
+            level_ += attackStep_;
+            if (level_ >= 1.0f) {
+                level_ = 1.0f;
+                stage_ = kDecay;
+            }
+            break;
+        case kDecay:
+            level_ += (params_.sustain - level_) * decayCoef_;
+            if (level_ - params_.sustain < kSilentLevel) stage_ = kSustain;
+            break;
+        case kSustain:
+            level_ = params_.sustain;
+            break;
+        case kRelease:
+            level_ -= level_ * releaseCoef_;
+            if (level_ < kSilentLevel) {
+                level_ = 0.0f;
+                stage_ = kIdle;
+            }
+            break;
+        case kIdle:
+            break;
+    }
+    return level_;
+}
+
+void UnisonVoice::render(const Wavetable &table, float increment, float cutoffHz, float gain, double sampleRate,
+                         float *out, int frames) {
+    if (stage_ == kIdle || frames <= 0) return;
+
+    // Block-rate parameters.
+    attackStep_ = 1.0f / std::max(1.0f, params_.attackMs * 0.001f * static_cast<float>(sampleRate));
+    decayCoef_ = timeCoef(params_.decayMs, sampleRate);
+    releaseCoef_ = timeCoef(params_.releaseMs, sampleRate);
+    for (int i = 0; i < kMaxCopies; ++i) inc_[i] = increment * ratio_[i];
+    const float *mip = table.mipLevel(Wavetable::levelForIncrement(increment * maxRatio_));
+    const float nyquistSafe = std::clamp(cutoffHz, 20.0f, 0.45f * static_cast<float>(sampleRate));
+    const float cutoffG = std::tan(fastmath::kPi * nyquistSafe / static_cast<float>(sampleRate));
+    gain *= velocity_;
+
+    // TPT SVF lowpass coefficients (Zavalishin), shared by both channels.
+    const float a1 = 1.0f / (1.0f + cutoffG * (cutoffG + k_));
+    const float a2 = cutoffG * a1;
+    const float a3 = cutoffG * a2;
+
+    const dsp::Kernels &kernels = dsp::kernels();
+    alignas(64) float oscL[kChunk];
+    alignas(64) float oscR[kChunk];
+    dsp::UnisonArgs osc{mip, kTableMask, phase_, inc_, gainL_, gainR_, copies_, oscL, oscR, 0};
+
+    for (int done = 0; done < frames && stage_ != kIdle; done += kChunk) {
+        osc.frames = std::min(kChunk, frames - done);
+        kernels.unisonOsc(osc);
+        float *o = out + 2 * done;
+        for (int f = 0; f < osc.frames; ++f) {
+            const float in[2] = {oscL[f], oscR[f]};
+            const float env = nextEnvelope() * gain;
+            for (int ch = 0; ch < 2; ++ch) {
+                const float v3 = in[ch] - ic2_[ch];
+                const float v1 = a1 * ic1_[ch] + a2 * v3;
+                const float v2 = ic2_[ch] + a2 * ic1_[ch] + a3 * v3;
+                ic1_[ch] = 2.0f * v1 - ic1_[ch];
+                ic2_[ch] = 2.0f * v2 - ic2_[ch];
+                o[2 * f + ch] += v2 * env;
+            }
+            if (stage_ == kIdle) break;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Wavetable.h"
+
+#include <cstdint>
+
+// One logical note of the wavetable backend, rendered as up to kMaxCopies detuned,
+// phase-randomised copies of the same Wavetable (unison / supersaw).
+//
+// The copies share everything except phase: one ADSR envelope, one stereo state-variable
+// lowpass and one mip level. Per sample the copies run 4, 8 or 16 at a time in the
+// dispatched unisonOsc kernel (DspKernels.h: phase advance, wrap, interpolation and the
+// pan-weighted stereo mix); only the two table reads per copy are scalar. A group of copies
+// therefore costs about what one separately enveloped and filtered voice does.
+//
+// Audio thread only; no allocation.
+class UnisonVoice {
+public:
+    static constexpr int kMaxCopies = 16;
+
+    struct Params {
+        int copies = 7;              // 1..kMaxCopies
+        float detuneCents = 20.0f;   // outermost copies sit at +/- this
+        float spread = 0.7f;         // stereo width of the copies, 0..1
+        float attackMs = 5.0f;
+        float decayMs = 250.0f;
+        float sustain = 0.8f;
+        float releaseMs = 300.0f;
+        float resonance = 0.707f;    // filter Q
+    };
+
+    UnisonVoice() = default;
+
+    // Starts (or retriggers from the current level) a note. seed picks the copy phases.
+    void noteOn(const Params &params, int note, float velocity, uint32_t seed);
+    void noteOff();
+    // Silences immediately (stream restart, table unloaded).
+    void reset();
+
+    bool active() const { return stage_ != kIdle; }
+    bool held() const { return stage_ != kIdle && stage_ != kRelease; }
+    int note() const { return note_; }
+    int copies() const { return copies_; }
+    // Envelope times velocity, 0..1 (for meters).
+    float level() const { return level_ * velocity_; }
+
+    // Adds frames of interleaved stereo to out. increment: centre frequency in cycles per
+    // sample; cutoffHz: shared lowpass; gain: linear, on top of envelope and velocity.
+    void render(const Wavetable &table, float increment, float cutoffHz, float gain, double sampleRate,
+                float *out, int frames);
+
+private:
+    enum Stage : uint8_t { kIdle, kAttack, kDecay, kSustain, kRelease };
+
+    static constexpr int kChunk = 64;   // oscillator frames per kernel call
+
+    float nextEnvelope();
+
+    // Per copy; entries past copies_ are silent (zero increment and gain) so the kernel may
+    // read whole lanes.
+    alignas(32) float phase_[kMaxCopies] = {};
+    alignas(32) float ratio_[kMaxCopies] = {};
+    alignas(32) float inc_[kMaxCopies] = {};
+    alignas(32) float gainL_[kMaxCopies] = {};
+    alignas(32) float gainR_[kMaxCopies] = {};
+    int copies_ = 0;
+    float maxRatio_ = 1.0f;
+
+    int note_ = -1;
+    float velocity_ = 0.0f;
+    Params params_;
+
+    Stage stage_ = kIdle;
+    float level_ = 0.0f;
+    float attackStep_ = 0.0f;
+    float decayCoef_ = 0.0f;
+    float releaseCoef_ = 0.0f;
+
+    // TPT state-variable lowpass, one state pair per channel.
+    float ic1_[2] = {};
+    float ic2_[2] = {};
+    float k_ = 1.414f;
+};
@@ -0,0 +1,52 @@
+#include "Visualization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace vis {
+
+    void Tap::publish(const float *stereo, int frames, const float *channelLevels, int activeVoices) {
+        Frame &f = frames_.back();
+        float sum[2] = {};
+        float peak[2] = {};
+        for (int i = 0; i < frames; ++i) {
+            const float l = stereo[2 * i];
+            const float r = stereo[2 * i + 1];
+            sum[0] += l * l;
+            sum[1] += r * r;
+            peak[0] = std::max(peak[0], std::fabs(l));
+            peak[1] = std::max(peak[1], std::fabs(r));
+
+            acc_ += l + r;
+            if (++accCount_ == kScopeDecimation) {
+                ring_[ringHead_] = acc_ * (0.5f / kScopeDecimation);
+                ringHead_ = (ringHead_ + 1) % kScopePoints;
+                acc_ = 0.0f;
+                accCount_ = 0;
+            }
+        }
+
+        if (++sequence_ == 0) sequence_ = 1;
+        f.sequence = sequence_;
+        f.activeVoices = static_cast<uint32_t>(std::max(activeVoices, 0));
+        for (int c = 0; c < 2; ++c) {
+            f.rms[c] = frames > 0 ? std::sqrt(sum[c] / static_cast<float>(frames)) : 0.0f;
+            f.peak[c] = peak[c];
+        }
+        std::memcpy(f.channelLevel, channelLevels, sizeof(f.channelLevel));
+        // Unroll the ring so the oldest point comes first.
+        const int tail = kScopePoints - ringHead_;
+        std::memcpy(f.scope, ring_ + ringHead_, sizeof(float) * static_cast<size_t>(tail));
+        std::memcpy(f.scope + tail, ring_, sizeof(float) * static_cast<size_t>(ringHead_));
+        frames_.publish();
+    }
+
+    uint32_t Tap::read(void *dst) {
+        frames_.consume();
+        const Frame &f = frames_.front();
+        if (f.sequence != 0) std::memcpy(dst, &f, sizeof(Frame));
+        return f.sequence;
+    }
+
+} // namespace vis
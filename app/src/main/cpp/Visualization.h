@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Audio -> UI meters: the callback publishes one Frame per block (output RMS/peak, per-channel
+// voice levels, voice count, a decimated scope) and the UI copies out the newest complete one
+// (OboeSynthesizer.readVisualization()). Both sides are wait-free and never allocate.
+namespace vis {
+
+    constexpr int kChannels = 16;          // MIDI channels, one wavetable voice each
+    constexpr int kScopePoints = 256;
+    constexpr int kScopeDecimation = 4;    // stream frames averaged per scope point
+
+    // Copied byte for byte into the Kotlin DirectByteBuffer (native order); the offsets are
+    // mirrored by OboeSynthesizer.VIS_*. Append fields, never reorder.
+    struct Frame {
+        uint32_t sequence = 0;              // block counter, 0 = nothing published yet
+        uint32_t activeVoices = 0;          // wavetable + FluidSynth
+        float rms[2] = {};                  // L, R over the block
+        float peak[2] = {};
+        float channelLevel[kChannels] = {}; // wavetable envelope, or held velocity/pressure (0..1)
+        float scope[kScopePoints] = {};     // mono, oldest first
+    };
+    static_assert(std::is_trivially_copyable<Frame>::value, "Frame is copied as raw bytes");
+    static_assert(offsetof(Frame, rms) == 8 && offsetof(Frame, peak) == 16 && offsetof(Frame, channelLevel) == 24
+                  && offsetof(Frame, scope) == 88 && sizeof(Frame) == 88 + 4 * kScopePoints,
+                  "layout is mirrored by OboeSynthesizer.VIS_*");
+
+    // Single writer, single reader. Three slots: the writer owns one, the reader owns one and
+    // the third is exchanged between them with one atomic swap per publish/consume, so neither
+    // side ever waits or sees a half-written value.
+    template <typename T>
+    class TripleBuffer {
+    public:
+        // Writer: fill back(), then publish() it.
+        T &back() { return slots_[back_]; }
+        void publish() {
+            back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndex;
+        }
+
+        // Reader: swaps in the newest published value if there is one; false if nothing new.
+        bool consume() {
+            if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+            return true;
+        }
+        const T &front() const { return slots_[front_]; }
+
+    private:
+        static constexpr uint8_t kIndex = 3;
+        static constexpr uint8_t kFresh = 4;
+
+        T slots_[3] = {};
+        uint8_t back_ = 0;                    // writer only
+        std::atomic<uint8_t> middle_{1};
+        uint8_t front_ = 2;                   // reader only
+    };
+
+    class Tap {
+    public:
+        // Audio thread, once per callback: measures the stereo output block and publishes it
+        // with the scope's latest kScopePoints points.
+        void publish(const float *stereo, int frames, const float *channelLevels, int activeVoices);
+
+        // UI thread: copies the newest frame (sizeof(Frame) bytes, any alignment) to dst, even
+        // if it was read before. Returns its sequence, 0 if nothing was published yet.
+        uint32_t read(void *dst);
+
+    private:
+        TripleBuffer<Frame> frames_;
+        uint32_t sequence_ = 0;
+
+        // Scope history, audio thread only: a ring of points plus the partial one in progress.
+        float ring_[kScopePoints] = {};
+        int ringHead_ = 0;
+        float acc_ = 0.0f;
+        int accCount_ = 0;
+    };
+
+} // namespace vis
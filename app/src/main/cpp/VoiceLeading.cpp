@@ -0,0 +1,118 @@
+#include "VoiceLeading.h"
+
+// Both tables are evaluated by the compiler (C++17 constexpr loops over local arrays).
+namespace {
+
+    using namespace voicing;
+
+    // Semitones above the root for layers 1..3.
+    constexpr int kUpperInterval[2][kTriads][kSevenths][kUpperLayers] = {
+            {   // stable: fifth, triad tone, seventh
+                    {{7, 4, 11}, {7, 4, 10}},
+                    {{7, 3, 11}, {7, 3, 10}},
+                    {{7, 5, 11}, {7, 5, 10}},
+            },
+            {   // unstable: diminished seventh chord, whatever the archetypes
+                    {{3, 6, 9}, {3, 6, 9}},
+                    {{3, 6, 9}, {3, 6, 9}},
+                    {{3, 6, 9}, {3, 6, 9}},
+            },
+    };
+
+    // Each changed note costs a note-off and a note-on, which outweighs any amount of motion
+    // (at most a tritone per voice).
+    constexpr int kChangeCost = 64;
+
+    struct Voicings {
+        uint8_t notes[kStates * kLayers];
+    };
+
+    constexpr Voicings makeVoicings() {
+        Voicings v{};
+        for (int unstable = 0; unstable < 2; ++unstable) {
+            for (int seventh = 0; seventh < kSevenths; ++seventh) {
+                for (int triad = 0; triad < kTriads; ++triad) {
+                    for (int root = 0; root < kRoots; ++root) {
+                        uint8_t *n = v.notes + stateIndex(root, triad, seventh, unstable != 0) * kLayers;
+                        n[0] = static_cast<uint8_t>(kBassNote + root);
+                        for (int l = 0; l < kUpperLayers; ++l) {
+                            n[1 + l] = static_cast<uint8_t>(n[0] + kUpperInterval[unstable][triad][seventh][l]);
+                        }
+                    }
+                }
+            }
+        }
+        return v;
+    }
+
+    constexpr Voicings kVoicings = makeVoicings();
+
+    struct Transitions {
+        uint8_t entries[kStates * kStates * kUpperMasks];
+    };
+
+    constexpr Transitions makeTransitions() {
+        // Upper layers each permutation moves: usable for a mask only if they all sound.
+        int moved[kUpperPerms] = {};
+        for (int p = 0; p < kUpperPerms; ++p) {
+            for (int l = 0; l < kUpperLayers; ++l) {
+                if (kUpperPerm[p][l] != l) moved[p] |= 1 << l;
+            }
+        }
+
+        Transitions t{};
+        for (int from = 0; from < kStates; ++from) {
+            const uint8_t *a = kVoicings.notes + from * kLayers;
+            for (int to = 0; to < kStates; ++to) {
+                const uint8_t *b = kVoicings.notes + to * kLayers;
+
+                // Cost of each layer's move under each permutation.
+                int cost[kUpperPerms][kUpperLayers] = {};
+                for (int p = 0; p < kUpperPerms; ++p) {
+                    for (int l = 0; l < kUpperLayers; ++l) {
+                        const int x = a[1 + l];
+                        const int y = b[1 + kUpperPerm[p][l]];
+                        const int d = ((x - y) % 12 + 12) % 12;
+                        cost[p][l] = d == 0 ? 0 : kChangeCost + (d > 6 ? 12 - d : d);
+                    }
+                }
+
+                uint8_t *out = t.entries + (from * kStates + to) * kUpperMasks;
+                for (int mask = 0; mask < kUpperMasks; ++mask) {
+                    // With one upper layer sounding (or none) there is nothing to swap.
+                    int best = 0;
+                    if (mask & (mask - 1)) {
+                        int bestCost = 1 << 30;
+                        for (int p = 0; p < kUpperPerms; ++p) {
+                            if ((moved[p] & ~mask) != 0) continue;
+                            const int c = ((mask & 1) ? cost[p][0] : 0) + ((mask & 2) ? cost[p][1] : 0)
+                                    + ((mask & 4) ? cost[p][2] : 0);
+                            if (c < bestCost) {
+                                best = p;
+                                bestCost = c;
+                            }
+                        }
+                    }
+
+                    int kept = a[0] == b[0] ? 1 : 0;
+                    for (int l = 0; l < kUpperLayers; ++l) {
+                        if (cost[best][l] == 0) kept |= 1 << (1 + l);
+                    }
+                    out[mask] = static_cast<uint8_t>(best | (kept << 3));
+                }
+            }
+        }
+        return t;
+    }
+
+    constexpr Transitions kTransitions = makeTransitions();
+
+} // namespace
+
+namespace voicing {
+
+    const uint8_t *voicings() { return kVoicings.notes; }
+
+    const uint8_t *transitions() { return kTransitions.entries; }
+
+} // namespace voicing
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+// Voice-leading tables for the v0.2 harmonic state space (VoiceLeader.kt), generated at
+// compile time (VoiceLeading.cpp) and linked as read-only data.
+//
+// A state is root x triad x seventh x stability (144 states). Its voicing has four layers,
+// one per slot in the canonical layout: the root in the bass (kBassNote + root) and three
+// upper tones (fifth, triad tone, seventh; minor third, diminished fifth and seventh when
+// unstable) at their interval above it, as VoiceLeader's fixed layout plays them. That is where
+// a slot starts when it attacks.
+//
+// For every state pair and every set of sounding upper layers the transition table holds the
+// assignment of those layers to the next chord's layers that changes the fewest notes, then
+// moves the least (by pitch class distance), and which layers keep their pitch class, i.e.
+// need no note-off/note-on. The bass always stays on the root. The voice-leading core does
+// one lookup per chord change, maps each sounding slot's layer through it and places the new
+// pitch class nearest the slot's current note (placeNear), so voices move by step instead of
+// jumping back to the canonical octave.
+namespace voicing {
+
+    constexpr int kRoots = 12;
+    constexpr int kTriads = 3;        // major (FAN), minor (STRETCH), sus4 (CLUSTER)
+    constexpr int kSevenths = 2;      // major 7th (COMPACT), minor 7th (WIDE)
+    constexpr int kStates = kRoots * kTriads * kSevenths * 2;
+
+    constexpr int kLayers = 4;        // 0 root, 1 fifth, 2 triad tone, 3 seventh
+    constexpr int kUpperLayers = 3;
+    constexpr int kUpperMasks = 1 << kUpperLayers;   // bit l - 1: upper layer l is sounding
+
+    constexpr int kBassNote = 48;     // C3; canonical upper tones fall in [51, 71)
+    constexpr int kUpperLow = kBassNote;          // led upper voices stay in [48, 72),
+    constexpr int kUpperHigh = kBassNote + 24;    // the two octaves around the canonical ones
+
+    // triad 0..kTriads-1, seventh 0..kSevenths-1; unstable states ignore both for the voicing.
+    constexpr int stateIndex(int rootPc, int triad, int seventh, bool unstable) {
+        return ((static_cast<int>(unstable) * kSevenths + seventh) * kTriads + triad) * kRoots + rootPc;
+    }
+
+    // Permutations of the upper layers; entry bits 0..2 index this, identity first.
+    constexpr int kUpperPerms = 6;
+    inline constexpr uint8_t kUpperPerm[kUpperPerms][kUpperLayers] = {
+            {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0},
+    };
+
+    // Layer of the next chord that layer takes over.
+    constexpr int targetLayer(uint8_t entry, int layer) {
+        return layer == 0 ? 0 : 1 + kUpperPerm[entry & 7][layer - 1];
+    }
+
+    // Whether layer keeps its pitch class across the transition. Bits 3..6, one per layer.
+    constexpr bool retained(uint8_t entry, int layer) {
+        return ((entry >> (3 + layer)) & 1) != 0;
+    }
+
+    // Upper note with targetNote's pitch class nearest current, kept in [kUpperLow, kUpperHigh).
+    constexpr int placeNear(int current, int targetNote) {
+        int step = ((targetNote - current) % 12 + 12) % 12;
+        if (step > 6) step -= 12;
+        int n = current + step;
+        while (n < kUpperLow) n += 12;
+        while (n >= kUpperHigh) n -= 12;
+        return n;
+    }
+
+    // kStates x kLayers MIDI notes, canonical voicings.
+    const uint8_t *voicings();
+    // [from][to][upperMask] entries, kStates * kStates * kUpperMasks bytes.
+    const uint8_t *transitions();
+
+    inline int note(int state, int layer) { return voicings()[state * kLayers + layer]; }
+
+    // upperMask: the upper layers currently sounding; the others map to themselves.
+    inline uint8_t transition(int from, int to, int upperMask) {
+        return transitions()[(from * kStates + to) * kUpperMasks + upperMask];
+    }
+
+}// namespace voicing
@@ -1,129 +1,125 @@
 #include "Wavetable.h"
+#include "BuiltinTables.h"
+#include "PcmConvert.h"
 #include <cmath>
+#include <complex>
 #include <cstring>
 #include <algorithm>
 
-// Little-endian helpers
-static uint16_t read_u16_le(const uint8_t *p) {
-    return static_cast<uint16_t>(p[0]) | (static_cast<uint16_t>(p[1]) << 8);
+namespace {
+
+    // Iterative radix-2 FFT; n must be a power of two. Import-time only.
+    void fft(std::vector<std::complex<double>> &a, bool inverse) {
+        const size_t n = a.size();
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+        for (size_t len = 2; len <= n; len <<= 1) {
+            const double ang = 2.0 * M_PI / static_cast<double>(len) * (inverse ? 1.0 : -1.0);
+            const std::complex<double> wlen(std::cos(ang), std::sin(ang));
+            for (size_t i = 0; i < n; i += len) {
+                std::complex<double> w(1.0, 0.0);
+                for (size_t k = 0; k < len / 2; ++k) {
+                    const std::complex<double> u = a[i + k];
+                    const std::complex<double> v = a[i + k + len / 2] * w;
+                    a[i + k] = u + v;
+                    a[i + k + len / 2] = u - v;
+                    w *= wlen;
+                }
+            }
+        }
+        if (inverse) {
+            for (auto &x : a) x /= static_cast<double>(n);
+        }
+    }
+
+} // namespace
+
+Wavetable::Wavetable(const uint8_t *data, size_t size) {
+    std::vector<float> samples;
+    if (!parseWav(data, size, samples)) samples.clear();
+    buildFromSamples(samples.data(), samples.size());
 }
-static uint32_t read_u32_le(const uint8_t *p) {
-    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+
+Wavetable::Wavetable(const float *samples, size_t count) {
+    buildFromSamples(samples, samples ? count : 0);
 }
 
-Wavetable::Wavetable(const uint8_t *data, size_t size) {
-    table_.assign(kWavetableSize, 0.0f);
+std::unique_ptr<Wavetable> Wavetable::wrap(const float *mipStack) {
+    if (!mipStack) return nullptr;
+    std::unique_ptr<Wavetable> t(new Wavetable());
+    t->mips_ = mipStack;
+    t->parsedOk_ = true;
+    return t;
+}
 
-    std::vector<float> samples;
-    if (!parseWav(data, size, samples) || samples.empty()) {
-        // Fallback to sine
-        makeSineTable();
+void Wavetable::buildFromSamples(const float *samples, size_t count) {
+    if (count == 0) {
+        // Fallback to the compile-time sine stack: no allocation, no build.
+        mips_ = builtin::waveStack(builtin::Shape::kSine);
         parsedOk_ = false;
         return;
     }
 
     parsedOk_ = true;
-    resampleToTable(samples, table_);
-
+    table_.assign(kWavetableSize, 0.0f);
+    resampleToTable(samples, count, table_);
     // Normalize to avoid clipping
-    float maxv = 0.0f;
-    for (float v : table_) maxv = std::max(maxv, std::fabs(v));
-    if (maxv < 1e-6f) maxv = 1.0f;
-    for (float &v : table_) v /= maxv;
+    pcm::normalizePeak(table_.data(), table_.size());
+
+    buildMipmaps();
+    // Level 0 is the full-band table; the staging copy is no longer needed.
+    table_.clear();
+    table_.shrink_to_fit();
 }
 
-void Wavetable::makeSineTable() {
-    for (int i = 0; i < kWavetableSize; ++i) {
-        const float phase = static_cast<float>(i) / static_cast<float>(kWavetableSize);
-        table_[i] = std::sin(2.0f * static_cast<float>(M_PI) * phase);
+int Wavetable::levelForIncrement(float phaseIncrement) {
+    // Level L keeps (kWavetableSize / 2) >> L harmonics; the top one must stay below 0.5 cycles/sample.
+    const float inc = std::fabs(phaseIncrement);
+    int level = 0;
+    float topHarmonic = static_cast<float>(kWavetableSize / 2);
+    while (level < kNumMipLevels - 1 && topHarmonic * inc >= 0.5f) {
+        topHarmonic *= 0.5f;
+        ++level;
     }
+    return level;
 }
 
-bool Wavetable::parseWav(const uint8_t *data, size_t size, std::vector<float> &out) {
-    // Minimal RIFF/WAVE parser. Accepts PCM 16-bit or IEEE float 32.
-    if (!data || size < 12) return false;
-    if (std::memcmp(data, "RIFF", 4) != 0) return false;
-    if (std::memcmp(data + 8, "WAVE", 4) != 0) return false;
-
-    size_t pos = 12;
-    uint16_t audioFormat = 0;
-    uint16_t numChannels = 1;
-    uint32_t sampleRate = 44100;
-    uint16_t bitsPerSample = 16;
-    const uint8_t *dataStart = nullptr;
-    size_t dataBytes = 0;
-
-    while (pos + 8 <= size) {
-        const uint8_t *hdr = data + pos;
-        char chunkId[5];
-        std::memcpy(chunkId, hdr, 4);
-        chunkId[4] = '\0';
-        uint32_t chunkSize = read_u32_le(hdr + 4);
-        pos += 8;
-
-        if (pos + chunkSize > size) return false; // malformed
-
-        if (std::memcmp(hdr, "fmt ", 4) == 0) {
-            // parse fmt chunk
-            if (chunkSize < 16) return false;
-            audioFormat = read_u16_le(data + pos);
-            numChannels = read_u16_le(data + pos + 2);
-            sampleRate = read_u32_le(data + pos + 4);
-            bitsPerSample = read_u16_le(data + pos + 14);
-            // ignore any extra fmt bytes
-        } else if (std::memcmp(hdr, "data", 4) == 0) {
-            dataStart = data + pos;
-            dataBytes = chunkSize;
-            break; // done
+void Wavetable::buildMipmaps() {
+    storage_.assign(kStackFloats, 0.0f);
+    std::copy(table_.begin(), table_.end(), storage_.begin());
+    mips_ = storage_.data();
+
+    std::vector<std::complex<double>> spectrum(kWavetableSize);
+    for (int i = 0; i < kWavetableSize; ++i) spectrum[i] = table_[i];
+    fft(spectrum, false);
+
+    std::vector<std::complex<double>> band(kWavetableSize);
+    for (int level = 1; level < kNumMipLevels; ++level) {
+        const int maxHarmonic = (kWavetableSize / 2) >> level;
+        for (int k = 0; k < kWavetableSize; ++k) {
+            const int h = k <= kWavetableSize / 2 ? k : kWavetableSize - k;
+            band[k] = h <= maxHarmonic ? spectrum[k] : std::complex<double>(0.0, 0.0);
         }
-
-        pos += chunkSize;
+        fft(band, true);
+        float *dst = storage_.data() + static_cast<size_t>(level) * kWavetableSize;
+        for (int i = 0; i < kWavetableSize; ++i) dst[i] = static_cast<float>(band[i].real());
     }
+}
 
-    if (!dataStart || dataBytes == 0) return false;
-
-    const size_t bytesPerSampleFrame = (bitsPerSample / 8) * numChannels;
-    if (bytesPerSampleFrame == 0) return false;
-
-    const size_t frameCount = dataBytes / bytesPerSampleFrame;
-    out.resize(frameCount);
-
+bool Wavetable::parseWav(const uint8_t *data, size_t size, std::vector<float> &out) {
+    pcm::WavInfo info;
+    if (!pcm::parseWav(data, size, info)) return false;
     // Convert/Downmix to mono float
-    if (audioFormat == 1 && bitsPerSample == 16) {
-        // PCM 16-bit
-        const int16_t *src = reinterpret_cast<const int16_t *>(dataStart);
-        for (size_t i = 0; i < frameCount; ++i) {
-            float acc = 0.0f;
-            for (uint16_t c = 0; c < numChannels; ++c) {
-                int16_t s = src[i * numChannels + c];
-                acc += static_cast<float>(s) / 32768.0f;
-            }
-            out[i] = acc / static_cast<float>(numChannels);
-        }
-        return true;
-    } else if (audioFormat == 3 && bitsPerSample == 32) {
-        // IEEE float 32-bit
-        const float *src = reinterpret_cast<const float *>(dataStart);
-        for (size_t i = 0; i < frameCount; ++i) {
-            float acc = 0.0f;
-            for (uint16_t c = 0; c < numChannels; ++c) {
-                acc += src[i * numChannels + c];
-            }
-            out[i] = acc / static_cast<float>(numChannels);
-        }
-        return true;
-    }
-
-    // Unsupported format
-    return false;
+    out.resize(info.frames);
+    pcm::downmixToMono(info.data, info.format, info.channels, info.frames, out.data());
+    return true;
 }
 
-void Wavetable::resampleToTable(const std::vector<float> &in, std::vector<float> &out) {
-    if (in.empty()) {
-        makeSineTable();
-        return;
-    }
-    const size_t inN = in.size();
+void Wavetable::resampleToTable(const float *in, size_t inN, std::vector<float> &out) {
     const size_t outN = out.size();
     for (size_t j = 0; j < outN; ++j) {
         const float pos = (static_cast<float>(j) * static_cast<float>(inN)) / static_cast<float>(outN);
@@ -1,36 +1,76 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 class Wavetable {
 public:
     static constexpr int kWavetableSize = 2048;
+    // Band-limited copies: level L keeps harmonics 1..(kWavetableSize / 2) >> L.
+    static constexpr int kNumMipLevels = 11;
 
-    // Construct from raw WAV file bytes (RIFF/WAVE). If parsing fails, this creates a sine table fallback.
+    // Construct from raw WAV file bytes (RIFF/WAVE). If parsing fails, the table renders the
+    // built-in sine (BuiltinTables.h) and parsedOk() is false.
     Wavetable(const uint8_t *data, size_t size);
 
+    // Construct from one cycle of mono float samples (any length; resampled to kWavetableSize
+    // straight from the caller's memory). An empty input creates the sine fallback.
+    Wavetable(const float *samples, size_t count);
+
+    // Floats in a full mip stack (level 0 first), the unit stored by WavetableCache.
+    static constexpr size_t kStackFloats = static_cast<size_t>(kNumMipLevels) * kWavetableSize;
+
+    // Wraps an existing, already built mip stack (e.g. an mmap'd cache entry) without copying.
+    // The memory must outlive the returned table.
+    static std::unique_ptr<Wavetable> wrap(const float *mipStack);
+
     // Access the internal table (kWavetableSize floats)
-    const float *data() const { return table_.data(); }
+    const float *data() const { return mips_; }
+
+    // All kNumMipLevels levels, contiguous (kStackFloats floats).
+    const float *mipStack() const { return mips_; }
+
+    // Band-limited table for a mip level in [0, kNumMipLevels).
+    const float *mipLevel(int level) const { return mips_ + static_cast<size_t>(level) * kWavetableSize; }
+
+    // Lowest mip level whose highest harmonic stays below Nyquist for a phase increment
+    // (cycles per output sample).
+    static int levelForIncrement(float phaseIncrement);
 
     // Returns true if the constructor successfully parsed the input data as a WAV file
     bool parsedOk() const { return parsedOk_; }
 
     // Render one sample from the table using a normalized phase in [0,1).
     inline float render(float phase) const {
+        return renderTable(mips_, phase);
+    }
+
+    // Render from a band-limited mip level.
+    inline float render(float phase, int level) const {
+        return renderTable(mipLevel(level), phase);
+    }
+
+private:
+    Wavetable() = default;
+
+    std::vector<float> table_;        // full-band cycle, only while building
+    std::vector<float> storage_;      // owned mip stack; empty for wrapped and fallback tables
+    const float *mips_ = nullptr;     // storage_ or external memory
+    bool parsedOk_ = false;
+
+    static inline float renderTable(const float *t, float phase) {
         const float idx = phase * static_cast<float>(kWavetableSize);
         int i0 = static_cast<int>(idx) % kWavetableSize;
         if (i0 < 0) i0 += kWavetableSize;
         int i1 = (i0 + 1) % kWavetableSize;
-        const float frac = idx - static_cast<float>(i0);
-        return table_[i0] * (1.0f - frac) + table_[i1] * frac;
+        const float frac = idx - static_cast<float>(static_cast<int>(idx));
+        return t[i0] * (1.0f - frac) + t[i1] * frac;
     }
 
-private:
-    std::vector<float> table_;
-    bool parsedOk_ = false;
-
-    void makeSineTable();
+    void buildFromSamples(const float *samples, size_t count);
+    void buildMipmaps();
     bool parseWav(const uint8_t *data, size_t size, std::vector<float> &out);
-    void resampleToTable(const std::vector<float> &in, std::vector<float> &out);
+    void resampleToTable(const float *in, size_t inN, std::vector<float> &out);
 };
@@ -0,0 +1,184 @@
+#include "WavetableCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr char kMagic[8] = {'B', 'H', 'W', 'T', 'C', 'A', 'C', 'H'};
+    constexpr uint32_t kEndianTag = 0x01020304u;
+    constexpr size_t kStackBytes = Wavetable::kStackFloats * sizeof(float);
+
+    size_t alignUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+
+    bool writeAll(std::FILE *f, const void *data, size_t bytes) {
+        return bytes == 0 || std::fwrite(data, 1, bytes, f) == bytes;
+    }
+
+    bool writeZeros(std::FILE *f, size_t bytes) {
+        static const uint8_t zeros[WavetableCache::kDataAlignment] = {};
+        while (bytes > 0) {
+            const size_t n = std::min(bytes, sizeof(zeros));
+            if (!writeAll(f, zeros, n)) return false;
+            bytes -= n;
+        }
+        return true;
+    }
+
+} // namespace
+
+uint64_t WavetableCache::contentHash(const uint8_t *data, size_t size) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+WavetableCache::~WavetableCache() { unmap(); }
+
+void WavetableCache::unmap() {
+    if (base_) munmap(const_cast<uint8_t *>(base_), mappedBytes_);
+    base_ = nullptr;
+    mappedBytes_ = 0;
+    entries_ = nullptr;
+    entryCount_ = 0;
+}
+
+bool WavetableCache::open(const std::string &path) {
+    if (!path_.empty()) return false;
+    path_ = path;
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const auto *base = static_cast<const uint8_t *>(p);
+    FileHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    // Bound the count before multiplying: on 32-bit a hostile entryCount would wrap dirEnd.
+    const bool countFits = h.entryCount <= (size - sizeof(FileHeader)) / sizeof(Entry);
+    const size_t dirEnd = countFits ? sizeof(FileHeader) + static_cast<size_t>(h.entryCount) * sizeof(Entry) : size;
+    bool valid = countFits
+            && std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0
+            && h.version == kFormatVersion
+            && h.endianTag == kEndianTag
+            && h.tableSize == static_cast<uint32_t>(Wavetable::kWavetableSize)
+            && h.mipLevels == static_cast<uint32_t>(Wavetable::kNumMipLevels)
+            && h.fileSize == size;
+
+    const auto *entries = reinterpret_cast<const Entry *>(base + sizeof(FileHeader));
+    for (uint32_t i = 0; valid && i < h.entryCount; ++i) {
+        const Entry &e = entries[i];
+        valid = e.offset % kDataAlignment == 0 && e.offset >= dirEnd && kStackBytes <= size && e.offset <= size - kStackBytes
+                && (i == 0 || entries[i - 1].hash < e.hash);
+    }
+    if (!valid) {
+        munmap(p, size);
+        return false;
+    }
+
+    // Sequential page-in of the whole file is the expected access pattern at startup.
+    madvise(p, size, MADV_WILLNEED);
+    base_ = base;
+    mappedBytes_ = size;
+    entries_ = entries;
+    entryCount_ = h.entryCount;
+    return true;
+}
+
+const float *WavetableCache::find(uint64_t hash) const {
+    const Entry *end = entries_ + entryCount_;
+    const Entry *it = std::lower_bound(entries_, end, hash,
+                                       [](const Entry &e, uint64_t h) { return e.hash < h; });
+    if (it == end || it->hash != hash) return nullptr;
+    return reinterpret_cast<const float *>(base_ + it->offset);
+}
+
+std::unique_ptr<Wavetable> WavetableCache::load(uint64_t hash) const {
+    return Wavetable::wrap(find(hash));
+}
+
+void WavetableCache::store(uint64_t hash, const Wavetable &table) {
+    if (find(hash)) return;
+    std::lock_guard<std::mutex> guard(pendingMutex_);
+    for (const Pending &p : pending_) {
+        if (p.hash == hash) return;
+    }
+    const float *stack = table.mipStack();
+    pending_.push_back(Pending{hash, std::vector<float>(stack, stack + Wavetable::kStackFloats)});
+}
+
+size_t WavetableCache::storedCount() const {
+    std::lock_guard<std::mutex> guard(pendingMutex_);
+    return pending_.size();
+}
+
+bool WavetableCache::flush() {
+    if (path_.empty()) return false;
+    std::lock_guard<std::mutex> guard(pendingMutex_);
+    if (pending_.empty()) return true;
+
+    // Merge mapped and pending entries by hash; data pointers stay in place until written.
+    struct Source {
+        uint64_t hash;
+        const float *stack;
+    };
+    std::vector<Source> sources;
+    sources.reserve(entryCount_ + pending_.size());
+    for (size_t i = 0; i < entryCount_; ++i) {
+        sources.push_back(Source{entries_[i].hash, reinterpret_cast<const float *>(base_ + entries_[i].offset)});
+    }
+    for (const Pending &p : pending_) sources.push_back(Source{p.hash, p.stack.data()});
+    std::sort(sources.begin(), sources.end(), [](const Source &a, const Source &b) { return a.hash < b.hash; });
+
+    const size_t dirEnd = sizeof(FileHeader) + sources.size() * sizeof(Entry);
+    const size_t dataStart = alignUp(dirEnd, kDataAlignment);
+    const size_t stride = alignUp(kStackBytes, kDataAlignment);
+
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kFormatVersion;
+    h.endianTag = kEndianTag;
+    h.tableSize = static_cast<uint32_t>(Wavetable::kWavetableSize);
+    h.mipLevels = static_cast<uint32_t>(Wavetable::kNumMipLevels);
+    h.entryCount = static_cast<uint32_t>(sources.size());
+    h.fileSize = dataStart + sources.size() * stride;
+
+    std::vector<Entry> dir(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        dir[i] = Entry{sources[i].hash, dataStart + i * stride, 1, 0};
+    }
+
+    const std::string tmp = path_ + ".tmp";
+    std::FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = writeAll(f, &h, sizeof(h))
+            && writeAll(f, dir.data(), dir.size() * sizeof(Entry))
+            && writeZeros(f, dataStart - dirEnd);
+    for (size_t i = 0; ok && i < sources.size(); ++i) {
+        ok = writeAll(f, sources[i].stack, kStackBytes) && writeZeros(f, stride - kStackBytes);
+    }
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    // Pending stacks are kept: this process still maps the old file, so a later flush must
+    // write them again.
+    return true;
+}
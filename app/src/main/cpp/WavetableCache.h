@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Wavetable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Persistent cache of built wavetable mip stacks, keyed by a hash of the source file bytes.
+//
+// The file is mmap'd read-only and entries are rendered from in place (Wavetable::wrap),
+// so a warm start costs a page-in instead of parse + resample + FFT per table.
+//
+// Layout (native endianness, all offsets from file start):
+//   Header      64 bytes, see FileHeader
+//   Directory   entryCount x Entry, sorted by hash
+//   Data        one Wavetable::kStackFloats stack per entry, each kDataAlignment-aligned
+//
+// A file with a different magic, version, endianness, table size or mip count is ignored
+// and replaced by the next flush().
+class WavetableCache {
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+    static constexpr size_t kDataAlignment = 64;
+
+    // 64-bit FNV-1a of the source bytes.
+    static uint64_t contentHash(const uint8_t *data, size_t size);
+
+    WavetableCache() = default;
+    ~WavetableCache();
+
+    WavetableCache(const WavetableCache &) = delete;
+    WavetableCache &operator=(const WavetableCache &) = delete;
+
+    // Maps path if it holds a valid cache and remembers it as the flush() target. Returns
+    // true if entries were mapped. Call once, before any lookup; a cache cannot be reopened
+    // because wrapped tables point into the mapping for its whole lifetime.
+    bool open(const std::string &path);
+
+    // Mapped mip stack for hash, or nullptr. Lock-free; safe from any thread after open().
+    const float *find(uint64_t hash) const;
+    // find() wrapped as a table that renders from the mapping.
+    std::unique_ptr<Wavetable> load(uint64_t hash) const;
+
+    // Queues a freshly built table for the next flush(). Thread-safe.
+    void store(uint64_t hash, const Wavetable &table);
+
+    // Writes mapped + stored entries to a temp file and renames it over the cache path.
+    // The current mapping stays valid (the old inode lives until unmapped).
+    bool flush();
+
+    size_t mappedCount() const { return entryCount_; }
+    size_t storedCount() const;
+
+private:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t tableSize;
+        uint32_t mipLevels;
+        uint32_t entryCount;
+        uint32_t reserved0;
+        uint64_t fileSize;
+        uint8_t reserved[24];
+    };
+    static_assert(sizeof(FileHeader) == 64, "cache header must stay 64 bytes");
+
+    struct Entry {
+        uint64_t hash;
+        uint64_t offset;  // byte offset of the mip stack
+        uint32_t frames;  // table frames in the stack (1 until multi-frame tables land)
+        uint32_t reserved;
+    };
+    static_assert(sizeof(Entry) == 24, "cache entry must stay 24 bytes");
+
+    struct Pending {
+        uint64_t hash;
+        std::vector<float> stack;
+    };
+
+    void unmap();
+
+    std::string path_;
+    const uint8_t *base_ = nullptr;
+    size_t mappedBytes_ = 0;
+    const Entry *entries_ = nullptr;
+    size_t entryCount_ = 0;
+
+    mutable std::mutex pendingMutex_;
+    std::vector<Pending> pending_;
+};
@@ -30,7 +30,9 @@ import com.breathinghand.core.midi.VoiceAllocator
 import com.breathinghand.core.midi.TouchSource
 import com.breathinghand.core.midi.AndroidMidiOutput
 import com.breathinghand.core.MusicalConstants
+import java.io.File
 import java.io.IOException
+import kotlin.math.abs
 import com.breathinghand.MidiLogger
 import kotlinx.coroutines.*
 
@@ -39,6 +41,9 @@ class MainActivity : AppCompatActivity() {
     companion object {
         private const val TAG_SEM = "BH_SEM"
         private const val COALESCE_WINDOW_MS = 10L
+        private const val DEVICE_PROFILE_FILE = "device_profile.txt"
+        // Hand rotation speed that reads as full conductor flow (one turn per second).
+        private const val CONDUCTOR_FULL_FLOW_RAD_PER_SEC = 6.2831855f
     }
 
     private val touchState = MutableTouchPolar()
@@ -153,8 +158,17 @@ class MainActivity : AppCompatActivity() {
         )
 
         internalSynth = OboeSynthesizer()
+        voiceLeader.setVoicingTable(internalSynth.voiceLeadingTable())
 
         importScope.launch {
+            // Engine tier (polyphony, interpolation, buffer depth, effects) from the device
+            // profile. Without one the self-benchmark runs alongside: FluidSynth starts with
+            // defaults and picks up the probed settings on the next launch.
+            val profile = File(filesDir, DEVICE_PROFILE_FILE)
+            if (internalSynth.loadDeviceProfile(profile) < 0) {
+                importScope.launch { internalSynth.probeDevice(profile) }
+            }
+
             val ok = internalSynth.initFluidSynthAndLoadBundledDefaultSf2(this@MainActivity)
             runOnUiThread {
                 if (ok) {
@@ -190,7 +204,7 @@ class MainActivity : AppCompatActivity() {
             FrameLayout.LayoutParams.MATCH_PARENT
         )
 
-        overlay = HarmonicOverlayView(this, harmonicEngine)
+        overlay = HarmonicOverlayView(this, harmonicEngine, internalSynth)
         overlay.layoutParams = FrameLayout.LayoutParams(
             FrameLayout.LayoutParams.MATCH_PARENT,
             FrameLayout.LayoutParams.MATCH_PARENT
@@ -505,6 +519,7 @@ class MainActivity : AppCompatActivity() {
 
         voiceLeader.allNotesOff()
         harmonicEngine.onAllFingersLift(touchFrame.tMs)
+        resetConductor()
         releaseCascadeUntilMs = 0L
         landingCascadeUntilMs = 0L
         TouchMath.reset()
@@ -515,6 +530,11 @@ class MainActivity : AppCompatActivity() {
         invalidateIfVisualChanged()
     }
 
+    /** Hand at rest: no flow (the granular source fades out), neutral height, open grip. */
+    private fun resetConductor() {
+        internalSynth.setConductor(0f, 0.5f, 0f)
+    }
+
     private fun fillActivePointersFromFrame(): Int {
         var n = 0
         for (s in 0 until MusicalConstants.MAX_VOICES) {
@@ -712,6 +732,14 @@ class MainActivity : AppCompatActivity() {
                     MidiLogger.logHarmony(harmonicEngine.state)
                 }
 
+                // Conductor: rotation speed is flow, hand height is height, a closed grip
+                // (instability) is grip. Feeds the mod matrix and the granular source.
+                internalSynth.setConductor(
+                    flowEnergy = (abs(harmonicEngine.angularVelocity) / CONDUCTOR_FULL_FLOW_RAD_PER_SEC).coerceIn(0f, 1f),
+                    verticalBias = 1f - centerYNorm.coerceIn(0f, 1f),
+                    grip = harmonicEngine.state.harmonicInstability
+                )
+
                 if (TelemetryRecorder.isRecording() && touchState.isActive) {
                     val state = harmonicEngine.state
                     val snapTNs = SystemClock.elapsedRealtimeNanos()
@@ -814,16 +842,30 @@ class MainActivity : AppCompatActivity() {
 
     override fun onPause() {
         super.onPause()
+        // Warm pause: only the stream stops; SoundFont and synth state stay loaded.
         internalSynth.stop()
         MidiLogger.logAllNotesOff("onPause")
         voiceLeader.allNotesOff()
         harmonicEngine.onAllFingersLift(SystemClock.uptimeMillis())
+        resetConductor()
         TouchMath.reset()
         radiusFilter.reset()
         timbreNav.resetAll()
         lastPointerCount = 0
     }
 
+    private val engineStats = LongArray(OboeSynthesizer.STAT_COUNT)
+
+    private fun logStartLatency() {
+        if (internalSynth.getStats(engineStats) < OboeSynthesizer.STAT_COUNT) return
+        Log.i(
+            "BreathingHand",
+            "audio start: ${engineStats[OboeSynthesizer.STAT_START_LATENCY_US]} us to first frame " +
+                "(starts=${engineStats[OboeSynthesizer.STAT_STARTS]}, " +
+                "stream opens=${engineStats[OboeSynthesizer.STAT_STREAM_OPENS]})"
+        )
+    }
+
     override fun onDestroy() {
         super.onDestroy()
         cancelReleaseCoalesce()
@@ -833,6 +875,8 @@ class MainActivity : AppCompatActivity() {
     override fun onResume() {
         super.onResume()
         internalSynth.start()
+        // Reported once the first unmuted callback has run.
+        window.decorView.postDelayed({ logStartLatency() }, 500)
         if (!cc11BaselineSent) {
             try {
                 internalSynth.controlChange(0, 11, 127)
@@ -1,9 +1,14 @@
 package com.breathinghand.audio
 
 import android.content.Context
+import com.breathinghand.core.midi.VoiceLeadingTable
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
 import java.io.File
 import java.io.FileOutputStream
 import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 class OboeSynthesizer {
     private var nativeHandle: Long = 0L
@@ -13,12 +18,17 @@ class OboeSynthesizer {
         nativeHandle = nativeCreate()
     }
 
+    /**
+     * Start (or warm-resume) audio. After [stop] the synth, loaded SoundFont and assets are
+     * still resident, so this only restarts the Oboe stream. See STAT_START_LATENCY_US.
+     */
     fun start() {
         if (nativeHandle != 0L) {
             nativeStart(nativeHandle)
         }
     }
 
+    /** Stop the stream but keep all engine state resident (use from onPause). */
     fun stop() {
         if (nativeHandle != 0L) {
             nativeStop(nativeHandle)
@@ -55,6 +65,287 @@ class OboeSynthesizer {
         }
     }
 
+    /**
+     * Battery mode: render the synth at half the stream rate (22.05/24 kHz) and upsample
+     * with a half-band filter. Switchable while playing: the output fades out and back in
+     * over a few milliseconds while the synth rate changes, and held notes carry on. Blocks
+     * the caller for at most ~100 ms; returns false if the audio callback did not acknowledge.
+     * See STAT_LOW_POWER_RENDER.
+     */
+    fun setLowPowerRender(enabled: Boolean): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeSetLowPowerRender(nativeHandle, enabled)
+    }
+
+    /**
+     * Follow breath on the microphone: opens a low-latency input stream that the audio
+     * callback drains every block, so the breath level (mod source kSrcBreath, and CC2 on
+     * SoundFonts) tracks the mic within one output buffer. The caller must declare and have
+     * been granted RECORD_AUDIO; the manifest does not request it yet. Returns false if the
+     * input could not be opened. See STAT_BREATH_*.
+     */
+    fun setBreathInput(enabled: Boolean): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeSetBreathInput(nativeHandle, enabled)
+    }
+
+    /**
+     * Send Universal MIDI Packets (MIDI 2.0). [words] holds [count] 32-bit words; each
+     * 64-bit channel voice packet becomes one engine event with its full 16/32-bit value.
+     * Returns the number of words consumed. Does not allocate.
+     */
+    fun sendUmp(words: IntArray, count: Int = words.size): Int {
+        if (nativeHandle == 0L) return 0
+        return nativeSendUmp(nativeHandle, words, count)
+    }
+
+    /** Single 32- or 64-bit packet without an array. */
+    fun sendUmp64(word0: Int, word1: Int) {
+        if (nativeHandle != 0L) {
+            nativeSendUmp64(nativeHandle, word0, word1)
+        }
+    }
+
+    /** MIDI 2.0 note on with a 16-bit velocity (0 still sounds, at the softest level). */
+    fun noteOn16(channel: Int, note: Int, velocity16: Int) {
+        sendUmp64(midi2Word0(UMP_NOTE_ON, channel, note, 0), (velocity16 and 0xFFFF) shl 16)
+    }
+
+    /** Per-note pitch bend, 32-bit unsigned with centre 0x80000000 (same range as [pitchBend]). */
+    fun perNotePitch32(channel: Int, note: Int, pitch32: Int) {
+        sendUmp64(midi2Word0(UMP_PER_NOTE_PITCH_BEND, channel, note, 0), pitch32)
+    }
+
+    /** Per-note (poly) pressure, 32-bit unsigned. */
+    fun perNotePressure32(channel: Int, note: Int, pressure32: Int) {
+        sendUmp64(midi2Word0(UMP_POLY_PRESSURE, channel, note, 0), pressure32)
+    }
+
+    /** Per-note brightness (assignable per-note controller 74), 32-bit unsigned. */
+    fun perNoteBrightness32(channel: Int, note: Int, brightness32: Int) {
+        perNoteController32(channel, note, 74, brightness32)
+    }
+
+    /** Assignable per-note controller; numbers follow CC numbering. */
+    fun perNoteController32(channel: Int, note: Int, controller: Int, value32: Int) {
+        sendUmp64(midi2Word0(UMP_ASSIGNABLE_PER_NOTE_CONTROLLER, channel, note, controller), value32)
+    }
+
+    private fun midi2Word0(opcode: Int, channel: Int, index: Int, index2: Int): Int =
+        (UMP_TYPE_MIDI2_CHANNEL_VOICE shl 28) or (opcode shl 20) or ((channel and 0x0F) shl 16) or
+            ((index and 0x7F) shl 8) or (index2 and 0xFF)
+
+    /**
+     * Start recording every native call (notes, controllers, UMP, conductor, routes,
+     * SoundFont/import/cache calls) with nanosecond timestamps into [file] for offline
+     * replay (`capture_replay` host tool, app/src/test/cpp). Off by default; costs one atomic
+     * load per call while off. Returns false if a capture is already running.
+     */
+    fun startCallCapture(file: File): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeStartCallCapture(nativeHandle, file.absolutePath)
+    }
+
+    /** Stop recording and close the file; returns the number of records written. */
+    fun stopCallCapture(): Long {
+        if (nativeHandle == 0L) return 0L
+        return nativeStopCallCapture(nativeHandle)
+    }
+
+    /**
+     * Apply the device profile saved in [file] by [probeDevice]: stream buffer depth,
+     * low-power render, default unison copies, and FluidSynth polyphony, interpolation and
+     * effects (those at init, so call before [initFluidSynth]). Returns the TIER_* it selects,
+     * or -1 if there is no usable profile (none yet, or written by an older engine).
+     */
+    fun loadDeviceProfile(file: File): Int {
+        if (nativeHandle == 0L) return -1
+        return nativeLoadDeviceProfile(nativeHandle, file.absolutePath)
+    }
+
+    /**
+     * First-launch self-benchmark: times the render kernels, measures the native rate, burst
+     * size and underrun-free buffer depth on a silent probe stream, then picks a TIER_*,
+     * saves the profile to [file] and applies it as [loadDeviceProfile] does. Blocks for about
+     * two seconds; call from a background thread. The output stream is closed for the probe
+     * and restarted afterwards if [start] was called. Returns -1 if the profile could not be
+     * saved (it is still applied for this run).
+     */
+    fun probeDevice(file: File): Int {
+        if (nativeHandle == 0L) return -1
+        return nativeProbeDevice(nativeHandle, file.absolutePath)
+    }
+
+    /**
+     * Start exporting the performance to [file] as a Standard MIDI File: every note and
+     * expression event the engine accepts, one track per MPE channel, with its arrival time.
+     * A native thread spools the events to disk while playing; the file is complete once
+     * [stopPerformanceExport] returns. Costs one atomic load per event while off. Returns
+     * false if an export is already running or [file] cannot be created.
+     */
+    fun startPerformanceExport(file: File): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeStartPerformanceExport(nativeHandle, file.absolutePath)
+    }
+
+    /** Finish the .mid file; returns the number of events written, or -1 on failure. */
+    fun stopPerformanceExport(): Long {
+        if (nativeHandle == 0L) return -1L
+        return nativeStopPerformanceExport(nativeHandle)
+    }
+
+    /**
+     * Copy native engine counters into [out] (indices are the STAT_* constants).
+     * Returns the number of values written. Does not allocate.
+     */
+    fun getStats(out: LongArray): Int {
+        if (nativeHandle == 0L) return 0
+        return nativeGetStats(nativeHandle, out)
+    }
+
+    /** A buffer for [readVisualization]; allocate once and reuse it every frame. */
+    fun newVisualizationBuffer(): ByteBuffer =
+        ByteBuffer.allocateDirect(VIS_FRAME_BYTES).order(ByteOrder.nativeOrder())
+
+    /**
+     * Copy the newest audio meters into [out] (from [newVisualizationBuffer]): output RMS/peak,
+     * per-channel voice levels, voice count and a decimated scope, laid out at the VIS_*
+     * offsets. Published by the audio callback once per block through a triple buffer, so this
+     * never waits or allocates. Returns the frame's sequence number (unchanged = no new block),
+     * 0 if nothing was rendered yet.
+     */
+    fun readVisualization(out: ByteBuffer): Int {
+        if (nativeHandle == 0L) return 0
+        return nativeReadVisualization(nativeHandle, out)
+    }
+
+    /** Names of the render-graph nodes, in node id order (the index used by getRenderNodeStats). */
+    fun getRenderNodeNames(): Array<String> {
+        if (nativeHandle == 0L) return emptyArray()
+        return nativeGetRenderNodeNames(nativeHandle) ?: emptyArray()
+    }
+
+    /**
+     * Per-node render cost: for node i, out[3i] is the total nanoseconds spent rendering,
+     * out[3i+1] the number of runs and out[3i+2] the runs skipped while the node was silent.
+     * Returns the number of nodes written. Does not allocate.
+     */
+    fun getRenderNodeStats(out: LongArray): Int {
+        if (nativeHandle == 0L) return 0
+        return nativeGetRenderNodeStats(nativeHandle, out)
+    }
+
+    /**
+     * Conductor ("Air hand") parameters as modulation sources, each 0..1.
+     * Safe to call from the touch/vision threads; picked up at the next audio block.
+     */
+    fun setConductor(flowEnergy: Float, verticalBias: Float, grip: Float) {
+        if (nativeHandle != 0L) {
+            nativeSetConductor(nativeHandle, flowEnergy, verticalBias, grip)
+        }
+    }
+
+    /**
+     * Replace the native modulation matrix routes.
+     * [routes] is a flat array of (source, dest, curve, amount) quadruples; see ModMatrix.h
+     * for the enum values and destination units. Call off the audio thread.
+     */
+    fun setModRoutes(routes: FloatArray) {
+        if (nativeHandle != 0L) {
+            nativeSetModRoutes(nativeHandle, routes)
+        }
+    }
+
+    fun setLfoRate(lfo: Int, hz: Float) {
+        if (nativeHandle != 0L) {
+            nativeSetLfoRate(nativeHandle, lfo, hz)
+        }
+    }
+
+    /**
+     * Queue a batch of WAV files for parallel import on the native worker pool, decoded
+     * natively and streamed from the file.
+     * [kind] is IMPORT_WAVETABLE or IMPORT_SAMPLE. Returns a job id, or -1 if the
+     * importer is saturated (retry later) or the batch is too large.
+     */
+    fun importFiles(paths: Array<String>, kind: Int): Int {
+        if (nativeHandle == 0L) return -1
+        return nativeImportFiles(nativeHandle, paths, kind)
+    }
+
+    /**
+     * Poll a job: fills [out] with (total, completed, failed[, cacheHits]). Lock-free on the native side,
+     * safe to call every UI frame. Returns false for an unknown or expired job id.
+     */
+    fun importProgress(jobId: Int, out: IntArray): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeImportProgress(nativeHandle, jobId, out)
+    }
+
+    /**
+     * Register PCM the app already holds as a wavetable or sample, without building a WAV file.
+     * [buffer] is a direct ByteBuffer in native byte order holding [frames] interleaved frames of
+     * [channels] channels in [format] (PCM_FORMAT_INT16 / PCM_FORMAT_FLOAT); [kind] is
+     * IMPORT_WAVETABLE or IMPORT_SAMPLE, [slot] -1 for the first free one. The buffer is
+     * converted to mono float in place, so its contents are consumed either way.
+     *
+     * Returns -1 on failure, else the slot (`result and PCM_SLOT_MASK`). With PCM_ADOPTED set a
+     * sample plays straight from [buffer]: the engine holds its own reference until the sample
+     * is freed, so the caller may drop the buffer but must not write to it again. Without it the
+     * engine kept nothing and the buffer can be reused at once. Mono int16 is adopted only when
+     * the buffer has room for 4 bytes per frame.
+     */
+    fun registerPcm(buffer: ByteBuffer, format: Int, channels: Int, frames: Int, sampleRate: Int, kind: Int, slot: Int = -1): Int {
+        if (nativeHandle == 0L || !buffer.isDirect) return -1
+        return nativeRegisterPcm(nativeHandle, buffer, format, channels, frames, sampleRate, kind, slot)
+    }
+
+    /** Native registry slot that request [index] of [jobId] was published to, or -1. */
+    fun importResultSlot(jobId: Int, index: Int): Int {
+        if (nativeHandle == 0L) return -1
+        return nativeImportResultSlot(nativeHandle, jobId, index)
+    }
+
+    /**
+     * Map the prebuilt wavetable cache (filesDir/wavetables.cache) so imports of unchanged
+     * files skip parsing and mipmap building. Call once at startup, before the first
+     * importFiles(); returns true if a valid cache was mapped.
+     */
+    fun openWavetableCache(context: Context): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeOpenWavetableCache(nativeHandle, File(context.filesDir, "wavetables.cache").absolutePath)
+    }
+
+    /** Persist tables built since startup into the cache. Call off the audio thread. */
+    fun flushWavetableCache(): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeFlushWavetableCache(nativeHandle)
+    }
+
+    /**
+     * Layer a registered wavetable (see importFiles) under every note: each note plays
+     * [unison] detuned, phase-randomised copies of the table (1..16) sharing one envelope and
+     * filter, so a 7-copy supersaw costs little more than a single voice. [detuneCents] is the
+     * spread of the outermost copies, [spread] their stereo width (0..1). Applies from the next
+     * note on; slot -1 turns the layer off. See STAT_WAVETABLE_VOICES.
+     */
+    fun setWavetableVoice(slot: Int, unison: Int = 7, detuneCents: Float = 20f, spread: Float = 0.7f): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeSetWavetableVoice(nativeHandle, slot, unison, detuneCents, spread)
+    }
+
+    /**
+     * Play a granular texture over a registered asset: [kind] is IMPORT_SAMPLE or
+     * IMPORT_WAVETABLE (looped at A3), [slot] the asset slot, -1 to turn it off. The texture is
+     * driven by setConductor(): flowEnergy sets the grain density (silent near 0), verticalBias
+     * the read position in the sample and grip the pitch spread (up to +/- an octave).
+     * See STAT_GRANULAR_GRAINS / STAT_GRANULAR_DROPPED.
+     */
+    fun setGranularSource(kind: Int, slot: Int): Boolean {
+        if (nativeHandle == 0L) return false
+        return nativeSetGranularSource(nativeHandle, kind, slot)
+    }
+
     /**
      * Ensure the bundled default SF2 exists as a real filesystem path (required by FluidSynth).
      *
@@ -138,11 +429,30 @@ class OboeSynthesizer {
     private external fun nativeDelete(handle: Long)
     private external fun nativeStart(handle: Long)
     private external fun nativeStop(handle: Long)
-    private external fun nativeNoteOn(handle: Long, channel: Int, note: Int, velocity: Int)
-    private external fun nativeNoteOff(handle: Long, channel: Int, note: Int)
-    private external fun nativePitchBend(handle: Long, channel: Int, bend14: Int)
-    private external fun nativeChannelPressure(handle: Long, channel: Int, pressure: Int)
-    private external fun nativeControlChange(handle: Long, channel: Int, cc: Int, value: Int)
+    private external fun nativeSetLowPowerRender(handle: Long, enabled: Boolean): Boolean
+    private external fun nativeSetBreathInput(handle: Long, enabled: Boolean): Boolean
+    @FastNative private external fun nativeSendUmp(handle: Long, words: IntArray, count: Int): Int
+    private external fun nativeStartCallCapture(handle: Long, path: String): Boolean
+    private external fun nativeStopCallCapture(handle: Long): Long
+    private external fun nativeLoadDeviceProfile(handle: Long, path: String): Int
+    private external fun nativeProbeDevice(handle: Long, path: String): Int
+    private external fun nativeStartPerformanceExport(handle: Long, path: String): Boolean
+    private external fun nativeStopPerformanceExport(handle: Long): Long
+    @FastNative private external fun nativeGetStats(handle: Long, out: LongArray): Int
+    @FastNative private external fun nativeReadVisualization(handle: Long, out: ByteBuffer): Int
+    private external fun nativeGetRenderNodeNames(handle: Long): Array<String>?
+    @FastNative private external fun nativeGetRenderNodeStats(handle: Long, out: LongArray): Int
+    private external fun nativeSetModRoutes(handle: Long, routes: FloatArray)
+    private external fun nativeSetLfoRate(handle: Long, lfo: Int, hz: Float)
+    private external fun nativeImportFiles(handle: Long, paths: Array<String>, kind: Int): Int
+    private external fun nativeImportProgress(handle: Long, jobId: Int, out: IntArray): Boolean
+    private external fun nativeImportResultSlot(handle: Long, jobId: Int, index: Int): Int
+    private external fun nativeRegisterPcm(handle: Long, buffer: ByteBuffer, format: Int, channels: Int, frames: Int,
+                                           sampleRate: Int, kind: Int, slot: Int): Int
+    private external fun nativeOpenWavetableCache(handle: Long, path: String): Boolean
+    private external fun nativeFlushWavetableCache(handle: Long): Boolean
+    private external fun nativeSetWavetableVoice(handle: Long, slot: Int, copies: Int, detuneCents: Float, spread: Float): Boolean
+    private external fun nativeSetGranularSource(handle: Long, kind: Int, slot: Int): Boolean
     private external fun nativeLoadSoundFont(handle: Long, path: String?): Boolean
     private external fun nativeInitFluidSynth(handle: Long): Boolean
     private external fun nativeShutdownFluidSynth(handle: Long): Boolean
@@ -152,5 +462,132 @@ class OboeSynthesizer {
         return nativeIsFluidSynthCompiled()
     }
     private external fun nativeIsFluidSynthCompiled(): Boolean
+
+    /**
+     * DSP kernel variant picked for this CPU at creation, followed by every variant it can
+     * run, e.g. "avx2 (sse2 sse4.1 avx2)". See STAT_DSP_ISA.
+     */
+    fun getDspKernels(): String = nativeGetDspKernels()
+    private external fun nativeGetDspKernels(): String
+
+    /**
+     * The voice-leading tables the native library generates at compile time (VoiceLeading.h),
+     * copied once for [com.breathinghand.core.midi.VoiceLeader.setVoicingTable]; null if the
+     * layouts disagree.
+     */
+    fun voiceLeadingTable(): VoiceLeadingTable? {
+        val voicings = ByteArray(VoiceLeadingTable.VOICING_BYTES)
+        val transitions = ByteArray(VoiceLeadingTable.TRANSITION_BYTES)
+        return if (nativeGetVoiceLeadingTable(voicings, transitions)) VoiceLeadingTable(voicings, transitions) else null
+    }
+    private external fun nativeGetVoiceLeadingTable(voicings: ByteArray, transitions: ByteArray): Boolean
+
+    /**
+     * Microbenchmark of the JNI transition alone: average nanoseconds per call of the same
+     * trivial native bound as a regular, a @FastNative and a @CriticalNative method, in that
+     * order. The note/expression calls above use the critical binding. Diagnostics only.
+     */
+    fun measureJniCallCost(iterations: Int = 1_000_000): DoubleArray {
+        val handle = nativeHandle
+        var sink = 0
+        val result = DoubleArray(3)
+        repeat(2) {   // the first pass warms up the JIT
+            var t0 = System.nanoTime()
+            for (i in 0 until iterations) sink += nativeCallCostRegular(handle, i)
+            result[0] = (System.nanoTime() - t0).toDouble() / iterations
+            t0 = System.nanoTime()
+            for (i in 0 until iterations) sink += nativeCallCostFast(handle, i)
+            result[1] = (System.nanoTime() - t0).toDouble() / iterations
+            t0 = System.nanoTime()
+            for (i in 0 until iterations) sink += nativeCallCostCritical(handle, i)
+            result[2] = (System.nanoTime() - t0).toDouble() / iterations
+        }
+        callCostSink = sink   // keeps the loops from being optimised away
+        return result
+    }
+    @Volatile private var callCostSink = 0
+    private external fun nativeCallCostRegular(handle: Long, value: Int): Int
+    @FastNative private external fun nativeCallCostFast(handle: Long, value: Int): Int
+
+    companion object {
+        // Per-touch-frame entry points: primitives only, so they bind as @CriticalNative
+        // (static, no JNIEnv, no thread-state transition). Registered in JNI_OnLoad.
+        @JvmStatic @CriticalNative private external fun nativeNoteOn(handle: Long, channel: Int, note: Int, velocity: Int)
+        @JvmStatic @CriticalNative private external fun nativeNoteOff(handle: Long, channel: Int, note: Int)
+        @JvmStatic @CriticalNative private external fun nativePitchBend(handle: Long, channel: Int, bend14: Int)
+        @JvmStatic @CriticalNative private external fun nativeChannelPressure(handle: Long, channel: Int, pressure: Int)
+        @JvmStatic @CriticalNative private external fun nativeControlChange(handle: Long, channel: Int, cc: Int, value: Int)
+        @JvmStatic @CriticalNative private external fun nativeSendUmp64(handle: Long, word0: Int, word1: Int)
+        @JvmStatic @CriticalNative private external fun nativeSetConductor(handle: Long, flow: Float, height: Float, grip: Float)
+        @JvmStatic @CriticalNative private external fun nativeCallCostCritical(handle: Long, value: Int): Int
+
+        // Indices into getStats(); must match EngineStat in EngineStats.h.
+        const val STAT_EVENTS_RECEIVED = 0
+        const val STAT_EVENTS_DROPPED = 1
+        const val STAT_NOTE_EVENTS = 2
+        const val STAT_CONTROL_EVENTS = 3
+        const val STAT_CONTROL_EVENTS_MERGED = 4
+        const val STAT_STARTS = 5
+        const val STAT_STREAM_OPENS = 6
+        const val STAT_START_LATENCY_US = 7
+        const val STAT_STREAM_DISCONNECTS = 8
+        const val STAT_STREAM_REOPEN_ATTEMPTS = 9
+        const val STAT_STREAM_RECOVERIES = 10
+        const val STAT_LAST_RECOVERY_US = 11
+        const val STAT_UMP_PACKETS = 12
+        const val STAT_UMP_IGNORED = 13
+        const val STAT_LOW_POWER_RENDER = 14
+        const val STAT_WAVETABLE_VOICES = 15
+        const val STAT_GRAPH_NODES_RUN = 16
+        const val STAT_GRAPH_NODES_SKIPPED = 17
+        const val STAT_GRANULAR_GRAINS = 18
+        const val STAT_GRANULAR_DROPPED = 19
+        const val STAT_DSP_ISA = 20
+        const val STAT_DSP_ISAS_AVAILABLE = 21
+        const val STAT_BREATH_INPUT_FRAMES = 22
+        const val STAT_BREATH_ONSETS = 23
+        const val STAT_BREATH_INPUT_ERRORS = 24
+        const val STAT_DEVICE_TIER = 25
+        const val STAT_COUNT = 26
+
+        // loadDeviceProfile() / probeDevice() / STAT_DEVICE_TIER; DeviceProfile::Tier.
+        const val TIER_LOW = 0
+        const val TIER_MID = 1
+        const val TIER_HIGH = 2
+
+        // Values of STAT_DSP_ISA (bit positions in STAT_DSP_ISAS_AVAILABLE); dsp::Isa.
+        const val DSP_ISA_SCALAR = 0
+        const val DSP_ISA_NEON = 1
+        const val DSP_ISA_SSE2 = 2
+        const val DSP_ISA_SSE41 = 3
+        const val DSP_ISA_AVX2 = 4
+        const val DSP_ISA_AVX512 = 5
+
+        // UMP message type and MIDI 2.0 channel voice opcodes used by the helpers above.
+        private const val UMP_TYPE_MIDI2_CHANNEL_VOICE = 0x4
+        private const val UMP_ASSIGNABLE_PER_NOTE_CONTROLLER = 0x1
+        private const val UMP_PER_NOTE_PITCH_BEND = 0x6
+        private const val UMP_NOTE_ON = 0x9
+        private const val UMP_POLY_PRESSURE = 0xA
+
+        const val IMPORT_WAVETABLE = 0
+        const val IMPORT_SAMPLE = 1
+
+        // readVisualization() frame layout (byte offsets); vis::Frame.
+        const val VIS_SEQUENCE = 0
+        const val VIS_ACTIVE_VOICES = 4
+        const val VIS_RMS = 8                // 2 floats: L, R
+        const val VIS_PEAK = 16              // 2 floats: L, R
+        const val VIS_CHANNEL_LEVEL = 24     // 16 floats, one per MIDI channel
+        const val VIS_SCOPE = 88             // VIS_SCOPE_POINTS floats, oldest first
+        const val VIS_SCOPE_POINTS = 256
+        const val VIS_FRAME_BYTES = VIS_SCOPE + 4 * VIS_SCOPE_POINTS
+
+        // registerPcm() sample formats (pcm::SampleFormat) and result bits.
+        const val PCM_FORMAT_INT16 = 0
+        const val PCM_FORMAT_FLOAT = 1
+        const val PCM_SLOT_MASK = 0xFFFF
+        const val PCM_ADOPTED = 1 shl 16
+    }
 }
 
@@ -3,7 +3,9 @@ package com.breathinghand.core
 import android.content.Context
 import android.graphics.Canvas
 import android.graphics.Paint
+import android.graphics.Path
 import android.view.View
+import com.breathinghand.audio.OboeSynthesizer
 import com.breathinghand.engine.GestureAnalyzer
 import kotlin.math.cos
 import kotlin.math.min
@@ -18,7 +20,11 @@ private fun midiToName(m: Int): String {
 }
 
 
-class HarmonicOverlayView(context: Context, private val engine: HarmonicEngine) : View(context) {
+class HarmonicOverlayView(
+    context: Context,
+    private val engine: HarmonicEngine,
+    private val synth: OboeSynthesizer? = null
+) : View(context) {
     private val paint = Paint(Paint.ANTI_ALIAS_FLAG).apply {
         strokeWidth = 5f
         style = Paint.Style.STROKE
@@ -28,6 +34,17 @@ class HarmonicOverlayView(context: Context, private val engine: HarmonicEngine)
         alpha = 50
     }
 
+    // Audio meters (what is actually sounding), refreshed every frame while audio flows.
+    private val visBuffer = synth?.newVisualizationBuffer()
+    private var lastVisSequence = 0
+    private var wasAudible = false
+    private val scopePath = Path()
+    private val meterPaint = Paint(Paint.ANTI_ALIAS_FLAG).apply {
+        strokeWidth = 3f
+        style = Paint.Style.STROKE
+        color = -8355712 // grey
+    }
+
     override fun onDraw(canvas: Canvas) {
         super.onDraw(canvas)
         val cx = width / 2f
@@ -105,5 +122,41 @@ class HarmonicOverlayView(context: Context, private val engine: HarmonicEngine)
             paint.style = Paint.Style.STROKE
             paint.color = color // restore
         }
+
+        drawMeters(canvas, cy + r + 24f)
+    }
+
+    // Scope across the width and one level bar per MIDI channel below it. Keeps invalidating
+    // while new, audible blocks arrive (plus one more to draw the silence); no allocation.
+    private fun drawMeters(canvas: Canvas, top: Float) {
+        val buf = visBuffer ?: return
+        val sequence = synth!!.readVisualization(buf)
+        if (sequence == 0) return
+
+        val scopeHeight = 120f
+        val mid = top + scopeHeight / 2f
+        val step = width.toFloat() / (OboeSynthesizer.VIS_SCOPE_POINTS - 1)
+        scopePath.reset()
+        for (i in 0 until OboeSynthesizer.VIS_SCOPE_POINTS) {
+            val y = mid - buf.getFloat(OboeSynthesizer.VIS_SCOPE + 4 * i) * scopeHeight / 2f
+            if (i == 0) scopePath.moveTo(0f, y) else scopePath.lineTo(i * step, y)
+        }
+        canvas.drawPath(scopePath, meterPaint)
+
+        val barTop = top + scopeHeight + 12f
+        val barHeight = 60f
+        val barWidth = width / 16f
+        for (ch in 0 until 16) {
+            val level = buf.getFloat(OboeSynthesizer.VIS_CHANNEL_LEVEL + 4 * ch).coerceIn(0f, 1f)
+            if (level <= 0f) continue
+            canvas.drawRect(ch * barWidth + 4f, barTop + barHeight * (1f - level),
+                (ch + 1) * barWidth - 4f, barTop + barHeight, meterPaint)
+        }
+
+        val audible = buf.getInt(OboeSynthesizer.VIS_ACTIVE_VOICES) > 0 ||
+            buf.getFloat(OboeSynthesizer.VIS_PEAK) > 0f || buf.getFloat(OboeSynthesizer.VIS_PEAK + 4) > 0f
+        if (sequence != lastVisSequence && (audible || wasAudible)) postInvalidateOnAnimation()
+        lastVisSequence = sequence
+        wasAudible = audible
     }
 }
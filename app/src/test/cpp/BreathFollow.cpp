@@ -0,0 +1,73 @@
+// Runs a WAV file through BreathFollower the way the engine runs the microphone: the
+// file stands in for the input stream, read in callback-sized blocks.
+//
+//   breath_follow [--block FRAMES] [--trace MS] <in.wav>
+//
+// Prints every onset with its time, and with --trace the level (0..1, the breath mod source
+// and CC2 value) every MS milliseconds.
+
+#include "BreathFollower.h"
+#include "StreamDecoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    void usage() {
+        std::fprintf(stderr, "usage: breath_follow [--block FRAMES] [--trace MS] <in.wav>\n");
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int block = 96;
+    double traceMs = 0.0;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--block") && i + 1 < argc) {
+            block = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc) {
+            traceMs = std::atof(argv[++i]);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!path || block <= 0) {
+        usage();
+        return 2;
+    }
+
+    auto input = pcm::StreamDecoder::open(path);
+    if (!input) {
+        std::fprintf(stderr, "breath_follow: cannot decode %s\n", path);
+        return 1;
+    }
+    const double rate = input->sampleRate();
+    BreathFollower follower;
+    follower.configure(BreathFollower::Params{}, rate);
+
+    std::vector<float> buf(static_cast<size_t>(block));
+    int64_t pos = 0;
+    double nextTraceMs = 0.0;
+    while (const size_t n = input->read(buf.data(), buf.size())) {
+        if (follower.process(buf.data(), static_cast<int>(n)) > 0) {
+            std::printf("onset %8.2f ms\n", static_cast<double>(follower.lastOnsetFrame()) * 1000.0 / rate);
+        }
+        pos += static_cast<int64_t>(n);
+        const double nowMs = static_cast<double>(pos) * 1000.0 / rate;
+        if (traceMs > 0.0 && nowMs >= nextTraceMs) {
+            std::printf("level %8.2f ms  %.3f  cc2=%d\n", nowMs, follower.level(),
+                        static_cast<int>(follower.level() * 127.0f + 0.5f));
+            nextTraceMs += traceMs;
+        }
+    }
+    std::printf("%.2f s, %llu onsets\n", static_cast<double>(pos) / rate,
+                static_cast<unsigned long long>(follower.onsets()));
+    return input->failed() ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+// BreathFollower over a WAV file standing in for the microphone: breath-like noise bursts are
+// written to breath.wav (in the build dir, also run through breath_follow), decoded back with
+// StreamDecoder in callback-sized reads and followed. Onsets and level must land within the
+// 5 ms control-latency budget and not depend on how the input is chunked.
+
+#include "BreathFollower.h"
+#include "StreamDecoder.h"
+#include "TestSupport.h"
+#include "WavWriter.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t kRate = 48000;
+    constexpr double kBurstStartsMs[] = {200.0, 700.0, 1150.0, 1550.0};   // gaps 250, 200, 150 ms
+    constexpr double kBurstMs = 250.0;
+    constexpr double kBurstDb = -20.0;
+    constexpr double kFloorDb = -70.0;   // room noise between breaths
+
+    struct Result {
+        std::vector<int64_t> onsetFrames;
+        std::vector<float> levels;        // after every read
+        std::vector<int64_t> levelFrames;
+    };
+
+    std::vector<float> breathSignal() {
+        const size_t frames = kRate * 2;
+        std::vector<float> v(frames);
+        uint32_t seed = 12345;
+        const double floorGain = std::pow(10.0, kFloorDb / 20.0);
+        const double burstGain = std::pow(10.0, kBurstDb / 20.0);
+        for (size_t i = 0; i < frames; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const double noise = static_cast<double>(static_cast<int32_t>(seed)) / 2147483648.0;
+            const double tMs = static_cast<double>(i) * 1000.0 / kRate;
+            double gain = floorGain;
+            for (double start : kBurstStartsMs) {
+                if (tMs >= start && tMs < start + kBurstMs) {
+                    // 2 ms fade-in, like the front of an exhale on the mic.
+                    gain = burstGain * std::min(1.0, (tMs - start) / 2.0);
+                }
+            }
+            v[i] = static_cast<float>(noise * gain * std::sqrt(3.0));
+        }
+        return v;
+    }
+
+    Result follow(const char *path, size_t readFrames) {
+        Result r;
+        auto input = pcm::StreamDecoder::open(path);
+        CHECK(input != nullptr);
+        if (!input) return r;
+        BreathFollower f;
+        f.configure(BreathFollower::Params{}, input->sampleRate());
+        std::vector<float> buf(readFrames);
+        int64_t pos = 0;
+        while (const size_t n = input->read(buf.data(), readFrames)) {
+            if (f.process(buf.data(), static_cast<int>(n)) > 0) r.onsetFrames.push_back(f.lastOnsetFrame());
+            pos += static_cast<int64_t>(n);
+            r.levels.push_back(f.level());
+            r.levelFrames.push_back(pos);
+        }
+        CHECK(static_cast<uint64_t>(r.onsetFrames.size()) == f.onsets());
+        return r;
+    }
+
+    // Level after the read that ends closest past frame.
+    float levelAt(const Result &r, int64_t frame) {
+        for (size_t i = 0; i < r.levelFrames.size(); ++i) {
+            if (r.levelFrames[i] >= frame) return r.levels[i];
+        }
+        return -1.0f;
+    }
+
+    void testOnsetsAndLevel() {
+        const char *path = "breath.wav";
+        CHECK(wavwriter::writeFloat32(path, breathSignal(), 1, kRate));
+
+        // 96 frames: a typical low-latency burst (2 ms at 48 kHz).
+        const Result r = follow(path, 96);
+        CHECK(r.onsetFrames.size() == std::size(kBurstStartsMs));
+        const BreathFollower::Params p;
+        const float burstLevel = static_cast<float>((kBurstDb - p.floorDb) / (p.ceilDb - p.floorDb));
+        for (size_t i = 0; i < std::min(r.onsetFrames.size(), std::size(kBurstStartsMs)); ++i) {
+            const double start = kBurstStartsMs[i] * kRate / 1000.0;
+            const double latencyMs = (static_cast<double>(r.onsetFrames[i]) - start) * 1000.0 / kRate;
+            std::printf("[breath_follower_test] onset %zu: %.2f ms after the burst\n", i, latencyMs);
+            CHECK(latencyMs >= 0.0 && latencyMs < 5.0);
+
+            // Level: at the burst's value 5 ms in, well on the way down 100 ms after it ends.
+            const auto at = [&](double ms) { return levelAt(r, static_cast<int64_t>(start + ms * kRate / 1000.0)); };
+            CHECK(at(5.0) > burstLevel - 0.1f);
+            CHECK(at(kBurstMs * 0.5) < burstLevel + 0.1f);
+            CHECK(at(kBurstMs + 100.0) < burstLevel * 0.6f);
+        }
+        CHECK(levelAt(r, kRate / 10) < 0.05f);          // room noise alone stays near 0
+        CHECK(!r.levels.empty() && r.levels.back() < 0.15f);   // 200 ms after the last burst
+
+        // Chunking does not change the result.
+        for (size_t frames : {size_t{1}, size_t{37}, pcm::StreamDecoder::kChunkFrames}) {
+            const Result other = follow(path, frames);
+            CHECK(other.onsetFrames == r.onsetFrames);
+        }
+    }
+
+    void testRefractory() {
+        // Two clicks 20 ms apart: within the refractory time, one onset.
+        BreathFollower f;
+        std::vector<float> in(kRate / 5, 0.0f);
+        for (int i = 0; i < 48; ++i) {
+            in[4800 + i] = 0.5f;
+            in[4800 + 960 + i] = 0.5f;
+        }
+        CHECK(f.process(in.data(), static_cast<int>(in.size())) == 1);
+        f.reset();
+        CHECK(f.onsets() == 0 && f.lastOnsetFrame() == -1 && f.level() == 0.0f);
+    }
+
+} // namespace
+
+int main() {
+    testOnsetsAndLevel();
+    testRefractory();
+    return testsupport::finish("breath_follower_test");
+}
@@ -0,0 +1,103 @@
+// Compile-time waveform, note and bend tables against runtime references.
+
+#include "BuiltinTables.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr int kN = Wavetable::kWavetableSize;
+
+    // Reference partial sum of the shape's Fourier series, same normalisation as the tables.
+    double reference(builtin::Shape shape, int level, int n) {
+        const int maxHarmonic = (kN / 2) >> level;
+        double sum = 0.0;
+        for (int k = 1; k <= maxHarmonic && k < kN / 2; ++k) {
+            double b = 0.0;
+            switch (shape) {
+                case builtin::Shape::kSine: b = k == 1 ? 1.0 : 0.0; break;
+                case builtin::Shape::kSaw: b = (k % 2 ? 2.0 : -2.0) / (kPi * k); break;
+                case builtin::Shape::kSquare: b = k % 2 ? 4.0 / (kPi * k) : 0.0; break;
+                case builtin::Shape::kTriangle: b = k % 2 ? ((k / 2) % 2 ? -8.0 : 8.0) / (kPi * kPi * k * k) : 0.0; break;
+                default: break;
+            }
+            if (b != 0.0) sum += b * std::sin(2.0 * kPi * k * n / kN);
+        }
+        return sum;
+    }
+
+    void testWaveStacks() {
+        const builtin::Shape shapes[] = {builtin::Shape::kSine, builtin::Shape::kSaw,
+                                         builtin::Shape::kSquare, builtin::Shape::kTriangle};
+        for (builtin::Shape shape : shapes) {
+            const float *stack = builtin::waveStack(shape);
+            CHECK(stack != nullptr);
+
+            double peak = 0.0;
+            for (int n = 0; n < kN; ++n) peak = std::max(peak, std::fabs(static_cast<double>(stack[n])));
+            CHECK_NEAR(peak, 1.0, 1e-6);
+
+            // The table gain is 1 / peak of the level-0 partial sum.
+            double refPeak = 0.0;
+            for (int n = 0; n < kN; ++n) refPeak = std::max(refPeak, std::fabs(reference(shape, 0, n)));
+            for (const int level : {2, 6, Wavetable::kNumMipLevels - 1}) {
+                double maxErr = 0.0;
+                for (int n = 0; n < kN; n += 7) {
+                    const double expected = reference(shape, level, n) / refPeak;
+                    maxErr = std::max(maxErr, std::fabs(stack[level * kN + n] - expected));
+                }
+                CHECK_NEAR(maxErr, 0.0, 2e-6);
+            }
+        }
+
+        // Wrapped built-ins render without building anything.
+        auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+        CHECK(saw != nullptr && saw->parsedOk());
+
+        // A failed parse falls back to the built-in sine instead of building one.
+        const uint8_t junk[] = {1, 2, 3};
+        Wavetable fallback(junk, sizeof(junk));
+        CHECK(!fallback.parsedOk());
+        CHECK(fallback.mipStack() == builtin::waveStack(builtin::Shape::kSine));
+        CHECK_NEAR(fallback.render(0.25f), 1.0, 1e-5);
+    }
+
+    void testNoteIncrements() {
+        for (const double rate : builtin::kTunedRates) {
+            const float *t = builtin::noteIncrements(rate);
+            CHECK(t != nullptr);
+            if (!t) continue;
+            for (int n = 0; n < 128; ++n) {
+                const double expected = 440.0 * std::pow(2.0, (n - 69) / 12.0) / rate;
+                CHECK_NEAR(t[n] / expected, 1.0, 1e-6);
+            }
+        }
+        CHECK(builtin::noteIncrements(22050.0) == nullptr);
+        CHECK_NEAR(builtin::noteIncrement(69, 22050.0), 440.0 / 22050.0, 1e-7);
+        CHECK(builtin::noteIncrement(200, 48000.0) == builtin::noteIncrement(127, 48000.0));
+    }
+
+    void testBendRatios() {
+        for (const int range : builtin::kBendRanges) {
+            for (int b = 0; b < 16384; b += 37) {
+                const double expected = std::pow(2.0, (b - 8192) * range / 8192.0 / 12.0);
+                CHECK_NEAR(builtin::bendToRatio(b, range) / expected, 1.0, 1e-6);
+            }
+            CHECK(builtin::bendToRatio(8192, range) == 1.0f);
+        }
+        // Untabulated range goes through fastmath.
+        CHECK_NEAR(builtin::bendToRatio(16383, 12), std::pow(2.0, 16383.0 / 8192.0 - 1.0), 1e-4);
+        CHECK(builtin::bendToRatio(-5, 2) == builtin::bendToRatio(0, 2));
+    }
+
+} // namespace
+
+int main() {
+    testWaveStacks();
+    testNoteIncrements();
+    testBendRatios();
+    return testsupport::finish("builtin_tables_test");
+}
@@ -0,0 +1,129 @@
+// CallCapture: concurrent recording, payload reassembly and file validation.
+
+#include "CallCapture.h"
+#include "TestSupport.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const std::string kPath = "/tmp/call_capture_test.bhcalls";
+
+    void testInactiveIsNoOp() {
+        CallCapture capture;
+        CHECK(!capture.active());
+        capture.record(CallCapture::kOpNoteOn, 0, 60, 100);
+        CHECK(capture.writtenCount() == 0);
+        CHECK(!capture.start("/nonexistent-dir/capture.bin"));
+        CHECK(!capture.active());
+    }
+
+    void testRoundTrip() {
+        std::remove(kPath.c_str());
+        CallCapture capture;
+        CHECK(capture.start(kPath));
+        CHECK(!capture.start(kPath));   // one session at a time
+
+        constexpr int kThreads = 4;
+        constexpr int kPerThread = 1000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&capture, t] {
+                const std::string path = "/sdcard/sf2/thread" + std::to_string(t) + "-with-a-long-file-name.sf2";
+                for (int i = 0; i < kPerThread; ++i) {
+                    capture.record(CallCapture::kOpPitchBend, t, i);
+                    if (i % 100 == 0) capture.recordWithPayload(CallCapture::kOpLoadSoundFont, path.data(), path.size());
+                }
+            });
+        }
+        for (auto &th : threads) th.join();
+        capture.record(CallCapture::kOpSetConductor, CallCapture::floatBits(0.25f), CallCapture::floatBits(0.5f),
+                       CallCapture::floatBits(1.0f));
+        capture.stop();
+        CHECK(!capture.active());
+        CHECK(capture.droppedCount() == 0);
+        capture.record(CallCapture::kOpStop);   // after stop: ignored
+
+        std::vector<CallCapture::Call> calls;
+        CallCapture::FileHeader header{};
+        CHECK(CallCapture::read(kPath, calls, &header));
+        CHECK(header.startEpochMs > 0);
+        CHECK(calls.size() == static_cast<size_t>(kThreads * (kPerThread + kPerThread / 100) + 1));
+
+        // Per-thread order is preserved, timestamps are monotonic per thread, payloads intact.
+        int nextBend[kThreads] = {};
+        int64_t lastT[kThreads] = {};
+        int loads = 0;
+        for (const auto &c : calls) {
+            if (c.op == CallCapture::kOpPitchBend) {
+                const int t = c.args[0];
+                CHECK(t >= 0 && t < kThreads);
+                if (t < 0 || t >= kThreads) continue;
+                CHECK(c.args[1] == nextBend[t]++);
+                CHECK(c.tNanos >= lastT[t]);
+                lastT[t] = c.tNanos;
+            } else if (c.op == CallCapture::kOpLoadSoundFont) {
+                const std::string path(c.payload.begin(), c.payload.end());
+                CHECK(path.rfind("/sdcard/sf2/thread", 0) == 0);
+                CHECK(path.size() > 40 && path.compare(path.size() - 4, 4, ".sf2") == 0);
+                ++loads;
+            }
+        }
+        for (int t = 0; t < kThreads; ++t) CHECK(nextBend[t] == kPerThread);
+        CHECK(loads == kThreads * kPerThread / 100);
+        CHECK(calls.back().op == CallCapture::kOpSetConductor);
+        CHECK(CallCapture::bitsFloat(calls.back().args[0]) == 0.25f);
+        CHECK(CallCapture::bitsFloat(calls.back().args[2]) == 1.0f);
+    }
+
+    void testRejectsForeignFiles() {
+        std::FILE *f = std::fopen(kPath.c_str(), "r+b");
+        CHECK(f != nullptr);
+        if (!f) return;
+        std::fwrite("XXXX", 4, 1, f);
+        std::fclose(f);
+        std::vector<CallCapture::Call> calls;
+        CHECK(!CallCapture::read(kPath, calls));
+        CHECK(!CallCapture::read("/nonexistent-file", calls));
+        std::remove(kPath.c_str());
+    }
+
+    // A short gesture session (two voices, glides, pressure, a UMP note and a low-power
+    // switch) left in the working directory for the capture_replay_session test.
+    void writeSession(const char *path) {
+        CallCapture capture;
+        CHECK(capture.start(path));
+        capture.record(CallCapture::kOpStart);
+        capture.record(CallCapture::kOpNoteOn, 0, 60, 100);
+        capture.record(CallCapture::kOpNoteOn, 1, 67, 90);
+        for (int i = 0; i < 200; ++i) {
+            capture.record(CallCapture::kOpPitchBend, 0, 8192 + i * 20);
+            capture.record(CallCapture::kOpChannelPressure, 1, i % 128);
+            capture.record(CallCapture::kOpSetConductor, CallCapture::floatBits(i / 200.0f),
+                           CallCapture::floatBits(0.5f), CallCapture::floatBits(0.25f));
+            if (i == 100) capture.record(CallCapture::kOpSetLowPowerRender, 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        const uint32_t ump[2] = {0x40923C00u, 0xFFFF0000u};   // MIDI 2.0 note on, ch 2
+        capture.recordWithPayload(CallCapture::kOpUmp, ump, sizeof(ump));
+        capture.record(CallCapture::kOpNoteOff, 0, 60);
+        capture.record(CallCapture::kOpNoteOff, 1, 67);
+        capture.record(CallCapture::kOpStop);
+        capture.stop();
+        CHECK(capture.writtenCount() == 609);
+    }
+
+} // namespace
+
+int main() {
+    testInactiveIsNoOp();
+    testRoundTrip();
+    testRejectsForeignFiles();
+    writeSession("session.bhcalls");
+    return testsupport::finish("call_capture_test");
+}
@@ -0,0 +1,425 @@
+// Replays a CallCapture file (OboeSynthesizer.startCallCapture) on the host.
+//
+//   capture_replay <file> [--speed X] [--block N] [--rate HZ] [--dump] [--wav out.wav] [--mid out.mid]
+//
+// The calls are fed, at their recorded times, through the same portable code the Android
+// callback runs: EngineEvent construction, MPSC queue, ControlCoalescer, ParamSmoother
+// glides, UMP decoding, ModMatrix and the half-band upsampler in low-power render. FluidSynth
+// is not available on the host, so a bank of wavetable voices (one per channel) stands in for
+// the synth. Each simulated callback is timed; the report lists the slowest blocks with their
+// capture timestamps so a field stutter can be lined up with what the user was doing.
+//
+// --speed 0 (default) runs as fast as possible; 1 paces calls in real time, 4 at 4x, ...
+// --mid exports the events the engine accepted as a Standard MIDI File (SmfRecorder), at
+// their capture times.
+
+#include "BuiltinTables.h"
+#include "CallCapture.h"
+#include "ControlCoalescer.h"
+#include "EventQueue.h"
+#include "FastMath.h"
+#include "HalfBandUpsampler.h"
+#include "ModMatrix.h"
+#include "SmfRecorder.h"
+#include "Ump.h"
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct Options {
+        std::string path;
+        std::string wavPath;
+        std::string midPath;
+        double speed = 0.0;
+        int block = 192;
+        double rate = 48000.0;
+        bool dump = false;
+    };
+
+    // Host model of one engine callback. Mirrors OboeSynthEngine's drain / coalesce / smooth /
+    // modulate sequence; the voices replace FluidSynth.
+    class ReplayEngine {
+    public:
+        static constexpr int kChannels = ModMatrix::kMaxVoices;
+        static constexpr int kSubBlock = 64;
+
+        explicit ReplayEngine(double rate) : rate_(rate) {
+            for (Channel &c : channels_) {
+                c.bend.configure(ParamSmoother::kLinear, 0.0f, 8192.0f);
+                c.pressure.configure(ParamSmoother::kExponential, 8.0f, 0.0f);
+                c.timbre.configure(ParamSmoother::kExponential, 8.0f, 64.0f);
+            }
+            ModMatrix::Route routes[ModMatrix::kMaxRoutes];
+            modMatrix_.setRoutes(routes, ModMatrix::defaultRoutes(routes, ModMatrix::kMaxRoutes));
+        }
+
+        bool post(const EngineEvent &e) {
+            if (events_.push(e)) {
+                if (export_) export_->recordAt(e, callNanos_);
+                return true;
+            }
+            ++dropped_;
+            return false;
+        }
+
+        // Mirrors accepted events into smf, stamped with the time of the call being applied.
+        void exportTo(SmfRecorder *smf) { export_ = smf; }
+        void setCallTime(int64_t tNanos) { callNanos_ = tNanos; }
+
+        void postUmp(const uint8_t *bytes, size_t size) {
+            std::vector<uint32_t> words(size / 4);
+            std::memcpy(words.data(), bytes, words.size() * 4);
+            for (size_t i = 0; i < words.size();) {
+                const int n = ump::packetWords(words[i]);
+                if (i + static_cast<size_t>(n) > words.size()) break;
+                EngineEvent e;
+                if (ump::toEvent(words.data() + i, n, e)) post(e);
+                i += static_cast<size_t>(n);
+            }
+        }
+
+        void setConductor(float flow, float height, float grip) {
+            modMatrix_.setGlobalSource(ModMatrix::kSrcFlow, flow);
+            modMatrix_.setGlobalSource(ModMatrix::kSrcHeight, height);
+            modMatrix_.setGlobalSource(ModMatrix::kSrcGrip, grip);
+        }
+
+        ModMatrix &modMatrix() { return modMatrix_; }
+        void setLowPower(bool on) {
+            if (on != halfRate_) upsampler_.reset();
+            halfRate_ = on;
+        }
+        void setPlaying(bool on) { playing_ = on; }
+        uint64_t dropped() const { return dropped_; }
+
+        void process(float *out, int frames) {
+            if (!playing_) {
+                std::memset(out, 0, sizeof(float) * static_cast<size_t>(frames) * 2);
+                return;
+            }
+            drain(frames);
+            for (int ch = 0; ch < kChannels; ++ch) {
+                const Channel &c = channels_[ch];
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcPitchBend, (c.bend.current() - 8192.0f) * (1.0f / 8192.0f));
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcPressure, c.pressure.current() * (1.0f / 127.0f));
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcTimbre, c.timbre.current() * (1.0f / 127.0f));
+                modMatrix_.setVoiceSource(ch, ModMatrix::kSrcVelocity, c.velocity);
+                modMatrix_.setVoiceActive(ch, c.held > 0);
+            }
+            modMatrix_.process(frames, rate_);
+
+            for (int offset = 0; offset < frames; offset += kSubBlock) {
+                const int n = std::min(kSubBlock, frames - offset);
+                for (Channel &c : channels_) {
+                    c.bend.advance(n);
+                    c.pressure.advance(n);
+                    c.timbre.advance(n);
+                }
+                float *dst = out + static_cast<size_t>(offset) * 2;
+                if (halfRate_) {
+                    // Even sub-blocks only (the default 192-frame block splits into 64s).
+                    const int low = n / 2;
+                    renderVoices(half_, low, rate_ * 0.5);
+                    upsampler_.process(half_, low, dst);
+                    if (n & 1) dst[2 * (n - 1)] = dst[2 * (n - 1) + 1] = 0.0f;
+                } else {
+                    renderVoices(dst, n, rate_);
+                }
+            }
+        }
+
+    private:
+        struct Channel {
+            ParamSmoother bend, pressure, timbre;
+            float velocity = 0.0f;
+            float phase = 0.0f;
+            int note = 60;
+            int held = 0;
+        };
+
+        void drain(int frames) {
+            EngineEvent e;
+            while (events_.pop(e)) {
+                if (coalescer_.absorb(e)) continue;
+                Channel &c = channels_[e.channel];
+                const bool highRes = e.flags & EngineEvent::kFlagHighRes;
+                const int velocity = highRes ? ump::velocity16To7Bit(e.value) : static_cast<int>(e.value);
+                // As the engine: controls queued ahead apply first; a note on a silent channel
+                // starts at them instead of gliding.
+                coalescer_.flushChannel(e.channel, [&](int ch, int slot, uint32_t value, uint8_t flags) {
+                    applyControl(ch, slot, value, flags, frames);
+                });
+                if (e.type == EngineEvent::kNoteOn && velocity > 0 && c.held == 0) {
+                    for (ParamSmoother *s : {&c.bend, &c.pressure, &c.timbre}) s->reset(s->target());
+                }
+                if (e.type == EngineEvent::kNoteOn) {
+                    if (velocity > 0) {
+                        c.velocity = static_cast<float>(velocity) * (1.0f / 127.0f);
+                        c.note = e.data1;
+                        ++c.held;
+                    } else if (c.held > 0) {
+                        --c.held;
+                    }
+                } else if (e.type == EngineEvent::kNoteOff && c.held > 0) {
+                    --c.held;
+                }
+            }
+            coalescer_.flush([&](int ch, int slot, uint32_t value, uint8_t flags) {
+                applyControl(ch, slot, value, flags, frames);
+            });
+        }
+
+        void applyControl(int ch, int slot, uint32_t value, uint8_t flags, int rampFrames) {
+            Channel &c = channels_[ch];
+            const bool highRes = flags & EngineEvent::kFlagHighRes;
+            const float v = static_cast<float>(value);
+            ParamSmoother *s = nullptr;
+            float target = v;
+            if (slot == ControlCoalescer::kSlotBend) {
+                s = &c.bend;
+                target = highRes ? v * ump::kToBend14 : v;
+            } else if (slot == ControlCoalescer::kSlotPressure) {
+                s = &c.pressure;
+                target = highRes ? v * ump::kTo7Bit : v;
+            } else if (slot == ControlCoalescer::kSlotCcBase + 74) {
+                s = &c.timbre;
+                target = highRes ? v * ump::kTo7Bit : v;
+            }
+            if (s) s->setTarget(target, rampFrames, rate_);
+        }
+
+        void renderVoices(float *out, int frames, double rate) {
+            static const auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+            std::memset(out, 0, sizeof(float) * static_cast<size_t>(frames) * 2);
+            const float *pitchRatio = modMatrix_.pitchRatio();
+            const float *modGain = modMatrix_.gain();
+            for (int ch = 0; ch < kChannels; ++ch) {
+                Channel &c = channels_[ch];
+                if (c.held == 0) continue;
+                const float bendSemis = (c.bend.current() - 8192.0f) * (48.0f / 8192.0f);
+                const float inc = builtin::noteIncrement(c.note, rate) * fastmath::semitonesToRatio(bendSemis) * pitchRatio[ch];
+                const int level = Wavetable::levelForIncrement(inc);
+                const float gain = 0.1f * c.velocity * modGain[ch];
+                for (int i = 0; i < frames; ++i) {
+                    const float s = saw->render(c.phase, level) * gain;
+                    out[2 * i] += s;
+                    out[2 * i + 1] += s;
+                    c.phase += inc;
+                    c.phase -= static_cast<float>(static_cast<int>(c.phase));
+                }
+            }
+        }
+
+        double rate_;
+        MpscQueue<EngineEvent, 1024> events_;
+        SmfRecorder *export_ = nullptr;
+        int64_t callNanos_ = 0;
+        ControlCoalescer coalescer_;
+        Channel channels_[kChannels];
+        ModMatrix modMatrix_;
+        HalfBandUpsampler upsampler_;
+        float half_[kSubBlock] = {};
+        bool halfRate_ = false;
+        bool playing_ = true;
+        uint64_t dropped_ = 0;
+    };
+
+    void dumpCall(const CallCapture::Call &c) {
+        std::printf("%12.3f ms  %-20s", static_cast<double>(c.tNanos) * 1e-6, CallCapture::opName(c.op));
+        switch (c.op) {
+            case CallCapture::kOpSetConductor:
+                std::printf(" %.3f %.3f %.3f", CallCapture::bitsFloat(c.args[0]), CallCapture::bitsFloat(c.args[1]),
+                            CallCapture::bitsFloat(c.args[2]));
+                break;
+            case CallCapture::kOpSetLfoRate:
+                std::printf(" %d %.3f Hz", c.args[0], CallCapture::bitsFloat(c.args[1]));
+                break;
+            case CallCapture::kOpLoadSoundFont:
+            case CallCapture::kOpOpenWavetableCache:
+            case CallCapture::kOpImportFiles:
+                if (c.op == CallCapture::kOpImportFiles) std::printf(" kind=%d", c.args[0]);
+                std::printf(" \"%.*s\"", static_cast<int>(c.payload.size()), reinterpret_cast<const char *>(c.payload.data()));
+                break;
+            case CallCapture::kOpUmp:
+            case CallCapture::kOpSetModRoutes:
+                std::printf(" (%zu bytes)", c.payload.size());
+                break;
+            case CallCapture::kOpRegisterPcm:
+                std::printf(" kind=%d format=%d channels=%d frames=%d", c.args[0], c.args[1], c.args[2], c.args[3]);
+                break;
+            default:
+                std::printf(" %d %d %d", c.args[0], c.args[1], c.args[2]);
+                break;
+        }
+        std::printf("\n");
+    }
+
+    void apply(ReplayEngine &engine, const CallCapture::Call &c, uint64_t &hostOnly) {
+        engine.setCallTime(c.tNanos);
+        switch (c.op) {
+            case CallCapture::kOpStart: engine.setPlaying(true); break;
+            case CallCapture::kOpStop: engine.setPlaying(false); break;
+            case CallCapture::kOpNoteOn: engine.post(EngineEvent::noteOn(c.args[0], c.args[1], c.args[2])); break;
+            case CallCapture::kOpNoteOff: engine.post(EngineEvent::noteOff(c.args[0], c.args[1])); break;
+            case CallCapture::kOpPitchBend: engine.post(EngineEvent::pitchBend(c.args[0], c.args[1])); break;
+            case CallCapture::kOpChannelPressure: engine.post(EngineEvent::channelPressure(c.args[0], c.args[1])); break;
+            case CallCapture::kOpControlChange:
+                engine.post(EngineEvent::controlChange(c.args[0], c.args[1], c.args[2]));
+                break;
+            case CallCapture::kOpUmp: engine.postUmp(c.payload.data(), c.payload.size()); break;
+            case CallCapture::kOpSetConductor:
+                engine.setConductor(CallCapture::bitsFloat(c.args[0]), CallCapture::bitsFloat(c.args[1]),
+                                    CallCapture::bitsFloat(c.args[2]));
+                break;
+            case CallCapture::kOpSetModRoutes: {
+                const size_t floats = std::min<size_t>(c.payload.size() / 4, ModMatrix::kMaxRoutes * 4);
+                std::vector<float> buf(floats);
+                std::memcpy(buf.data(), c.payload.data(), floats * 4);
+                ModMatrix::Route routes[ModMatrix::kMaxRoutes];
+                const int count = static_cast<int>(floats / 4);
+                for (int i = 0; i < count; ++i) {
+                    routes[i].source = static_cast<ModMatrix::Source>(static_cast<int>(buf[i * 4 + 0]));
+                    routes[i].dest = static_cast<ModMatrix::Dest>(static_cast<int>(buf[i * 4 + 1]));
+                    routes[i].curve = static_cast<ModMatrix::Curve>(static_cast<int>(buf[i * 4 + 2]));
+                    routes[i].amount = buf[i * 4 + 3];
+                }
+                engine.modMatrix().setRoutes(routes, count);
+                break;
+            }
+            case CallCapture::kOpSetLfoRate: engine.modMatrix().setLfoRate(c.args[0], CallCapture::bitsFloat(c.args[1])); break;
+            case CallCapture::kOpSetLowPowerRender: engine.setLowPower(c.args[0] != 0); break;
+            default:
+                // SoundFont, FluidSynth, import and cache calls touch device files; listed only.
+                ++hostOnly;
+                break;
+        }
+    }
+
+    bool parseArgs(int argc, char **argv, Options &o) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (a == "--speed" && hasValue) o.speed = std::atof(argv[++i]);
+            else if (a == "--block" && hasValue) o.block = std::max(1, std::atoi(argv[++i]));
+            else if (a == "--rate" && hasValue) o.rate = std::atof(argv[++i]);
+            else if (a == "--wav" && hasValue) o.wavPath = argv[++i];
+            else if (a == "--mid" && hasValue) o.midPath = argv[++i];
+            else if (a == "--dump") o.dump = true;
+            else if (!a.empty() && a[0] != '-' && o.path.empty()) o.path = a;
+            else return false;
+        }
+        return !o.path.empty() && o.rate > 0.0;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: capture_replay <file> [--speed X] [--block N] [--rate HZ] [--dump] [--wav out.wav] [--mid out.mid]\n");
+        return 2;
+    }
+
+    std::vector<CallCapture::Call> calls;
+    CallCapture::FileHeader header{};
+    if (!CallCapture::read(opt.path, calls, &header)) {
+        std::fprintf(stderr, "capture_replay: %s is not a readable capture (format %u)\n", opt.path.c_str(),
+                     CallCapture::kFormatVersion);
+        return 1;
+    }
+    if (opt.dump) {
+        for (const auto &c : calls) dumpCall(c);
+    }
+
+    uint64_t perOp[CallCapture::kOpCount] = {};
+    for (const auto &c : calls) ++perOp[c.op];
+    const int64_t lastNanos = calls.empty() ? 0 : calls.back().tNanos;
+    const int64_t blockNanos = static_cast<int64_t>(1e9 * opt.block / opt.rate);
+    const int64_t blocks = lastNanos / blockNanos + 1;
+
+    ReplayEngine engine(opt.rate);
+    SmfRecorder smf;
+    if (!opt.midPath.empty()) {
+        if (!smf.start(opt.midPath)) {
+            std::fprintf(stderr, "capture_replay: cannot write %s\n", opt.midPath.c_str());
+            return 1;
+        }
+        engine.exportTo(&smf);
+    }
+    std::vector<float> out(static_cast<size_t>(opt.block) * 2);
+    std::vector<float> recording;
+    std::vector<double> blockUs;
+    blockUs.reserve(static_cast<size_t>(blocks));
+    uint64_t hostOnly = 0;
+    size_t next = 0;
+
+    using clock = std::chrono::steady_clock;
+    const auto wallStart = clock::now();
+    for (int64_t b = 0; b < blocks; ++b) {
+        const int64_t blockEnd = (b + 1) * blockNanos;
+        if (opt.speed > 0.0) {
+            std::this_thread::sleep_until(wallStart + std::chrono::nanoseconds(static_cast<int64_t>(b * blockNanos / opt.speed)));
+        }
+        while (next < calls.size() && calls[next].tNanos < blockEnd) apply(engine, calls[next++], hostOnly);
+
+        const auto t0 = clock::now();
+        engine.process(out.data(), opt.block);
+        blockUs.push_back(std::chrono::duration<double, std::micro>(clock::now() - t0).count());
+        if (!opt.wavPath.empty()) recording.insert(recording.end(), out.begin(), out.end());
+    }
+
+    std::printf("%s: %zu calls over %.3f s (captured at epoch %lld ms)\n", opt.path.c_str(), calls.size(),
+                static_cast<double>(lastNanos) * 1e-9, static_cast<long long>(header.startEpochMs));
+    for (int op = 1; op < CallCapture::kOpCount; ++op) {
+        if (perOp[op]) std::printf("  %-20s %8llu\n", CallCapture::opName(static_cast<CallCapture::Op>(op)),
+                                   static_cast<unsigned long long>(perOp[op]));
+    }
+    if (hostOnly) std::printf("  (%llu file/synth calls listed but not replayed on the host)\n",
+                              static_cast<unsigned long long>(hostOnly));
+
+    std::vector<double> sorted = blockUs;
+    std::sort(sorted.begin(), sorted.end());
+    const double budgetUs = 1e6 * opt.block / opt.rate;
+    const auto pct = [&](double p) { return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1))]; };
+    const auto over = std::count_if(blockUs.begin(), blockUs.end(), [&](double us) { return us > budgetUs; });
+    std::printf("blocks %lld x %d frames @ %.0f Hz (budget %.0f us): p50 %.1f us  p99 %.1f us  max %.1f us  over budget %lld\n",
+                static_cast<long long>(blocks), opt.block, opt.rate, budgetUs, pct(0.5), pct(0.99), sorted.back(),
+                static_cast<long long>(over));
+    std::printf("event queue drops %llu\n", static_cast<unsigned long long>(engine.dropped()));
+
+    // Slowest blocks with their capture time, to line up with the user's report.
+    std::vector<size_t> order(blockUs.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    const size_t worst = std::min<size_t>(5, order.size());
+    std::partial_sort(order.begin(), order.begin() + static_cast<long>(worst), order.end(),
+                      [&](size_t a, size_t b) { return blockUs[a] > blockUs[b]; });
+    for (size_t i = 0; i < worst; ++i) {
+        std::printf("  slow block at %10.3f ms  %8.1f us\n",
+                    static_cast<double>(order[i]) * static_cast<double>(blockNanos) * 1e-6, blockUs[order[i]]);
+    }
+
+    if (!opt.midPath.empty()) {
+        const bool ok = smf.stop();
+        std::printf("exported %llu events to %s\n", static_cast<unsigned long long>(smf.writtenCount()),
+                    opt.midPath.c_str());
+        if (!ok) {
+            std::fprintf(stderr, "capture_replay: cannot write %s\n", opt.midPath.c_str());
+            return 1;
+        }
+    }
+    if (!opt.wavPath.empty() && !wavwriter::writeFloat32(opt.wavPath, recording, 2, static_cast<uint32_t>(opt.rate))) {
+        std::fprintf(stderr, "capture_replay: cannot write %s\n", opt.wavPath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+// Event queue, control coalescing and smoothing ramps.
+
+#include "ControlCoalescer.h"
+#include "EventQueue.h"
+#include "TestSupport.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    EngineEvent makeEvent(uint8_t type, uint8_t channel, uint8_t data1, uint32_t value) {
+        EngineEvent e;
+        e.type = type;
+        e.channel = channel;
+        e.data1 = data1;
+        e.value = value;
+        return e;
+    }
+
+    void testCoalescingKeepsLastValue() {
+        ControlCoalescer c;
+        for (uint32_t v = 0; v < 10; ++v) CHECK(c.absorb(makeEvent(EngineEvent::kPitchBend, 2, 0, 8000 + v)));
+        CHECK(c.absorb(makeEvent(EngineEvent::kChannelPressure, 2, 0, 10)));
+        CHECK(c.absorb(makeEvent(EngineEvent::kChannelPressure, 2, 0, 90)));
+        CHECK(c.absorb(makeEvent(EngineEvent::kControlChange, 3, 74, 5)));
+        // Notes and order-sensitive CCs are not absorbed.
+        CHECK(!c.absorb(makeEvent(EngineEvent::kNoteOn, 2, 60, 100)));
+        CHECK(!c.absorb(makeEvent(EngineEvent::kControlChange, 2, 64, 127)));
+        CHECK(!c.absorb(makeEvent(EngineEvent::kControlChange, 2, 101, 0)));
+        CHECK(!c.absorb(makeEvent(EngineEvent::kControlChange, 2, 123, 0)));
+
+        CHECK(c.absorbedCount() == 13);
+        CHECK(c.mergedCount() == 10);
+
+        int calls = 0;
+        c.flush([&](int ch, int slot, uint32_t value, uint8_t) {
+            ++calls;
+            if (slot == ControlCoalescer::kSlotBend) {
+                CHECK(ch == 2);
+                CHECK(value == 8009);
+            } else if (slot == ControlCoalescer::kSlotPressure) {
+                CHECK(value == 90);
+            } else {
+                CHECK(ch == 3);
+                CHECK(slot == ControlCoalescer::kSlotCcBase + 74);
+                CHECK(value == 5);
+            }
+        });
+        CHECK(calls == 3);
+
+        calls = 0;
+        c.flush([&](int, int, uint32_t, uint8_t) { ++calls; });
+        CHECK(calls == 0);
+    }
+
+    // The engine's drain: before an in-order event its channel's queued controls are applied,
+    // and a note starting on a silent channel snaps its smoothers to their targets instead of
+    // ramping. An MPE note's initial bend is sent just ahead of its note-on.
+    void testNoteStartsAtItsControls() {
+        ControlCoalescer c;
+        ParamSmoother bend[ControlCoalescer::kChannels];
+        for (ParamSmoother &b : bend) b.configure(ParamSmoother::kLinear, 0.0f, 8192.0f);
+        bend[1].reset(12000.0f);   // where the previous note on channel 1 left it
+
+        const EngineEvent queued[] = {
+                makeEvent(EngineEvent::kPitchBend, 1, 0, 4000),
+                makeEvent(EngineEvent::kControlChange, 1, 7, 90),
+                makeEvent(EngineEvent::kPitchBend, 2, 0, 9000),
+                makeEvent(EngineEvent::kControlChange, 1, 64, 127),   // sustain: in order
+                makeEvent(EngineEvent::kNoteOn, 1, 60, 100),
+        };
+        std::vector<int> applied;   // slot, or 1000 + cc for in-order CCs
+        float bendAtNoteOn = -1.0f;
+        bool movingAtNoteOn = true;
+        auto apply = [&](int ch, int slot, uint32_t value) {
+            applied.push_back(slot);
+            if (slot == ControlCoalescer::kSlotBend) bend[ch].setTarget(static_cast<float>(value), 192, 48000.0);
+        };
+        for (const EngineEvent &e : queued) {
+            if (c.absorb(e)) continue;
+            c.flushChannel(e.channel, [&](int ch, int slot, uint32_t value, uint8_t) { apply(ch, slot, value); });
+            if (e.type == EngineEvent::kNoteOn) {
+                bend[e.channel].reset(bend[e.channel].target());
+                bendAtNoteOn = bend[e.channel].current();
+                movingAtNoteOn = bend[e.channel].moving();
+            } else {
+                applied.push_back(1000 + e.data1);
+            }
+        }
+        CHECK(bendAtNoteOn == 4000.0f);
+        CHECK(!movingAtNoteOn);
+        // Bend and volume went out before the sustain switch they were sent ahead of.
+        CHECK(applied.size() == 3);
+        CHECK(applied.size() == 3 && applied[0] == ControlCoalescer::kSlotBend
+              && applied[1] == ControlCoalescer::kSlotCcBase + 7 && applied[2] == 1064);
+
+        // Channel 2 was left pending for the end-of-block flush, and ramps there.
+        int calls = 0;
+        c.flush([&](int ch, int slot, uint32_t value, uint8_t) {
+            ++calls;
+            CHECK(ch == 2 && slot == ControlCoalescer::kSlotBend);
+            apply(ch, slot, value);
+        });
+        CHECK(calls == 1);
+        CHECK(bend[2].moving() && bend[2].target() == 9000.0f);
+    }
+
+    void testLinearRamp() {
+        ParamSmoother s;
+        s.configure(ParamSmoother::kLinear, 0.0f, 8192.0f);
+        s.setTarget(8192.0f + 256.0f, 256, 48000.0);
+        CHECK(s.moving());
+        CHECK_NEAR(s.advance(64), 8192.0 + 64.0, 1e-3);
+        CHECK_NEAR(s.advance(128), 8192.0 + 192.0, 1e-3);
+        CHECK_NEAR(s.advance(64), 8448.0, 0.0);
+        CHECK(!s.moving());
+    }
+
+    void testExponentialRamp() {
+        ParamSmoother s;
+        s.configure(ParamSmoother::kExponential, 10.0f, 0.0f);
+        s.setTarget(127.0f, 192, 48000.0);
+        // One time constant (480 frames) covers ~63 % of the distance.
+        const float v = s.advance(480);
+        CHECK_NEAR(v, 127.0 * (1.0 - std::exp(-1.0)), 0.05);
+        for (int i = 0; i < 100 && s.moving(); ++i) s.advance(480);
+        CHECK(!s.moving());
+        CHECK_NEAR(s.current(), 127.0, 0.0);
+    }
+
+    void testQueueOrderAndCapacity() {
+        MpscQueue<EngineEvent, 8> q;
+        for (uint32_t i = 0; i < 8; ++i) CHECK(q.push(makeEvent(EngineEvent::kNoteOn, 0, 0, i)));
+        CHECK(!q.push(makeEvent(EngineEvent::kNoteOn, 0, 0, 99)));
+        EngineEvent e;
+        for (uint32_t i = 0; i < 8; ++i) {
+            CHECK(q.pop(e));
+            CHECK(e.value == i);
+        }
+        CHECK(!q.pop(e));
+    }
+
+    void testQueueMultipleProducers() {
+        constexpr int kPerThread = 20000;
+        MpscQueue<EngineEvent, 1024> q;
+        std::vector<std::thread> producers;
+        for (uint8_t t = 0; t < 3; ++t) {
+            producers.emplace_back([&q, t] {
+                for (uint32_t i = 0; i < kPerThread; ++i) {
+                    while (!q.push(makeEvent(EngineEvent::kControlChange, t, 0, i))) std::this_thread::yield();
+                }
+            });
+        }
+        uint32_t next[3] = {0, 0, 0};
+        int received = 0;
+        EngineEvent e;
+        while (received < 3 * kPerThread) {
+            if (!q.pop(e)) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Per-producer FIFO order must hold.
+            CHECK(e.value == next[e.channel]);
+            next[e.channel] = e.value + 1;
+            ++received;
+        }
+        for (auto &p : producers) p.join();
+        CHECK(!q.pop(e));
+    }
+
+} // namespace
+
+int main() {
+    testCoalescingKeepsLastValue();
+    testNoteStartsAtItsControls();
+    testLinearRamp();
+    testExponentialRamp();
+    testQueueOrderAndCapacity();
+    testQueueMultipleProducers();
+    return testsupport::finish("ControlCoalescerTest");
+}
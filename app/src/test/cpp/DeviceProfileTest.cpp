@@ -0,0 +1,113 @@
+// DeviceProfile: tier choice from measurements, kernel timing and the saved profile format.
+
+#include "DeviceProfile.h"
+#include "DspKernels.h"
+#include "TestSupport.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+    const std::string kPath = "/tmp/device_profile_test.txt";
+
+    DeviceProfile::Measurements measurements(double voiceNs, int bursts) {
+        DeviceProfile::Measurements m;
+        m.sampleRate = 48000.0;
+        m.framesPerBurst = 192;
+        m.bufferBursts = bursts;
+        m.voiceNsPerFrame = voiceNs;
+        m.unisonNsPerFrame = voiceNs * 2.0;
+        return m;
+    }
+
+    void testChoose() {
+        // Half of a 48 kHz frame is ~10.4 us: 20 ns/voice fits ~520 voices, 100 ns ~104, 400 ns ~26.
+        CHECK_NEAR(DeviceProfile::voiceCapacity(measurements(20.0, 2)), 520.8, 0.1);
+        CHECK(DeviceProfile::voiceCapacity(measurements(0.0, 2)) == 0.0);
+
+        const DeviceProfile high = DeviceProfile::choose(measurements(20.0, 2));
+        CHECK(high.tier == DeviceProfile::kTierHigh);
+        CHECK(high.polyphony == 128 && high.interpolation == 4 && high.effects && !high.lowPowerRender);
+        CHECK(high.bufferBursts == 2);
+        CHECK(high.measured.voiceNsPerFrame == 20.0);
+
+        const DeviceProfile mid = DeviceProfile::choose(measurements(100.0, 1));
+        CHECK(mid.tier == DeviceProfile::kTierMid);
+        CHECK(mid.polyphony == 64 && mid.interpolation == 1 && mid.effects);
+        CHECK(mid.bufferBursts == 1);
+
+        const DeviceProfile low = DeviceProfile::choose(measurements(400.0, 2));
+        CHECK(low.tier == DeviceProfile::kTierLow);
+        CHECK(low.polyphony == 32 && !low.effects && low.lowPowerRender && low.unisonCopies == 3);
+
+        // A fast CPU that still underruns below three bursts drops a tier; low stays low.
+        CHECK(DeviceProfile::choose(measurements(20.0, 3)).tier == DeviceProfile::kTierMid);
+        CHECK(DeviceProfile::choose(measurements(400.0, 5)).tier == DeviceProfile::kTierLow);
+
+        // No timing (probe failed): the lowest tier, never a division by zero.
+        CHECK(DeviceProfile::choose(measurements(0.0, 2)).tier == DeviceProfile::kTierLow);
+
+        // Without a profile the engine runs the old hand-tuned settings.
+        const DeviceProfile none;
+        CHECK(none.tier == DeviceProfile::kTierMid && none.polyphony == 64 && none.interpolation == 1);
+        CHECK(none.bufferBursts == 0);
+    }
+
+    void testMeasureKernels() {
+        dsp::bindBest();
+        DeviceProfile::Measurements m;
+        DeviceProfile::measureKernels(m);
+        CHECK(m.voiceNsPerFrame > 0.0 && m.voiceNsPerFrame < 1e5);
+        CHECK(m.unisonNsPerFrame > 0.0 && m.unisonNsPerFrame < 1e6);
+        CHECK(m.isa == static_cast<int>(dsp::kernels().isa));
+        const DeviceProfile p = DeviceProfile::choose(m);
+        std::printf("host: voice %.2f ns/frame, 7-copy unison %.2f ns/frame, capacity %.0f voices -> %s tier\n",
+                    m.voiceNsPerFrame, m.unisonNsPerFrame, DeviceProfile::voiceCapacity(m),
+                    DeviceProfile::tierName(p.tier));
+    }
+
+    void testSaveLoad() {
+        std::remove(kPath.c_str());
+        DeviceProfile loaded;
+        CHECK(!DeviceProfile::load(kPath, loaded));   // first launch: nothing saved yet
+
+        const DeviceProfile saved = DeviceProfile::choose(measurements(400.0, 3));
+        CHECK(saved.save(kPath));
+        CHECK(DeviceProfile::load(kPath, loaded));
+        CHECK(loaded.tier == saved.tier);
+        CHECK(loaded.polyphony == saved.polyphony && loaded.interpolation == saved.interpolation);
+        CHECK(loaded.effects == saved.effects && loaded.lowPowerRender == saved.lowPowerRender);
+        CHECK(loaded.unisonCopies == saved.unisonCopies && loaded.bufferBursts == saved.bufferBursts);
+        CHECK(loaded.measured.framesPerBurst == 192 && loaded.measured.bufferBursts == 3);
+        CHECK_NEAR(loaded.measured.voiceNsPerFrame, 400.0, 1e-3);
+        CHECK_NEAR(loaded.measured.sampleRate, 48000.0, 1e-3);
+
+        // Another format version or a damaged value means probing again.
+        auto write = [](const char *text) {
+            std::FILE *f = std::fopen(kPath.c_str(), "w");
+            std::fputs(text, f);
+            std::fclose(f);
+        };
+        write("version=0\ntier=2\npolyphony=128\ninterpolation=4\neffects=1\nlowPowerRender=0\n");
+        CHECK(!DeviceProfile::load(kPath, loaded));
+        write("version=1\ntier=7\npolyphony=128\ninterpolation=4\neffects=1\nlowPowerRender=0\n");
+        CHECK(!DeviceProfile::load(kPath, loaded));
+        write("version=1\ntier=2\npolyphony=lots\ninterpolation=4\neffects=1\nlowPowerRender=0\n");
+        CHECK(!DeviceProfile::load(kPath, loaded));
+        write("version=1\ntier=2\n");
+        CHECK(!DeviceProfile::load(kPath, loaded));
+        write("version=1\ntier=2\npolyphony=128\ninterpolation=4\neffects=1\nlowPowerRender=0\nfuture=3\n");
+        CHECK(DeviceProfile::load(kPath, loaded));   // unknown keys are ignored
+        CHECK(loaded.tier == DeviceProfile::kTierHigh && loaded.polyphony == 128);
+        std::remove(kPath.c_str());
+    }
+
+} // namespace
+
+int main() {
+    testChoose();
+    testMeasureKernels();
+    testSaveLoad();
+    return testsupport::finish("device_profile_test");
+}
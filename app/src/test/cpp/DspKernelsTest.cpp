@@ -0,0 +1,186 @@
+// DspKernels: every variant this CPU runs against plain scalar references, and binding.
+
+#include "DspKernels.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    std::vector<float> noise(size_t n, uint32_t seed) {
+        std::vector<float> v(n);
+        for (float &x : v) {
+            seed = seed * 1664525u + 1013904223u;
+            x = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        }
+        return v;
+    }
+
+    double maxDiff(const float *a, const float *b, size_t n) {
+        double d = 0.0;
+        for (size_t i = 0; i < n; ++i) d = std::max(d, static_cast<double>(std::fabs(a[i] - b[i])));
+        return d;
+    }
+
+    void testFir(const dsp::Kernels &k) {
+        constexpr int kTaps = 31;
+        const auto taps = noise(kTaps, 1);
+        const auto x = noise(200 + kTaps, 2);
+        for (int frames : {0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 200}) {
+            std::vector<float> got(static_cast<size_t>(frames) + 1, 9.0f), want(static_cast<size_t>(frames));
+            for (int j = 0; j < frames; ++j) {
+                float acc = 0.0f;
+                for (int i = 0; i < kTaps; ++i) acc += taps[i] * x[j + i];
+                want[j] = acc;
+            }
+            k.fir(taps.data(), kTaps, x.data(), got.data(), frames);
+            CHECK(maxDiff(got.data(), want.data(), static_cast<size_t>(frames)) < 1e-5);
+            CHECK(got[frames] == 9.0f);   // nothing written past the end
+        }
+    }
+
+    void testMixAndConvert(const dsp::Kernels &k) {
+        const auto a = noise(130, 3), b = noise(130, 4);
+        for (int count : {0, 1, 5, 16, 31, 64, 129}) {
+            std::vector<float> out(a.begin(), a.begin() + count + 1);
+            const float sentinel = out[count];
+            k.mixScale(out.data(), b.data(), 0.5f, count);
+            for (int i = 0; i < count; ++i) CHECK_NEAR(out[i], b[i] * 0.5f, 1e-7);
+            k.mixAdd(out.data(), a.data(), -2.0f, count);
+            for (int i = 0; i < count; ++i) CHECK_NEAR(out[i], b[i] * 0.5f - 2.0f * a[i], 1e-6);
+            CHECK(out[count] == sentinel);
+        }
+
+        std::vector<float> inter(2 * 70, 1.0f);
+        k.interleaveAdd(inter.data(), a.data(), b.data(), 69);
+        CHECK(inter[0] == 1.0f + a[0] && inter[1] == 1.0f + b[0]);
+        CHECK(inter[2 * 68 + 1] == 1.0f + b[68]);
+        CHECK(inter[2 * 69] == 1.0f);
+
+        // Odd byte offset: WAV data is not guaranteed to be aligned.
+        uint8_t bytes[1 + 2 * 67];
+        for (int i = 0; i < 67; ++i) {
+            const auto v = static_cast<int16_t>(i * 977 - 32768);
+            std::memcpy(bytes + 1 + 2 * i, &v, 2);
+        }
+        float pcm[67];
+        k.int16ToFloat(bytes + 1, pcm, 67, 1.0f / 32768.0f);
+        for (int i = 0; i < 67; ++i) CHECK(pcm[i] == static_cast<float>(i * 977 - 32768) / 32768.0f);
+
+        for (int count : {0, 1, 3, 4, 17, 64, 129}) {
+            float want = 0.0f;
+            for (int i = 0; i < count; ++i) want = std::max(want, std::fabs(a[i]));
+            CHECK(k.peakAbs(a.data(), count) == want);
+        }
+        std::vector<float> spike(40, 0.0f);
+        spike[37] = -0.75f;   // in the scalar tail for every width
+        CHECK(k.peakAbs(spike.data(), 40) == 0.75f);
+    }
+
+    void testUnison(const dsp::Kernels &k) {
+        constexpr int kSize = 2048;
+        const auto table = noise(kSize, 5);
+        for (int copies = 1; copies <= 16; ++copies) {
+            alignas(64) float phase[16] = {}, inc[16] = {}, gl[16] = {}, gr[16] = {};
+            float refPhase[16] = {};
+            for (int c = 0; c < copies; ++c) {
+                phase[c] = refPhase[c] = 0.06f * static_cast<float>(c);
+                inc[c] = 0.0123f * (1.0f + 0.01f * static_cast<float>(c));
+                gl[c] = 0.1f * static_cast<float>(c + 1);
+                gr[c] = 1.0f - 0.05f * static_cast<float>(c);
+            }
+            constexpr int kFrames = 50;
+            float outL[kFrames], outR[kFrames];
+            k.unisonOsc({table.data(), kSize - 1, phase, inc, gl, gr, copies, outL, outR, kFrames});
+
+            for (int f = 0; f < kFrames; ++f) {
+                double l = 0.0, r = 0.0;
+                for (int c = 0; c < copies; ++c) {
+                    refPhase[c] += inc[c];
+                    refPhase[c] -= std::floor(refPhase[c]);
+                    const float x = refPhase[c] * kSize;
+                    const int i = static_cast<int>(std::floor(x));
+                    const float s = table[i & (kSize - 1)]
+                            + (table[(i + 1) & (kSize - 1)] - table[i & (kSize - 1)]) * (x - std::floor(x));
+                    l += s * gl[c];
+                    r += s * gr[c];
+                }
+                CHECK_NEAR(outL[f], l, 1e-4);
+                CHECK_NEAR(outR[f], r, 1e-4);
+            }
+            CHECK(maxDiff(phase, refPhase, static_cast<size_t>(copies)) < 1e-5);
+        }
+    }
+
+    void testGrain(const dsp::Kernels &k) {
+        const auto src = noise(4096, 6);
+        std::vector<float> window(4097);
+        for (int i = 0; i <= 4096; ++i) window[i] = 0.5f - 0.5f * std::cos(6.2831853f * static_cast<float>(i) / 4096.0f);
+
+        for (int frames : {1, 7, 16, 37, 100}) {
+            dsp::GrainArgs g{};
+            g.source = src.data();
+            g.mask = 4095;
+            g.base = 4000;       // wraps around the loop
+            g.inc = 1.37f;
+            g.window = window.data();
+            g.winInc = 4096.0f / 120.0f;
+            g.gainL = 0.7f;
+            g.gainR = 0.3f;
+            g.age = 11;
+            std::vector<float> left(frames, 0.25f), right(frames, -0.25f);
+            g.left = left.data();
+            g.right = right.data();
+            g.frames = frames;
+            k.grain(g);
+
+            for (int f = 0; f < frames; ++f) {
+                const float t = static_cast<float>(g.age + f);
+                const float x = t * g.inc;
+                const int xi = static_cast<int>(std::floor(x));
+                const float a = src[(g.base + xi) & g.mask], b = src[(g.base + xi + 1) & g.mask];
+                const float s = (a + (b - a) * (x - std::floor(x))) * window[static_cast<int>(t * g.winInc)];
+                CHECK_NEAR(left[f], 0.25f + s * 0.7f, 1e-5);
+                CHECK_NEAR(right[f], -0.25f + s * 0.3f, 1e-5);
+            }
+        }
+    }
+
+    void testBinding() {
+        const uint32_t isas = dsp::availableIsas();
+        CHECK(isas != 0);
+        CHECK(dsp::variant(dsp::Isa::kCount) == nullptr);
+        CHECK(!dsp::bind(dsp::Isa::kCount));
+
+        const dsp::Isa best = dsp::bindBest();
+        CHECK(&dsp::kernels() == dsp::variant(best));
+        CHECK((isas >> static_cast<unsigned>(best)) == 1u);   // nothing wider is available
+#if defined(__x86_64__)
+        CHECK(isas & (1u << static_cast<unsigned>(dsp::Isa::kSse2)));
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            CHECK(dsp::variant(dsp::Isa::kAvx2) != nullptr);
+            CHECK(dsp::variant(dsp::Isa::kAvx2)->laneWidth == 8);
+        }
+#endif
+    }
+
+} // namespace
+
+int main() {
+    for (int i = 0; i < static_cast<int>(dsp::Isa::kCount); ++i) {
+        const dsp::Kernels *k = dsp::variant(static_cast<dsp::Isa>(i));
+        if (!k) continue;
+        std::printf("[dsp_kernels_test] %s (%d lanes)\n", dsp::isaName(k->isa), k->laneWidth);
+        testFir(*k);
+        testMixAndConvert(*k);
+        testUnison(*k);
+        testGrain(*k);
+    }
+    testBinding();
+    return testsupport::finish("dsp_kernels_test");
+}
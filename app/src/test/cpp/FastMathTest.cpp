@@ -0,0 +1,146 @@
+// Accuracy tests for FastMath.h: scalar and block (SIMD) paths against double-precision libm.
+
+#include "FastMath.h"
+#include "TestSupport.h"
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace {
+
+    using BlockFn = void (*)(const float *, float *, int);
+
+    struct Sweep {
+        double maxAbs = 0.0;
+        double maxRel = 0.0;
+    };
+
+    // Evaluates both the scalar function and the block function over [lo, hi].
+    // An odd count makes sure the scalar tail after the vector loop is covered too.
+    Sweep sweep(float lo, float hi, float (*scalar)(float), BlockFn block,
+                const std::function<double(double)> &reference) {
+        constexpr int kCount = 200003;
+        std::vector<float> in(kCount), out(kCount);
+        for (int i = 0; i < kCount; ++i) {
+            in[i] = lo + (hi - lo) * static_cast<float>(i) / static_cast<float>(kCount - 1);
+        }
+        block(in.data(), out.data(), kCount);
+
+        Sweep s;
+        for (int i = 0; i < kCount; ++i) {
+            const double ref = reference(static_cast<double>(in[i]));
+            for (const float got : {scalar(in[i]), out[i]}) {
+                const double err = std::fabs(static_cast<double>(got) - ref);
+                s.maxAbs = std::max(s.maxAbs, err);
+                if (std::fabs(ref) > 1e-30) s.maxRel = std::max(s.maxRel, err / std::fabs(ref));
+            }
+        }
+        return s;
+    }
+
+    void testExp2() {
+        const Sweep s = sweep(-60.0f, 60.0f, fastmath::exp2, fastmath::exp2Block,
+                              [](double x) { return std::exp2(x); });
+        CHECK(s.maxRel < 1e-6);
+        CHECK_NEAR(fastmath::exp2(0.0f), 1.0, 1e-6);
+        CHECK_NEAR(fastmath::exp2(-1.0f), 0.5, 1e-7);
+        CHECK(std::isfinite(fastmath::exp2(1000.0f)));
+        CHECK(fastmath::exp2(-1000.0f) >= 0.0f);
+    }
+
+    void testExp() {
+        const Sweep s = sweep(-20.0f, 20.0f, fastmath::exp, fastmath::expBlock,
+                              [](double x) { return std::exp(x); });
+        CHECK(s.maxRel < 2e-6);
+    }
+
+    void testLog2() {
+        const Sweep s = sweep(1e-4f, 1000.0f, fastmath::log2, fastmath::log2Block,
+                              [](double x) { return std::log2(x); });
+        CHECK(s.maxAbs < 1e-6);
+        CHECK_NEAR(fastmath::log2(1.0f), 0.0, 1e-6);
+        CHECK_NEAR(fastmath::log2(8.0f), 3.0, 1e-6);
+        CHECK(std::isfinite(fastmath::log2(0.0f)));
+        CHECK(std::isfinite(fastmath::log2(-1.0f)));
+    }
+
+    void testTanh() {
+        const Sweep s = sweep(-12.0f, 12.0f, fastmath::tanh, fastmath::tanhBlock,
+                              [](double x) { return std::tanh(x); });
+        CHECK(s.maxAbs < 1e-6);
+        CHECK_NEAR(fastmath::tanh(1e-4f), 1e-4, 1e-10);
+    }
+
+    void testSinCos() {
+        const float range = 64.0f * fastmath::kPi;
+        const Sweep s = sweep(-range, range, fastmath::sin, fastmath::sinBlock,
+                              [](double x) { return std::sin(x); });
+        CHECK(s.maxAbs < 2e-6);
+        const Sweep c = sweep(-range, range, fastmath::cos, fastmath::cosBlock,
+                              [](double x) { return std::cos(x); });
+        CHECK(c.maxAbs < 2e-6);
+    }
+
+    // Beyond 2^23 every float is integral; beyond 2^31 it does not fit the int32 conversion.
+    void testFloorLargeMagnitude() {
+        using fastmath::lane::floorv;
+        CHECK(floorv(2.5f) == 2.0f && floorv(-2.5f) == -3.0f && floorv(-0.0f) == 0.0f);
+        CHECK(floorv(8388609.0f) == 8388609.0f && floorv(-8388609.0f) == -8388609.0f);
+        CHECK(floorv(3e9f) == 3e9f && floorv(-3e9f) == -3e9f && floorv(1e30f) == 1e30f);
+        CHECK(std::isnan(floorv(std::nanf(""))));
+        CHECK(std::isfinite(fastmath::sin(3e9f)) && std::isfinite(fastmath::sin(-3e9f)));
+    }
+
+    void testDecibels() {
+        const Sweep g = sweep(-120.0f, 24.0f, fastmath::dbToGain, fastmath::dbToGainBlock,
+                              [](double db) { return std::pow(10.0, db / 20.0); });
+        CHECK(g.maxRel < 2e-6);
+        const Sweep d = sweep(1e-5f, 16.0f, fastmath::gainToDb, fastmath::gainToDbBlock,
+                              [](double gain) { return 20.0 * std::log10(gain); });
+        CHECK(d.maxAbs < 1e-5);
+    }
+
+    void testMidiConversions() {
+        CHECK_NEAR(fastmath::noteToHz(69.0f), 440.0, 1e-3);
+        CHECK_NEAR(fastmath::noteToHz(60.0f), 261.6255653, 1e-3);
+        CHECK_NEAR(fastmath::semitonesToRatio(12.0f), 2.0, 1e-6);
+        CHECK_NEAR(fastmath::semitonesToRatio(-7.0f), std::pow(2.0, -7.0 / 12.0), 1e-6);
+        CHECK_NEAR(fastmath::bend14ToSemitones(8192, 2.0f), 0.0, 0.0);
+        CHECK_NEAR(fastmath::bend14ToSemitones(0, 48.0f), -48.0, 1e-6);
+        CHECK_NEAR(fastmath::velocityToGain(127), 1.0, 1e-6);
+        CHECK_NEAR(fastmath::velocityToGain(1, -40.0f), 0.01, 1e-7);
+        CHECK(fastmath::velocityToGain(0) == 0.0f);
+
+        float st[5] = {-12.0f, -1.0f, 0.0f, 7.0f, 24.0f};
+        fastmath::semitonesToRatioBlock(st, st, 5);
+        CHECK_NEAR(st[0], 0.5, 1e-6);
+        CHECK_NEAR(st[2], 1.0, 1e-6);
+        CHECK_NEAR(st[4], 4.0, 4e-6);
+    }
+
+} // namespace
+
+int main() {
+#if defined(REQUIRE_AVX2)
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+        std::printf("[FastMathTest] AVX2/FMA not available, skipping\n");
+        return 77;
+    }
+#endif
+#if defined(REQUIRE_AVX512)
+    if (!__builtin_cpu_supports("avx512f")) {
+        std::printf("[FastMathTest] AVX-512F not available, skipping\n");
+        return 77;
+    }
+#endif
+    testExp2();
+    testExp();
+    testLog2();
+    testTanh();
+    testSinCos();
+    testFloorLargeMagnitude();
+    testDecibels();
+    testMidiConversions();
+    return testsupport::finish("FastMathTest");
+}
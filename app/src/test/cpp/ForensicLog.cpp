@@ -0,0 +1,440 @@
+#include "ForensicLog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace forensic {
+
+    namespace {
+
+        constexpr size_t kReadChunk = 1 << 20;
+        constexpr int kMaxFields = 8;
+
+        struct Field {
+            const char *p;
+            size_t n;
+            bool is(const char *s) const { return std::strlen(s) == n && std::memcmp(p, s, n) == 0; }
+        };
+
+        // Splits [p, end) on ',' into at most kMaxFields fields.
+        int split(const char *p, const char *end, Field *fields) {
+            int count = 0;
+            while (count < kMaxFields) {
+                const char *comma = static_cast<const char *>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+                const char *stop = comma ? comma : end;
+                fields[count++] = {p, static_cast<size_t>(stop - p)};
+                if (!comma) break;
+                p = comma + 1;
+            }
+            return count;
+        }
+
+        bool toInt(const Field &f, int &out) {
+            size_t i = 0;
+            bool negative = false;
+            if (i < f.n && (f.p[i] == '-' || f.p[i] == '+')) negative = f.p[i++] == '-';
+            if (i == f.n) return false;
+            long value = 0;
+            for (; i < f.n; ++i) {
+                if (f.p[i] < '0' || f.p[i] > '9') return false;
+                value = value * 10 + (f.p[i] - '0');
+            }
+            out = static_cast<int>(negative ? -value : value);
+            return true;
+        }
+
+        TouchAction touchAction(const Field &f) {
+            if (f.is("MOVE")) return kMove;
+            if (f.is("DOWN")) return kDown;
+            if (f.is("PTR_DOWN")) return kPointerDown;
+            if (f.is("PTR_UP")) return kPointerUp;
+            if (f.is("UP")) return kUp;
+            if (f.is("CANCEL")) return kCancel;
+            return kOtherAction;
+        }
+
+        TxKind txKind(const Field &f) {
+            if (f.is("NOTE_ON")) return kTxNoteOn;
+            if (f.is("NOTE_OFF")) return kTxNoteOff;
+            if (f.is("PITCH_BEND")) return kTxPitchBend;
+            if (f.is("CH_AFTERTOUCH")) return kTxPressure;
+            if (f.is("CC")) return kTxControl;
+            return kTxOther;
+        }
+
+    } // namespace
+
+    bool parseLine(const char *line, size_t length, Record &out) {
+        const char *end = line + length;
+        while (end > line && (end[-1] == '\n' || end[-1] == '\r')) --end;
+        const char *comma = static_cast<const char *>(std::memchr(line, ',', static_cast<size_t>(end - line)));
+        if (!comma) return false;
+
+        // Timestamp: the digit run right before the first comma (skips logcat prefix and BOM).
+        const char *digits = comma;
+        while (digits > line && digits[-1] >= '0' && digits[-1] <= '9') --digits;
+        if (digits == comma || comma - digits > 18) return false;
+        int64_t t = 0;
+        for (const char *p = digits; p < comma; ++p) t = t * 10 + (*p - '0');
+
+        Field f[kMaxFields];
+        const int n = split(comma + 1, end, f);
+        Record r;
+        r.tMs = t;
+        const Field &kind = f[0];
+        if (kind.is("TOUCH_RAW")) {
+            int index = 0, count = 0;
+            if (n < 4 || !toInt(f[2], index) || !toInt(f[3], count)) return false;
+            r.kind = kTouchRaw;
+            r.sub = touchAction(f[1]);
+            r.pointerIndex = static_cast<int16_t>(index);
+            r.pointerCount = static_cast<int16_t>(count);
+        } else if (kind.is("HARMONY")) {
+            r.kind = kHarmony;
+        } else if (kind.is("MIDI_COMMIT")) {
+            r.kind = kMidiDecision;
+        } else if (kind.is("NOTE_TRANS")) {
+            int slot = 0;
+            if (n < 5 || !toInt(f[1], slot) || !toInt(f[2], r.channel) || !toInt(f[3], r.a) || !toInt(f[4], r.b)) {
+                return false;
+            }
+            r.kind = kNoteTrans;
+            r.pointerIndex = static_cast<int16_t>(slot);
+        } else if (kind.is("MIDI_TX")) {
+            if (n < 4 || !toInt(f[2], r.channel) || !toInt(f[3], r.a)) return false;
+            if (n >= 5 && !toInt(f[4], r.b)) return false;
+            r.kind = kMidiTx;
+            r.sub = txKind(f[1]);
+        } else if (kind.is("MIDI_ALL_OFF")) {
+            r.kind = kAllNotesOff;
+        } else if (kind.is("CASCADE")) {
+            if (n < 3) return false;
+            r.kind = kCascade;
+            r.flagA = f[1].is("true");
+            r.flagB = f[2].is("true");
+        } else if (kind.is("SLOT_CH")) {
+            int slot = 0;
+            if (n < 4 || !toInt(f[1], slot) || !toInt(f[2], r.channel)) return false;
+            r.kind = kSlotChannel;
+            r.pointerIndex = static_cast<int16_t>(slot);
+            r.flagA = f[3].is("true");
+        } else {
+            return false;
+        }
+        out = r;
+        return true;
+    }
+
+    const char *kindName(Kind kind) {
+        static const char *const kNames[kKindCount] = {
+                "unknown", "TOUCH_RAW", "HARMONY", "MIDI_COMMIT", "NOTE_TRANS", "MIDI_TX", "MIDI_ALL_OFF",
+                "CASCADE", "SLOT_CH",
+        };
+        return kind < kKindCount ? kNames[kind] : "unknown";
+    }
+
+    // ---- LineReader ----
+
+    LineReader::LineReader(const std::string &path) : buffer_(kReadChunk) {
+        if (path == "-") {
+            file_ = stdin;
+        } else {
+            file_ = std::fopen(path.c_str(), "rb");
+            ownsFile_ = true;
+        }
+    }
+
+    LineReader::~LineReader() {
+        if (file_ && ownsFile_) std::fclose(file_);
+    }
+
+    bool LineReader::readLine(const char *&line, size_t &length) {
+        for (;;) {
+            const char *start = buffer_.data() + begin_;
+            const char *nl = static_cast<const char *>(std::memchr(start, '\n', end_ - begin_));
+            if (nl) {
+                line = start;
+                length = static_cast<size_t>(nl - start) + 1;
+                begin_ += length;
+                return true;
+            }
+            if (eof_) {
+                if (begin_ == end_) return false;
+                line = start;
+                length = end_ - begin_;
+                begin_ = end_;
+                return true;
+            }
+            // Compact, grow for overlong lines, refill.
+            std::memmove(buffer_.data(), start, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+            if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+            const size_t got = std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+            bytes_ += got;
+            end_ += got;
+            if (got == 0) eof_ = true;
+        }
+    }
+
+    bool LineReader::next(Record &out) {
+        if (!file_) return false;
+        const char *line;
+        size_t length;
+        while (readLine(line, length)) {
+            ++lines_;
+            if (parseLine(line, length, out)) return true;
+        }
+        return false;
+    }
+
+    // ---- MergedReader ----
+
+    MergedReader::MergedReader(const std::vector<std::string> &paths) {
+        for (const std::string &path : paths) {
+            auto *reader = new LineReader(path);
+            readers_.push_back(reader);
+            if (!reader->ok()) {
+                ok_ = false;
+                continue;
+            }
+            Source s{reader, {}, false};
+            s.valid = reader->next(s.head);
+            sources_.push_back(s);
+        }
+    }
+
+    MergedReader::~MergedReader() {
+        for (LineReader *reader : readers_) delete reader;
+    }
+
+    bool MergedReader::next(Record &out) {
+        Source *best = nullptr;
+        for (Source &s : sources_) {
+            if (s.valid && (!best || s.head.tMs < best->head.tMs)) best = &s;
+        }
+        if (!best) return false;
+        out = best->head;
+        best->valid = best->reader->next(best->head);
+        return true;
+    }
+
+    uint64_t MergedReader::lines() const {
+        uint64_t total = 0;
+        for (const LineReader *reader : readers_) total += reader->lines();
+        return total;
+    }
+
+    uint64_t MergedReader::bytes() const {
+        uint64_t total = 0;
+        for (const LineReader *reader : readers_) total += reader->bytes();
+        return total;
+    }
+
+    // ---- Statistics ----
+
+    Percentiles summarize(std::vector<float> &samples) {
+        Percentiles p;
+        p.count = samples.size();
+        if (samples.empty()) return p;
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (float v : samples) sum += v;
+        p.mean = sum / static_cast<double>(samples.size());
+        // Nearest rank.
+        auto rank = [&](double q) {
+            size_t i = static_cast<size_t>(q * static_cast<double>(samples.size()) + 0.999999);
+            return static_cast<double>(samples[std::min(samples.size(), std::max<size_t>(i, 1)) - 1]);
+        };
+        p.p50 = rank(0.50);
+        p.p90 = rank(0.90);
+        p.p99 = rank(0.99);
+        p.max = samples.back();
+        return p;
+    }
+
+    // ---- LatencyAnalyzer ----
+
+    const char *LatencyAnalyzer::stageName(Stage stage) {
+        static const char *const kNames[kStageCount] = {
+                "touch -> note", "last finger -> note", "release -> off", "touch -> decision",
+                "decision -> transition", "decision -> MIDI_TX", "touch -> MIDI_TX", "MIDI_TX burst span",
+                "cascade window",
+        };
+        return stage < kStageCount ? kNames[stage] : "unknown";
+    }
+
+    void LatencyAnalyzer::feed(const Record &r) {
+        ++counters_.records[r.kind < kKindCount ? r.kind : kUnknown];
+        reorder_.push({r, seq_++});
+        if (r.tMs > newestT_) newestT_ = r.tMs;
+        while (!reorder_.empty() && reorder_.top().record.tMs < newestT_ - config_.reorderMs) {
+            process(reorder_.top().record);
+            reorder_.pop();
+        }
+    }
+
+    void LatencyAnalyzer::process(const Record &r) {
+        if (r.tMs < lastT_) ++counters_.outOfOrder;
+        else lastT_ = r.tMs;
+        expire(r.tMs);
+
+        switch (r.kind) {
+            case kTouchRaw: onTouch(r); break;
+            case kHarmony:
+            case kMidiDecision: onDecision(r); break;
+            case kNoteTrans:
+                if (transitionPending_) {
+                    add(kDecisionToTransition, r.tMs - decisionT_);
+                    transitionPending_ = false;
+                }
+                break;
+            case kMidiTx: onTx(r); break;
+            case kAllNotesOff: onAllOff(r); break;
+            case kCascade: onCascade(r); break;
+            default: break;
+        }
+    }
+
+    void LatencyAnalyzer::finish() {
+        while (!reorder_.empty()) {
+            process(reorder_.top().record);
+            reorder_.pop();
+        }
+        expire(INT64_MAX);
+    }
+
+    void LatencyAnalyzer::expire(int64_t now) {
+        const int64_t window = config_.joinWindowMs;
+        if (landing_.open && now - landing_.lastT > window) {
+            ++counters_.landingsUnmatched;
+            counters_.landingSuppressed += landing_.changes - std::min(landing_.decisions, landing_.changes);
+            landing_.open = false;
+        }
+        if (release_.open && now - release_.lastT > window) {
+            ++counters_.releasesUnmatched;
+            counters_.releaseSuppressed += release_.changes - std::min(release_.decisions, release_.changes);
+            release_.open = false;
+        }
+        if (decisionPending_ && now - decisionT_ > window) {
+            ++counters_.decisionsOrphaned;
+            decisionPending_ = false;
+        }
+        if (transitionPending_ && now - decisionT_ > window) transitionPending_ = false;
+        if (burstOpen_ && now - burstLastT_ > config_.burstGapMs) endBurst();
+    }
+
+    void LatencyAnalyzer::onTouch(const Record &r) {
+        lastTouchT_ = r.tMs;
+        // One Android event is logged as one line per pointer.
+        if (r.tMs == touchKeyT_ && r.sub == touchKeyAction_ && r.pointerCount == touchKeyCount_) return;
+        touchKeyT_ = r.tMs;
+        touchKeyAction_ = r.sub;
+        touchKeyCount_ = r.pointerCount;
+        ++counters_.touchEvents;
+
+        if (r.sub == kDown || r.sub == kPointerDown) {
+            if (release_.open) {
+                // Re-landing before the release resolved: the release never sounded.
+                ++counters_.releasesUnmatched;
+                counters_.releaseSuppressed += release_.changes - std::min(release_.decisions, release_.changes);
+                release_.open = false;
+            }
+            if (!landing_.open) {
+                landing_ = {true, r.tMs, r.tMs, 0, 0};
+                ++counters_.landings;
+            }
+            landing_.lastT = r.tMs;
+            ++landing_.changes;
+            ++counters_.landingChanges;
+        } else if (r.sub == kPointerUp || r.sub == kUp || r.sub == kCancel) {
+            if (landing_.open) {
+                ++counters_.landingsUnmatched;
+                counters_.landingSuppressed += landing_.changes - std::min(landing_.decisions, landing_.changes);
+                landing_.open = false;
+            }
+            if (!release_.open) {
+                release_ = {true, r.tMs, r.tMs, 0, 0};
+                ++counters_.releases;
+            }
+            release_.lastT = r.tMs;
+            ++release_.changes;
+            ++counters_.releaseChanges;
+        }
+    }
+
+    void LatencyAnalyzer::onDecision(const Record &r) {
+        // HARMONY and MIDI_COMMIT for the same change share a timestamp.
+        if (decisionPending_ && r.tMs == decisionT_) return;
+        if (decisionPending_) ++counters_.decisionsOrphaned;   // superseded before any note
+        ++counters_.decisions;
+        decisionPending_ = true;
+        transitionPending_ = true;
+        decisionT_ = r.tMs;
+        decisionTouchT_ = INT64_MIN;
+        if (lastTouchT_ != INT64_MIN && r.tMs - lastTouchT_ <= config_.joinWindowMs) {
+            decisionTouchT_ = lastTouchT_;
+            add(kTouchToDecision, r.tMs - lastTouchT_);
+        }
+        if (landing_.open) ++landing_.decisions;
+        if (release_.open) ++release_.decisions;
+        if (cascadeOpen_) ++counters_.cascadeLeaks;
+    }
+
+    void LatencyAnalyzer::onTx(const Record &r) {
+        if (r.sub != kTxNoteOn && r.sub != kTxNoteOff) return;
+        if (!burstOpen_) {
+            burstOpen_ = true;
+            burstFirstT_ = r.tMs;
+            burstSize_ = 0;
+        }
+        burstLastT_ = r.tMs;
+        ++burstSize_;
+
+        if (decisionPending_) {
+            add(kDecisionToTx, r.tMs - decisionT_);
+            if (decisionTouchT_ != INT64_MIN) add(kTouchToTx, r.tMs - decisionTouchT_);
+            decisionPending_ = false;
+        }
+        if (r.sub == kTxNoteOn && landing_.open) closeLanding(r.tMs);
+        if (r.sub == kTxNoteOff && release_.open) closeRelease(r.tMs);
+    }
+
+    void LatencyAnalyzer::onAllOff(const Record &r) {
+        if (release_.open) closeRelease(r.tMs);
+    }
+
+    void LatencyAnalyzer::onCascade(const Record &r) {
+        const bool active = r.flagA || r.flagB;
+        if (active && !cascadeOpen_) {
+            cascadeOpen_ = true;
+            cascadeT_ = r.tMs;
+            ++counters_.cascades;
+        } else if (!active && cascadeOpen_) {
+            cascadeOpen_ = false;
+            add(kCascadeWindow, r.tMs - cascadeT_);
+        }
+    }
+
+    void LatencyAnalyzer::closeLanding(int64_t noteT) {
+        add(kTouchToNote, noteT - landing_.firstT);
+        add(kLastFingerToNote, noteT - landing_.lastT);
+        counters_.landingSuppressed += landing_.changes - std::min(landing_.decisions, landing_.changes);
+        landing_.open = false;
+    }
+
+    void LatencyAnalyzer::closeRelease(int64_t offT) {
+        add(kReleaseToOff, offT - release_.lastT);
+        counters_.releaseSuppressed += release_.changes - std::min(release_.decisions, release_.changes);
+        release_.open = false;
+    }
+
+    void LatencyAnalyzer::endBurst() {
+        ++counters_.bursts;
+        counters_.burstMessages += burstSize_;
+        add(kTxBurstSpan, burstLastT_ - burstFirstT_);
+        burstOpen_ = false;
+    }
+
+} // namespace forensic
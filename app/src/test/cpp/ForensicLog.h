@@ -0,0 +1,225 @@
+#pragma once
+
+// Streaming parser and touch-to-note latency analysis for the forensic logs
+// (session_log.csv, logcat FORENSIC_DATA / FORENSIC_MIDI / BH_INVARIANT).
+//
+// Records are "<tMs>,<KIND>,..." lines; a logcat prefix ("... D FORENSIC_DATA: ") and a BOM
+// are skipped. All stamps are SystemClock.uptimeMillis, so separate logcat captures of the
+// different tags can be merged by time (see MergedReader).
+
+#include <cstdint>
+#include <cstdio>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace forensic {
+
+    enum Kind : uint8_t {
+        kUnknown = 0,
+        kTouchRaw,       // action, pointerIndex, pointerCount, x, y, ...
+        kHarmony,        // decision: sector=, pc=, fc=
+        kMidiDecision,   // MIDI_COMMIT (older builds): decision with the same meaning as HARMONY
+        kNoteTrans,      // slot, channel, oldNote, newNote, reason
+        kMidiTx,         // kind, midiCh, a[, b]
+        kAllNotesOff,    // reason
+        kCascade,        // releaseActive, landingActive
+        kSlotChannel,    // slot, channel, active
+        kKindCount
+    };
+
+    enum TouchAction : uint8_t { kDown, kPointerDown, kMove, kPointerUp, kUp, kCancel, kOtherAction };
+    enum TxKind : uint8_t { kTxNoteOn, kTxNoteOff, kTxPitchBend, kTxPressure, kTxControl, kTxOther };
+
+    struct Record {
+        int64_t tMs = 0;
+        Kind kind = kUnknown;
+        uint8_t sub = 0;              // TouchAction or TxKind
+        int16_t pointerIndex = 0;
+        int16_t pointerCount = 0;
+        int channel = 0;              // MIDI_TX: 1-based MIDI channel; NOTE_TRANS: channel
+        int a = 0, b = 0;             // MIDI_TX data bytes; NOTE_TRANS old/new note
+        bool flagA = false, flagB = false;   // CASCADE release/landing
+    };
+
+    // Parses one line (no allocation). False for lines that are not forensic records.
+    bool parseLine(const char *line, size_t length, Record &out);
+    const char *kindName(Kind kind);
+
+    // Buffered line reader over one file ("-" = stdin).
+    class LineReader {
+    public:
+        explicit LineReader(const std::string &path);
+        ~LineReader();
+        LineReader(const LineReader &) = delete;
+        LineReader &operator=(const LineReader &) = delete;
+
+        bool ok() const { return file_ != nullptr; }
+        // Next parsed record; false at end of file. Non-record lines are counted and skipped.
+        bool next(Record &out);
+        uint64_t lines() const { return lines_; }
+        uint64_t bytes() const { return bytes_; }
+
+    private:
+        bool readLine(const char *&line, size_t &length);
+
+        std::FILE *file_ = nullptr;
+        bool ownsFile_ = false;
+        std::vector<char> buffer_;
+        size_t begin_ = 0, end_ = 0;
+        bool eof_ = false;
+        uint64_t lines_ = 0;
+        uint64_t bytes_ = 0;
+    };
+
+    // K-way merge by timestamp of several time-ordered logs (one per logcat tag, for instance).
+    class MergedReader {
+    public:
+        explicit MergedReader(const std::vector<std::string> &paths);
+        ~MergedReader();
+        MergedReader(const MergedReader &) = delete;
+        MergedReader &operator=(const MergedReader &) = delete;
+
+        bool ok() const { return ok_; }
+        bool next(Record &out);
+        uint64_t lines() const;
+        uint64_t bytes() const;
+
+    private:
+        struct Source {
+            LineReader *reader;
+            Record head;
+            bool valid;
+        };
+        std::vector<LineReader *> readers_;
+        std::vector<Source> sources_;
+        bool ok_ = true;
+    };
+
+    struct Percentiles {
+        size_t count = 0;
+        double mean = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+    };
+    // Sorts samples in place.
+    Percentiles summarize(std::vector<float> &samples);
+
+    struct AnalyzerConfig {
+        int joinWindowMs = 250;    // a touch/decision with no outcome within this is unmatched
+        int burstGapMs = 5;        // note TX further apart than this start a new burst
+        int reorderMs = 50;        // TOUCH_RAW is stamped with the event time but logged after
+                                   // the decision it caused; records are re-sorted within this
+    };
+
+    // Joins touch frames to decisions, note transitions and MIDI_TX in one pass.
+    //
+    // Landing:  first DOWN/PTR_DOWN of a run -> first note TX (touchToNote); the last finger of
+    //           the run -> first note TX (lastFingerToNote). Finger-count changes in the run that
+    //           produced no decision are counted as suppressed by the landing cascade.
+    // Release:  last PTR_UP/UP of a run -> first NOTE_OFF or MIDI_ALL_OFF.
+    // Decision: HARMONY (or MIDI_COMMIT) -> previous touch frame (touchToDecision),
+    //           first NOTE_TRANS, first note TX, and the span of the resulting TX burst.
+    // CASCADE records (BH_INVARIANT) give window durations and decisions leaking through them.
+    // Input is re-sorted by stamp within reorderMs (touch before anything else on a tie).
+    class LatencyAnalyzer {
+    public:
+        enum Stage {
+            kTouchToNote,
+            kLastFingerToNote,
+            kReleaseToOff,
+            kTouchToDecision,
+            kDecisionToTransition,
+            kDecisionToTx,
+            kTouchToTx,
+            kTxBurstSpan,
+            kCascadeWindow,
+            kStageCount
+        };
+
+        struct Counters {
+            uint64_t records[kKindCount] = {};
+            uint64_t touchEvents = 0;          // distinct Android events (TOUCH_RAW lines grouped)
+            uint64_t landings = 0;
+            uint64_t landingChanges = 0;       // finger-count increases inside landings
+            uint64_t landingSuppressed = 0;    // ... that did not produce a decision
+            uint64_t landingsUnmatched = 0;    // no note within the join window
+            uint64_t releases = 0;
+            uint64_t releaseChanges = 0;
+            uint64_t releaseSuppressed = 0;
+            uint64_t releasesUnmatched = 0;
+            uint64_t decisions = 0;
+            uint64_t decisionsOrphaned = 0;    // no note TX within the join window
+            uint64_t bursts = 0;
+            uint64_t burstMessages = 0;
+            uint64_t cascades = 0;
+            uint64_t cascadeLeaks = 0;         // decisions while a cascade window was open
+            uint64_t outOfOrder = 0;           // records later than the reorder window
+        };
+
+        explicit LatencyAnalyzer(AnalyzerConfig config = {}) : config_(config) {}
+
+        void feed(const Record &r);
+        // Closes whatever is still open at end of input.
+        void finish();
+
+        const Counters &counters() const { return counters_; }
+        std::vector<float> &samples(Stage stage) { return samples_[stage]; }
+        static const char *stageName(Stage stage);
+
+    private:
+        struct Run {
+            bool open = false;
+            int64_t firstT = 0, lastT = 0;
+            uint32_t changes = 0, decisions = 0;
+        };
+
+        struct Pending {
+            Record record;
+            uint64_t seq;
+            bool operator>(const Pending &o) const {
+                if (record.tMs != o.record.tMs) return record.tMs > o.record.tMs;
+                const bool touch = record.kind == kTouchRaw, otherTouch = o.record.kind == kTouchRaw;
+                if (touch != otherTouch) return otherTouch;
+                return seq > o.seq;
+            }
+        };
+
+        void process(const Record &r);
+        void onTouch(const Record &r);
+        void onDecision(const Record &r);
+        void onTx(const Record &r);
+        void onAllOff(const Record &r);
+        void onCascade(const Record &r);
+        void expire(int64_t now);
+        void closeLanding(int64_t noteT);
+        void closeRelease(int64_t offT);
+        void endBurst();
+        void add(Stage stage, int64_t ms) { samples_[stage].push_back(static_cast<float>(ms)); }
+
+        AnalyzerConfig config_;
+        Counters counters_;
+        std::vector<float> samples_[kStageCount];
+
+        std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> reorder_;
+        uint64_t seq_ = 0;
+        int64_t newestT_ = INT64_MIN;
+        int64_t lastT_ = INT64_MIN;
+        int64_t lastTouchT_ = INT64_MIN;
+        int64_t touchKeyT_ = INT64_MIN;
+        uint8_t touchKeyAction_ = kOtherAction;
+        int16_t touchKeyCount_ = -1;
+
+        Run landing_, release_;
+
+        bool decisionPending_ = false;     // waiting for its first note TX
+        bool transitionPending_ = false;   // waiting for its first NOTE_TRANS
+        int64_t decisionT_ = 0, decisionTouchT_ = INT64_MIN;
+
+        bool burstOpen_ = false;
+        int64_t burstFirstT_ = 0, burstLastT_ = 0;
+        uint32_t burstSize_ = 0;
+
+        bool cascadeOpen_ = false;
+        int64_t cascadeT_ = 0;
+    };
+
+} // namespace forensic
@@ -0,0 +1,184 @@
+// Forensic log parsing and the touch -> decision -> MIDI_TX join.
+
+#include "ForensicLog.h"
+#include "TestSupport.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using forensic::LatencyAnalyzer;
+
+    bool parse(const char *line, forensic::Record &r) {
+        return forensic::parseLine(line, std::strlen(line), r);
+    }
+
+    void feedLines(LatencyAnalyzer &analyzer, const std::vector<const char *> &lines) {
+        for (const char *line : lines) {
+            forensic::Record r;
+            if (parse(line, r)) analyzer.feed(r);
+        }
+        analyzer.finish();
+    }
+
+    void testParse() {
+        forensic::Record r;
+        CHECK(parse("\xEF\xBB\xBF" "99517165,TOUCH_RAW,PTR_DOWN,2,3,452.46,987.76,0.41,0.46,1.0,0.01,-1\n", r));
+        CHECK(r.tMs == 99517165 && r.kind == forensic::kTouchRaw && r.sub == forensic::kPointerDown);
+        CHECK(r.pointerIndex == 2 && r.pointerCount == 3);
+
+        CHECK(parse("10-17 05:14:00.123  4242  4242 D FORENSIC_MIDI: 99517217,MIDI_TX,NOTE_ON,2,64,1", r));
+        CHECK(r.kind == forensic::kMidiTx && r.sub == forensic::kTxNoteOn);
+        CHECK(r.channel == 2 && r.a == 64 && r.b == 1);
+        CHECK(parse("99517217,MIDI_TX,CH_AFTERTOUCH,3,90\r\n", r));
+        CHECK(r.sub == forensic::kTxPressure && r.a == 90);
+
+        CHECK(parse("D/BH_INVARIANT( 4242): 1200,NOTE_TRANS,1,3,60,64,harmony;landing", r));
+        CHECK(r.kind == forensic::kNoteTrans && r.pointerIndex == 1 && r.channel == 3 && r.a == 60 && r.b == 64);
+        CHECK(parse("1300,CASCADE,false,true", r));
+        CHECK(r.kind == forensic::kCascade && !r.flagA && r.flagB);
+        CHECK(parse("1400,HARMONY,sector=3,pc=7,fc=4", r) && r.kind == forensic::kHarmony);
+        CHECK(parse("99519402,MIDI_ALL_OFF,FRAME_LATCH_RELEASE:ACTION_UP,,", r) && r.kind == forensic::kAllNotesOff);
+
+        CHECK(!parse("--------- beginning of main", r));
+        CHECK(!parse("1500,LAND,f=4,triad=1,sev=0", r));
+        CHECK(!parse("1500,MIDI_TX,NOTE_ON,x,64,1", r));
+        CHECK(!parse("", r));
+    }
+
+    void testLandingAndRelease() {
+        LatencyAnalyzer analyzer;
+        feedLines(analyzer, {
+                "1000,TOUCH_RAW,DOWN,0,1,1,1,0,0,1,0,-1",
+                "1007,TOUCH_RAW,PTR_DOWN,0,2,1,1,0,0,1,0,-1",
+                "1007,TOUCH_RAW,PTR_DOWN,1,2,1,1,0,0,1,0,-1",
+                "1007,TOUCH_RAW,PTR_DOWN,0,3,1,1,0,0,1,0,-1",
+                "1007,TOUCH_RAW,PTR_DOWN,1,3,1,1,0,0,1,0,-1",
+                "1007,TOUCH_RAW,PTR_DOWN,2,3,1,1,0,0,1,0,-1",
+                "1039,TOUCH_RAW,MOVE,0,3,1,1,0,0,1,0,-1",
+                "1051,MIDI_COMMIT,4,2,3",
+                "1053,NOTE_TRANS,0,2,-1,64,landing",
+                "1052,MIDI_TX,NOTE_ON,2,64,1",   // logged out of order (separate tags): re-sorted
+                "1052,MIDI_TX,NOTE_ON,3,68,1",
+                "1053,MIDI_TX,NOTE_ON,4,71,1",
+                "2000,TOUCH_RAW,PTR_UP,0,3,1,1,0,0,1,0,-1",
+                "2000,TOUCH_RAW,PTR_UP,1,2,1,1,0,0,1,0,-1",
+                "2008,TOUCH_RAW,UP,0,1,1,1,0,0,1,0,-1",
+                "2014,MIDI_ALL_OFF,FRAME_LATCH_RELEASE:ACTION_UP,,",
+                "2014,MIDI_TX,NOTE_OFF,2,64,0",
+        });
+        const LatencyAnalyzer::Counters &c = analyzer.counters();
+        CHECK(c.touchEvents == 7);
+        CHECK(c.outOfOrder == 0);
+        CHECK(c.landings == 1 && c.landingChanges == 3 && c.landingSuppressed == 2 && c.landingsUnmatched == 0);
+        CHECK(c.releases == 1 && c.releaseChanges == 3 && c.releaseSuppressed == 3 && c.releasesUnmatched == 0);
+        CHECK(c.decisions == 1 && c.decisionsOrphaned == 0);
+        CHECK(c.bursts == 2 && c.burstMessages == 4);
+
+        auto one = [&](LatencyAnalyzer::Stage stage, float expected) {
+            const std::vector<float> &s = analyzer.samples(stage);
+            CHECK(s.size() == 1);
+            if (s.size() == 1) CHECK_NEAR(s[0], expected, 0.0);
+        };
+        one(LatencyAnalyzer::kTouchToNote, 52);
+        one(LatencyAnalyzer::kLastFingerToNote, 45);
+        one(LatencyAnalyzer::kTouchToDecision, 12);
+        one(LatencyAnalyzer::kDecisionToTransition, 2);
+        one(LatencyAnalyzer::kDecisionToTx, 1);
+        one(LatencyAnalyzer::kTouchToTx, 13);
+        one(LatencyAnalyzer::kReleaseToOff, 6);
+    }
+
+    // Touch frames are stamped with the event time and logged after their consequences.
+    void testReorder() {
+        LatencyAnalyzer analyzer(forensic::AnalyzerConfig{250, 5, 20});
+        feedLines(analyzer, {
+                "100,TOUCH_RAW,MOVE,0,2,1,1,0,0,1,0,-1",
+                "118,HARMONY,sector=1,pc=0,fc=2",
+                "118,MIDI_TX,NOTE_ON,1,60,1",
+                "117,TOUCH_RAW,MOVE,0,2,1,1,0,0,1,0,-1",   // the frame that caused it
+                "118,TOUCH_RAW,MOVE,1,2,1,1,0,0,1,0,-1",
+                "200,MIDI_TX,NOTE_OFF,1,60,0",
+                "260,MIDI_TX,NOTE_OFF,1,61,0",
+                "150,TOUCH_RAW,MOVE,0,2,1,1,0,0,1,0,-1",   // beyond the reorder window
+        });
+        CHECK(analyzer.counters().outOfOrder == 1);
+        const std::vector<float> &touch = analyzer.samples(LatencyAnalyzer::kTouchToDecision);
+        CHECK(touch.size() == 1 && touch[0] == 0.0f);
+        const std::vector<float> &tx = analyzer.samples(LatencyAnalyzer::kTouchToTx);
+        CHECK(tx.size() == 1 && tx[0] == 0.0f);
+    }
+
+    void testOrphansAndCascades() {
+        LatencyAnalyzer analyzer(forensic::AnalyzerConfig{100, 5, 0});
+        feedLines(analyzer, {
+                "0,TOUCH_RAW,DOWN,0,1,1,1,0,0,1,0,-1",
+                "5,CASCADE,false,true",
+                "10,HARMONY,sector=1,pc=0,fc=1",      // leaks through the landing window
+                "10,MIDI_COMMIT,1,0,1",               // same decision, logged twice
+                "40,CASCADE,false,false",
+                "50,HARMONY,sector=2,pc=0,fc=1",      // supersedes the first before any note
+                "500,TOUCH_RAW,MOVE,0,1,1,1,0,0,1,0,-1",
+                "510,HARMONY,sector=3,pc=0,fc=1",
+                "511,MIDI_TX,NOTE_ON,1,60,1",
+                "511,MIDI_TX,PITCH_BEND,1,0,64",      // expression traffic does not join
+                "530,MIDI_TX,NOTE_ON,1,61,1",
+        });
+        const LatencyAnalyzer::Counters &c = analyzer.counters();
+        CHECK(c.decisions == 3);
+        CHECK(c.decisionsOrphaned == 2);
+        CHECK(c.cascades == 1 && c.cascadeLeaks == 1);
+        CHECK(c.landingsUnmatched == 1);   // first note arrived 500 ms after the only landing
+        CHECK(c.bursts == 2);
+        CHECK(analyzer.samples(LatencyAnalyzer::kCascadeWindow).size() == 1);
+        CHECK(analyzer.samples(LatencyAnalyzer::kDecisionToTx).size() == 1);
+    }
+
+    void testPercentilesAndMerge() {
+        std::vector<float> v;
+        for (int i = 100; i >= 1; --i) v.push_back(static_cast<float>(i));
+        const forensic::Percentiles p = forensic::summarize(v);
+        CHECK(p.count == 100);
+        CHECK_NEAR(p.p50, 50, 0);
+        CHECK_NEAR(p.p90, 90, 0);
+        CHECK_NEAR(p.p99, 99, 0);
+        CHECK_NEAR(p.max, 100, 0);
+        CHECK_NEAR(p.mean, 50.5, 1e-9);
+
+        // Two per-tag captures merged back into time order.
+        const std::string a = "/tmp/forensic_log_test_a.txt", b = "/tmp/forensic_log_test_b.txt";
+        std::FILE *fa = std::fopen(a.c_str(), "wb");
+        std::FILE *fb = std::fopen(b.c_str(), "wb");
+        CHECK(fa && fb);
+        if (!fa || !fb) return;
+        std::fputs("--------- beginning of main\n10,TOUCH_RAW,DOWN,0,1\n30,HARMONY,fc=1\n", fa);
+        std::fputs("20,MIDI_TX,NOTE_ON,1,60,1\n40,MIDI_TX,NOTE_OFF,1,60,0", fb);   // no trailing newline
+        std::fclose(fa);
+        std::fclose(fb);
+        forensic::MergedReader reader({a, b});
+        CHECK(reader.ok());
+        std::vector<int64_t> times;
+        forensic::Record r;
+        while (reader.next(r)) times.push_back(r.tMs);
+        CHECK((times == std::vector<int64_t>{10, 20, 30, 40}));
+        CHECK(reader.lines() == 5);
+        std::remove(a.c_str());
+        std::remove(b.c_str());
+
+        forensic::MergedReader missing({"/nonexistent-forensic-log"});
+        CHECK(!missing.ok());
+    }
+
+} // namespace
+
+int main() {
+    testParse();
+    testLandingAndRelease();
+    testReorder();
+    testOrphansAndCascades();
+    testPercentilesAndMerge();
+    return testsupport::finish("forensic_log_test");
+}
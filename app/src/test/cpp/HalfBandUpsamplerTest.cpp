@@ -0,0 +1,118 @@
+// Half-band 2x upsampler: passband, image rejection, latency and chunking.
+
+#include "DspKernels.h"
+#include "HalfBandUpsampler.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+
+    // Stereo tone at f (cycles per low-rate sample), right channel inverted.
+    std::vector<float> tone(double f, int frames) {
+        std::vector<float> v(static_cast<size_t>(frames) * 2);
+        for (int i = 0; i < frames; ++i) {
+            const float s = static_cast<float>(0.5 * std::sin(2.0 * kPi * f * i));
+            v[2 * i] = s;
+            v[2 * i + 1] = -s;
+        }
+        return v;
+    }
+
+    // Amplitude of frequency f (cycles per sample) in channel ch of interleaved stereo.
+    double amplitude(const std::vector<float> &x, int ch, int start, int count, double f) {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < count; ++i) {
+            // Hann window; amplitude corrected for its 0.5 coherent gain.
+            const double w = 0.5 - 0.5 * std::cos(2.0 * kPi * i / count);
+            const double s = x[static_cast<size_t>(2 * (start + i) + ch)] * w;
+            re += s * std::cos(2.0 * kPi * f * i);
+            im -= s * std::sin(2.0 * kPi * f * i);
+        }
+        return 2.0 * std::sqrt(re * re + im * im) / (0.5 * count);
+    }
+
+    std::vector<float> upsample(const std::vector<float> &in, int chunk) {
+        HalfBandUpsampler up;
+        const int frames = static_cast<int>(in.size() / 2);
+        std::vector<float> out(in.size() * 2);
+        for (int i = 0; i < frames; i += chunk) {
+            const int n = std::min(chunk, frames - i);
+            up.process(in.data() + 2 * i, n, out.data() + 4 * i);
+        }
+        return out;
+    }
+
+    void testPassbandAndImages() {
+        constexpr int kFrames = 8192;
+        constexpr int kSkip = 256;
+        constexpr int kCount = 8192;
+        double worstRipple = 0.0;
+        double worstImageDb = -200.0;
+        for (const double f : {0.01, 0.1, 0.2, 0.3, 0.4, 0.42}) {
+            const auto out = upsample(tone(f, kFrames), 61);
+            // At the doubled rate the tone sits at f/2 and its image at 0.5 - f/2.
+            for (int ch = 0; ch < 2; ++ch) {
+                const double a = amplitude(out, ch, kSkip, kCount, f / 2.0);
+                const double image = amplitude(out, ch, kSkip, kCount, 0.5 - f / 2.0);
+                worstRipple = std::max(worstRipple, std::fabs(20.0 * std::log10(a / 0.5)));
+                worstImageDb = std::max(worstImageDb, 20.0 * std::log10(image / 0.5 + 1e-12));
+            }
+        }
+        CHECK(worstRipple < 0.01);
+        CHECK(worstImageDb < -80.0);
+    }
+
+    void testDcAndLatency() {
+        HalfBandUpsampler up;
+        // Taps sum to one: DC passes at unity on both phases.
+        double sum = 0.0;
+        for (int i = 0; i < HalfBandUpsampler::kTaps; ++i) sum += up.taps()[i];
+        CHECK_NEAR(sum, 1.0, 1e-6);
+
+        // An impulse comes out of the even phase after kLatencyFrames output frames.
+        std::vector<float> in(2 * 64, 0.0f);
+        in[0] = 1.0f;
+        in[1] = 1.0f;
+        std::vector<float> out(in.size() * 2);
+        up.process(in.data(), 64, out.data());
+        int peak = 0;
+        for (int i = 0; i < 128; ++i) {
+            if (std::fabs(out[2 * i]) > std::fabs(out[2 * peak])) peak = i;
+        }
+        CHECK(peak == HalfBandUpsampler::kLatencyFrames);
+        CHECK_NEAR(out[2 * peak], 1.0, 1e-6);
+        CHECK(out[2 * peak + 1] == out[2 * peak]);
+    }
+
+    void testChunkingIsTransparent() {
+        const auto in = tone(0.123, 1000);
+        const auto a = upsample(in, 1000);
+        const auto b = upsample(in, 7);
+        const auto c = upsample(in, HalfBandUpsampler::kMaxChunk + 3);
+        double maxDiff = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(a[i] - b[i])));
+            maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(a[i] - c[i])));
+        }
+        CHECK_NEAR(maxDiff, 0.0, 1e-6);
+    }
+
+} // namespace
+
+int main() {
+    // Once per DSP kernel variant this CPU can run.
+    for (int i = 0; i < static_cast<int>(dsp::Isa::kCount); ++i) {
+        if (!dsp::bind(static_cast<dsp::Isa>(i))) continue;
+        std::printf("[half_band_upsampler_test] %s\n", dsp::isaName(static_cast<dsp::Isa>(i)));
+        testPassbandAndImages();
+        testDcAndLatency();
+        testChunkingIsTransparent();
+    }
+    return testsupport::finish("half_band_upsampler_test");
+}
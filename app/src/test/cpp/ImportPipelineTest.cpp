@@ -0,0 +1,210 @@
+// Batch import: WAV conversion kernels, wavetable mipmaps and the parallel pipeline.
+
+#include "ImportPipeline.h"
+#include "PcmConvert.h"
+#include "TestSupport.h"
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+
+    std::string tempPath(const char *name) {
+        return std::string("/tmp/import_pipeline_test_") + name;
+    }
+
+    // Square wave: every odd harmonic, so mip levels have something to remove.
+    std::vector<float> squareCycle(int n) {
+        std::vector<float> v(static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i) v[static_cast<size_t>(i)] = i < n / 2 ? 0.5f : -0.5f;
+        return v;
+    }
+
+    void testResamplerChunking() {
+        std::vector<float> in(10000);
+        for (size_t i = 0; i < in.size(); ++i) in[i] = static_cast<float>(std::sin(0.01 * static_cast<double>(i)));
+
+        pcm::LinearResampler whole(44100.0, 48000.0);
+        std::vector<float> a(whole.maxOutput(in.size()));
+        a.resize(whole.process(in.data(), in.size(), a.data(), a.size()));
+
+        pcm::LinearResampler chunked(44100.0, 48000.0);
+        std::vector<float> b;
+        std::vector<float> tmp(chunked.maxOutput(777));
+        for (size_t pos = 0; pos < in.size(); pos += 777) {
+            const size_t n = std::min<size_t>(777, in.size() - pos);
+            const size_t got = chunked.process(in.data() + pos, n, tmp.data(), tmp.size());
+            b.insert(b.end(), tmp.begin(), tmp.begin() + static_cast<std::ptrdiff_t>(got));
+        }
+
+        CHECK(a.size() == b.size());
+        CHECK(std::abs(static_cast<long>(a.size()) - static_cast<long>(10000 * 48000 / 44100)) <= 2);
+        double maxDiff = 0.0;
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(a[i] - b[i])));
+        CHECK_NEAR(maxDiff, 0.0, 1e-6);
+    }
+
+    void testDownmix() {
+        const int16_t stereo[] = {32767, -32768, 16384, 16384};
+        float out[2];
+        pcm::downmixToMono(stereo, pcm::SampleFormat::kInt16, 2, 2, out);
+        CHECK_NEAR(out[0], 0.0, 1e-4);
+        CHECK_NEAR(out[1], 0.5, 1e-6);
+    }
+
+    // Each layout converted in place must match downmixToMono from an untouched copy.
+    void testMonoInPlace() {
+        constexpr size_t kFrames = 3000;   // several downmix scratch chunks
+        for (const auto format : {pcm::SampleFormat::kInt16, pcm::SampleFormat::kFloat32}) {
+            for (const int channels : {1, 2, 5}) {
+                const size_t bytes = kFrames * static_cast<size_t>(channels) * pcm::bytesPerSample(format);
+                std::vector<float> storage(std::max(bytes, kFrames * sizeof(float)) / sizeof(float));
+                auto *raw = reinterpret_cast<uint8_t *>(storage.data());
+                for (size_t i = 0; i < bytes; ++i) raw[i] = static_cast<uint8_t>(i * 37 + (i >> 7));
+                if (format == pcm::SampleFormat::kFloat32) {
+                    for (size_t i = 0; i < bytes / 4; ++i) storage[i] = std::sin(0.001f * static_cast<float>(i));
+                }
+                const std::vector<uint8_t> copy(raw, raw + bytes);
+                std::vector<float> want(kFrames);
+                pcm::downmixToMono(copy.data(), format, channels, kFrames, want.data());
+
+                float *mono = pcm::toMonoInPlace(raw, storage.size() * sizeof(float), format, channels, kFrames);
+                CHECK(mono == storage.data());
+                if (mono) CHECK(std::equal(want.begin(), want.end(), mono));
+            }
+        }
+
+        // Mono int16 needs room for the floats; misaligned buffers are refused.
+        std::vector<float> storage(64);
+        CHECK(pcm::toMonoInPlace(storage.data(), 2 * 64, pcm::SampleFormat::kInt16, 1, 64) == nullptr);
+        CHECK(pcm::toMonoInPlace(storage.data(), 4 * 64, pcm::SampleFormat::kInt16, 1, 64) != nullptr);
+        CHECK(pcm::toMonoInPlace(reinterpret_cast<uint8_t *>(storage.data()) + 2, 200, pcm::SampleFormat::kInt16, 2, 32) == nullptr);
+        CHECK(pcm::toMonoInPlace(storage.data(), 4 * 63, pcm::SampleFormat::kFloat32, 1, 64) == nullptr);
+    }
+
+    // An adopted sample hands its memory back exactly once, when the reclaimer frees it: not
+    // while a block that may have loaded it is still running, and not only with the registry.
+    void testAdoptedSampleRelease() {
+        static float pcm[16] = {};
+        int released = 0;
+        Reclaimer reclaimer(false);
+        AssetRegistry registry(reclaimer);
+        auto a = std::make_unique<SampleAsset>();
+        a->external = pcm;
+        a->externalFrames = 16;
+        a->releaseExternal = [&released] { ++released; };
+        const int slot = registry.publishSample(std::move(a), 3);
+        CHECK(slot == 3);
+        CHECK(registry.sample(3)->data() == pcm && registry.sample(3)->size() == 16);
+        {
+            Reclaimer::Guard block(reclaimer);
+            CHECK(registry.unloadSample(3));
+            CHECK(reclaimer.collect() == 0);
+            CHECK(released == 0);   // retired, this block may still be reading it
+        }
+        CHECK(reclaimer.collect() == 1);
+        CHECK(released == 1);
+    }
+
+    void testMipmaps() {
+        const auto cycle = squareCycle(Wavetable::kWavetableSize);
+        Wavetable t(cycle.data(), cycle.size());
+
+        // Top level keeps only the fundamental. Levels are not renormalised, so a unit square
+        // leaves a sine of amplitude 4/pi.
+        const float *top = t.mipLevel(Wavetable::kNumMipLevels - 1);
+        double maxErr = 0.0;
+        for (int i = 0; i < Wavetable::kWavetableSize; ++i) {
+            const double s = 4.0 / kPi * std::sin(2.0 * kPi * (i + 0.5) / Wavetable::kWavetableSize);
+            maxErr = std::max(maxErr, std::fabs(std::fabs(top[i]) - std::fabs(s)));
+        }
+        CHECK_NEAR(maxErr, 0.0, 1e-3);
+
+        CHECK(Wavetable::levelForIncrement(0.5f / Wavetable::kWavetableSize) == 0);
+        CHECK(Wavetable::levelForIncrement(0.25f) == Wavetable::kNumMipLevels - 1);
+        CHECK(Wavetable::levelForIncrement(0.01f) > Wavetable::levelForIncrement(0.001f));
+    }
+
+    void testPipeline() {
+        AssetRegistry registry;
+        ImportPipeline pipeline(registry, 48000.0, 3);
+        CHECK(pipeline.workerCount() == 3);
+
+        const auto cycle = squareCycle(600);
+        std::vector<float> longSample(44100);
+        for (size_t i = 0; i < longSample.size(); ++i) longSample[i] = 0.25f * static_cast<float>(std::sin(0.05 * static_cast<double>(i)));
+
+        const std::string tablePath = tempPath("table.wav");
+        const std::string samplePath = tempPath("sample.wav");
+        const std::string garbagePath = tempPath("garbage.wav");
+        CHECK(wavwriter::writeInt16(tablePath, cycle, 1, 44100));
+        CHECK(wavwriter::writeFloat32(samplePath, longSample, 1, 44100));
+        {
+            std::FILE *f = std::fopen(garbagePath.c_str(), "wb");
+            std::fputs("not a wav file", f);
+            std::fclose(f);
+        }
+
+        std::vector<ImportPipeline::Request> tables;
+        for (int i = 0; i < 6; ++i) tables.push_back({tablePath, ImportPipeline::Kind::kWavetable});
+        tables.push_back({garbagePath, ImportPipeline::Kind::kWavetable});
+        tables.push_back({tempPath("missing.wav"), ImportPipeline::Kind::kWavetable});
+        const int tableJob = pipeline.submit(tables);
+        const int sampleJob = pipeline.submit({{samplePath, ImportPipeline::Kind::kSample}});
+        CHECK(tableJob >= 0);
+        CHECK(sampleJob >= 0 && sampleJob != tableJob);
+
+        pipeline.waitIdle();
+
+        ImportPipeline::Progress p;
+        CHECK(pipeline.progress(tableJob, p));
+        CHECK(p.done && p.total == 8 && p.completed == 8 && p.failed == 2);
+        for (int i = 0; i < 6; ++i) {
+            // Slots are reserved in request order.
+            CHECK(pipeline.resultSlot(tableJob, i) == i);
+            CHECK(registry.wavetable(i) != nullptr);
+        }
+        CHECK(pipeline.resultSlot(tableJob, 6) == -1);
+        CHECK(pipeline.resultSlot(tableJob, 7) == -1);
+        CHECK(registry.wavetable(6) == nullptr);
+
+        CHECK(pipeline.progress(sampleJob, p));
+        CHECK(p.done && p.failed == 0);
+        const SampleAsset *s = registry.sample(pipeline.resultSlot(sampleJob, 0));
+        CHECK(s != nullptr);
+        if (s) {
+            CHECK(std::abs(static_cast<long>(s->frames.size()) - 48000) <= 2);
+            float peak = 0.0f;
+            for (float v : s->frames) peak = std::max(peak, std::fabs(v));
+            CHECK_NEAR(peak, 1.0, 1e-6);
+        }
+
+        // Freed failure slots are reusable by the next job.
+        const int again = pipeline.submit({{tablePath, ImportPipeline::Kind::kWavetable}});
+        pipeline.waitIdle();
+        CHECK(pipeline.resultSlot(again, 0) == 6);
+        CHECK(!pipeline.progress(-1, p));
+        CHECK(registry.version() == 8);
+
+        std::remove(tablePath.c_str());
+        std::remove(samplePath.c_str());
+        std::remove(garbagePath.c_str());
+    }
+
+} // namespace
+
+int main() {
+    testResamplerChunking();
+    testDownmix();
+    testMonoInPlace();
+    testAdoptedSampleRelease();
+    testMipmaps();
+    testPipeline();
+    return testsupport::finish("import_pipeline_test");
+}
@@ -0,0 +1,131 @@
+// Touch-to-note latency report over forensic logs.
+//
+//   latency_report [--window MS] [--burst-gap MS] [--reorder MS] [--csv] <log> [<log> ...]
+//
+// Accepts session_log.csv exports and raw `adb logcat` captures of the FORENSIC_DATA,
+// FORENSIC_MIDI and BH_INVARIANT tags ("-" reads stdin). Several files are merged by timestamp,
+// so each tag may be captured separately. Streams the input; memory grows only with the number
+// of joined latencies, not with the log size.
+
+#include "ForensicLog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+    void usage() {
+        std::fprintf(stderr, "usage: latency_report [--window MS] [--burst-gap MS] [--reorder MS] [--csv] <log> [<log> ...]\n");
+    }
+
+    double percent(uint64_t part, uint64_t whole) {
+        return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    forensic::AnalyzerConfig config;
+    bool csv = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--window") && i + 1 < argc) {
+            config.joinWindowMs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--burst-gap") && i + 1 < argc) {
+            config.burstGapMs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--reorder") && i + 1 < argc) {
+            config.reorderMs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--csv")) {
+            csv = true;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage();
+            return 2;
+        } else {
+            paths.emplace_back(argv[i]);
+        }
+    }
+    if (paths.empty() || config.joinWindowMs <= 0 || config.burstGapMs < 0 || config.reorderMs < 0) {
+        usage();
+        return 2;
+    }
+
+    forensic::MergedReader reader(paths);
+    if (!reader.ok()) {
+        std::fprintf(stderr, "latency_report: cannot open input\n");
+        return 2;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    forensic::LatencyAnalyzer analyzer(config);
+    forensic::Record r;
+    uint64_t records = 0;
+    while (reader.next(r)) {
+        analyzer.feed(r);
+        ++records;
+    }
+    analyzer.finish();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    using Analyzer = forensic::LatencyAnalyzer;
+    if (csv) {
+        std::printf("stage,count,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n");
+        for (int s = 0; s < Analyzer::kStageCount; ++s) {
+            const auto stage = static_cast<Analyzer::Stage>(s);
+            const forensic::Percentiles p = forensic::summarize(analyzer.samples(stage));
+            std::printf("%s,%zu,%.2f,%.0f,%.0f,%.0f,%.0f\n", Analyzer::stageName(stage), p.count, p.mean, p.p50,
+                        p.p90, p.p99, p.max);
+        }
+        return records ? 0 : 1;
+    }
+
+    const Analyzer::Counters &c = analyzer.counters();
+    std::printf("%llu lines, %llu records, %.1f MB in %.3f s (%.1f M lines/s)\n",
+                static_cast<unsigned long long>(reader.lines()), static_cast<unsigned long long>(records),
+                static_cast<double>(reader.bytes()) / 1e6, seconds,
+                seconds > 0.0 ? static_cast<double>(reader.lines()) / seconds / 1e6 : 0.0);
+    for (int k = 1; k < forensic::kKindCount; ++k) {
+        if (c.records[k]) {
+            std::printf("  %-14s %10llu\n", forensic::kindName(static_cast<forensic::Kind>(k)),
+                        static_cast<unsigned long long>(c.records[k]));
+        }
+    }
+    if (c.outOfOrder) {
+        std::printf("  %llu records arrived later than the reorder window\n",
+                    static_cast<unsigned long long>(c.outOfOrder));
+    }
+
+    std::printf("\n%-24s %7s %8s %6s %6s %6s %6s   (ms)\n", "stage", "count", "mean", "p50", "p90", "p99", "max");
+    for (int s = 0; s < Analyzer::kStageCount; ++s) {
+        const auto stage = static_cast<Analyzer::Stage>(s);
+        const forensic::Percentiles p = forensic::summarize(analyzer.samples(stage));
+        if (!p.count) {
+            std::printf("%-24s %7s\n", Analyzer::stageName(stage), "-");
+            continue;
+        }
+        std::printf("%-24s %7zu %8.2f %6.0f %6.0f %6.0f %6.0f\n", Analyzer::stageName(stage), p.count, p.mean, p.p50,
+                    p.p90, p.p99, p.max);
+    }
+
+    std::printf("\ntouch events %llu\n", static_cast<unsigned long long>(c.touchEvents));
+    std::printf("landings     %6llu  finger changes %6llu  suppressed %6llu (%.0f%%)  without note %llu\n",
+                static_cast<unsigned long long>(c.landings), static_cast<unsigned long long>(c.landingChanges),
+                static_cast<unsigned long long>(c.landingSuppressed), percent(c.landingSuppressed, c.landingChanges),
+                static_cast<unsigned long long>(c.landingsUnmatched));
+    std::printf("releases     %6llu  finger changes %6llu  suppressed %6llu (%.0f%%)  without off %llu\n",
+                static_cast<unsigned long long>(c.releases), static_cast<unsigned long long>(c.releaseChanges),
+                static_cast<unsigned long long>(c.releaseSuppressed), percent(c.releaseSuppressed, c.releaseChanges),
+                static_cast<unsigned long long>(c.releasesUnmatched));
+    std::printf("decisions    %6llu  without note %llu\n", static_cast<unsigned long long>(c.decisions),
+                static_cast<unsigned long long>(c.decisionsOrphaned));
+    std::printf("TX bursts    %6llu  notes/burst %.1f\n", static_cast<unsigned long long>(c.bursts),
+                c.bursts ? static_cast<double>(c.burstMessages) / static_cast<double>(c.bursts) : 0.0);
+    if (c.cascades) {
+        std::printf("cascades     %6llu  decisions inside a cascade window %llu\n",
+                    static_cast<unsigned long long>(c.cascades), static_cast<unsigned long long>(c.cascadeLeaks));
+    }
+    return records ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// ModMatrix routing, curves, voice masking, release hold, route hand-off and concurrent writers.
+
+#include "ModMatrix.h"
+#include "TestSupport.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+    void testRoutingAndCurves() {
+        ModMatrix m;
+        const ModMatrix::Route routes[] = {
+                {ModMatrix::kSrcPitchBend, ModMatrix::kDestPitch,   ModMatrix::kCurveLinear,  2.0f},
+                {ModMatrix::kSrcTimbre,    ModMatrix::kDestCutoff,  ModMatrix::kCurveBipolar, 3.0f},
+                {ModMatrix::kSrcPressure,  ModMatrix::kDestGain,    ModMatrix::kCurveExp,     12.0f},
+                {ModMatrix::kSrcHeight,    ModMatrix::kDestPan,     ModMatrix::kCurveBipolar, 1.0f},
+                {ModMatrix::kSrcVelocity,  ModMatrix::kDestCutoff,  ModMatrix::kCurveLog,     1.0f},
+        };
+        m.setRoutes(routes, 5);
+
+        m.setVoiceActive(0, true);
+        m.setVoiceActive(9, true);
+        m.setVoiceSource(0, ModMatrix::kSrcPitchBend, 0.5f);
+        m.setVoiceSource(0, ModMatrix::kSrcTimbre, 1.0f);
+        m.setVoiceSource(0, ModMatrix::kSrcPressure, 0.5f);
+        m.setVoiceSource(0, ModMatrix::kSrcVelocity, 0.5f);
+        m.setVoiceSource(9, ModMatrix::kSrcPitchBend, -1.0f);
+        m.setVoiceSource(9, ModMatrix::kSrcTimbre, 0.5f);
+        // Voice 3 is inactive: its sources must not leak into the outputs.
+        m.setVoiceSource(3, ModMatrix::kSrcPitchBend, 1.0f);
+        m.setGlobalSource(ModMatrix::kSrcHeight, 0.75f);
+        m.process(192, 48000.0);
+
+        CHECK(m.routeCount() == 5);
+        CHECK(m.activeLaneCount() >= 10);
+        CHECK_NEAR(m.dest(ModMatrix::kDestPitch)[0], 1.0, 1e-6);
+        CHECK_NEAR(m.dest(ModMatrix::kDestPitch)[9], -2.0, 1e-6);
+        CHECK_NEAR(m.dest(ModMatrix::kDestPitch)[3], 0.0, 0.0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestCutoff)[0], 3.75, 1e-6);     // 3 + 1 - (1 - 0.5)^2
+        CHECK_NEAR(m.dest(ModMatrix::kDestCutoff)[9], 0.0, 1e-6);
+        CHECK_NEAR(m.dest(ModMatrix::kDestGain)[0], 3.0, 1e-6);        // 12 * 0.5^2
+        CHECK_NEAR(m.dest(ModMatrix::kDestPan)[0], 0.5, 1e-6);         // global, broadcast
+        CHECK_NEAR(m.dest(ModMatrix::kDestPan)[9], 0.5, 1e-6);
+
+        CHECK_NEAR(m.pitchRatio()[0], std::pow(2.0, 1.0 / 12.0), 1e-5);
+        CHECK_NEAR(m.cutoffScale()[0], std::pow(2.0, 3.75), 1e-4);
+        CHECK_NEAR(m.gain()[0], std::pow(10.0, 3.0 / 20.0), 1e-5);
+        CHECK_NEAR(m.pitchRatio()[3], 1.0, 1e-6);
+    }
+
+    // A released voice keeps its last modulation through the release tail; the next note on
+    // that lane starts from its own sources.
+    void testReleasedLaneHolds() {
+        ModMatrix m;
+        const ModMatrix::Route r = {ModMatrix::kSrcPressure, ModMatrix::kDestGain, ModMatrix::kCurveLinear, 6.0f};
+        m.setRoutes(&r, 1);
+        m.setVoiceActive(2, true);
+        m.setVoiceSource(2, ModMatrix::kSrcPressure, 0.5f);
+        m.process(64, 48000.0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestGain)[2], 3.0, 1e-6);
+
+        m.setVoiceActive(2, false);
+        m.setVoiceSource(2, ModMatrix::kSrcPressure, 0.0f);
+        m.process(64, 48000.0);
+        m.process(64, 48000.0);
+        CHECK(m.activeLaneCount() == 0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestGain)[2], 3.0, 1e-6);
+        CHECK_NEAR(m.gain()[2], std::pow(10.0, 3.0 / 20.0), 1e-5);
+
+        m.setVoiceActive(2, true);
+        m.setVoiceSource(2, ModMatrix::kSrcPressure, 1.0f);
+        m.process(64, 48000.0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestGain)[2], 6.0, 1e-6);
+    }
+
+    void testNoActiveVoices() {
+        ModMatrix m;
+        m.setVoiceSource(0, ModMatrix::kSrcPressure, 1.0f);
+        m.process(256, 48000.0);
+        CHECK(m.activeLaneCount() == 0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestGain)[0], 0.0, 0.0);
+        CHECK_NEAR(m.gain()[0], 1.0, 1e-6);
+    }
+
+    void testDefaultsAndInvalidRoutes() {
+        ModMatrix m;
+        m.process(64, 48000.0);
+        ModMatrix::Route defaults[ModMatrix::kMaxRoutes];
+        CHECK(m.routeCount() == ModMatrix::defaultRoutes(defaults, ModMatrix::kMaxRoutes));
+
+        // Defaults are gain-neutral: full pressure leaves a voice at 0 dB.
+        m.setVoiceActive(0, true);
+        m.setVoiceSource(0, ModMatrix::kSrcPressure, 1.0f);
+        m.process(64, 48000.0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestGain)[0], 0.0, 0.0);
+
+        ModMatrix::Route bad[2];
+        bad[0].source = static_cast<ModMatrix::Source>(200);
+        bad[1] = {ModMatrix::kSrcLfo1, ModMatrix::kDestPitch, ModMatrix::kCurveLinear, 0.5f};
+        m.setRoutes(bad, 2);
+        m.process(64, 48000.0);
+        CHECK(m.routeCount() == 1);
+    }
+
+    void testLfoAdvances() {
+        ModMatrix m;
+        const ModMatrix::Route r = {ModMatrix::kSrcLfo1, ModMatrix::kDestPitch, ModMatrix::kCurveLinear, 1.0f};
+        m.setRoutes(&r, 1);
+        m.setLfoRate(0, 1.0f);
+        m.setVoiceActive(0, true);
+        // A quarter period at 1 Hz: 12000 frames at 48 kHz.
+        for (int i = 0; i < 125; ++i) m.process(96, 48000.0);
+        CHECK_NEAR(m.dest(ModMatrix::kDestPitch)[0], 1.0, 1e-4);
+    }
+
+    // Two configuring threads racing setRoutes(): the audio thread must only ever apply one
+    // writer's whole table, never a mix of both (it may keep none while every pull races).
+    void testConcurrentWriters() {
+        ModMatrix m;
+        ModMatrix::Route a[ModMatrix::kMaxRoutes];
+        ModMatrix::Route b[8];
+        for (auto &r : a) r = {ModMatrix::kSrcPressure, ModMatrix::kDestPitch, ModMatrix::kCurveLinear, 1.0f};
+        for (auto &r : b) r = {ModMatrix::kSrcPressure, ModMatrix::kDestPitch, ModMatrix::kCurveLinear, 2.0f};
+        m.setRoutes(b, 8);
+        m.setVoiceActive(0, true);
+        m.setVoiceSource(0, ModMatrix::kSrcPressure, 1.0f);
+
+        std::atomic<bool> stop{false};
+        std::thread writerA([&] { while (!stop.load()) m.setRoutes(a, ModMatrix::kMaxRoutes); });
+        std::thread writerB([&] { while (!stop.load()) m.setRoutes(b, 8); });
+        int torn = 0;
+        for (int i = 0; i < 20000; ++i) {
+            m.process(64, 48000.0);
+            const float pitch = m.dest(ModMatrix::kDestPitch)[0];
+            const bool wholeA = m.routeCount() == ModMatrix::kMaxRoutes && pitch == 32.0f;
+            const bool wholeB = m.routeCount() == 8 && pitch == 16.0f;
+            const bool none = m.routeCount() == 0 && pitch == 0.0f;   // no table pulled yet
+            if (!wholeA && !wholeB && !none) ++torn;
+        }
+        stop.store(true);
+        writerA.join();
+        writerB.join();
+        CHECK(torn == 0);
+    }
+
+} // namespace
+
+int main() {
+    testRoutingAndCurves();
+    testReleasedLaneHolds();
+    testNoActiveVoices();
+    testDefaultsAndInvalidRoutes();
+    testLfoAdvances();
+    testConcurrentWriters();
+    return testsupport::finish("ModMatrixTest");
+}
@@ -0,0 +1,452 @@
+// Host throughput benchmark for the native DSP kernels.
+//
+//   native_bench            full run
+//   native_bench --quick    short smoke run (used by ctest)
+
+#include "BuiltinTables.h"
+#include "DspKernels.h"
+#include "FastMath.h"
+#include "GranularEngine.h"
+#include "HalfBandUpsampler.h"
+#include "ImportPipeline.h"
+#include "ModMatrix.h"
+#include "RenderGraph.h"
+#include "UnisonVoice.h"
+#include "WavWriter.h"
+#include "WavetableCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    int gIterations = 2000;
+    volatile float gSink = 0.0f;
+
+    template <typename Fn>
+    double nsPerElement(int n, Fn fn) {
+        using clock = std::chrono::steady_clock;
+        fn(); // warm-up
+        const auto t0 = clock::now();
+        for (int it = 0; it < gIterations; ++it) fn();
+        const auto t1 = clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        return ns / (static_cast<double>(gIterations) * n);
+    }
+
+    void report(const char *name, double fastNs, double libmNs) {
+        std::printf("  %-18s fast %7.3f ns/elem   libm %7.3f ns/elem   x%.1f\n",
+                    name, fastNs, libmNs, libmNs / fastNs);
+    }
+
+    void benchFastMath() {
+        std::printf("FastMath (block of 256):\n");
+        constexpr int kN = 256;
+        std::vector<float> in(kN), out(kN);
+        for (int i = 0; i < kN; ++i) in[i] = -8.0f + 16.0f * static_cast<float>(i) / kN;
+
+        auto libm = [&](float (*f)(float)) {
+            return nsPerElement(kN, [&] {
+                for (int i = 0; i < kN; ++i) out[i] = f(in[i]);
+                gSink = gSink + out[kN / 2];
+            });
+        };
+        auto fast = [&](void (*f)(const float *, float *, int)) {
+            return nsPerElement(kN, [&] {
+                f(in.data(), out.data(), kN);
+                gSink = gSink + out[kN / 2];
+            });
+        };
+
+        report("exp2", fast(fastmath::exp2Block), libm([](float x) { return std::exp2(x); }));
+        report("exp", fast(fastmath::expBlock), libm([](float x) { return std::exp(x); }));
+        report("tanh", fast(fastmath::tanhBlock), libm([](float x) { return std::tanh(x); }));
+        report("sin", fast(fastmath::sinBlock), libm([](float x) { return std::sin(x); }));
+        report("semitonesToRatio", fast(fastmath::semitonesToRatioBlock),
+               libm([](float x) { return std::pow(2.0f, x / 12.0f); }));
+        for (float &v : in) v = std::fabs(v) + 1e-3f;
+        report("log2", fast(fastmath::log2Block), libm([](float x) { return std::log2(x); }));
+    }
+
+    void benchTuningTables() {
+        std::printf("Tuning tables (256 lookups):\n");
+        constexpr int kN = 256;
+        std::vector<int> notes(kN), bends(kN);
+        for (int i = 0; i < kN; ++i) {
+            notes[i] = (i * 37) % 128;
+            bends[i] = (i * 6151) % 16384;
+        }
+        const float *incs = builtin::noteIncrements(48000.0);
+        const double tableNote = nsPerElement(kN, [&] {
+            float acc = 0.0f;
+            for (int n : notes) acc += incs[n];
+            gSink = gSink + acc;
+        });
+        const double mathNote = nsPerElement(kN, [&] {
+            float acc = 0.0f;
+            for (int n : notes) acc += fastmath::noteToHz(static_cast<float>(n)) * (1.0f / 48000.0f);
+            gSink = gSink + acc;
+        });
+        std::printf("  note->increment    table %7.3f ns/elem   fastmath %7.3f ns/elem\n", tableNote, mathNote);
+        const double tableBend = nsPerElement(kN, [&] {
+            float acc = 0.0f;
+            for (int b : bends) acc += builtin::bendToRatio(b, 48);
+            gSink = gSink + acc;
+        });
+        const double mathBend = nsPerElement(kN, [&] {
+            float acc = 0.0f;
+            for (int b : bends) acc += fastmath::semitonesToRatio(fastmath::bend14ToSemitones(b, 48.0f));
+            gSink = gSink + acc;
+        });
+        std::printf("  bend->ratio        table %7.3f ns/elem   fastmath %7.3f ns/elem\n", tableBend, mathBend);
+    }
+
+    void benchModMatrix() {
+        std::printf("ModMatrix (one block, all 16 voices active):\n");
+        for (const int routeCount : {3, 8, 16, 32}) {
+            ModMatrix m;
+            ModMatrix::Route routes[ModMatrix::kMaxRoutes];
+            for (int r = 0; r < routeCount; ++r) {
+                routes[r].source = static_cast<ModMatrix::Source>(r % ModMatrix::kNumSources);
+                routes[r].dest = static_cast<ModMatrix::Dest>(r % ModMatrix::kNumDests);
+                routes[r].curve = static_cast<ModMatrix::Curve>(r % ModMatrix::kNumCurves);
+                routes[r].amount = 0.1f * static_cast<float>(r + 1);
+            }
+            m.setRoutes(routes, routeCount);
+            for (int v = 0; v < ModMatrix::kMaxVoices; ++v) {
+                m.setVoiceActive(v, true);
+                m.setVoiceSource(v, ModMatrix::kSrcPressure, 0.01f * static_cast<float>(v));
+            }
+            const double ns = nsPerElement(1, [&] {
+                m.process(192, 48000.0);
+                gSink = gSink + m.gain()[3];
+            });
+            std::printf("  %2d routes          %8.1f ns/block\n", routeCount, ns);
+        }
+    }
+
+    void benchImport() {
+        const int files = gIterations < 100 ? 4 : 32;
+        std::printf("ImportPipeline (%d x 2 s stereo 44.1 kHz samples -> 48 kHz):\n", files);
+        std::vector<float> stereo(2 * 88200);
+        for (size_t i = 0; i < stereo.size(); ++i) stereo[i] = 0.5f * std::sin(0.001f * static_cast<float>(i));
+        const std::string path = "/tmp/native_bench_import.wav";
+        if (!wavwriter::writeInt16(path, stereo, 2, 44100)) {
+            std::printf("  (skipped: cannot write %s)\n", path.c_str());
+            return;
+        }
+
+        std::vector<ImportPipeline::Request> requests(static_cast<size_t>(files), {path, ImportPipeline::Kind::kSample});
+        const int maxWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int workers = 1;; workers = std::min(workers * 2, maxWorkers)) {
+            AssetRegistry registry;
+            ImportPipeline pipeline(registry, 48000.0, workers);
+            const auto t0 = std::chrono::steady_clock::now();
+            pipeline.submit(requests);
+            pipeline.waitIdle();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            std::printf("  %2d worker(s)       %8.1f ms   %6.1f files/s\n", workers, ms, 1000.0 * files / ms);
+            if (workers == maxWorkers) break;
+        }
+        std::remove(path.c_str());
+    }
+
+    void benchWavetableCache() {
+        const int tables = gIterations < 100 ? 8 : 64;
+        std::printf("WavetableCache (%d tables, build vs mmap'd load):\n", tables);
+        const std::string path = "/tmp/native_bench_wavetables.cache";
+        std::remove(path.c_str());
+        std::vector<float> cycle(2048);
+        using clock = std::chrono::steady_clock;
+
+        double buildMs = 0.0;
+        {
+            WavetableCache cache;
+            cache.open(path);
+            const auto t0 = clock::now();
+            for (int t = 0; t < tables; ++t) {
+                for (size_t i = 0; i < cycle.size(); ++i) cycle[i] = std::sin(0.003f * static_cast<float>((t + 1) * i));
+                Wavetable table(cycle.data(), cycle.size());
+                cache.store(static_cast<uint64_t>(t + 1), table);
+            }
+            buildMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+            cache.flush();
+        }
+
+        const auto t0 = clock::now();
+        WavetableCache cache;
+        cache.open(path);
+        for (int t = 0; t < tables; ++t) {
+            auto table = cache.load(static_cast<uint64_t>(t + 1));
+            if (table) gSink = gSink + table->render(0.3f, 4);
+        }
+        const double loadMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+        std::printf("  build %8.2f ms   load %8.3f ms   x%.0f\n", buildMs, loadMs, buildMs / loadMs);
+        std::remove(path.c_str());
+    }
+
+    // Stand-in for the synth: 16 wavetable voices (saw, mip level per pitch), stereo out.
+    void renderVoices(float *out, int frames, double sampleRate, float *phases) {
+        static const auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+        std::memset(out, 0, sizeof(float) * static_cast<size_t>(frames) * 2);
+        for (int v = 0; v < 16; ++v) {
+            const float inc = builtin::noteIncrement(48 + 3 * v, sampleRate);
+            const int level = Wavetable::levelForIncrement(inc);
+            float phase = phases[v];
+            for (int i = 0; i < frames; ++i) {
+                const float s = saw->render(phase, level) * (1.0f / 16.0f);
+                out[2 * i] += s;
+                out[2 * i + 1] += s;
+                phase += inc;
+                phase -= static_cast<float>(static_cast<int>(phase));
+            }
+            phases[v] = phase;
+        }
+    }
+
+    void benchLowPowerRender() {
+        std::printf("Low-power render (16 wavetable voices, 192-frame blocks at 48 kHz):\n");
+        constexpr int kBlock = 192;
+        std::vector<float> out(2 * kBlock), half(kBlock);
+        float phases[16] = {};
+        HalfBandUpsampler up;
+
+        const double fullNs = nsPerElement(kBlock, [&] {
+            renderVoices(out.data(), kBlock, 48000.0, phases);
+            gSink = gSink + out[7];
+        });
+        const double halfNs = nsPerElement(kBlock, [&] {
+            renderVoices(half.data(), kBlock / 2, 24000.0, phases);
+            up.process(half.data(), kBlock / 2, out.data());
+            gSink = gSink + out[7];
+        });
+        const double upNs = nsPerElement(kBlock, [&] {
+            up.process(half.data(), kBlock / 2, out.data());
+            gSink = gSink + out[7];
+        });
+        std::printf("  full rate          %7.2f ns/frame\n", fullNs);
+        std::printf("  half rate + 2x     %7.2f ns/frame   (upsampler %.2f ns/frame)   saves %.0f%%\n",
+                    halfNs, upNs, 100.0 * (1.0 - halfNs / fullNs));
+
+        // Image rejection: a tone at f (of the 24 kHz rate) leaves an image at 24 kHz - f.
+        constexpr int kFrames = 8192;
+        std::vector<float> tone(2 * kFrames), up2(4 * kFrames);
+        HalfBandUpsampler probe;
+        for (const double f : {0.1, 0.3, 0.42}) {
+            for (int i = 0; i < kFrames; ++i) tone[2 * i] = tone[2 * i + 1] = static_cast<float>(std::sin(6.283185307179586 * f * i));
+            probe.reset();
+            probe.process(tone.data(), kFrames, up2.data());
+            auto magnitude = [&](double g) {
+                double re = 0.0, im = 0.0;
+                for (int i = 0; i < kFrames; ++i) {
+                    const double w = 0.5 - 0.5 * std::cos(6.283185307179586 * i / kFrames);
+                    re += up2[2 * (kFrames / 2 + i)] * w * std::cos(6.283185307179586 * g * i);
+                    im -= up2[2 * (kFrames / 2 + i)] * w * std::sin(6.283185307179586 * g * i);
+                }
+                return std::sqrt(re * re + im * im);
+            };
+            std::printf("  image at %5.0f Hz  %7.1f dB\n", 24000.0 - f * 24000.0,
+                        20.0 * std::log10(magnitude(0.5 - f / 2.0) / magnitude(f / 2.0)));
+        }
+    }
+
+    void benchUnison() {
+        std::printf("Unison (saw, %s kernels, 192-frame blocks at 48 kHz):\n", dsp::isaName(dsp::kernels().isa));
+        constexpr int kBlock = 192;
+        static const auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+        const float inc = builtin::noteIncrement(57, 48000.0);
+        std::vector<float> out(2 * kBlock);
+        UnisonVoice::Params p;
+        p.sustain = 1.0f;
+
+        p.copies = 1;
+        UnisonVoice single;
+        single.noteOn(p, 57, 1.0f, 1);
+        const double singleNs = nsPerElement(kBlock, [&] {
+            single.render(*saw, inc, 8000.0f, 1.0f, 48000.0, out.data(), kBlock);
+            gSink = gSink + out[7];
+        });
+        std::printf("  1 voice            %7.2f ns/frame\n", singleNs);
+        for (const int copies : {4, 8, 16}) {
+            // Layered: one fully enveloped and filtered voice per copy.
+            std::vector<UnisonVoice> layered(static_cast<size_t>(copies));
+            for (auto &v : layered) v.noteOn(p, 57, 1.0f, 1);
+            const double layeredNs = nsPerElement(kBlock, [&] {
+                for (auto &v : layered) v.render(*saw, inc, 8000.0f, 1.0f, 48000.0, out.data(), kBlock);
+                gSink = gSink + out[7];
+            });
+            p.copies = copies;
+            UnisonVoice stack;
+            stack.noteOn(p, 57, 1.0f, 1);
+            const double stackNs = nsPerElement(kBlock, [&] {
+                stack.render(*saw, inc, 8000.0f, 1.0f, 48000.0, out.data(), kBlock);
+                gSink = gSink + out[7];
+            });
+            std::printf("  %2d copies          %7.2f ns/frame   layered %7.2f ns/frame   x%.1f   (%.2f voices)\n",
+                        copies, stackNs, layeredNs, layeredNs / stackNs, stackNs / singleNs);
+            p.copies = 1;
+        }
+    }
+
+    // A unison voice as a graph source, next to one that is silent.
+    class UnisonNode final : public RenderNode {
+    public:
+        UnisonNode(const char *name, bool sounding) : RenderNode(name), sounding_(sounding) {
+            UnisonVoice::Params p;
+            p.sustain = 1.0f;
+            voice_.noteOn(p, 57, 1.0f, 1);
+        }
+        bool active() const override { return sounding_; }
+        bool process(const float *const *, int, float *out, int frames) override {
+            std::memset(out, 0, sizeof(float) * 2 * static_cast<size_t>(frames));
+            voice_.render(table(), builtin::noteIncrement(57, 48000.0), 8000.0f, 1.0f, 48000.0, out, frames);
+            return true;
+        }
+        UnisonVoice &voice() { return voice_; }
+        static const Wavetable &table() {
+            static const auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+            return *saw;
+        }
+
+    private:
+        UnisonVoice voice_;
+        bool sounding_;
+    };
+
+    void benchRenderGraph() {
+        constexpr int kSub = RenderGraph::kMaxFrames;
+        std::printf("Render graph (%d-frame sub-blocks, 7-copy unison source + 3 silent sources -> master):\n", kSub);
+        UnisonNode direct("direct", true), live("live", true);
+        UnisonNode quiet[3] = {{"quiet", false}, {"quiet", false}, {"quiet", false}};
+        MixNode master("master");
+        RenderGraph graph;
+        const int m = graph.addNode(&master);
+        graph.connect(graph.addNode(&live), m);
+        for (auto &q : quiet) graph.connect(graph.addNode(&q), m);
+        graph.setOutput(m);
+        graph.compile();
+
+        float out[2 * kSub];
+        const double directNs = nsPerElement(kSub, [&] {
+            std::memset(out, 0, sizeof(out));
+            direct.voice().render(UnisonNode::table(), builtin::noteIncrement(57, 48000.0), 8000.0f, 1.0f, 48000.0,
+                                  out, kSub);
+            gSink = gSink + out[3];
+        });
+        const double graphNs = nsPerElement(kSub, [&] {
+            graph.render(out, kSub);
+            gSink = gSink + out[3];
+        });
+        std::printf("  direct %7.2f ns/frame   graph %7.2f ns/frame   overhead %5.0f ns per sub-block, %d buffers\n",
+                    directNs, graphNs, (graphNs - directNs) * kSub, graph.plannedBuffers());
+    }
+
+    void benchGranular() {
+        std::printf("Granular (%s kernels, 100 ms grains over a 2 s sample, 192-frame blocks at 48 kHz):\n",
+                    dsp::isaName(dsp::kernels().isa));
+        constexpr int kBlock = 192;
+        std::vector<float> source(96000);
+        for (size_t i = 0; i < source.size(); ++i) source[i] = std::sin(0.05f * static_cast<float>(i));
+        std::vector<float> out(2 * kBlock);
+        for (const int grains : {64, 128, 256, 512}) {
+            GranularEngine g;
+            g.setSource(source.data(), static_cast<int>(source.size()), 48000.0, false);
+            GranularEngine::Params p;
+            p.grainMs = 100.0f;
+            p.density = static_cast<float>(grains) * 20.0f;   // keeps the pool full
+            p.maxGrains = grains;
+            p.pitchSpreadCents = 700.0f;
+            p.positionJitter = 0.4f;
+            for (int i = 0; i < 50; ++i) g.render(p, 48000.0, out.data(), kBlock);
+            const double ns = nsPerElement(kBlock, [&] {
+                g.render(p, 48000.0, out.data(), kBlock);
+                gSink = gSink + out[5];
+            });
+            std::printf("  %3d grains   %8.2f ns/frame   %5.2f ns/grain-frame   %4.1f%% of real time\n", g.activeGrains(),
+                        ns, ns / g.activeGrains(), ns * 48000.0 / 1e7);
+        }
+    }
+
+    // The same workloads once per kernel variant this CPU runs (the engine binds the last row).
+    void benchDspKernels() {
+        std::printf("DSP kernel variants (ns per output frame; mix/convert per sample):\n");
+        std::printf("  %-8s %5s %11s %11s %12s %10s %8s %8s\n", "isa", "lanes", "unison x7", "unison x16",
+                    "grains x256", "half-band", "mix", "int16");
+        constexpr int kBlock = 192;
+        static const auto saw = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+        const float inc = builtin::noteIncrement(57, 48000.0);
+        std::vector<float> source(96000);
+        for (size_t i = 0; i < source.size(); ++i) source[i] = std::sin(0.05f * static_cast<float>(i));
+        std::vector<float> out(2 * kBlock), in(2 * kBlock, 0.25f), up(4 * kBlock);
+        std::vector<int16_t> pcm(2 * kBlock, 1234);
+
+        for (int i = 0; i < static_cast<int>(dsp::Isa::kCount); ++i) {
+            if (!dsp::bind(static_cast<dsp::Isa>(i))) continue;
+            auto unison = [&](int copies) {
+                UnisonVoice::Params p;
+                p.sustain = 1.0f;
+                p.copies = copies;
+                UnisonVoice v;
+                v.noteOn(p, 57, 1.0f, 1);
+                return nsPerElement(kBlock, [&] {
+                    v.render(*saw, inc, 8000.0f, 1.0f, 48000.0, out.data(), kBlock);
+                    gSink = gSink + out[7];
+                });
+            };
+            GranularEngine g;
+            g.setSource(source.data(), static_cast<int>(source.size()), 48000.0, false);
+            GranularEngine::Params gp;
+            gp.grainMs = 100.0f;
+            gp.density = 256.0f * 20.0f;
+            gp.maxGrains = 256;
+            gp.pitchSpreadCents = 700.0f;
+            for (int b = 0; b < 50; ++b) g.render(gp, 48000.0, out.data(), kBlock);
+            const double grainNs = nsPerElement(kBlock, [&] {
+                g.render(gp, 48000.0, out.data(), kBlock);
+                gSink = gSink + out[5];
+            });
+            HalfBandUpsampler hb;
+            const double hbNs = nsPerElement(kBlock, [&] {
+                hb.process(in.data(), kBlock, up.data());
+                gSink = gSink + up[3];
+            });
+            const dsp::Kernels &k = dsp::kernels();
+            const double mixNs = nsPerElement(2 * kBlock, [&] {
+                k.mixAdd(out.data(), in.data(), 0.5f, 2 * kBlock);
+                gSink = gSink + out[1];
+            });
+            const double convertNs = nsPerElement(2 * kBlock, [&] {
+                k.int16ToFloat(pcm.data(), out.data(), 2 * kBlock, 1.0f / 32768.0f);
+                gSink = gSink + out[1];
+            });
+            std::printf("  %-8s %5d %11.2f %11.2f %12.1f %10.2f %8.3f %8.3f\n", dsp::isaName(k.isa), k.laneWidth,
+                        unison(7), unison(16), grainNs, hbNs, mixNs, convertNs);
+        }
+        std::printf("  bound: %s\n", dsp::isaName(dsp::bindBest()));
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) gIterations = 20;
+    }
+    dsp::bindBest();   // as the engine does at creation
+    benchFastMath();
+    benchTuningTables();
+    benchModMatrix();
+    benchImport();
+    benchWavetableCache();
+    benchLowPowerRender();
+    benchUnison();
+    benchGranular();
+    benchRenderGraph();
+    benchDspKernels();
+    return 0;
+}
@@ -0,0 +1,136 @@
+// Reclaimer: deferred frees around guards, deleters that retire, concurrent readers.
+
+#include "Reclaimer.h"
+#include "TestSupport.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Counts destructions and poisons itself so a stale reader notices.
+    struct Payload {
+        static constexpr uint32_t kAlive = 0xA11CEu;
+        static constexpr uint32_t kDead = 0xDEADu;
+
+        explicit Payload(int *destroyed = nullptr) : destroyed_(destroyed) {}
+        ~Payload() {
+            magic.store(kDead, std::memory_order_relaxed);
+            if (destroyed_) ++*destroyed_;
+        }
+
+        std::atomic<uint32_t> magic{kAlive};
+        int *destroyed_;
+    };
+
+    void testGuardDefersFree() {
+        int destroyed = 0;
+        Reclaimer reclaimer(false);
+
+        // Nobody inside a guard: freed by the next pass.
+        reclaimer.retire(new Payload(&destroyed));
+        CHECK(reclaimer.pending() == 1);
+        CHECK(reclaimer.collect() == 1);
+        CHECK(destroyed == 1);
+        CHECK(reclaimer.collect() == 0);
+
+        // Retired while a block runs: kept until that block is over, however many passes run.
+        {
+            Reclaimer::Guard block(reclaimer);
+            reclaimer.retire(new Payload(&destroyed));
+            CHECK(reclaimer.collect() == 0);
+            CHECK(reclaimer.collect() == 0);
+            CHECK(destroyed == 1);
+        }
+        CHECK(reclaimer.collect() == 1);
+        CHECK(destroyed == 2);
+
+        // A block that started after the retire but before any pass announced the same epoch
+        // and is waited for too; the one after it is not.
+        reclaimer.retire(new Payload(&destroyed));
+        {
+            Reclaimer::Guard block(reclaimer);
+            CHECK(reclaimer.collect() == 0);
+            Reclaimer::Guard nested(reclaimer);   // newer epoch, does not hold it back
+            CHECK(reclaimer.collect() == 0);
+        }
+        CHECK(reclaimer.collect() == 1);
+        CHECK(destroyed == 3);
+        CHECK(reclaimer.freedCount() == 3);
+    }
+
+    // Destroying an engine retires what it owned; that is picked up by the following pass.
+    struct Owner {
+        Reclaimer *reclaimer;
+        Payload *child;
+        ~Owner() { reclaimer->retire(child); }
+    };
+
+    void testDeleterRetires() {
+        int destroyed = 0;
+        Reclaimer reclaimer(false);
+        reclaimer.retire(new Owner{&reclaimer, new Payload(&destroyed)});
+        CHECK(reclaimer.collect() == 1);
+        CHECK(destroyed == 0 && reclaimer.pending() == 1);
+        CHECK(reclaimer.collect() == 1);
+        CHECK(destroyed == 1);
+
+        // The destructor frees the rest without waiting for a pass.
+        {
+            Reclaimer last(false);
+            last.retire(new Owner{&last, new Payload(&destroyed)});
+        }
+        CHECK(destroyed == 2);
+    }
+
+    // Readers dereference the current payload inside guards while a writer keeps replacing it;
+    // a payload freed too early shows up as kDead (or under ASan).
+    void testConcurrentReaders() {
+        constexpr int kReaders = 3;
+        constexpr int kSwaps = 20000;
+        Reclaimer reclaimer;
+        std::atomic<Payload *> current{new Payload()};
+        std::atomic<bool> stop{false};
+        std::atomic<int> bad{0};
+        std::atomic<int64_t> blocks{0};
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < kReaders; ++r) {
+            readers.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    Reclaimer::Guard block(reclaimer);
+                    const Payload *p = current.load(std::memory_order_acquire);
+                    for (int i = 0; i < 64; ++i) {
+                        if (p->magic.load(std::memory_order_relaxed) != Payload::kAlive) bad.fetch_add(1);
+                    }
+                    blocks.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        while (blocks.load() < kReaders) std::this_thread::yield();   // readers are running
+        for (int i = 0; i < kSwaps; ++i) {
+            reclaimer.retire(current.exchange(new Payload(), std::memory_order_acq_rel));
+        }
+        stop.store(true);
+        for (auto &t : readers) t.join();
+        CHECK(bad.load() == 0);
+        CHECK(blocks.load() > 0);
+
+        for (int i = 0; i < 500 && reclaimer.pending() > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        CHECK(reclaimer.pending() == 0);
+        CHECK(reclaimer.freedCount() == kSwaps);
+        delete current.load();
+    }
+
+} // namespace
+
+int main() {
+    testGuardDefersFree();
+    testDeleterRetires();
+    testConcurrentReaders();
+    return testsupport::finish("reclaimer_test");
+}
@@ -0,0 +1,212 @@
+// RenderGraph: ordering, buffer reuse, cycles, silent-subgraph skipping, plan swaps.
+
+#include "RenderGraph.h"
+#include "TestSupport.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr int kFrames = RenderGraph::kMaxFrames;
+
+    // Writes a constant; sounding while `on`.
+    class ConstSource final : public RenderNode {
+    public:
+        ConstSource(const char *name, float value) : RenderNode(name), value_(value) {}
+        bool on = true;
+
+        bool active() const override { return on; }
+        bool process(const float *const *, int, float *out, int frames) override {
+            for (int i = 0; i < 2 * frames; ++i) out[i] = value_;
+            return on;
+        }
+
+    private:
+        float value_;
+    };
+
+    // out = sum(inputs) * factor; records the order it ran in.
+    class Scale final : public RenderNode {
+    public:
+        Scale(const char *name, float factor, std::vector<const RenderNode *> *trace = nullptr)
+                : RenderNode(name), factor_(factor), trace_(trace) {}
+
+        bool process(const float *const *inputs, int numInputs, float *out, int frames) override {
+            if (trace_) trace_->push_back(this);
+            for (int i = 0; i < 2 * frames; ++i) {
+                float s = 0.0f;
+                for (int k = 0; k < numInputs; ++k) s += inputs[k][i];
+                out[i] = s * factor_;
+            }
+            return numInputs > 0;
+        }
+
+    private:
+        float factor_;
+        std::vector<const RenderNode *> *trace_;
+    };
+
+    float renderOnce(RenderGraph &g) {
+        float out[2 * kFrames];
+        g.render(out, kFrames);
+        return out[0];
+    }
+
+    void testOrderAndMix() {
+        std::vector<const RenderNode *> trace;
+        ConstSource a("a", 1.0f), b("b", 2.0f);
+        Scale fxA("fxA", 10.0f, &trace), fxB("fxB", 100.0f, &trace);
+        MixNode master("master");
+        RenderGraph g;
+        // Add out of order: the schedule must follow edges, not ids.
+        const int m = g.addNode(&master);
+        const int fa = g.addNode(&fxA);
+        const int fb = g.addNode(&fxB);
+        const int na = g.addNode(&a);
+        const int nb = g.addNode(&b);
+        CHECK(g.connect(na, fa) && g.connect(nb, fb) && g.connect(fa, m) && g.connect(fb, m));
+        CHECK(!g.connect(m, m));
+        CHECK(g.setOutput(m));
+        CHECK(g.compile());
+        CHECK(g.plannedNodes() == 5);
+        CHECK_NEAR(renderOnce(g), 1.0 * 10 + 2.0 * 100, 1e-4);
+        CHECK(trace.size() == 2);
+
+        // Sources' buffers are reused by the effects: never more than 3 live at once.
+        CHECK(g.plannedBuffers() <= 3);
+        CHECK(a.stats().runs == 1 && master.stats().runs == 1);
+    }
+
+    void testChainReusesTwoBuffers() {
+        ConstSource src("src", 1.0f);
+        std::vector<Scale *> chain;
+        RenderGraph g;
+        int prev = g.addNode(&src);
+        for (int i = 0; i < 20; ++i) {
+            chain.push_back(new Scale("gain", 1.1f));
+            const int id = g.addNode(chain.back());
+            CHECK(g.connect(prev, id));
+            prev = id;
+        }
+        CHECK(g.setOutput(prev));
+        CHECK(g.compile());
+        CHECK(g.plannedNodes() == 21);
+        CHECK(g.plannedBuffers() == 2);
+        CHECK_NEAR(renderOnce(g), std::pow(1.1, 20), 1e-3);
+        for (Scale *s : chain) delete s;
+    }
+
+    void testCycleAndUnreachable() {
+        ConstSource src("src", 1.0f), orphan("orphan", 5.0f);
+        Scale x("x", 1.0f), y("y", 1.0f);
+        MixNode master("master");
+        RenderGraph g;
+        const int s = g.addNode(&src), o = g.addNode(&orphan);
+        const int nx = g.addNode(&x), ny = g.addNode(&y), m = g.addNode(&master);
+        (void) o;
+        CHECK(!g.compile());   // no output yet
+        g.connect(s, m);
+        g.setOutput(m);
+        CHECK(g.compile());
+        CHECK(g.plannedNodes() == 2);   // the orphan and x/y do not feed the master
+        renderOnce(g);
+        CHECK(orphan.stats().runs == 0 && orphan.stats().skips == 0);
+
+        g.connect(nx, ny);
+        g.connect(ny, nx);
+        g.connect(ny, m);
+        CHECK(!g.compile());   // x <-> y cycle
+        CHECK(g.plannedNodes() == 2);   // previous plan still live
+        CHECK_NEAR(renderOnce(g), 1.0, 1e-6);
+        CHECK(g.disconnect(ny, nx));
+        CHECK(!g.disconnect(ny, nx));
+        CHECK(g.compile());
+        CHECK(g.plannedNodes() == 4);
+    }
+
+    void testSilentSubgraphSkipped() {
+        ConstSource a("a", 1.0f), b("b", 3.0f);
+        Scale fxB("fxB", 2.0f), post("post", 1.0f);
+        MixNode master("master");
+        RenderGraph g;
+        const int na = g.addNode(&a), nb = g.addNode(&b);
+        const int fb = g.addNode(&fxB), p = g.addNode(&post), m = g.addNode(&master);
+        g.connect(nb, fb);
+        g.connect(fb, p);
+        g.connect(na, m);
+        g.connect(p, m);
+        g.setOutput(m);
+        CHECK(g.compile());
+
+        CHECK_NEAR(renderOnce(g), 1.0 + 6.0, 1e-6);
+        CHECK(g.lastRun() == 5 && g.lastSkipped() == 0);
+
+        // b goes quiet: b, fxB and post are skipped, the master still mixes a.
+        b.on = false;
+        CHECK_NEAR(renderOnce(g), 1.0, 1e-6);
+        CHECK(g.lastRun() == 2 && g.lastSkipped() == 3);
+        CHECK(fxB.stats().skips == 1 && fxB.stats().runs == 1);
+
+        // Everything quiet: silent output, nothing runs.
+        a.on = false;
+        float out[2 * kFrames];
+        for (float &v : out) v = 9.0f;
+        CHECK(!g.render(out, kFrames));
+        CHECK(out[0] == 0.0f && out[2 * kFrames - 1] == 0.0f);
+        CHECK(g.lastRun() == 0 && g.lastSkipped() == 5);
+        CHECK(master.stats().nanos > 0);
+    }
+
+    void testSwapWhileRendering() {
+        ConstSource one("one", 1.0f), two("two", 2.0f);
+        MixNode master("master");
+        Reclaimer reclaimer;
+        RenderGraph g(reclaimer);
+        const int n1 = g.addNode(&one), n2 = g.addNode(&two), m = g.addNode(&master);
+        g.connect(n1, m);
+        g.setOutput(m);
+        CHECK(g.compile());
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> bad{0};
+        std::thread audio([&] {
+            float out[2 * kFrames];
+            while (!stop.load(std::memory_order_relaxed)) {
+                Reclaimer::Guard block(reclaimer);
+                g.render(out, kFrames);
+                if (out[0] != 1.0f && out[0] != 3.0f) bad.fetch_add(1);
+            }
+        });
+        // Recompile between the two topologies; retired plans are freed by the reclaimer as
+        // the audio thread moves on, so a use-after-free would show as garbage (or under ASan).
+        for (int i = 0; i < 2000; ++i) {
+            if (i & 1) g.disconnect(n2, m); else g.connect(n2, m);
+            CHECK(g.compile());
+        }
+        stop.store(true);
+        audio.join();
+        CHECK(bad.load() == 0);
+
+        // Every replaced plan is freed once the housekeeping thread has caught up.
+        for (int i = 0; i < 500 && reclaimer.pending() > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        CHECK(reclaimer.pending() == 0);
+        CHECK(reclaimer.freedCount() == 2000);
+    }
+
+} // namespace
+
+int main() {
+    testOrderAndMix();
+    testChainReusesTwoBuffers();
+    testCycleAndUnreachable();
+    testSilentSubgraphSkipped();
+    testSwapWhileRendering();
+    return testsupport::finish("render_graph_test");
+}
@@ -0,0 +1,247 @@
+// SmfRecorder: MIDI 1.0 encoding, delta times, per-channel tracks and concurrent recording.
+
+#include "SmfRecorder.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const std::string kPath = "/tmp/smf_recorder_test.mid";
+
+    struct TrackEvent {
+        uint32_t tick = 0;              // absolute
+        std::vector<uint8_t> bytes;     // status and data, or FF type data for meta events
+    };
+
+    struct Smf {
+        int format = -1;
+        int division = 0;
+        std::vector<std::vector<TrackEvent>> tracks;
+    };
+
+    uint32_t bigEndian(const std::vector<uint8_t> &b, size_t at, int n) {
+        uint32_t v = 0;
+        for (int i = 0; i < n; ++i) v = (v << 8) | b[at + static_cast<size_t>(i)];
+        return v;
+    }
+
+    uint32_t varLen(const std::vector<uint8_t> &b, size_t &at) {
+        uint32_t v = 0;
+        while (at < b.size()) {
+            const uint8_t c = b[at++];
+            v = (v << 7) | (c & 0x7F);
+            if (!(c & 0x80)) break;
+        }
+        return v;
+    }
+
+    // Just enough of an SMF reader for what SmfRecorder writes (no running status, no sysex).
+    bool readSmf(const std::string &path, Smf &out) {
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        std::vector<uint8_t> b;
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) b.insert(b.end(), buf, buf + n);
+        std::fclose(f);
+
+        if (b.size() < 14 || std::string(b.begin(), b.begin() + 4) != "MThd" || bigEndian(b, 4, 4) != 6) return false;
+        out.format = static_cast<int>(bigEndian(b, 8, 2));
+        const uint32_t ntrks = bigEndian(b, 10, 2);
+        out.division = static_cast<int>(bigEndian(b, 12, 2));
+        size_t at = 14;
+        for (uint32_t t = 0; t < ntrks; ++t) {
+            if (at + 8 > b.size() || std::string(b.begin() + static_cast<long>(at), b.begin() + static_cast<long>(at) + 4) != "MTrk") {
+                return false;
+            }
+            const size_t end = at + 8 + bigEndian(b, at + 4, 4);
+            if (end > b.size()) return false;
+            at += 8;
+            std::vector<TrackEvent> events;
+            uint32_t tick = 0;
+            while (at < end) {
+                tick += varLen(b, at);
+                TrackEvent e;
+                e.tick = tick;
+                const uint8_t status = b[at];
+                size_t len;
+                if (status == 0xFF) {
+                    size_t p = at + 2;
+                    const uint32_t metaLen = varLen(b, p);
+                    len = p - at + metaLen;
+                } else {
+                    len = (status & 0xF0) == 0xD0 || (status & 0xF0) == 0xC0 ? 2 : 3;
+                }
+                e.bytes.assign(b.begin() + static_cast<long>(at), b.begin() + static_cast<long>(at + len));
+                at += len;
+                events.push_back(std::move(e));
+            }
+            if (at != end) return false;
+            out.tracks.push_back(std::move(events));
+        }
+        return at == b.size();
+    }
+
+    bool isEndOfTrack(const TrackEvent &e) {
+        return e.bytes.size() == 3 && e.bytes[0] == 0xFF && e.bytes[1] == 0x2F;
+    }
+
+    int64_t ticksToNanos(uint32_t ticks) {
+        return static_cast<int64_t>(ticks) * SmfRecorder::kMicrosPerQuarter * 1000 / SmfRecorder::kTicksPerQuarter;
+    }
+
+    bool fileExists(const std::string &path) {
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        if (f) std::fclose(f);
+        return f != nullptr;
+    }
+
+    void testMidi1Encoding() {
+        uint8_t m[3];
+        CHECK(SmfRecorder::toMidi1(EngineEvent::noteOn(3, 60, 100), m) == 3);
+        CHECK(m[0] == 0x93 && m[1] == 60 && m[2] == 100);
+        CHECK(SmfRecorder::toMidi1(EngineEvent::noteOff(15, 61), m) == 3);
+        CHECK(m[0] == 0x8F && m[1] == 61 && m[2] == 0);
+        CHECK(SmfRecorder::toMidi1(EngineEvent::pitchBend(1, 8192 + 5), m) == 3);
+        CHECK(m[0] == 0xE1 && m[1] == 5 && m[2] == 64);
+        CHECK(SmfRecorder::toMidi1(EngineEvent::channelPressure(2, 77), m) == 2);
+        CHECK(m[0] == 0xD2 && m[1] == 77);
+        CHECK(SmfRecorder::toMidi1(EngineEvent::controlChange(0, 74, 127), m) == 3);
+        CHECK(m[0] == 0xB0 && m[1] == 74 && m[2] == 127);
+
+        // MIDI 2.0 values are reduced; a zero 16-bit velocity still sounds.
+        EngineEvent hi = EngineEvent::noteOn(4, 62, 0);
+        hi.flags = EngineEvent::kFlagHighRes;
+        hi.value = 0;
+        SmfRecorder::toMidi1(hi, m);
+        CHECK(m[0] == 0x94 && m[2] == 1);
+        hi.value = 0xFFFF;
+        SmfRecorder::toMidi1(hi, m);
+        CHECK(m[2] == 127);
+        hi.type = EngineEvent::kPitchBend;
+        hi.value = 0x80000000u;
+        SmfRecorder::toMidi1(hi, m);
+        CHECK(m[0] == 0xE4 && m[1] == 0 && m[2] == 64);
+        hi.type = EngineEvent::kChannelPressure;
+        hi.value = 0xFFFFFFFFu;
+        CHECK(SmfRecorder::toMidi1(hi, m) == 2 && m[1] == 127);
+
+        CHECK(SmfRecorder::toTicks(-5) == 0);
+        CHECK(SmfRecorder::toTicks(500000000) == static_cast<uint32_t>(SmfRecorder::kTicksPerQuarter));
+    }
+
+    void testTracksAndTiming() {
+        std::remove(kPath.c_str());
+        SmfRecorder smf;
+        CHECK(!smf.stop());                           // nothing running
+        CHECK(!smf.start("/nonexistent-dir/take.mid"));
+        smf.recordAt(EngineEvent::noteOn(0, 1, 1), 0); // inactive: ignored
+        CHECK(smf.start(kPath));
+        CHECK(!smf.start(kPath));                     // one export at a time
+
+        // Two MPE member channels and a controller on a third, at known times (ms).
+        struct Timed { int64_t ms; EngineEvent e; };
+        const Timed events[] = {
+                {10, EngineEvent::noteOn(1, 60, 100)},
+                {12, EngineEvent::noteOn(2, 64, 90)},
+                {15, EngineEvent::pitchBend(1, 9000)},
+                {20, EngineEvent::channelPressure(2, 50)},
+                {250, EngineEvent::controlChange(5, 74, 30)},
+                {500, EngineEvent::noteOff(1, 60)},
+                {1000, EngineEvent::noteOff(2, 64)},
+        };
+        for (const Timed &t : events) smf.recordAt(t.e, t.ms * 1000000);
+        CHECK(smf.stop());
+        CHECK(!smf.active());
+        CHECK(smf.writtenCount() == sizeof(events) / sizeof(events[0]));
+        CHECK(smf.droppedCount() == 0);
+        for (int ch = 1; ch <= SmfRecorder::kChannels; ++ch) CHECK(!fileExists(kPath + ".ch" + std::to_string(ch)));
+
+        Smf file;
+        CHECK(readSmf(kPath, file));
+        CHECK(file.format == 1);
+        CHECK(file.division == SmfRecorder::kTicksPerQuarter);
+        CHECK(file.tracks.size() == 4);               // tempo + channels 2, 3, 6
+        if (file.tracks.size() != 4) return;
+
+        // Every track ends at the same tick, past the last event.
+        const uint32_t endTick = file.tracks[0].back().tick;
+        CHECK(endTick >= SmfRecorder::toTicks(1000 * 1000000LL));
+        for (const auto &track : file.tracks) {
+            CHECK(!track.empty() && isEndOfTrack(track.back()));
+            CHECK(track.back().tick == endTick);
+        }
+
+        // Events land in their channel's track, in order, within a tick of their time.
+        const uint8_t channelOfTrack[4] = {0xFF, 1, 2, 5};
+        size_t seen = 0;
+        for (size_t t = 1; t < file.tracks.size(); ++t) {
+            size_t next = 0;
+            for (const TrackEvent &e : file.tracks[t]) {
+                if (e.bytes[0] == 0xFF) continue;
+                CHECK((e.bytes[0] & 0x0F) == channelOfTrack[t]);
+                while (next < sizeof(events) / sizeof(events[0]) && events[next].e.channel != channelOfTrack[t]) ++next;
+                if (next == sizeof(events) / sizeof(events[0])) {
+                    CHECK(false);
+                    break;
+                }
+                uint8_t expected[3];
+                const int n = SmfRecorder::toMidi1(events[next].e, expected);
+                CHECK(e.bytes.size() == static_cast<size_t>(n));
+                CHECK(std::equal(e.bytes.begin(), e.bytes.end(), expected));
+                CHECK_NEAR(static_cast<double>(ticksToNanos(e.tick)), events[next].ms * 1e6, 0.6e6);
+                ++next;
+                ++seen;
+            }
+        }
+        CHECK(seen == sizeof(events) / sizeof(events[0]));
+    }
+
+    void testConcurrentRecording() {
+        std::remove(kPath.c_str());
+        SmfRecorder smf;
+        CHECK(smf.start(kPath));
+        constexpr int kThreads = 4;
+        constexpr int kPerThread = 2000;   // fewer than the queue holds in one writer period
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&smf, t] {
+                for (int i = 0; i < kPerThread; ++i) smf.record(EngineEvent::pitchBend(t, i));
+            });
+        }
+        for (auto &th : threads) th.join();
+        CHECK(smf.stop());
+        CHECK(smf.writtenCount() + smf.droppedCount() == kThreads * kPerThread);
+
+        Smf file;
+        CHECK(readSmf(kPath, file));
+        CHECK(file.tracks.size() == 1 + kThreads);
+        uint64_t events = 0;
+        for (size_t t = 1; t < file.tracks.size(); ++t) {
+            // One producer per channel: its bends arrive in order.
+            int last = -1;
+            for (const TrackEvent &e : file.tracks[t]) {
+                if (e.bytes[0] == 0xFF) continue;
+                const int bend = e.bytes[1] | (e.bytes[2] << 7);
+                CHECK(bend > last);
+                last = bend;
+                ++events;
+            }
+        }
+        CHECK(events == smf.writtenCount());
+        std::remove(kPath.c_str());
+    }
+
+} // namespace
+
+int main() {
+    testMidi1Encoding();
+    testTracksAndTiming();
+    testConcurrentRecording();
+    return testsupport::finish("smf_recorder_test");
+}
@@ -0,0 +1,146 @@
+// StreamDecoder: chunked WAV decoding against the whole-buffer parser, header checks and
+// failure reporting.
+
+#include "StreamDecoder.h"
+#include "TestSupport.h"
+#include "WavWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::string tempPath(const char *name) {
+        return std::string("/tmp/stream_decoder_test_") + name;
+    }
+
+    std::vector<uint8_t> readAll(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    bool writeAll(const std::string &path, const std::vector<uint8_t> &bytes) {
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        return std::fclose(f) == 0 && ok;
+    }
+
+    std::vector<float> tone(size_t frames, int channels) {
+        std::vector<float> v(frames * static_cast<size_t>(channels));
+        for (size_t i = 0; i < frames; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                v[i * channels + c] = 0.5f * static_cast<float>(std::sin(0.01 * static_cast<double>(i) * (c + 1)));
+            }
+        }
+        return v;
+    }
+
+    // Every frame the stream delivers, in reads of at most maxFrames.
+    std::vector<float> drain(pcm::StreamDecoder &d, size_t maxFrames) {
+        std::vector<float> all;
+        std::vector<float> chunk(maxFrames);
+        while (const size_t n = d.read(chunk.data(), maxFrames)) {
+            CHECK(n <= maxFrames && n <= pcm::StreamDecoder::kChunkFrames);
+            all.insert(all.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(n));
+        }
+        return all;
+    }
+
+    void testWavMatchesWholeFileParse() {
+        // Longer than several chunks and not a multiple of one.
+        constexpr size_t kFrames = 3 * pcm::StreamDecoder::kChunkFrames + 123;
+        const std::string int16Path = tempPath("int16.wav");
+        const std::string floatPath = tempPath("float.wav");
+        CHECK(wavwriter::writeInt16(int16Path, tone(kFrames, 2), 2, 48000));
+        CHECK(wavwriter::writeFloat32(floatPath, tone(kFrames, 3), 3, 22050));
+
+        for (const std::string &path : {int16Path, floatPath}) {
+            const std::vector<uint8_t> bytes = readAll(path);
+            pcm::WavInfo info;
+            CHECK(pcm::parseWav(bytes.data(), bytes.size(), info));
+            std::vector<float> want(info.frames);
+            pcm::downmixToMono(info.data, info.format, info.channels, info.frames, want.data());
+
+            for (const size_t maxFrames : {size_t{1000}, pcm::StreamDecoder::kChunkFrames, size_t{100000}}) {
+                auto d = pcm::StreamDecoder::open(path);
+                CHECK(d != nullptr);
+                if (!d) continue;
+                CHECK(d->channels() == info.channels);
+                CHECK(d->sampleRate() == info.sampleRate);
+                CHECK(d->frameCountHint() == kFrames);
+                const std::vector<float> got = drain(*d, maxFrames);
+                CHECK(!d->failed());
+                CHECK(got == want);
+                CHECK(d->read(nullptr, 16) == 0);   // stays at the end
+            }
+        }
+    }
+
+    void testWavChunkWalk() {
+        // An odd-sized chunk (padded to even) before fmt, and one between fmt and data.
+        std::vector<uint8_t> b = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+                                  'j', 'u', 'n', 'k', 3, 0, 0, 0, 1, 2, 3, 0,
+                                  'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1, 0, 0x44, 0xAC, 0, 0,
+                                  0x88, 0x58, 1, 0, 2, 0, 16, 0,
+                                  'L', 'I', 'S', 'T', 2, 0, 0, 0, 9, 9,
+                                  'd', 'a', 't', 'a', 6, 0, 0, 0, 0x00, 0x40, 0x00, 0xC0, 0xFF, 0x7F};
+        const std::string path = tempPath("chunks.wav");
+        CHECK(writeAll(path, b));
+        auto d = pcm::StreamDecoder::open(path);
+        CHECK(d != nullptr);
+        if (d) {
+            CHECK(d->sampleRate() == 44100 && d->channels() == 1);
+            const std::vector<float> got = drain(*d, 64);
+            CHECK(got.size() == 3 && !d->failed());
+            if (got.size() == 3) {
+                CHECK(got[0] == 0.5f && got[1] == -0.5f);
+                CHECK_NEAR(got[2], 32767.0 / 32768.0, 1e-7);
+            }
+        }
+
+        // Truncated: the data chunk promises more than the file holds.
+        b.resize(b.size() - 2);
+        CHECK(writeAll(path, b));
+        d = pcm::StreamDecoder::open(path);
+        CHECK(d != nullptr);
+        if (d) {
+            CHECK(drain(*d, 64).size() == 2);
+            CHECK(d->failed());
+        }
+    }
+
+    void testRejects() {
+        CHECK(pcm::StreamDecoder::open(tempPath("missing.wav")) == nullptr);
+
+        const std::string path = tempPath("garbage.bin");
+        CHECK(writeAll(path, {'n', 'o', 't', ' ', 'a', 'u', 'd', 'i', 'o', '!', '!', '!'}));
+        CHECK(pcm::StreamDecoder::open(path) == nullptr);
+
+        // 24-bit PCM: recognised as WAV but not a supported sample format.
+        CHECK(wavwriter::detail::write(path, 1, 24, 1, 44100, {0, 0, 0, 1, 2, 3}));
+        CHECK(pcm::StreamDecoder::open(path) == nullptr);
+    }
+
+    void testNotWav() {
+        // Compressed files are decoded by the app, never here; nor is a truncated header.
+        const std::string path = tempPath("fake.ogg");
+        CHECK(writeAll(path, {'O', 'g', 'g', 'S', 0, 2, 0, 0, 0, 0, 0, 0}));
+        CHECK(pcm::StreamDecoder::open(path) == nullptr);
+        CHECK(writeAll(path, {'R', 'I', 'F', 'F', 1, 2, 3, 4}));
+        CHECK(pcm::StreamDecoder::open(path) == nullptr);
+    }
+
+} // namespace
+
+int main() {
+    testWavMatchesWholeFileParse();
+    testWavChunkWalk();
+    testRejects();
+    testNotWav();
+    return testsupport::finish("stream_decoder_test");
+}
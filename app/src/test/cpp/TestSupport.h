@@ -0,0 +1,41 @@
+#pragma once
+
+// Minimal assertion helpers for the host-side native tests (no external test framework).
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace testsupport {
+    inline int &failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline int finish(const char *suite) {
+        if (failures() == 0) {
+            std::printf("[%s] OK\n", suite);
+            return 0;
+        }
+        std::printf("[%s] %d failure(s)\n", suite, failures());
+        return 1;
+    }
+}
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);      \
+            ++testsupport::failures();                                               \
+        }                                                                            \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tol)                                            \
+    do {                                                                             \
+        const double a_ = (actual), e_ = (expected);                                 \
+        if (!(std::fabs(a_ - e_) <= (tol))) {                                        \
+            std::printf("%s:%d: CHECK_NEAR failed: %s = %.9g, expected %.9g (tol %g)\n", \
+                        __FILE__, __LINE__, #actual, a_, e_, static_cast<double>(tol)); \
+            ++testsupport::failures();                                               \
+        }                                                                            \
+    } while (0)
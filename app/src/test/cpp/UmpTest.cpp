@@ -0,0 +1,132 @@
+// UMP decoding into engine events and high-resolution values through the coalescer.
+
+#include "ControlCoalescer.h"
+#include "TestSupport.h"
+#include "Ump.h"
+
+#include <cstdint>
+
+namespace {
+
+    constexpr uint32_t midi2(uint32_t opcode, uint32_t channel, uint32_t index, uint32_t index2 = 0) {
+        return (0x4u << 28) | (opcode << 20) | (channel << 16) | (index << 8) | index2;
+    }
+
+    void testPacketSizes() {
+        CHECK(ump::packetWords(0x00000000u) == 1);  // utility
+        CHECK(ump::packetWords(0x20903C64u) == 1);  // MIDI 1.0 channel voice
+        CHECK(ump::packetWords(midi2(0x9, 0, 60)) == 2);
+        CHECK(ump::packetWords(0x30000000u) == 2);  // 7-bit data (SysEx)
+        CHECK(ump::packetWords(0x50000000u) == 4);  // 8-bit data
+        CHECK(ump::packetWords(0xF0000000u) == 4);  // stream
+    }
+
+    void testMidi2ChannelVoice() {
+        EngineEvent e;
+        uint32_t p[2] = {midi2(0x9, 5, 64), 0xABCD0000u};
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(e.type == EngineEvent::kNoteOn && e.channel == 5 && e.data1 == 64);
+        CHECK(e.flags == EngineEvent::kFlagHighRes);
+        CHECK(e.value == 0xABCD);
+
+        // Zero velocity is a sounding note in MIDI 2.0.
+        CHECK(ump::velocity16To7Bit(0) == 1);
+        CHECK(ump::velocity16To7Bit(0xFFFF) == 127);
+
+        p[0] = midi2(0x6, 3, 60);  // per-note pitch bend -> channel bend
+        p[1] = 0x80000001u;
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(e.type == EngineEvent::kPitchBend && e.channel == 3 && e.value == 0x80000001u);
+        CHECK_NEAR(e.value * static_cast<double>(ump::kToBend14), 8192.0, 1e-3);
+
+        p[0] = midi2(0xA, 3, 60);  // poly pressure -> channel pressure
+        p[1] = 0xFFFFFFFFu;
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(e.type == EngineEvent::kChannelPressure && e.value == 0xFFFFFFFFu);
+        CHECK(ump::to7Bit(e.value) == 127);
+
+        p[0] = midi2(0x1, 3, 60, 74);  // assignable per-note controller 74 -> brightness
+        p[1] = 0x40000000u;
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(e.type == EngineEvent::kControlChange && e.data1 == 74 && e.value == 0x40000000u);
+
+        p[0] = midi2(0xB, 0, 1);
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(e.type == EngineEvent::kControlChange && e.data1 == 1);
+
+        p[0] = midi2(0xE, 0, 0);
+        p[1] = ump::kBendCentre;
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(e.type == EngineEvent::kPitchBend && ump::to14Bit(e.value) == 8192);
+
+        // Not handled: registered per-note controllers, program change, per-note management.
+        p[0] = midi2(0x0, 0, 60, 3);
+        CHECK(!ump::toEvent(p, 2, e));
+        p[0] = midi2(0xC, 0, 0);
+        CHECK(!ump::toEvent(p, 2, e));
+        p[0] = midi2(0xF, 0, 60);
+        CHECK(!ump::toEvent(p, 2, e));
+
+        // Truncated packet.
+        p[0] = midi2(0x9, 0, 60);
+        CHECK(!ump::toEvent(p, 1, e));
+    }
+
+    void testMidi1ChannelVoice() {
+        EngineEvent e;
+        const uint32_t noteOn = 0x20923C64u;  // group 0, note on ch 2, note 60, vel 100
+        CHECK(ump::toEvent(&noteOn, 1, e));
+        CHECK(e.type == EngineEvent::kNoteOn && e.channel == 2 && e.data1 == 60 && e.value == 100);
+        CHECK(e.flags == 0);
+
+        const uint32_t bend = 0x20E17F40u;    // lsb 0x7F, msb 0x40
+        CHECK(ump::toEvent(&bend, 1, e));
+        CHECK(e.type == EngineEvent::kPitchBend && e.channel == 1 && e.value == (0x40u << 7 | 0x7Fu));
+
+        const uint32_t utility = 0x00000000u;
+        CHECK(!ump::toEvent(&utility, 1, e));
+    }
+
+    void testCoalescerKeepsResolution() {
+        ControlCoalescer c;
+        EngineEvent e;
+        const uint32_t p[2] = {midi2(0xD, 4, 0), 0x12345678u};
+        CHECK(ump::toEvent(p, 2, e));
+        CHECK(c.absorb(e));
+
+        // A later MIDI 1.0 value in the same block replaces both value and flags.
+        EngineEvent bend1;
+        bend1.type = EngineEvent::kPitchBend;
+        bend1.channel = 4;
+        bend1.value = 9000;
+        CHECK(c.absorb(bend1));
+        const uint32_t bend2[2] = {midi2(0xE, 4, 0), 0x90000000u};
+        CHECK(ump::toEvent(bend2, 2, e));
+        CHECK(c.absorb(e));
+
+        int calls = 0;
+        c.flush([&](int ch, int slot, uint32_t value, uint8_t flags) {
+            ++calls;
+            CHECK(ch == 4);
+            CHECK(flags == EngineEvent::kFlagHighRes);
+            if (slot == ControlCoalescer::kSlotPressure) {
+                CHECK(value == 0x12345678u);
+                // Far finer than one 7-bit step survives the conversion to smoother units.
+                CHECK_NEAR(value * static_cast<double>(ump::kTo7Bit), 0x12345678 / 33554432.0, 1e-5);
+            } else {
+                CHECK(slot == ControlCoalescer::kSlotBend);
+                CHECK(value == 0x90000000u);
+            }
+        });
+        CHECK(calls == 2);
+    }
+
+} // namespace
+
+int main() {
+    testPacketSizes();
+    testMidi2ChannelVoice();
+    testMidi1ChannelVoice();
+    testCoalescerKeepsResolution();
+    return testsupport::finish("ump_test");
+}
@@ -0,0 +1,140 @@
+// UnisonVoice: pitch, detune layout, power and stereo balance, envelope, determinism.
+
+#include "BuiltinTables.h"
+#include "DspKernels.h"
+#include "TestSupport.h"
+#include "UnisonVoice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kRate = 48000.0;
+
+    UnisonVoice::Params params(int copies, float detuneCents, float spread) {
+        UnisonVoice::Params p;
+        p.copies = copies;
+        p.detuneCents = detuneCents;
+        p.spread = spread;
+        p.attackMs = 1.0f;
+        p.sustain = 1.0f;
+        p.releaseMs = 20.0f;
+        return p;
+    }
+
+    std::vector<float> render(UnisonVoice &voice, const Wavetable &table, int note, int frames, int chunk = 192) {
+        std::vector<float> out(static_cast<size_t>(frames) * 2, 0.0f);
+        const float inc = builtin::noteIncrement(note, kRate);
+        for (int i = 0; i < frames; i += chunk) {
+            voice.render(table, inc, 20000.0f, 1.0f, kRate, out.data() + 2 * i, std::min(chunk, frames - i));
+        }
+        return out;
+    }
+
+    // Hann-windowed single-bin amplitude of channel ch at hz.
+    double amplitude(const std::vector<float> &x, int ch, int start, int count, double hz) {
+        double re = 0.0, im = 0.0;
+        const double f = hz / kRate;
+        for (int i = 0; i < count; ++i) {
+            const double w = 0.5 - 0.5 * std::cos(2.0 * kPi * i / count);
+            const double s = x[static_cast<size_t>(2 * (start + i) + ch)] * w;
+            re += s * std::cos(2.0 * kPi * f * i);
+            im -= s * std::sin(2.0 * kPi * f * i);
+        }
+        return 2.0 * std::sqrt(re * re + im * im) / (0.5 * count);
+    }
+
+    double rms(const std::vector<float> &x, int ch, int start, int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) sum += static_cast<double>(x[static_cast<size_t>(2 * (start + i) + ch)]) * x[static_cast<size_t>(2 * (start + i) + ch)];
+        return std::sqrt(sum / count);
+    }
+
+    const Wavetable &sine() {
+        static const auto t = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSine));
+        return *t;
+    }
+
+    const Wavetable &saw() {
+        static const auto t = Wavetable::wrap(builtin::waveStack(builtin::Shape::kSaw));
+        return *t;
+    }
+
+    void testSingleCopyPitch() {
+        UnisonVoice voice;
+        voice.noteOn(params(1, 0.0f, 0.0f), 69, 1.0f, 1);
+        CHECK(voice.active() && voice.held() && voice.note() == 69 && voice.copies() == 1);
+        const auto out = render(voice, sine(), 69, 12000);
+        // Centre pan: equal-power -3 dB per side.
+        CHECK_NEAR(amplitude(out, 0, 2400, 8192, 440.0), std::sqrt(0.5), 0.02);
+        CHECK_NEAR(amplitude(out, 1, 2400, 8192, 440.0), std::sqrt(0.5), 0.02);
+        CHECK(amplitude(out, 0, 2400, 8192, 880.0) < 1e-3);
+    }
+
+    void testDetuneLayout() {
+        // Two copies at +/- an octave: the centre pitch itself must be absent.
+        UnisonVoice voice;
+        voice.noteOn(params(2, 1200.0f, 0.0f), 69, 1.0f, 7);
+        const auto out = render(voice, sine(), 69, 12000);
+        CHECK_NEAR(amplitude(out, 0, 2400, 8192, 220.0), 0.5, 0.02);
+        CHECK_NEAR(amplitude(out, 0, 2400, 8192, 880.0), 0.5, 0.02);
+        CHECK(amplitude(out, 0, 2400, 8192, 440.0) < 5e-3);
+    }
+
+    void testPowerAndBalance() {
+        UnisonVoice single, stack;
+        single.noteOn(params(1, 0.0f, 0.0f), 57, 1.0f, 3);
+        stack.noteOn(params(UnisonVoice::kMaxCopies, 30.0f, 1.0f), 57, 1.0f, 3);
+        CHECK(stack.copies() == UnisonVoice::kMaxCopies);
+        const auto a = render(single, saw(), 57, 48000);
+        const auto b = render(stack, saw(), 57, 48000);
+        const double singleRms = rms(a, 0, 4800, 43200);
+        const double leftRms = rms(b, 0, 4800, 43200), rightRms = rms(b, 1, 4800, 43200);
+        // Incoherent copies with 1/sqrt(N) gains keep the power of a single voice.
+        CHECK(std::fabs(20.0 * std::log10(leftRms / singleRms)) < 3.0);
+        CHECK(std::fabs(20.0 * std::log10(leftRms / rightRms)) < 1.5);
+        float peak = 0.0f;
+        for (float s : b) peak = std::max(peak, std::fabs(s));
+        CHECK(peak < 2.0f);
+    }
+
+    void testEnvelopeAndChunking() {
+        UnisonVoice a, b;
+        a.noteOn(params(5, 15.0f, 0.5f), 60, 0.8f, 11);
+        b.noteOn(params(5, 15.0f, 0.5f), 60, 0.8f, 11);
+        const auto whole = render(a, saw(), 60, 4800, 4800);
+        const auto pieces = render(b, saw(), 60, 4800, 37);
+        CHECK(whole == pieces);
+
+        a.noteOff();
+        CHECK(a.active() && !a.held());
+        // 20 ms release reaches -80 dB in about 9 time constants.
+        const auto tail = render(a, saw(), 60, 9600);
+        CHECK(!a.active());
+        CHECK(rms(tail, 0, 9000, 600) == 0.0);
+
+        // Same seed, same output; another seed moves the copy phases.
+        UnisonVoice c;
+        c.noteOn(params(5, 15.0f, 0.5f), 60, 0.8f, 12);
+        const auto other = render(c, saw(), 60, 4800, 4800);
+        CHECK(other != whole);
+    }
+
+} // namespace
+
+int main() {
+    // Once per DSP kernel variant this CPU can run.
+    for (int i = 0; i < static_cast<int>(dsp::Isa::kCount); ++i) {
+        if (!dsp::bind(static_cast<dsp::Isa>(i))) continue;
+        std::printf("[unison_voice_test] %s\n", dsp::isaName(static_cast<dsp::Isa>(i)));
+        testSingleCopyPitch();
+        testDetuneLayout();
+        testPowerAndBalance();
+        testEnvelopeAndChunking();
+    }
+    return testsupport::finish("unison_voice_test");
+}
@@ -0,0 +1,119 @@
+// vis::Tap / TripleBuffer: the reader always gets the newest complete frame, never a torn one,
+// while the writer publishes concurrently; block measurements and the scope history.
+
+#include "TestSupport.h"
+#include "Visualization.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    void testTripleBuffer() {
+        vis::TripleBuffer<int> b;
+        CHECK(!b.consume());
+        b.back() = 1;
+        b.publish();
+        b.back() = 2;
+        b.publish();
+        CHECK(b.consume());
+        CHECK(b.front() == 2);     // only the newest survives
+        CHECK(!b.consume());
+        CHECK(b.front() == 2);
+        b.back() = 3;
+        b.publish();
+        CHECK(b.consume() && b.front() == 3);
+    }
+
+    void testMeasurements() {
+        vis::Tap tap;
+        vis::Frame f;
+        CHECK(tap.read(&f) == 0);
+
+        // L: constant 0.5; R: alternating +/-1.
+        constexpr int kFrames = 96;
+        std::vector<float> block(2 * kFrames);
+        for (int i = 0; i < kFrames; ++i) {
+            block[2 * i] = 0.5f;
+            block[2 * i + 1] = i % 2 ? -1.0f : 1.0f;
+        }
+        float levels[vis::kChannels] = {};
+        levels[3] = 0.25f;
+        tap.publish(block.data(), kFrames, levels, 5);
+        CHECK(tap.read(&f) == 1);
+        CHECK(f.sequence == 1 && f.activeVoices == 5);
+        CHECK_NEAR(f.rms[0], 0.5, 1e-6);
+        CHECK_NEAR(f.rms[1], 1.0, 1e-6);
+        CHECK_NEAR(f.peak[0], 0.5, 1e-6);
+        CHECK_NEAR(f.peak[1], 1.0, 1e-6);
+        CHECK(f.channelLevel[3] == 0.25f && f.channelLevel[0] == 0.0f);
+        // 96 frames -> 24 scope points of (0.5 + mean(R)) / 2 = 0.25, newest last.
+        CHECK(f.scope[vis::kScopePoints - 1] == 0.25f && f.scope[vis::kScopePoints - 24] == 0.25f);
+        CHECK(f.scope[vis::kScopePoints - 25] == 0.0f);
+
+        // Reading again returns the same frame.
+        CHECK(tap.read(&f) == 1);
+
+        // The scope keeps kScopePoints points across blocks, oldest first.
+        for (int b = 0; b < 20; ++b) {
+            for (int i = 0; i < kFrames; ++i) {
+                const float v = static_cast<float>(b) / 100.0f;
+                block[2 * i] = v;
+                block[2 * i + 1] = v;
+            }
+            tap.publish(block.data(), kFrames, levels, 0);
+        }
+        CHECK(tap.read(&f) == 21);
+        CHECK_NEAR(f.scope[vis::kScopePoints - 1], 0.19, 1e-6);
+        CHECK_NEAR(f.scope[0], 0.09, 1e-6);   // 256 points = blocks 9..19 (the first 8 of block 9)
+    }
+
+    // A writer thread publishes frames whose every field is derived from one value; the
+    // reader must only ever see self-consistent frames with non-decreasing sequences.
+    void testConcurrent() {
+        vis::Tap tap;
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            std::vector<float> block(2 * 64);
+            float levels[vis::kChannels];
+            for (int n = 1; n <= 200000; ++n) {
+                const float v = static_cast<float>(n % 1000) / 1000.0f;
+                for (float &s : block) s = v;
+                for (float &l : levels) l = v;
+                tap.publish(block.data(), 64, levels, n % 1000);
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        vis::Frame f;
+        uint32_t last = 0;
+        int reads = 0;
+        bool torn = false;
+        bool backwards = false;
+        while (!done.load(std::memory_order_acquire) || reads == 0) {
+            const uint32_t seq = tap.read(&f);
+            if (seq == 0) continue;
+            ++reads;
+            backwards |= seq < last;
+            last = seq;
+            const float v = static_cast<float>(f.activeVoices) / 1000.0f;
+            torn |= f.peak[0] != v || std::fabs(f.rms[1] - v) > 1e-6f || f.scope[vis::kScopePoints - 1] != v;
+            for (float l : f.channelLevel) torn |= l != v;
+        }
+        writer.join();
+        CHECK(!torn);
+        CHECK(!backwards);
+        CHECK(tap.read(&f) == 200000);
+        std::printf("[visualization_test] %d concurrent reads\n", reads);
+    }
+
+} // namespace
+
+int main() {
+    testTripleBuffer();
+    testMeasurements();
+    testConcurrent();
+    return testsupport::finish("visualization_test");
+}
@@ -0,0 +1,168 @@
+// Compile-time voice-leading tables against a brute-force search.
+
+#include "VoiceLeading.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+
+namespace {
+
+    using namespace voicing;
+
+    int stableState(int root, int triad, int seventh) { return stateIndex(root, triad, seventh, false); }
+
+    void testVoicings() {
+        // C major 7 (FAN, COMPACT): C3 under G, E, B in the octave above it.
+        const int cmaj7 = stableState(0, 0, 0);
+        CHECK(note(cmaj7, 0) == 48);
+        CHECK(note(cmaj7, 1) == 55);
+        CHECK(note(cmaj7, 2) == 52);
+        CHECK(note(cmaj7, 3) == 59);
+
+        // A minor 7 (STRETCH, WIDE): A3 + E, C, G.
+        const int am7 = stableState(9, 1, 1);
+        CHECK(note(am7, 0) == 57);
+        CHECK(note(am7, 1) == 64);
+        CHECK(note(am7, 2) == 60);
+        CHECK(note(am7, 3) == 67);
+
+        // Unstable ignores the archetypes: diminished seventh on the root.
+        for (int triad = 0; triad < kTriads; ++triad) {
+            for (int seventh = 0; seventh < kSevenths; ++seventh) {
+                const int s = stateIndex(2, triad, seventh, true);
+                CHECK(note(s, 0) == 50);
+                CHECK(note(s, 1) == 53);
+                CHECK(note(s, 2) == 56);
+                CHECK(note(s, 3) == 59);
+            }
+        }
+
+        // Every state: bass is the root, upper tones in the octave above it (VoiceLeader's
+        // fixed layout), which placeNear() leaves where they are.
+        for (int s = 0; s < kStates; ++s) {
+            CHECK(note(s, 0) == kBassNote + s % kRoots);
+            for (int l = 1; l < kLayers; ++l) {
+                CHECK(note(s, l) > note(s, 0) && note(s, l) < note(s, 0) + 12);
+                CHECK(placeNear(note(s, l), note(s, l)) == note(s, l));
+            }
+        }
+    }
+
+    // Fewest changed notes, then least total motion, over every permutation of the sounding
+    // upper layers.
+    int pcDistance(int a, int b) {
+        const int d = ((a - b) % 12 + 12) % 12;
+        return d > 6 ? 12 - d : d;
+    }
+
+    void bestCost(int from, int to, int mask, int &changes, int &motion) {
+        int perm[kUpperLayers] = {0, 1, 2};
+        changes = 1 << 20;
+        motion = 1 << 20;
+        do {
+            bool fixesSilent = true;
+            int c = 0, m = 0;
+            for (int l = 0; l < kUpperLayers; ++l) {
+                if (!((mask >> l) & 1)) {
+                    fixesSilent &= perm[l] == l;
+                    continue;
+                }
+                const int d = pcDistance(note(from, 1 + l), note(to, 1 + perm[l]));
+                c += d != 0;
+                m += d;
+            }
+            if (fixesSilent && (c < changes || (c == changes && m < motion))) {
+                changes = c;
+                motion = m;
+            }
+        } while (std::next_permutation(perm, perm + kUpperLayers));
+    }
+
+    void testTransitions() {
+        for (int from = 0; from < kStates; ++from) {
+            for (int to = 0; to < kStates; ++to) {
+                for (int mask = 0; mask < kUpperMasks; ++mask) {
+                    const uint8_t e = transition(from, to, mask);
+                    CHECK(targetLayer(e, 0) == 0);
+                    CHECK(retained(e, 0) == (note(from, 0) == note(to, 0)));
+
+                    int changes = 0, motion = 0;
+                    bool seen[kLayers] = {};
+                    for (int l = 1; l < kLayers; ++l) {
+                        const int t = targetLayer(e, l);
+                        CHECK(t >= 1 && t < kLayers && !seen[t]);
+                        seen[t] = true;
+                        const int d = pcDistance(note(from, l), note(to, t));
+                        CHECK(retained(e, l) == (d == 0));
+                        if ((mask >> (l - 1)) & 1) {
+                            changes += d != 0;
+                            motion += d;
+                        } else {
+                            CHECK(t == l);   // silent layers stay put
+                        }
+                    }
+
+                    int wantChanges = 0, wantMotion = 0;
+                    bestCost(from, to, mask, wantChanges, wantMotion);
+                    CHECK(changes == wantChanges);
+                    CHECK(motion == wantMotion);
+                }
+            }
+        }
+    }
+
+    void testProgression() {
+        // Cmaj7 -> Am7 with all four fingers down: E and G are common, B steps up to C and
+        // the bass moves C -> A.
+        const int cmaj7 = stableState(0, 0, 0);
+        const int am7 = stableState(9, 1, 1);
+        const uint8_t e = transition(cmaj7, am7, kUpperMasks - 1);
+        CHECK(!retained(e, 0));
+        int layer[kLayers] = {0, 1, 2, 3};
+        int moved = 0;
+        for (int l = 1; l < kLayers; ++l) {
+            moved += !retained(e, l);
+            layer[l] = targetLayer(e, l);
+        }
+        CHECK(moved == 1);
+        CHECK(note(am7, layer[1]) == 67 && note(am7, layer[2]) == 64);
+        CHECK(placeNear(note(cmaj7, 3), note(am7, layer[3])) == 60);
+
+        // Walking a cycle of fifths with everything sounding keeps the slot layers a
+        // permutation of the upper layers.
+        int state = cmaj7;
+        int slot[kLayers] = {0, 1, 2, 3};
+        for (int step = 1; step <= 12; ++step) {
+            const int next = stableState((7 * step) % 12, step % kTriads, step % kSevenths);
+            const uint8_t t = transition(state, next, kUpperMasks - 1);
+            for (int s = 1; s < kLayers; ++s) {
+                slot[s] = targetLayer(t, slot[s]);
+            }
+            CHECK(slot[1] + slot[2] + slot[3] == 6 && slot[1] * slot[2] * slot[3] == 6);
+            state = next;
+        }
+
+        // Voices go to the nearest octave but stay in range.
+        CHECK(placeNear(52, 50) == 50);
+        CHECK(placeNear(50, 59) == 47 + 12);   // D3 -> B2 would leave the range
+        CHECK(placeNear(71, 60) == 72 - 12);
+        CHECK(placeNear(58, 53) == 53);
+        CHECK(placeNear(62, 56) == 68);
+
+        // Same state: nothing moves.
+        for (int mask = 0; mask < kUpperMasks; ++mask) {
+            const uint8_t same = transition(am7, am7, mask);
+            for (int l = 0; l < kLayers; ++l) {
+                CHECK(targetLayer(same, l) == l && retained(same, l));
+            }
+        }
+    }
+
+} // namespace
+
+int main() {
+    testVoicings();
+    testTransitions();
+    testProgression();
+    return testsupport::finish("voice_leading_test");
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// Writes small RIFF/WAVE fixtures for the host tests and benchmark.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace wavwriter {
+
+    namespace detail {
+        inline void put16(std::vector<uint8_t> &b, uint32_t v) {
+            b.push_back(static_cast<uint8_t>(v));
+            b.push_back(static_cast<uint8_t>(v >> 8));
+        }
+
+        inline void put32(std::vector<uint8_t> &b, uint32_t v) {
+            put16(b, v & 0xFFFF);
+            put16(b, v >> 16);
+        }
+
+        inline bool write(const std::string &path, uint16_t format, uint16_t bits, int channels, uint32_t rate,
+                          const std::vector<uint8_t> &payload) {
+            std::vector<uint8_t> b;
+            const uint32_t blockAlign = static_cast<uint32_t>(channels) * bits / 8;
+            b.insert(b.end(), {'R', 'I', 'F', 'F'});
+            put32(b, static_cast<uint32_t>(36 + payload.size()));
+            b.insert(b.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+            put32(b, 16);
+            put16(b, format);
+            put16(b, static_cast<uint32_t>(channels));
+            put32(b, rate);
+            put32(b, rate * blockAlign);
+            put16(b, blockAlign);
+            put16(b, bits);
+            b.insert(b.end(), {'d', 'a', 't', 'a'});
+            put32(b, static_cast<uint32_t>(payload.size()));
+            b.insert(b.end(), payload.begin(), payload.end());
+
+            std::FILE *f = std::fopen(path.c_str(), "wb");
+            if (!f) return false;
+            const bool ok = std::fwrite(b.data(), 1, b.size(), f) == b.size();
+            return std::fclose(f) == 0 && ok;
+        }
+    } // namespace detail
+
+    // Interleaved samples in [-1, 1].
+    inline bool writeInt16(const std::string &path, const std::vector<float> &samples, int channels, uint32_t rate) {
+        std::vector<uint8_t> payload;
+        payload.reserve(samples.size() * 2);
+        for (float s : samples) {
+            const float c = s < -1.0f ? -1.0f : (s > 1.0f ? 1.0f : s);
+            detail::put16(payload, static_cast<uint16_t>(static_cast<int16_t>(c * 32767.0f)));
+        }
+        return detail::write(path, 1, 16, channels, rate, payload);
+    }
+
+    inline bool writeFloat32(const std::string &path, const std::vector<float> &samples, int channels, uint32_t rate) {
+        std::vector<uint8_t> payload(samples.size() * 4);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            uint32_t bits;
+            static_assert(sizeof(bits) == sizeof(float), "IEEE float expected");
+            std::memcpy(&bits, &samples[i], sizeof(bits));
+            payload[i * 4 + 0] = static_cast<uint8_t>(bits);
+            payload[i * 4 + 1] = static_cast<uint8_t>(bits >> 8);
+            payload[i * 4 + 2] = static_cast<uint8_t>(bits >> 16);
+            payload[i * 4 + 3] = static_cast<uint8_t>(bits >> 24);
+        }
+        return detail::write(path, 3, 32, channels, rate, payload);
+    }
+
+} // namespace wavwriter
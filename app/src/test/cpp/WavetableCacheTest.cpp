@@ -0,0 +1,183 @@
+// WavetableCache round trip, validation and import-pipeline hits.
+
+#include "ImportPipeline.h"
+#include "TestSupport.h"
+#include "WavWriter.h"
+#include "WavetableCache.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const std::string kCachePath = "/tmp/wavetable_cache_test.cache";
+
+    std::vector<float> sawCycle(int n, float skew) {
+        std::vector<float> v(static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i) v[static_cast<size_t>(i)] = std::pow(static_cast<float>(i) / n, skew) * 2.0f - 1.0f;
+        return v;
+    }
+
+    void testRoundTrip() {
+        std::remove(kCachePath.c_str());
+        const auto a = sawCycle(700, 1.0f);
+        const auto b = sawCycle(900, 2.0f);
+        Wavetable ta(a.data(), a.size());
+        Wavetable tb(b.data(), b.size());
+
+        {
+            WavetableCache cache;
+            CHECK(!cache.open(kCachePath));   // missing file: nothing mapped, path remembered
+            cache.store(42, ta);
+            cache.store(7, tb);
+            cache.store(42, ta);              // duplicate ignored
+            CHECK(cache.storedCount() == 2);
+            CHECK(cache.find(42) == nullptr); // not visible until reopened
+            CHECK(cache.flush());
+        }
+
+        WavetableCache cache;
+        CHECK(cache.open(kCachePath));
+        CHECK(cache.mappedCount() == 2);
+        CHECK(!cache.open(kCachePath));       // one open per cache
+        CHECK(cache.find(1) == nullptr);
+
+        const float *sa = cache.find(42);
+        const float *sb = cache.find(7);
+        CHECK(sa != nullptr && sb != nullptr);
+        if (sa && sb) {
+            CHECK(reinterpret_cast<uintptr_t>(sa) % WavetableCache::kDataAlignment == 0);
+            CHECK(reinterpret_cast<uintptr_t>(sb) % WavetableCache::kDataAlignment == 0);
+            CHECK(std::memcmp(sa, ta.mipStack(), Wavetable::kStackFloats * sizeof(float)) == 0);
+            CHECK(std::memcmp(sb, tb.mipStack(), Wavetable::kStackFloats * sizeof(float)) == 0);
+        }
+
+        // A wrapped table renders from the mapping exactly like the built one.
+        auto wrapped = cache.load(42);
+        CHECK(wrapped != nullptr && wrapped->parsedOk());
+        if (wrapped) {
+            CHECK(wrapped->data() == sa);
+            for (float phase = 0.0f; phase < 1.0f; phase += 0.0137f) {
+                CHECK(wrapped->render(phase, 3) == ta.render(phase, 3));
+            }
+        }
+
+        // Merging: a flush after new stores keeps the mapped entries.
+        const auto c = sawCycle(500, 0.5f);
+        Wavetable tc(c.data(), c.size());
+        cache.store(42, ta);                  // already mapped, ignored
+        cache.store(99, tc);
+        CHECK(cache.storedCount() == 1);
+        CHECK(cache.flush());
+        WavetableCache merged;
+        CHECK(merged.open(kCachePath));
+        CHECK(merged.mappedCount() == 3);
+        CHECK(merged.find(99) != nullptr && merged.find(7) != nullptr);
+    }
+
+    // Overwrites one header word of the cache file; returns the previous value.
+    uint32_t patchHeader(long offset, uint32_t value) {
+        uint32_t old = 0;
+        std::FILE *f = std::fopen(kCachePath.c_str(), "r+b");
+        CHECK(f != nullptr);
+        if (!f) return old;
+        std::fseek(f, offset, SEEK_SET);
+        CHECK(std::fread(&old, sizeof(old), 1, f) == 1);
+        std::fseek(f, offset, SEEK_SET);
+        std::fwrite(&value, sizeof(value), 1, f);
+        std::fclose(f);
+        return old;
+    }
+
+    void testRejectsStaleFiles() {
+        // An entry count whose directory size wraps a 32-bit size_t (24 x 0xAAAAAAAB = 8 mod
+        // 2^32) and one past the file end: both rejected before the directory is walked.
+        const uint32_t count = patchHeader(24, 0xAAAAAAABu);
+        {
+            WavetableCache cache;
+            CHECK(!cache.open(kCachePath));
+        }
+        patchHeader(24, count + 1000);
+        {
+            WavetableCache cache;
+            CHECK(!cache.open(kCachePath));
+        }
+        patchHeader(24, count);
+        {
+            WavetableCache cache;
+            CHECK(cache.open(kCachePath));
+        }
+
+        // Corrupt the version field: the file must be ignored, not trusted.
+        patchHeader(8, WavetableCache::kFormatVersion + 1);
+        WavetableCache cache;
+        CHECK(!cache.open(kCachePath));
+        CHECK(cache.mappedCount() == 0);
+
+        std::FILE *f = std::fopen(kCachePath.c_str(), "wb");
+        std::fputs("short", f);
+        std::fclose(f);
+        WavetableCache truncated;
+        CHECK(!truncated.open(kCachePath));
+        std::remove(kCachePath.c_str());
+    }
+
+    void testPipelineUsesCache() {
+        std::remove(kCachePath.c_str());
+        const std::string wavPath = "/tmp/wavetable_cache_test.wav";
+        CHECK(wavwriter::writeInt16(wavPath, sawCycle(1024, 1.5f), 1, 48000));
+        const std::vector<ImportPipeline::Request> requests(3, {wavPath, ImportPipeline::Kind::kWavetable});
+
+        {
+            WavetableCache cache;
+            cache.open(kCachePath);
+            AssetRegistry registry;
+            ImportPipeline pipeline(registry, 48000.0, 2);
+            pipeline.setWavetableCache(&cache);
+            const int job = pipeline.submit(requests);
+            pipeline.waitIdle();
+            ImportPipeline::Progress p;
+            CHECK(pipeline.progress(job, p));
+            CHECK(p.failed == 0 && p.cacheHits == 0);
+            CHECK(cache.storedCount() == 1);  // same content, one entry
+            CHECK(cache.flush());
+        }
+
+        WavetableCache cache;
+        CHECK(cache.open(kCachePath));
+        AssetRegistry registry;
+        ImportPipeline pipeline(registry, 48000.0, 2);
+        pipeline.setWavetableCache(&cache);
+        const int job = pipeline.submit(requests);
+        pipeline.waitIdle();
+        ImportPipeline::Progress p;
+        CHECK(pipeline.progress(job, p));
+        CHECK(p.failed == 0 && p.cacheHits == 3);
+        CHECK(cache.storedCount() == 0);      // nothing rebuilt
+        const Wavetable *t = registry.wavetable(pipeline.resultSlot(job, 0));
+        CHECK(t != nullptr);
+        // Published tables render straight from the mapping.
+        std::vector<uint8_t> bytes;
+        if (std::FILE *f = std::fopen(wavPath.c_str(), "rb")) {
+            int ch;
+            while ((ch = std::fgetc(f)) != EOF) bytes.push_back(static_cast<uint8_t>(ch));
+            std::fclose(f);
+        }
+        if (t) CHECK(t->mipStack() == cache.find(WavetableCache::contentHash(bytes.data(), bytes.size())));
+
+        std::remove(wavPath.c_str());
+        std::remove(kCachePath.c_str());
+    }
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testRejectsStaleFiles();
+    testPipelineUsesCache();
+    return testsupport::finish("wavetable_cache_test");
+}
@@ -0,0 +1,93 @@
+package com.breathinghand.shared
+
+import com.breathinghand.core.HarmonicState
+import com.breathinghand.core.MusicalConstants
+import com.breathinghand.core.midi.MidiOutput
+import com.breathinghand.core.midi.SlotPresence
+import com.breathinghand.core.midi.VoiceLeader
+import com.breathinghand.core.midi.VoiceLeadingTable
+import com.breathinghand.engine.GestureAnalyzer
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+class VoiceLeaderTest {
+
+    private class Slots : SlotPresence {
+        val active = BooleanArray(MusicalConstants.MAX_VOICES)
+        override fun isSlotActive(slotIndex: Int): Boolean = active[slotIndex]
+    }
+
+    // Note sounding on each channel (-1: none).
+    private class Output : MidiOutput {
+        val note = IntArray(17) { -1 }
+        override fun sendNoteOn(channel: Int, note: Int, velocity: Int) { this.note[channel] = note }
+        override fun sendNoteOff(channel: Int, note: Int, velocity: Int) {
+            if (this.note[channel] == note) this.note[channel] = -1
+        }
+        override fun sendPitchBend(channel: Int, value14Bit: Int) {}
+        override fun sendControlChange(channel: Int, controller: Int, value: Int) {}
+        override fun sendChannelPressure(channel: Int, pressure: Int) {}
+    }
+
+    // Canonical voicings as the native generator builds them (48 + root + interval); every
+    // transition is the identity except C maj7 -> G maj7, which swaps upper layers 1 and 2
+    // whenever both sound (voicing::kUpperPerm[2]).
+    private fun table(): VoiceLeadingTable {
+        val voicings = ByteArray(VoiceLeadingTable.VOICING_BYTES)
+        for (unstable in 0..1) for (seventh in 0 until VoiceLeadingTable.SEVENTH_COUNT) {
+            for (triad in 0 until VoiceLeadingTable.TRIAD_COUNT) for (root in 0 until VoiceLeadingTable.ROOT_COUNT) {
+                val s = VoiceLeadingTable.stateIndex(root, triad, seventh, unstable == 1)
+                val upper = if (unstable == 1) intArrayOf(3, 6, 9)
+                else intArrayOf(7, intArrayOf(4, 3, 5)[triad], if (seventh == 0) 11 else 10)
+                voicings[s * VoiceLeadingTable.LAYER_COUNT] = (48 + root).toByte()
+                for (l in 0 until 3) voicings[s * VoiceLeadingTable.LAYER_COUNT + 1 + l] = (48 + root + upper[l]).toByte()
+            }
+        }
+        val transitions = ByteArray(VoiceLeadingTable.TRANSITION_BYTES)
+        val from = VoiceLeadingTable.stateIndex(0, 0, 0, false)
+        val to = VoiceLeadingTable.stateIndex(7, 0, 0, false)
+        for (mask in 0 until VoiceLeadingTable.UPPER_MASK_COUNT) {
+            if ((mask and 3) == 3) {
+                transitions[(from * VoiceLeadingTable.STATE_COUNT + to) * VoiceLeadingTable.UPPER_MASK_COUNT + mask] = 2
+            }
+        }
+        return VoiceLeadingTable(voicings, transitions)
+    }
+
+    private fun upperPitchClasses(out: Output): Set<Int> = (2..4).map { out.note[it] % 12 }.toSet()
+
+    // Slots 1-3 sound, a chord change swaps slots 1 and 2, then slot 2 lifts and lands again:
+    // it must take the layer nobody holds (the fifth), not its own (now slot 1's third).
+    @Test
+    fun testRetouchAfterSwapDoesNotDouble() {
+        val leader = VoiceLeader()
+        leader.setVoicingTable(table())
+        val slots = Slots()
+        val out = Output()
+        val state = HarmonicState(rootPc = 0, fingerCount = 4,
+            triad = GestureAnalyzer.TRIAD_FAN, seventh = GestureAnalyzer.SEVENTH_COMPACT)
+
+        for (i in 0..3) slots.active[i] = true
+        leader.process(state, slots, out)
+        assertEquals(listOf(48, 55, 52, 59), (1..4).map { out.note[it] })
+
+        state.rootPc = 7   // G maj7: slot 1 takes B, slot 2 takes D
+        leader.process(state, slots, out)
+        assertEquals(11, out.note[2] % 12)
+        assertEquals(2, out.note[3] % 12)
+        assertEquals(setOf(2, 6, 11), upperPitchClasses(out))
+
+        slots.active[2] = false
+        leader.process(state, slots, out)
+        assertEquals(-1, out.note[3])
+        slots.active[2] = true
+        leader.process(state, slots, out)
+        assertEquals(62, out.note[3], "re-touched slot plays the free fifth")
+        assertEquals(setOf(2, 6, 11), upperPitchClasses(out))
+
+        // And no doubling carries into the next change.
+        state.rootPc = 0
+        leader.process(state, slots, out)
+        assertEquals(setOf(4, 7, 11), upperPitchClasses(out))
+    }
+}
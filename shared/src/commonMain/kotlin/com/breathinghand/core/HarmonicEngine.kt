@@ -14,9 +14,14 @@ class HarmonicEngine {
     private var lastAngleRad: Float = 0f
     private var lastAngleTimeMs: Long = 0L
 
+    /** Hand rotation speed (rad/s, signed) from the last update(); 0 once all fingers lift. */
+    var angularVelocity: Float = 0f
+        private set
+
     fun onAllFingersLift(nowMs: Long) {
         hasTouch = false
         lastAngleTimeMs = 0L
+        angularVelocity = 0f
     }
 
     fun beginFromRestoredState(nowMs: Long, restored: HarmonicState, angleRad: Float) {
@@ -76,6 +81,7 @@ class HarmonicEngine {
         }
 
         val angVel = computeAngularVelocity(nowMs, angleRad)
+        angularVelocity = angVel
         val dwellMs = nowMs - dwellStartMs
         // Rule 5: Stability Comes From Physics, Not Permission — Dwell is debounce/resistance, not a permission gate.
         val shouldAdvance =
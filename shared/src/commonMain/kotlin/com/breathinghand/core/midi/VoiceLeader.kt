@@ -20,6 +20,9 @@ internal expect object DebugLogger {
  * - Reserved Channel: Channel 1 is Global (unused here).
  * - Silence Over Guessing: NONE archetype -> Silence.
  * - Platform Agnostic: Uses SlotPresence interface.
+ * - Voice Leading: with a [VoiceLeadingTable], a chord change is one table lookup that
+ *   moves each sounding slot to the nearest tone of the new chord; slots whose pitch class
+ *   is shared keep sounding (no note-off/note-on). Without one, slot i plays layer i.
  */
 class VoiceLeader {
 
@@ -44,6 +47,11 @@ class VoiceLeader {
     private val sentCC74 = IntArray(MusicalConstants.MAX_VOICES) { -1 }
     private val sentAftertouch = IntArray(MusicalConstants.MAX_VOICES) { -1 }
 
+    // Voice leading (Zero-Alloc): layer each slot currently plays, and the state it voices
+    private var voicingTable: VoiceLeadingTable? = null
+    private val slotLayer = IntArray(MusicalConstants.MAX_VOICES) { it }
+    private var voicedState = -1
+
     private var landingCascadeActive = false
     private var releaseCascadeActive = false
 
@@ -75,6 +83,12 @@ class VoiceLeader {
             DebugLogger.logCascadeState(releaseCascadeActive, landingCascadeActive)
         }
     }
+    /** Enables table-driven voice leading (null: fixed slot layers). Call off the hot path. */
+    fun setVoicingTable(table: VoiceLeadingTable?) {
+        voicingTable = table
+        voicedState = -1
+        for (i in slotLayer.indices) slotLayer[i] = i
+    }
     fun close() { allNotesOff() }
 
     /**
@@ -115,6 +129,8 @@ class VoiceLeader {
         if (midiOutputRef == null) midiOutputRef = midiOutput
         
         val allowAttack = !landingCascadeActive && !releaseCascadeActive
+        val table = voicingTable
+        if (table != null) advanceVoicing(table, state, slots)
 
         for (i in 0 until MusicalConstants.MAX_VOICES) {
             val channel = i + CHANNEL_OFFSET
@@ -143,7 +159,7 @@ class VoiceLeader {
 
             // 2. Determine Target Note
             val targetNote = if (isActive) {
-                calculateTargetNote(i, state)
+                if (table != null) ledNote(table, i) else calculateTargetNote(i, state)
             } else {
                 -1
             }
@@ -171,6 +187,74 @@ class VoiceLeader {
         }
     }
 
+    /**
+     * One table lookup per chord change: sounding slots take over the new chord's layers
+     * with the fewest changed notes; silent (or re-attacking) slots take the upper layers no
+     * sounding slot holds, their own first, so two slots never double a tone.
+     */
+    private fun advanceVoicing(table: VoiceLeadingTable, state: HarmonicState, slots: SlotPresence) {
+        val triad = when (effectiveTriad(state)) {
+            GestureAnalyzer.TRIAD_STRETCH -> 1
+            GestureAnalyzer.TRIAD_CLUSTER -> 2
+            else -> 0
+        }
+        val seventh = if (effectiveSeventh(state) == GestureAnalyzer.SEVENTH_WIDE) 1 else 0
+        val target = VoiceLeadingTable.stateIndex(
+            state.rootPc, triad, seventh, state.harmonicInstability >= INSTABILITY_THRESHOLD
+        )
+
+        var upperMask = 0
+        var silentSlots = 0
+        for (i in 1 until VoiceLeadingTable.LAYER_COUNT) {
+            if (slots.isSlotActive(i) && currentNotes[i] != -1) {
+                upperMask = upperMask or (1 shl (slotLayer[i] - 1))
+            } else {
+                silentSlots = silentSlots or (1 shl i)
+            }
+        }
+        var heldLayers = upperMask
+        for (i in 1 until VoiceLeadingTable.LAYER_COUNT) {
+            if ((silentSlots and (1 shl i)) != 0 && (heldLayers and (1 shl (i - 1))) == 0) {
+                slotLayer[i] = i
+                heldLayers = heldLayers or (1 shl (i - 1))
+                silentSlots = silentSlots and (1 shl i).inv()
+            }
+        }
+        for (i in 1 until VoiceLeadingTable.LAYER_COUNT) {
+            if ((silentSlots and (1 shl i)) == 0) continue
+            var layer = 1
+            while ((heldLayers and (1 shl (layer - 1))) != 0) layer++
+            slotLayer[i] = layer
+            heldLayers = heldLayers or (1 shl (layer - 1))
+        }
+        if (voicedState >= 0 && target != voicedState) {
+            val entry = table.transition(voicedState, target, upperMask)
+            for (i in 1 until VoiceLeadingTable.LAYER_COUNT) {
+                slotLayer[i] = VoiceLeadingTable.targetLayer(entry, slotLayer[i])
+            }
+        }
+        voicedState = target
+    }
+
+    /** Slot's note in the voiced state: bass on the root, upper voices near where they are. */
+    private fun ledNote(table: VoiceLeadingTable, slotIndex: Int): Int {
+        if (slotIndex >= VoiceLeadingTable.LAYER_COUNT) return -1
+        val note = table.note(voicedState, slotLayer[slotIndex])
+        val current = currentNotes[slotIndex]
+        return if (slotIndex == 0 || current == -1) note else VoiceLeadingTable.placeNear(current, note)
+    }
+
+    // Hold last non-NONE archetype
+    private fun effectiveTriad(state: HarmonicState): Int {
+        if (state.triad != GestureAnalyzer.TRIAD_NONE) lastTriadNonNone = state.triad
+        return lastTriadNonNone
+    }
+
+    private fun effectiveSeventh(state: HarmonicState): Int {
+        if (state.seventh != GestureAnalyzer.SEVENTH_NONE) lastSeventhNonNone = state.seventh
+        return lastSeventhNonNone
+    }
+
     private fun calculateTargetNote(slotIndex: Int, state: HarmonicState): Int {
         val baseMidi = 48 + state.rootPc 
         val isUnstable = state.harmonicInstability >= INSTABILITY_THRESHOLD
@@ -189,13 +273,7 @@ class VoiceLeader {
             0 -> baseMidi + 0              // Root
             1 -> baseMidi + 7              // Perfect 5th
             2 -> { // Triad Layer (hold last non-NONE)
-                val effectiveTriad = if (state.triad != GestureAnalyzer.TRIAD_NONE) {
-                    lastTriadNonNone = state.triad
-                    state.triad
-                } else {
-                    lastTriadNonNone
-                }
-                when (effectiveTriad) {
+                when (effectiveTriad(state)) {
                     GestureAnalyzer.TRIAD_FAN     -> baseMidi + 4  // Major
                     GestureAnalyzer.TRIAD_STRETCH -> baseMidi + 3  // Minor
                     GestureAnalyzer.TRIAD_CLUSTER -> baseMidi + 5  // Sus4
@@ -203,13 +281,7 @@ class VoiceLeader {
                 }
             }
             3 -> { // Seventh Layer (hold last non-NONE)
-                val effectiveSeventh = if (state.seventh != GestureAnalyzer.SEVENTH_NONE) {
-                    lastSeventhNonNone = state.seventh
-                    state.seventh
-                } else {
-                    lastSeventhNonNone
-                }
-                when (effectiveSeventh) {
+                when (effectiveSeventh(state)) {
                     GestureAnalyzer.SEVENTH_COMPACT -> baseMidi + 11 // Major 7
                     GestureAnalyzer.SEVENTH_WIDE    -> baseMidi + 10 // Minor 7
                     else -> -1 // Shouldn't reach here
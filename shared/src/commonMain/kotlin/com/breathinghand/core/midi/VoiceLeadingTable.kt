@@ -0,0 +1,71 @@
+package com.breathinghand.core.midi
+
+/**
+ * Precomputed voice leading for every HarmonicState pair.
+ *
+ * The tables are generated at compile time by the native engine (VoiceLeading.h) and
+ * copied here once at startup; this class only indexes them. Layout and encoding must match
+ * the native side.
+ *
+ * - Voicing: per state, the canonical note of each layer (0 root/bass, 1 fifth,
+ *   2 triad tone, 3 seventh), at 48 + root + interval like VoiceLeader's fixed layout.
+ * - Transition: per (from, to, sounding upper layers), the layer each upper layer moves to
+ *   (fewest changed notes, then least motion) and which layers keep their pitch class.
+ *
+ * Zero-alloc lookups.
+ */
+class VoiceLeadingTable(
+    private val voicings: ByteArray,
+    private val transitions: ByteArray
+) {
+    init {
+        require(voicings.size == VOICING_BYTES && transitions.size == TRANSITION_BYTES)
+    }
+
+    fun note(state: Int, layer: Int): Int = voicings[state * LAYER_COUNT + layer].toInt()
+
+    /** Packed entry; decode with [targetLayer] and [isRetained]. */
+    fun transition(from: Int, to: Int, upperMask: Int): Int =
+        transitions[(from * STATE_COUNT + to) * UPPER_MASK_COUNT + upperMask].toInt() and 0xFF
+
+    companion object {
+        const val ROOT_COUNT = 12
+        const val TRIAD_COUNT = 3       // 0 major (FAN), 1 minor (STRETCH), 2 sus4 (CLUSTER)
+        const val SEVENTH_COUNT = 2     // 0 major 7th (COMPACT), 1 minor 7th (WIDE)
+        const val STATE_COUNT = ROOT_COUNT * TRIAD_COUNT * SEVENTH_COUNT * 2
+        const val LAYER_COUNT = 4
+        const val UPPER_MASK_COUNT = 8  // bit (layer - 1): upper layer is sounding
+
+        const val VOICING_BYTES = STATE_COUNT * LAYER_COUNT
+        const val TRANSITION_BYTES = STATE_COUNT * STATE_COUNT * UPPER_MASK_COUNT
+
+        /** Upper voices are kept in [UPPER_LOW, UPPER_HIGH), around the canonical [51, 71). */
+        const val UPPER_LOW = 48
+        const val UPPER_HIGH = 72
+
+        // voicing::kUpperPerm, flattened: permutation p maps upper layer l to 1 + UPPER_PERM[p * 3 + l - 1].
+        private val UPPER_PERM = intArrayOf(
+            0, 1, 2,  0, 2, 1,  1, 0, 2,  1, 2, 0,  2, 0, 1,  2, 1, 0
+        )
+
+        fun stateIndex(rootPc: Int, triad: Int, seventh: Int, unstable: Boolean): Int {
+            val u = if (unstable) 1 else 0
+            return ((u * SEVENTH_COUNT + seventh) * TRIAD_COUNT + triad) * ROOT_COUNT + rootPc
+        }
+
+        fun targetLayer(entry: Int, layer: Int): Int =
+            if (layer == 0) 0 else 1 + UPPER_PERM[(entry and 7) * 3 + layer - 1]
+
+        fun isRetained(entry: Int, layer: Int): Boolean = ((entry shr (3 + layer)) and 1) != 0
+
+        /** Upper note with [targetNote]'s pitch class nearest [current], kept in range. */
+        fun placeNear(current: Int, targetNote: Int): Int {
+            var step = ((targetNote - current) % 12 + 12) % 12
+            if (step > 6) step -= 12
+            var n = current + step
+            while (n < UPPER_LOW) n += 12
+            while (n >= UPPER_HIGH) n -= 12
+            return n
+        }
+    }
+}